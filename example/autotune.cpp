@@ -0,0 +1,421 @@
+// In-process tuning of the spreadsort constants and the block_indirect_sort
+// block sizes for the host it runs on.
+//
+//  Copyright Steven Ross 2009-2014.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+//  See http://www.boost.org/libs/sort for library home page.
+
+// Unlike tune.pl, this doesn't rebuild anything: every candidate setting is
+// compiled in as a tuning policy (or block size), so one run measures all of
+// them on this machine and writes a header to include before the library:
+//
+//   autotune [-small | -large | element_count] [-runs n] [-threads n]
+//            [-int file] [-float file] [-o header]
+//
+// -int and -float replace the synthetic data for integer_sort and float_sort
+// with a raw binary file of ints or floats, like the input.txt the other
+// examples read.  The header defines BOOST_SORT_BLOCK_INDIRECT_BLOCK_SIZES
+// and a boost_sort_host_tuning policy to pass to integer_sort and float_sort:
+//   integer_sort<boost_sort_host_tuning>(first, last);
+// Each constant is swept with the others at their defaults, so the result is
+// a starting point, as with tune.pl, not a guaranteed optimum.
+
+#include <boost/sort/spreadsort/spreadsort.hpp>
+#include <boost/sort/block_indirect_sort/block_indirect_sort.hpp>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+using namespace boost::sort::spreadsort;
+
+typedef std::vector<std::pair<int, double> > timings;
+
+//Candidate policies, each varying one constant from default_tuning
+template <int Splits>
+struct splits_tuning : default_tuning {
+  enum { max_splits = Splits, max_finishing_splits = Splits + 1,
+         int_log_min_split_count =
+           Splits < default_tuning::int_log_min_split_count ? Splits :
+           default_tuning::int_log_min_split_count,
+         float_log_min_split_count =
+           Splits < default_tuning::float_log_min_split_count ? Splits :
+           default_tuning::float_log_min_split_count };
+};
+
+template <int Log_mean>
+struct mean_bin_tuning : default_tuning {
+  enum { int_log_mean_bin_size = Log_mean,
+         float_log_mean_bin_size = Log_mean };
+};
+
+template <int Log_split>
+struct min_split_tuning : default_tuning {
+  enum { int_log_min_split_count = Log_split,
+         float_log_min_split_count = Log_split };
+};
+
+template <int Log_block>
+struct block_candidate {
+  enum { value = 1 << Log_block };
+};
+
+//Runs bench.time<Candidate<First>>() up to Candidate<Last>
+template <template <int> class Candidate, int First, int Last>
+struct sweep {
+  template <class Bench>
+  static void run(const Bench &bench, timings &result) {
+    result.push_back(std::make_pair(First,
+      bench.template time<Candidate<First> >()));
+    sweep<Candidate, First + 1, Last>::run(bench, result);
+  }
+};
+
+template <template <int> class Candidate, int Last>
+struct sweep<Candidate, Last, Last> {
+  template <class Bench>
+  static void run(const Bench &bench, timings &result) {
+    result.push_back(std::make_pair(Last,
+      bench.template time<Candidate<Last> >()));
+  }
+};
+
+//Sorts a copy of each input runs times, returning the sum of the best times
+template <class T, class Sort>
+double best_time(const std::vector<std::vector<T> > &inputs, unsigned runs,
+                 Sort sort) {
+  double total = 0.0;
+  std::vector<T> array;
+  for (size_t u = 0; u < inputs.size(); ++u) {
+    double best = 0.0;
+    for (unsigned r = 0; r < runs; ++r) {
+      array = inputs[u];
+      std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+      sort(array);
+      double elapsed = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+      if (!r || elapsed < best)
+        best = elapsed;
+    }
+    if (!std::is_sorted(array.begin(), array.end())) {
+      printf("sort verification failed!\n");
+      exit(1);
+    }
+    total += best;
+  }
+  return total;
+}
+
+template <class Tuning>
+struct integer_sorter {
+  void operator()(std::vector<int> &array) const {
+    integer_sort<Tuning>(array.begin(), array.end());
+  }
+};
+
+template <class Tuning>
+struct float_sorter {
+  void operator()(std::vector<float> &array) const {
+    float_sort<Tuning>(array.begin(), array.end());
+  }
+};
+
+struct integer_bench {
+  std::vector<std::vector<int> > inputs;
+  unsigned runs;
+  template <class Tuning>
+  double time() const {
+    return best_time(inputs, runs, integer_sorter<Tuning>());
+  }
+};
+
+struct float_bench {
+  std::vector<std::vector<float> > inputs;
+  unsigned runs;
+  template <class Tuning>
+  double time() const {
+    return best_time(inputs, runs, float_sorter<Tuning>());
+  }
+};
+
+//An element of Size bytes, ordered by its first 8
+template <size_t Size>
+struct blob {
+  boost::uint64_t key;
+  char pad[Size - sizeof(boost::uint64_t)];
+  bool operator<(const blob &other) const { return key < other.key; }
+};
+
+//Makes an element with the given key
+template <class T>
+struct element_maker {
+  static T make(boost::uint64_t key) { return T(key); }
+};
+
+template <size_t Size>
+struct element_maker<blob<Size> > {
+  static blob<Size> make(boost::uint64_t key) {
+    blob<Size> result;
+    memset(&result, 0, sizeof(result));
+    result.key = key;
+    return result;
+  }
+};
+
+template <class T, unsigned Block_size>
+struct block_sorter {
+  unsigned nthread;
+  void operator()(std::vector<T> &array) const {
+    typedef typename std::vector<T>::iterator iter;
+    boost::sort::blk_detail::block_indirect_sort<Block_size, 64, iter,
+      std::less<T> >(array.begin(), array.end(), std::less<T>(), nthread);
+  }
+};
+
+template <class T>
+struct block_bench {
+  std::vector<std::vector<T> > inputs;
+  unsigned runs;
+  unsigned nthread;
+  template <class Candidate>
+  double time() const {
+    block_sorter<T, Candidate::value> sorter;
+    sorter.nthread = nthread;
+    return best_time(inputs, runs, sorter);
+  }
+};
+
+//Picks the fastest, keeping the default unless another is 1% faster
+//(or if the default wasn't a candidate, just the fastest)
+int pick(const timings &result, int default_value, const char *name) {
+  std::pair<int, double> best(default_value, -1.0);
+  for (size_t u = 0; u < result.size(); ++u)
+    if (result[u].first == default_value)
+      best.second = result[u].second * 0.99;
+  for (size_t u = 0; u < result.size(); ++u) {
+    printf("%s %d: %f s\n", name, result[u].first, result[u].second);
+    if (best.second < 0.0 || result[u].second < best.second)
+      best = result[u];
+  }
+  return best.first;
+}
+
+template <class T>
+bool read_file(const char *name, std::vector<T> &array) {
+  std::ifstream input(name, std::ios_base::in | std::ios_base::binary);
+  if (input.fail())
+    return false;
+  input.seekg(0, std::ios_base::end);
+  size_t count = size_t(input.tellg()) / sizeof(T);
+  input.seekg(0, std::ios_base::beg);
+  array.resize(count);
+  if (count)
+    input.read(reinterpret_cast<char *>(&array[0]), count * sizeof(T));
+  return true;
+}
+
+//Sweeps block sizes of 128 to 4096 for elements of sizeof(T) bytes
+template <class T>
+int tune_block_size(size_t count, unsigned runs, unsigned nthread,
+                    int default_value) {
+  //Keeping each input under 64MB
+  const size_t max_count = (size_t(64) << 20) / sizeof(T);
+  if (count > max_count)
+    count = max_count;
+  std::mt19937_64 generator(1);
+  block_bench<T> bench;
+  bench.runs = runs;
+  bench.nthread = nthread;
+  bench.inputs.resize(1);
+  for (size_t u = 0; u < count; ++u)
+    bench.inputs[0].push_back(element_maker<T>::make(generator()));
+  timings result;
+  sweep<block_candidate, 7, 12>::run(bench, result);
+  for (size_t u = 0; u < result.size(); ++u)
+    result[u].first = 1 << result[u].first;
+  char name[32];
+  sprintf(name, "block_size[%u]", unsigned(sizeof(T)));
+  return pick(result, default_value, name);
+}
+
+int main(int argc, const char ** argv) {
+  size_t count = 5000000;
+  unsigned runs = 3;
+  unsigned nthread = std::thread::hardware_concurrency();
+  const char *int_file = NULL;
+  const char *float_file = NULL;
+  const char *out_file = NULL;
+  for (int u = 1; u < argc; ++u) {
+    std::string arg(argv[u]);
+    if (arg == "-small")
+      count = 100000;
+    else if (arg == "-large")
+      count = 20000000;
+    else if (arg == "-runs" && u + 1 < argc)
+      runs = atoi(argv[++u]);
+    else if (arg == "-threads" && u + 1 < argc)
+      nthread = atoi(argv[++u]);
+    else if (arg == "-int" && u + 1 < argc)
+      int_file = argv[++u];
+    else if (arg == "-float" && u + 1 < argc)
+      float_file = argv[++u];
+    else if (arg == "-o" && u + 1 < argc)
+      out_file = argv[++u];
+    else if (!arg.empty() && arg[0] != '-')
+      count = atol(argv[u]);
+    else {
+      printf("usage: autotune [-small | -large | element_count] [-runs n] "
+             "[-threads n] [-int file] [-float file] [-o header]\n");
+      return 1;
+    }
+  }
+  if (!runs)
+    runs = 1;
+
+  //Synthetic data: full-range, narrow-range and clustered values
+  std::mt19937 generator(1);
+  integer_bench ints;
+  ints.runs = runs;
+  float_bench floats;
+  floats.runs = runs;
+  if (int_file) {
+    ints.inputs.resize(1);
+    if (!read_file(int_file, ints.inputs[0])) {
+      printf("%s could not be opened\n", int_file);
+      return 1;
+    }
+  } else {
+    ints.inputs.resize(3);
+    for (size_t u = 0; u < count; ++u) {
+      boost::uint32_t value = generator();
+      ints.inputs[0].push_back(int(value));
+      ints.inputs[1].push_back(int(value >> 12));
+      ints.inputs[2].push_back(int((value & 0xff00000f) ^ (u & 0xfff0)));
+    }
+  }
+  if (float_file) {
+    floats.inputs.resize(1);
+    if (!read_file(float_file, floats.inputs[0])) {
+      printf("%s could not be opened\n", float_file);
+      return 1;
+    }
+  } else {
+    floats.inputs.resize(2);
+    std::normal_distribution<float> normal(0.0f, 1000.0f);
+    for (size_t u = 0; u < count; ++u) {
+      boost::uint32_t bits = generator();
+      float value;
+      //Skipping NaNs and infinities
+      if ((bits & 0x7f800000) == 0x7f800000)
+        bits &= 0xbfffffff;
+      memcpy(&value, &bits, sizeof(value));
+      floats.inputs[0].push_back(value);
+      floats.inputs[1].push_back(normal(generator));
+    }
+  }
+
+  printf("Tuning on %u element inputs with %u threads\n",
+         unsigned(ints.inputs[0].size()), nthread);
+  timings result;
+  sweep<splits_tuning, 8, 14>::run(ints, result);
+  int int_splits = pick(result, default_tuning::max_splits,
+                        "integer max_splits");
+  result.clear();
+  sweep<splits_tuning, 8, 14>::run(floats, result);
+  int float_splits = pick(result, default_tuning::max_splits,
+                          "float max_splits");
+  result.clear();
+  sweep<mean_bin_tuning, 0, 4>::run(ints, result);
+  int int_mean = pick(result, default_tuning::int_log_mean_bin_size,
+                      "int_log_mean_bin_size");
+  result.clear();
+  sweep<mean_bin_tuning, 0, 4>::run(floats, result);
+  int float_mean = pick(result, default_tuning::float_log_mean_bin_size,
+                        "float_log_mean_bin_size");
+  result.clear();
+  sweep<min_split_tuning, 4, 11>::run(ints, result);
+  int int_split_count = pick(result, default_tuning::int_log_min_split_count,
+                             "int_log_min_split_count");
+  result.clear();
+  sweep<min_split_tuning, 4, 11>::run(floats, result);
+  int float_split_count =
+    pick(result, default_tuning::float_log_min_split_count,
+         "float_log_min_split_count");
+  //integer_sort and float_sort share max_splits; integers matter more
+  int splits = int_splits;
+  if (int_split_count > splits)
+    int_split_count = splits;
+  if (float_split_count > splits)
+    float_split_count = splits;
+  if (float_splits != int_splits)
+    printf("float_sort prefers max_splits %d; using %d\n", float_splits,
+           splits);
+
+  //block_indirect_sort only runs in parallel with 2 or more threads
+  static const unsigned default_blocks[10] =
+    { BOOST_SORT_BLOCK_INDIRECT_BLOCK_SIZES };
+  int blocks[10];
+  for (unsigned u = 0; u < 10; ++u)
+    blocks[u] = default_blocks[u];
+  if (nthread > 1) {
+    blocks[0] = tune_block_size<boost::uint8_t>(count, runs, nthread,
+                                                blocks[0]);
+    blocks[1] = tune_block_size<boost::uint16_t>(count, runs, nthread,
+                                                 blocks[1]);
+    blocks[2] = tune_block_size<boost::uint32_t>(count, runs, nthread,
+                                                 blocks[2]);
+    blocks[3] = tune_block_size<boost::uint64_t>(count, runs, nthread,
+                                                 blocks[3]);
+    blocks[4] = tune_block_size<blob<16> >(count, runs, nthread, blocks[4]);
+    blocks[5] = tune_block_size<blob<32> >(count, runs, nthread, blocks[5]);
+    blocks[6] = tune_block_size<blob<64> >(count, runs, nthread, blocks[6]);
+    blocks[7] = tune_block_size<blob<128> >(count, runs, nthread, blocks[7]);
+    blocks[8] = tune_block_size<blob<256> >(count, runs, nthread, blocks[8]);
+    blocks[9] = tune_block_size<blob<512> >(count, runs, nthread, blocks[9]);
+  } else {
+    printf("Only one thread; keeping the default block sizes\n");
+  }
+
+  std::ofstream ofile;
+  if (out_file) {
+    ofile.open(out_file, std::ios_base::out | std::ios_base::trunc);
+    if (ofile.fail()) {
+      printf("could not open %s for writing!\n", out_file);
+      return 1;
+    }
+  }
+  std::ostream &out = out_file ? ofile : std::cout;
+  out << "//Generated by autotune on " << ints.inputs[0].size()
+      << " elements with " << nthread << " threads.\n"
+      << "//Include before any other boost/sort header.\n"
+      << "#ifndef BOOST_SORT_HOST_TUNING_HPP\n"
+      << "#define BOOST_SORT_HOST_TUNING_HPP\n"
+      << "#include <boost/sort/spreadsort/detail/tuning.hpp>\n\n"
+      << "#define BOOST_SORT_BLOCK_INDIRECT_BLOCK_SIZES \\\n    ";
+  for (unsigned u = 0; u < 10; ++u)
+    out << blocks[u] << (u < 9 ? ", " : "\n\n");
+  out << "struct boost_sort_host_tuning\n"
+      << "  : boost::sort::spreadsort::default_tuning {\n"
+      << "  enum { max_splits = " << splits << ",\n"
+      << "         max_finishing_splits = " << splits + 1 << ",\n"
+      << "         int_log_mean_bin_size = " << int_mean << ",\n"
+      << "         int_log_min_split_count = " << int_split_count << ",\n"
+      << "         float_log_mean_bin_size = " << float_mean << ",\n"
+      << "         float_log_min_split_count = " << float_split_count
+      << " };\n};\n"
+      << "#endif\n";
+  return 0;
+}
@@ -18,10 +18,13 @@
 #include <future>
 #include <iostream>
 #include <iterator>
+#include <memory>
+#include <thread>
+#include <vector>
 #include <boost/sort/pdqsort/pdqsort.hpp>
 #include <boost/sort/common/util/atomic.hpp>
 #include <boost/sort/common/util/algorithm.hpp>
-#include <boost/sort/common/stack_cnc.hpp>
+#include <boost/sort/common/scheduler.hpp>
 #include <boost/sort/block_indirect_sort/blk_detail/block.hpp>
 
 namespace boost
@@ -36,7 +39,7 @@ namespace blk_detail
 //---------------------------------------------------------------------------
 namespace bsc = boost::sort::common;
 namespace bscu = bsc::util;
-using bsc::stack_cnc;
+using bsc::scheduler;
 using bsc::range;
 
 ///---------------------------------------------------------------------------
@@ -56,7 +59,7 @@ struct backbone
     typedef range< size_t >                                     range_pos;
     typedef range< Iter_t >                                     range_it;
     typedef range< value_t * >                                  range_buf;
-    typedef std::function< void(void) >                         function_t;
+    typedef scheduler< >                                        scheduler_t;
     typedef block< Block_size, Iter_t >                         block_t;
 
     //------------------------------------------------------------------------
@@ -86,8 +89,9 @@ struct backbone
     // thread local varible. It is a pointer to the buffer
     static thread_local value_t *buf;
 
-    // concurrent stack where store the function_t elements
-    stack_cnc< function_t > works;
+    // work stealing scheduler, with a slot for each thread, where store the
+    // works
+    std::unique_ptr< scheduler_t > works;
 
     // global indicator of error
     bool error;
@@ -97,6 +101,26 @@ struct backbone
     //------------------------------------------------------------------------
     backbone (Iter_t first, Iter_t last, Compare comp);
 
+    //------------------------------------------------------------------------
+    //  function : create_works
+    /// @brief create the scheduler of the works of nthread threads
+    //------------------------------------------------------------------------
+    void create_works (uint32_t nthread)
+    {
+        works.reset (new scheduler_t (nthread));
+    }
+    //------------------------------------------------------------------------
+    //  function : push_work
+    /// @brief insert a work in the scheduler, in the slot of the thread.
+    ///        Before exec is called, the work is inserted in the slot 0
+    /// @param func : function without arguments to run
+    //------------------------------------------------------------------------
+    template < class Func_t >
+    void push_work (Func_t &&func)
+    {
+        works->emplace (std::forward< Func_t > (func));
+    }
+
     //------------------------------------------------------------------------
     //  function : get_block
     /// @brief obtain the block in the position pos
@@ -132,20 +156,29 @@ struct backbone
     //-------------------------------------------------------------------------
     //  function : exec
     /// @brief Initialize the thread local buffer with the ptr_buf pointer,
-    ///        and begin with the execution of the functions stored in works
+    ///        and begin with the execution of the works of the scheduler
     //
+    /// @param nthr : index of the thread, which is its slot in the scheduler
     /// @param ptr_buf : Pointer to the memory assigned to the thread_local
     ///                  buffer
     /// @param counter : atomic counter for to invoke to the exec function
     ///                  with only 1 parameter
     //-------------------------------------------------------------------------
-    void exec (value_t *ptr_buf, atomic_t &counter)
+    void exec (uint32_t nthr, value_t *ptr_buf, atomic_t &counter)
     {
         buf = ptr_buf;
-        exec (counter);
+        works->exec (nthr, counter);
+    }
+    //-------------------------------------------------------------------------
+    //  function : exec
+    /// @brief execute works until counter is zero, from a work
+    //
+    /// @param counter : atomic counter. When 0 exits the function
+    //-------------------------------------------------------------------------
+    void exec (atomic_t &counter)
+    {
+        works->exec (counter);
     }
-
-    void exec (atomic_t &counter);
 
 //---------------------------------------------------------------------------
 }; // end struct backbone
@@ -193,23 +226,6 @@ backbone< Block_size, Iter_t, Compare >
     range_tail.last = last;
 }
 //
-//-------------------------------------------------------------------------
-//  function : exec
-/// @brief execute the function_t stored in works, until counter is zero
-//
-/// @param counter : atomic counter. When 0 exits the function
-//-------------------------------------------------------------------------
-template < uint32_t Block_size, class Iter_t, class Compare >
-void backbone< Block_size, Iter_t, Compare >::exec (atomic_t &counter)
-{
-    function_t func_exec;
-    while (bscu::atomic_read (counter) != 0)
-    {
-        if (works.pop_move_back (func_exec)) func_exec ( );
-        else std::this_thread::yield ( );
-    }
-}
-//
 //****************************************************************************
 } //    End namespace blk_detail
 } //    End namespace sort
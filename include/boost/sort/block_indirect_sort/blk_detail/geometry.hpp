@@ -0,0 +1,189 @@
+//----------------------------------------------------------------------------
+/// @file geometry.hpp
+/// @brief This file contains the selection, at run time, of the block size
+///        and group size of block_indirect_sort from the size of the L2
+///        cache of the host, used when BOOST_SORT_BLOCK_INDIRECT_CACHE_AWARE
+///        is defined
+///
+/// @author Copyright (c) 2016 Francisco Jose Tapia (fjtapia@gmail.com )\n
+///         Distributed under the Boost Software License, Version 1.0.\n
+///         ( See accompanying file LICENSE_1_0.txt or copy at
+///           http://www.boost.org/LICENSE_1_0.txt  )
+/// @version 0.1
+///
+/// @remarks
+//-----------------------------------------------------------------------------
+#ifndef __BOOST_SORT_PARALLEL_DETAIL_GEOMETRY_HPP
+#define __BOOST_SORT_PARALLEL_DETAIL_GEOMETRY_HPP
+
+#include <atomic>
+#include <climits>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+#if defined(__APPLE__)
+#include <sys/sysctl.h>
+#include <sys/types.h>
+#endif
+
+namespace boost
+{
+namespace sort
+{
+namespace blk_detail
+{
+//
+// The block sizes of BOOST_SORT_BLOCK_INDIRECT_BLOCK_SIZES, and the group
+// sizes, are the geometry of log scale 0, measured on hosts with 256KB of L2
+// per core. The geometry of log scale s multiplies the block size by 2^s and
+// divides the group size by 2^s, so the elements of a group, and then the
+// division of the work between the threads, don't change.
+static constexpr size_t reference_l2_size = size_t(256) << 10;
+static constexpr int min_log_scale = -1;
+static constexpr int max_log_scale = 2;
+static constexpr int auto_log_scale = INT_MIN;
+//
+//-----------------------------------------------------------------------------
+//  function : l2_cache_size
+/// @brief size in bytes of the L2 cache of the first CPU, read with sysconf,
+///        or from /sys/devices/system/cpu on Linux, and with sysctl on macOS
+/// @return size of the cache, or 0 if unknown
+//-----------------------------------------------------------------------------
+inline size_t l2_cache_size (void)
+{
+#if defined(_SC_LEVEL2_CACHE_SIZE)
+    long nbytes = sysconf (_SC_LEVEL2_CACHE_SIZE);
+    if (nbytes > 0) return size_t (nbytes);
+#endif
+#if defined(__linux__)
+    for (int index = 0; index < 10; ++index)
+    {
+        char path[80], text[32];
+        int level = 0;
+        std::sprintf (path, "/sys/devices/system/cpu/cpu0/cache/index%d/level",
+                      index);
+        FILE *file = std::fopen (path, "r");
+        if (file == nullptr) break;
+        bool ok = std::fscanf (file, "%d", &level) == 1;
+        std::fclose (file);
+        if (!ok || level != 2) continue;
+
+        std::sprintf (path, "/sys/devices/system/cpu/cpu0/cache/index%d/type",
+                      index);
+        file = std::fopen (path, "r");
+        if (file == nullptr) continue;
+        ok = std::fscanf (file, "%31s", text) == 1;
+        std::fclose (file);
+        if (!ok || text[0] == 'I') continue;
+
+        std::sprintf (path, "/sys/devices/system/cpu/cpu0/cache/index%d/size",
+                      index);
+        file = std::fopen (path, "r");
+        if (file == nullptr) continue;
+        unsigned long nunit = 0;
+        char unit = 0;
+        int nread = std::fscanf (file, "%lu%c", &nunit, &unit);
+        std::fclose (file);
+        if (nread < 1) continue;
+        if (unit == 'K') nunit <<= 10;
+        else if (unit == 'M') nunit <<= 20;
+        return size_t (nunit);
+    }
+#elif defined(__APPLE__)
+    size_t nbytes = 0, len = sizeof (nbytes);
+    if (sysctlbyname ("hw.l2cachesize", &nbytes, &len, nullptr, 0) == 0)
+        return nbytes;
+#endif
+    return 0;
+}
+//
+//-----------------------------------------------------------------------------
+//  function : cache_log_scale
+/// @brief log scale of the geometry closest to the L2 cache of the host,
+///        calculated the first time it is called
+//-----------------------------------------------------------------------------
+inline int cache_log_scale (void)
+{
+    static const int log_scale = [ ]( ) -> int
+    {
+        size_t nbytes = l2_cache_size ( );
+        if (nbytes == 0) return 0;
+        long scale = std::lround (std::log2 (double (nbytes) /
+                                             double (reference_l2_size)));
+        if (scale < min_log_scale) return min_log_scale;
+        if (scale > max_log_scale) return max_log_scale;
+        return int (scale);
+    }( );
+    return log_scale;
+}
+//
+//-----------------------------------------------------------------------------
+//  function : override_log_scale
+/// @brief log scale set with set_block_indirect_geometry, or auto_log_scale
+//-----------------------------------------------------------------------------
+inline std::atomic<int> & override_log_scale (void)
+{
+    static std::atomic<int> log_scale (auto_log_scale);
+    return log_scale;
+}
+//
+//-----------------------------------------------------------------------------
+//  function : geometry_log_scale
+/// @brief log scale of the geometry to use
+//-----------------------------------------------------------------------------
+inline int geometry_log_scale (void)
+{
+    int log_scale = override_log_scale ( ).load (std::memory_order_relaxed);
+    return (log_scale == auto_log_scale) ? cache_log_scale ( ) : log_scale;
+}
+//
+//****************************************************************************
+} //    End namespace blk_detail
+//****************************************************************************
+//
+//-----------------------------------------------------------------------------
+//  function : set_block_indirect_geometry
+/// @brief select the geometry of block_indirect_sort in all the threads,
+///        overriding the one chosen from the L2 cache. Only used when
+///        BOOST_SORT_BLOCK_INDIRECT_CACHE_AWARE is defined.
+/// @param log_scale : log2 of the factor applied to the block sizes of the
+///                    table, and dividing the group sizes, from -1 to 2
+//-----------------------------------------------------------------------------
+inline void set_block_indirect_geometry (int log_scale)
+{
+    if (log_scale < blk_detail::min_log_scale)
+        log_scale = blk_detail::min_log_scale;
+    if (log_scale > blk_detail::max_log_scale)
+        log_scale = blk_detail::max_log_scale;
+    blk_detail::override_log_scale ( ).store (log_scale);
+}
+//
+//-----------------------------------------------------------------------------
+//  function : reset_block_indirect_geometry
+/// @brief return to the geometry chosen from the L2 cache of the host
+//-----------------------------------------------------------------------------
+inline void reset_block_indirect_geometry (void)
+{
+    blk_detail::override_log_scale ( ).store (blk_detail::auto_log_scale);
+}
+//
+//-----------------------------------------------------------------------------
+//  function : block_indirect_geometry
+/// @brief log scale of the geometry used by block_indirect_sort
+//-----------------------------------------------------------------------------
+inline int block_indirect_geometry (void)
+{
+    return blk_detail::geometry_log_scale ( );
+}
+//
+//****************************************************************************
+} //    End namespace sort
+} //    End namespace boost
+//****************************************************************************
+//
+#endif
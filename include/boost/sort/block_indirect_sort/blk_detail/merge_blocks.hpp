@@ -53,7 +53,6 @@ struct merge_blocks
     typedef range<size_t> range_pos;
     typedef range<Iter_t> range_it;
     typedef range<value_t *> range_buf;
-    typedef std::function<void(void)> function_t;
     typedef backbone<Block_size, Iter_t, Compare> backbone_t;
     typedef compare_block_pos<Block_size, Iter_t, Compare> compare_block_pos_t;
 
@@ -81,13 +80,13 @@ struct merge_blocks
     //
     //------------------------------------------------------------------------
     //  function : function_merge_range_pos
-    /// @brief create a function_t with a call to merge_range_pos, and insert
-    ///        in the stack of the backbone
+    /// @brief create a work with a call to merge_range_pos, and insert
+    ///        in the deque of works of the backbone
     //
     /// @param rng_input : range of positions of blocks in the index to merge
     /// @param son_counter : atomic variable which is decremented when finish
     ///                      the function. This variable is used for to know
-    ///                      when are finished all the function_t created
+    ///                      when are finished all the works created
     ///                      inside an object
     /// @param error : global indicator of error.
     ///
@@ -96,7 +95,7 @@ struct merge_blocks
                     bool &error)
     {
         bscu::atomic_add(counter, 1);
-        function_t f1 = [this, rng_input, &counter, &error]( ) -> void
+        auto f1 = [this, rng_input, &counter, &error]( ) -> void
         {
             if (! error)
             {
@@ -111,19 +110,19 @@ struct merge_blocks
             }
             bscu::atomic_sub (counter, 1);
         };
-        bk.works.emplace_back(f1);
+        bk.push_work(std::move(f1));
     }
     ;
     //
     //------------------------------------------------------------------------
     //  function : function_cut_range
-    /// @brief create a function_t with a call to cut_range, and inser in
-    ///        the stack of the backbone
+    /// @brief create a work with a call to cut_range, and inser in
+    ///        the deque of works of the backbone
     //
     /// @param rng_input : range of positions in the index to cut
     /// @param counter : atomic variable which is decremented when finish
     ///                  the function. This variable is used for to know
-    ///                  when are finished all the function_t created
+    ///                  when are finished all the works created
     ///                  inside an object
     /// @param error : global indicator of error.
     //------------------------------------------------------------------------
@@ -131,7 +130,7 @@ struct merge_blocks
                     bool &error)
     {
         bscu::atomic_add(counter, 1);
-        function_t f1 = [this, rng_input, &counter, &error]( ) -> void
+        auto f1 = [this, rng_input, &counter, &error]( ) -> void
         {
             if (! error)
             {
@@ -146,7 +145,7 @@ struct merge_blocks
             }
             bscu::atomic_sub (counter, 1);
         };
-        bk.works.emplace_back(f1);
+        bk.push_work(std::move(f1));
     }
 
 
@@ -264,8 +263,8 @@ void merge_blocks<Block_size, Group_size, Iter_t, Compare>
 //-------------------------------------------------------------------------
 //  function : cut_range
 /// @brief when the rng_input is greather than Group_size, this function divide
-///        it in several parts creating function_t elements, which are inserted
-///        in the concurrent stack of the backbone
+///        it in several parts creating works, which are inserted
+///        in the deque of works of the backbone
 //
 /// @param rng_input : range to divide
 //-------------------------------------------------------------------------
@@ -344,11 +343,11 @@ void merge_blocks<Block_size, Group_size, Iter_t, Compare>
 //  function : extract_ranges
 /// @brief from a big range of positions of blocks in the index. Examine which
 ///        are mergeable, and generate a couple of ranges for to be merged.
-///        With the ranges obtained generate function_t elements and are
-///        inserted in the concurrent stack.
+///        With the ranges obtained generate works and are
+///        inserted in the deque of works.
 ///        When the range obtained is smaller than Group_size, generate a
-///        function_t calling to merge_range_pos, when is greater, generate a
-///        function_t calling to cut_range
+///        work calling to merge_range_pos, when is greater, generate a
+///        work calling to cut_range
 //
 /// @param rpos range_input : range of the position in the index, where must
 ///                           extract the ranges to merge
@@ -48,7 +48,6 @@ struct move_blocks
     typedef bsc::range<size_t> range_pos;
     typedef bsc::range<Iter_t> range_it;
     typedef bsc::range<value_t *> range_buf;
-    typedef std::function<void(void)> function_t;
     typedef backbone<Block_size, Iter_t, Compare> backbone_t;
 
     //------------------------------------------------------------------------
@@ -69,13 +68,13 @@ struct move_blocks
     //
     //------------------------------------------------------------------------
     //  function : function_move_sequence
-    /// @brief create a function_t with a call to move_sequence, and insert
-    ///        in the stack of the backbone
+    /// @brief create a work with a call to move_sequence, and insert
+    ///        in the deque of works of the backbone
     ///
     /// @param sequence :sequence of positions for to move the blocks
     /// @param counter : atomic variable which is decremented when finish
     ///                  the function. This variable is used for to know
-    ///                  when are finished all the function_t created
+    ///                  when are finished all the works created
     ///                  inside an object
     /// @param error : global indicator of error.
     //------------------------------------------------------------------------
@@ -83,7 +82,7 @@ struct move_blocks
                                 atomic_t &counter, bool &error)
     {
         bscu::atomic_add(counter, 1);
-        function_t f1 = [this, sequence, &counter, &error]( ) -> void
+        auto f1 = [this, sequence, &counter, &error]( ) -> void
         {
             if (! error)
             {
@@ -98,19 +97,19 @@ struct move_blocks
             }
             bscu::atomic_sub (counter, 1);
         };
-        bk.works.emplace_back(f1);
+        bk.push_work(std::move(f1));
     }
 
     //
     //------------------------------------------------------------------------
     //  function : function_move_long_sequence
-    /// @brief create a function_t with a call to move_long_sequence, and
-    ///        insert in the stack of the backbone
+    /// @brief create a work with a call to move_long_sequence, and
+    ///        insert in the deque of works of the backbone
     //
     /// @param sequence :sequence of positions for to move the blocks
     /// @param counter : atomic variable which is decremented when finish
     ///                  the function. This variable is used for to know
-    ///                  when are finished all the function_t created
+    ///                  when are finished all the works created
     ///                  inside an object
     /// @param error : global indicator of error.
     //------------------------------------------------------------------------
@@ -118,7 +117,7 @@ struct move_blocks
                                      atomic_t &counter, bool &error)
     {
         bscu::atomic_add(counter, 1);
-        function_t f1 = [this, sequence, &counter, &error]( ) -> void
+        auto f1 = [this, sequence, &counter, &error]( ) -> void
         {
             if (! error)
             {
@@ -133,7 +132,7 @@ struct move_blocks
             }
             bscu::atomic_sub (counter, 1);
         };
-        bk.works.emplace_back(f1);
+        bk.push_work(std::move(f1));
     }
 
 //---------------------------------------------------------------------------
@@ -235,8 +234,8 @@ void move_blocks<Block_size, Group_size, Iter_t, Compare>
 //  function : move_long_sequence
 /// @brief move the blocks, following the positions of the init_sequence.
 ///        if the sequence is greater than Group_size, it is divided in small
-///        sequences, creating function_t elements, for to be inserted in the
-///        concurrent stack
+///        sequences, creating works, for to be inserted in the
+///        deque of works
 //
 /// @param init_sequence : vector with the positions from and where move the
 ///                        blocks
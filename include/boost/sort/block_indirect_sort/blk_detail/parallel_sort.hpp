@@ -14,9 +14,11 @@
 #ifndef __BOOST_SORT_PARALLEL_DETAIL_PARALLEL_SORT_HPP
 #define __BOOST_SORT_PARALLEL_DETAIL_PARALLEL_SORT_HPP
 
+#include <functional>
 #include <boost/sort/block_indirect_sort/blk_detail/backbone.hpp>
 #include <boost/sort/pdqsort/pdqsort.hpp>
 #include <boost/sort/common/pivot.hpp>
+#include <boost/sort/common/presorted.hpp>
 
 namespace boost
 {
@@ -48,7 +50,6 @@ struct parallel_sort
     //-------------------------------------------------------------------------
     typedef typename std::iterator_traits<Iter_t>::value_type value_t;
     typedef std::atomic<uint32_t> atomic_t;
-    typedef std::function<void(void)> function_t;
     typedef backbone<Block_size, Iter_t, Compare> backbone_t;
 
     //------------------------------------------------------------------------
@@ -73,8 +74,8 @@ struct parallel_sort
     //
     //------------------------------------------------------------------------
     //  function : function_divide_sort
-    /// @brief create a function_t with a call to divide_sort, and inser in
-    ///        the stack of the backbone
+    /// @brief create a work with a call to divide_sort, and inser in
+    ///        the deque of works of the backbone
     //
     /// @param first : iterator to the first element of the range to divide
     /// @param last : iterator to the next element after the last element of
@@ -83,7 +84,7 @@ struct parallel_sort
     ///                pdqsort
     /// @param counter : atomic variable which is decremented when finish
     ///                  the function. This variable is used for to know
-    ///                  when are finished all the function_t created
+    ///                  when are finished all the works created
     ///                  inside an object
     /// @param error : global indicator of error.
     //------------------------------------------------------------------------
@@ -91,7 +92,7 @@ struct parallel_sort
                               atomic_t &counter, bool &error)
     {
         bscu::atomic_add(counter, 1);
-        function_t f1 = [this, first, last, level, &counter, &error]( )
+        auto f1 = [this, first, last, level, &counter, &error]( )
         {
             if (! error)
             {
@@ -106,7 +107,30 @@ struct parallel_sort
             }
             bscu::atomic_sub (counter, 1);
         };
-        bk.works.emplace_back(f1);
+        bk.push_work(std::move(f1));
+    }
+    //
+    //------------------------------------------------------------------------
+    //  function : operator()
+    /// @brief run func(i) for each i in [0, nwork), as works of the backbone,
+    ///        and wait until all are finished. Used by the parallel check of
+    ///        the sorted and reverse sorted data, and the reversal
+    //------------------------------------------------------------------------
+    template<class Func>
+    void operator()(uint32_t nwork, Func func)
+    {
+        atomic_t son_counter(nwork - 1);
+        for (uint32_t i = 1; i < nwork; ++i)
+        {
+            auto f1 = [i, &func, &son_counter]( )
+            {
+                func (i);
+                bscu::atomic_sub (son_counter, 1);
+            };
+            bk.push_work(std::move(f1));
+        }
+        func(0);
+        bk.exec(son_counter);
     }
 
 //--------------------------------------------------------------------------
@@ -133,27 +157,19 @@ parallel_sort<Block_size, Iter_t, Compare>
 ::parallel_sort(backbone_t &bkbn, Iter_t first, Iter_t last)
  : bk(bkbn), counter(0)
 {
-    using std::swap;
     assert((last - first) >= 0);
     size_t nelem = size_t(last - first);
 
-    //------------------- check if sort --------------------------------------
-    bool sorted = true;
-    for (Iter_t it1 = first, it2 = first + 1;
-         it2 != last && (sorted = ! bk.cmp(*it2, *it1)); it1 = it2++);
-    if (sorted) return;
-
-    //------------------- check if reverse sort ---------------------------
-    sorted = true;
-    for (Iter_t it1 = first, it2 = first + 1;
-         it2 != last && (sorted = ! bk.cmp(*it1, *it2)); it1 = it2++);
-
-    if (sorted)
+    //------------- check if sort or reverse sort ----------------------------
+    // The chunks of the check are works of the backbone, run by the threads
+    // of the algorithm which are idle
+    uint32_t nthread = bk.works->size();
+    uint32_t presort = bsc::presorted(first, last, bk.cmp, false, nthread,
+                                      std::ref(*this));
+    if (! (presort & bsc::scan_unsorted)) return;
+    if (! (presort & bsc::scan_unreversed))
     {
-        size_t nelem2 = nelem >> 1;
-        Iter_t it1 = first, it2 = last - 1;
-        for (size_t i = 0; i < nelem2; ++i)
-            swap(*(it1++), *(it2--));
+        bsc::parallel_reverse(first, last, nthread, std::ref(*this));
         return;
     }
 
@@ -221,7 +237,7 @@ void parallel_sort<Block_size, Iter_t, Compare>
 
     swap(*first, *c_last);
 
-    // insert  the work of the second half in the stack of works
+    // insert  the work of the second half in the deque of works
     function_divide_sort(c_first, last, level - 1, counter, bk.error);
     if (bk.error) return;
 
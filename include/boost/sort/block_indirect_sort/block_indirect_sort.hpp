@@ -21,15 +21,27 @@
 #include <boost/sort/block_indirect_sort/blk_detail/merge_blocks.hpp>
 #include <boost/sort/block_indirect_sort/blk_detail/move_blocks.hpp>
 #include <boost/sort/block_indirect_sort/blk_detail/parallel_sort.hpp>
+#include <boost/sort/block_indirect_sort/blk_detail/geometry.hpp>
 #include <boost/sort/pdqsort/pdqsort.hpp>
 #include <boost/sort/common/util/traits.hpp>
 #include <boost/sort/common/util/algorithm.hpp>
+#include <boost/sort/common/presorted.hpp>
+#include <boost/sort/common/thread_pool.hpp>
 
 
 // This value is the minimal number of threads for to use the
 // block_indirect_sort algorithm
 #define BOOST_NTHREAD_BORDER 6
 
+// Block size used for each size of element, indexed by the log2 of the
+// element size (the last entry is for elements over 256 bytes). A table
+// measured on the target host, as example/autotune.cpp writes, can be
+// defined before including this file.
+#ifndef BOOST_SORT_BLOCK_INDIRECT_BLOCK_SIZES
+#define BOOST_SORT_BLOCK_INDIRECT_BLOCK_SIZES \
+    4096, 4096, 4096, 4096, 2048, 1024, 768, 512, 256, 128
+#endif
+
 namespace boost
 {
 namespace sort
@@ -78,7 +90,6 @@ struct block_indirect_sort
     typedef range<size_t> range_pos;
     typedef range<Iter_t> range_it;
     typedef range<value_t *> range_buf;
-    typedef std::function<void(void)> function_t;
 
     // classes used in the internal operations of the algorithm
     typedef block_pos block_pos_t;
@@ -198,26 +209,12 @@ block_indirect_sort<Block_size, Group_size, Iter_t, Compare>
         size_t nelem = size_t(last - first);
         if (nelem == 0) return;
 
-        //------------------- check if sort -----------------------------------
-        bool sorted = true;
-        for (Iter_t it1 = first, it2 = first + 1; it2 != last && (sorted =
-                        ! bk.cmp(*it2, *it1)); it1 = it2++);
-        if (sorted) return;
-
-        //------------------- check if reverse sort ---------------------------
-        sorted = true;
-        for (Iter_t it1 = first, it2 = first + 1; it2 != last && (sorted =
-                        ! bk.cmp(*it1, *it2)); it1 = it2++);
-
-        if (sorted)
+        //------------- check if sort or reverse sort -------------------------
+        uint32_t presort = bsc::presorted(first, last, bk.cmp, false, nthread);
+        if (! (presort & bsc::scan_unsorted)) return;
+        if (! (presort & bsc::scan_unreversed))
         {
-            size_t nelem2 = nelem >> 1;
-            Iter_t it1 = first, it2 = last - 1;
-            for (size_t i = 0; i < nelem2; ++i)
-            {
-		using std::swap;
-                swap(*(it1++), *(it2--));
-            }
+            bsc::parallel_reverse(first, last, nthread);
             return;
         }
 
@@ -256,32 +253,25 @@ block_indirect_sort<Block_size, Group_size, Iter_t, Compare>
             vbuf[i] = ptr + (i * Block_size);
         }
 
-        // Insert the first work in the stack
+        // Insert the first work in the deque of the thread 0
+        bk.create_works(nthread);
         bscu::atomic_write(counter, 1);
-        function_t f1 = [this]( )
+        auto f1 = [this]( )
         {
             start_function ( );
             bscu::atomic_sub (this->counter, 1);
         };
-        bk.works.emplace_back(f1);
+        bk.push_work(std::move(f1));
 
         //---------------------------------------------------------------------
         //                    PROCESS
         //---------------------------------------------------------------------
-        std::vector<std::future<void> > vfuture(nthread);
-
-        // The function launched with the futures is "execute the functions of
-        // the stack until this->counter is zero
+        // The function launched in each thread is "execute the works of
+        // its deque, or stolen from the others, until this->counter is zero
         // vbuf[i] is the memory from the main thread for to configure the
         // thread local buffer
-        for (uint32_t i = 0; i < nthread; ++i)
-        {
-            auto f1 = [&vbuf,i, this]( )
-            {   bk.exec (vbuf[i], this->counter);};
-            vfuture[i] = std::async(std::launch::async, f1);
-        }
-        for (uint32_t i = 0; i < nthread; ++i)
-            vfuture[i].get();
+        bsc::run_threads(nthread, [&vbuf, this](uint32_t i)
+        {   bk.exec (i, vbuf[i], this->counter);});
         if (bk.error) throw std::bad_alloc();
     }
     catch (std::bad_alloc &)
@@ -333,7 +323,7 @@ void block_indirect_sort<Block_size, Group_size, Iter_t, Compare>
             split_range (pos_index_mid, pos_index2, level_thread - 1);
             bscu::atomic_sub (son_counter, 1);
         };
-        bk.works.emplace_back(f1);
+        bk.push_work(std::move(f1));
         if (bk.error) return;
         split_range(pos_index1, pos_index_mid, level_thread - 1);
     }
@@ -345,7 +335,7 @@ void block_indirect_sort<Block_size, Group_size, Iter_t, Compare>
             parallel_sort_t (this->bk, mid, last);
             bscu::atomic_sub (son_counter, 1);
         };
-        bk.works.emplace_back(f1);
+        bk.push_work(std::move(f1));
         if (bk.error) return;
         parallel_sort_t(bk, first, mid);
     }
@@ -377,6 +367,41 @@ void block_indirect_sort<Block_size, Group_size, Iter_t, Compare>
     }
 }
 
+///---------------------------------------------------------------------------
+//  function block_indirect_sort_geometry
+/// @brief Run block_indirect_sort with the block size Block_size and group
+///        size Group_size, or, when BOOST_SORT_BLOCK_INDIRECT_CACHE_AWARE is
+///        defined, with the geometry of geometry_log_scale, which keeps the
+///        product of both. Each geometry is a different instantiation, then
+///        the option multiplies by four the code generated.
+//----------------------------------------------------------------------------
+template<uint32_t Block_size, uint32_t Group_size, class Iter_t, class Compare>
+inline void block_indirect_sort_geometry(Iter_t first, Iter_t last,
+                                         Compare cmp, uint32_t nthr)
+{
+#ifdef BOOST_SORT_BLOCK_INDIRECT_CACHE_AWARE
+    switch (geometry_log_scale())
+    {
+    case -1:
+        block_indirect_sort<Block_size / 2, Group_size * 2, Iter_t, Compare>
+                        (first, last, cmp, nthr);
+        return;
+    case 1:
+        block_indirect_sort<Block_size * 2, Group_size / 2, Iter_t, Compare>
+                        (first, last, cmp, nthr);
+        return;
+    case 2:
+        block_indirect_sort<Block_size * 4, Group_size / 4, Iter_t, Compare>
+                        (first, last, cmp, nthr);
+        return;
+    default:
+        break;
+    };
+#endif
+    block_indirect_sort<Block_size, Group_size, Iter_t, Compare>
+                    (first, last, cmp, nthr);
+}
+//
 ///---------------------------------------------------------------------------
 //  function block_indirect_sort_call
 /// @brief This class is select the block size in the block_indirect_sort
@@ -388,7 +413,8 @@ template <class Iter_t, class Compare,
 inline void block_indirect_sort_call(Iter_t first, Iter_t last, Compare cmp,
                 uint32_t nthr)
 {
-    block_indirect_sort<128, 128, Iter_t, Compare>(first, last, cmp, nthr);
+    block_indirect_sort_geometry<128, 128, Iter_t, Compare>
+                    (first, last, cmp, nthr);
 }
 
 template<size_t Size>
@@ -397,7 +423,7 @@ struct block_size
     static constexpr const uint32_t BitsSize =
                     (Size == 0) ? 0 : (Size > 256) ? 9 : tmsb[Size - 1];
     static constexpr const uint32_t sz[10] =
-    { 4096, 4096, 4096, 4096, 2048, 1024, 768, 512, 256, 128 };
+    { BOOST_SORT_BLOCK_INDIRECT_BLOCK_SIZES };
     static constexpr const uint32_t data = sz[BitsSize];
 };
 //
@@ -412,8 +438,8 @@ template <class Iter_t, class Compare,
 inline void block_indirect_sort_call (Iter_t first, Iter_t last, Compare cmp,
                                       uint32_t nthr)
 {
-    block_indirect_sort<block_size<sizeof (value_iter<Iter_t> )>::data, 64,
-                        Iter_t, Compare> (first, last, cmp, nthr);
+    block_indirect_sort_geometry<block_size<sizeof (value_iter<Iter_t> )>::data,
+                                 64, Iter_t, Compare> (first, last, cmp, nthr);
 }
 
 //
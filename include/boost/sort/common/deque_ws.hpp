@@ -0,0 +1,192 @@
+//----------------------------------------------------------------------------
+/// @file deque_ws.hpp
+/// @brief This file contains the class deque_ws, a lock-free work stealing
+///        deque of pointers
+///
+/// @author Copyright (c) 2016 Francisco Jose Tapia (fjtapia@gmail.com )\n
+///         Distributed under the Boost Software License, Version 1.0.\n
+///         ( See accompanying file LICENSE_1_0.txt or copy at
+///           http://www.boost.org/LICENSE_1_0.txt  )
+/// @version 0.1
+///
+/// @remarks The algorithm is described in
+///          Chase, Lev, "Dynamic Circular Work-Stealing Deque", SPAA 2005,
+///          with the memory orderings of
+///          Le, Pop, Cohen, Zappa Nardelli, "Correct and Efficient
+///          Work-Stealing for Weak Memory Models", PPoPP 2013
+//-----------------------------------------------------------------------------
+#ifndef __BOOST_SORT_COMMON_DEQUE_WS_HPP
+#define __BOOST_SORT_COMMON_DEQUE_WS_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace boost
+{
+namespace sort
+{
+namespace common
+{
+//
+//---------------------------------------------------------------------------
+/// @class deque_ws
+/// @brief Work stealing deque of T pointers. The owner thread pushes and pops
+///        at the bottom, as a stack, and the other threads steal from the
+///        top, the oldest elements, which are usually the biggest works.
+///        No operation takes a lock, and the owner only synchronizes with the
+///        thieves when one element is left.
+/// @remarks The circular buffer doubles when full. The old buffers are kept
+///          until the destruction of the deque, because a thief can still be
+///          reading them.
+//---------------------------------------------------------------------------
+template<class T>
+class deque_ws
+{
+    //------------------------------------------------------------------------
+    //                     D E F I N I T I O N S
+    //------------------------------------------------------------------------
+    struct buffer_t
+    {
+        int64_t mask;
+        std::unique_ptr<std::atomic<T *>[]> slot;
+
+        explicit buffer_t(int64_t size)
+        : mask(size - 1), slot(new std::atomic<T *>[size]) { };
+
+        T *get(int64_t pos) const
+        {
+            return slot[pos & mask].load(std::memory_order_relaxed);
+        };
+
+        void put(int64_t pos, T *ptr)
+        {
+            slot[pos & mask].store(ptr, std::memory_order_relaxed);
+        };
+    };
+
+    //------------------------------------------------------------------------
+    //                      V A R I A B L E S
+    //------------------------------------------------------------------------
+    // top and bottom are kept apart, in different cache lines, as the first
+    // is written by the thieves, and the second only by the owner
+    std::atomic<int64_t> top;
+    char padding[64];
+    std::atomic<int64_t> bottom;
+    std::atomic<buffer_t *> buffer;
+    // all the buffers allocated, the last is the current one
+    std::vector<std::unique_ptr<buffer_t> > vbuffer;
+
+    //------------------------------------------------------------------------
+    //  function : grow
+    /// @brief doubles the buffer, copying the elements in [t, b)
+    //------------------------------------------------------------------------
+    buffer_t *grow(buffer_t *old, int64_t t, int64_t b)
+    {
+        vbuffer.emplace_back(new buffer_t(2 * (old->mask + 1)));
+        buffer_t *pbuf = vbuffer.back().get();
+        for (int64_t i = t; i < b; ++i) pbuf->put(i, old->get(i));
+        buffer.store(pbuf, std::memory_order_release);
+        return pbuf;
+    };
+
+  public:
+    //
+    //------------------------------------------------------------------------
+    //  function : deque_ws
+    /// @brief constructor of the class
+    /// @param size : initial capacity, a power of 2
+    //------------------------------------------------------------------------
+    explicit deque_ws(int64_t size = 64) : top(0), bottom(0)
+    {
+        vbuffer.emplace_back(new buffer_t(size));
+        buffer.store(vbuffer.back().get(), std::memory_order_relaxed);
+    };
+
+    deque_ws(const deque_ws &) = delete;
+    deque_ws & operator=(const deque_ws &) = delete;
+    //
+    //------------------------------------------------------------------------
+    //  function : push
+    /// @brief insert ptr at the bottom. Only called by the owner
+    //------------------------------------------------------------------------
+    void push(T *ptr)
+    {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_acquire);
+        buffer_t *pbuf = buffer.load(std::memory_order_relaxed);
+        if (b - t > pbuf->mask) pbuf = grow(pbuf, t, b);
+        pbuf->put(b, ptr);
+        bottom.store(b + 1, std::memory_order_release);
+    };
+    //
+    //------------------------------------------------------------------------
+    //  function : pop
+    /// @brief extract the element at the bottom, the last pushed. Only called
+    ///        by the owner
+    /// @return pointer extracted, or nullptr if the deque is empty
+    //------------------------------------------------------------------------
+    T *pop(void)
+    {
+        int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        buffer_t *pbuf = buffer.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_relaxed);
+        if (t > b)
+        {   // empty
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        };
+        T *ptr = pbuf->get(b);
+        if (t == b)
+        {   // last element, raced with the thieves
+            if (!top.compare_exchange_strong(t, t + 1,
+                            std::memory_order_seq_cst,
+                            std::memory_order_relaxed))
+                ptr = nullptr;
+            bottom.store(b + 1, std::memory_order_relaxed);
+        };
+        return ptr;
+    };
+    //
+    //------------------------------------------------------------------------
+    //  function : steal
+    /// @brief extract the element at the top, the first pushed. Called by any
+    ///        thread
+    /// @return pointer extracted, or nullptr if the deque is empty or
+    ///         another thread took the element first
+    //------------------------------------------------------------------------
+    T *steal(void)
+    {
+        int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b) return nullptr;
+        buffer_t *pbuf = buffer.load(std::memory_order_acquire);
+        T *ptr = pbuf->get(t);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                        std::memory_order_relaxed))
+            return nullptr;
+        return ptr;
+    };
+    //
+    //------------------------------------------------------------------------
+    //  function : empty
+    /// @brief approximate check, exact only when no thread is using the deque
+    //------------------------------------------------------------------------
+    bool empty(void) const
+    {
+        return bottom.load(std::memory_order_relaxed) <=
+               top.load(std::memory_order_relaxed);
+    };
+};
+//
+//****************************************************************************
+} //    End namespace common
+} //    End namespace sort
+} //    End namespace boost
+//****************************************************************************
+//
+#endif
@@ -0,0 +1,244 @@
+//----------------------------------------------------------------------------
+/// @file merge_path.hpp
+/// @brief This file contains the parallel merge of two sorted ranges, split
+///        in independent parts with the co-rank (merge path) of the limits,
+///        and the parallel move and destruction of the auxiliary buffers
+///
+/// @author Copyright (c) 2016 Francisco Jose Tapia (fjtapia@gmail.com )\n
+///         Distributed under the Boost Software License, Version 1.0.\n
+///         ( See accompanying file LICENSE_1_0.txt or copy at
+///           http://www.boost.org/LICENSE_1_0.txt  )
+/// @version 0.1
+///
+/// @remarks The co-rank is described in
+///          Siebert, Traff, "Perfectly load-balanced, optimal, stable,
+///          parallel merge", 2013
+//-----------------------------------------------------------------------------
+#ifndef __BOOST_SORT_COMMON_MERGE_PATH_HPP
+#define __BOOST_SORT_COMMON_MERGE_PATH_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+#include <boost/sort/common/range.hpp>
+#include <boost/sort/common/thread_pool.hpp>
+#include <boost/sort/common/util/algorithm.hpp>
+#include <boost/sort/common/util/merge.hpp>
+
+namespace boost
+{
+namespace sort
+{
+namespace common
+{
+//
+// Minimal number of elements merged, moved or destroyed by each thread
+static constexpr size_t merge_min_thread = size_t(1) << 15;
+//
+//-----------------------------------------------------------------------------
+//  function : number_parts
+/// @brief number of parts of at least merge_min_thread elements, and at most
+///        one for each thread, in which split nelem elements
+/// @return number of parts, 0 only if nelem is 0
+//-----------------------------------------------------------------------------
+inline uint32_t number_parts(size_t nelem, uint32_t nthread)
+{
+    size_t npart = nelem / merge_min_thread;
+    if (npart > nthread) npart = nthread;
+    if (npart == 0 && nelem != 0) npart = 1;
+    return uint32_t(npart);
+}
+//
+//-----------------------------------------------------------------------------
+//  function : run_parts
+/// @brief split [0, nelem) in parts of at least merge_min_thread elements,
+///        one for each thread, and call func(pos1, pos2) for each part
+//-----------------------------------------------------------------------------
+template<class Func>
+void run_parts(size_t nelem, uint32_t nthread, Func func)
+{
+    uint32_t npart = number_parts(nelem, nthread);
+    if (npart < 2)
+    {
+        if (nelem != 0) func(size_t(0), nelem);
+        return;
+    }
+    run_threads(npart, [&](uint32_t i)
+    {
+        func((i * nelem) / npart, ((i + 1) * nelem) / npart);
+    });
+}
+//
+//-----------------------------------------------------------------------------
+//  function : co_rank
+/// @brief find how many elements of the first range are in the first k
+///        elements of the stable merge of the two ranges, where the elements
+///        of the first range go before the equal elements of the second
+/// @param k : number of elements of the merge, not greater than the sum of
+///            the sizes of the ranges
+/// @return number of elements of the first range. The rest, up to k, are the
+///         first elements of the second range
+//-----------------------------------------------------------------------------
+template<class Iter1_t, class Iter2_t, class Compare>
+size_t co_rank(Iter1_t first1, Iter1_t last1, Iter2_t first2, Iter2_t last2,
+               size_t k, Compare comp)
+{
+    size_t n1 = size_t(last1 - first1), n2 = size_t(last2 - first2);
+    assert(k <= n1 + n2);
+    size_t low = (k > n2) ? k - n2 : 0;
+    size_t high = (k < n1) ? k : n1;
+
+    // The first i which doesn't leave an element of the first range after an
+    // element of the second range not smaller than it
+    while (low < high)
+    {
+        size_t mid = low + ((high - low) >> 1);
+        if (! comp(*(first2 + (k - mid - 1)), *(first1 + mid)))
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return low;
+}
+//
+//-----------------------------------------------------------------------------
+//  function : parallel_merge
+/// @brief merge, moving them, the sorted ranges src1 and src2 to the
+///        initialized range which begins in dest, which can't overlap them.
+///        The merge is split in parts of the same size, and each thread
+///        merges the elements of its part, found with co_rank
+/// @param nthread : number of threads to use
+/// @return range with the elements merged
+//-----------------------------------------------------------------------------
+template<class Iter1_t, class Iter2_t, class Iter3_t, class Compare>
+range<Iter3_t> parallel_merge(Iter3_t dest, const range<Iter1_t> &src1,
+                              const range<Iter2_t> &src2, Compare comp,
+                              uint32_t nthread)
+{
+    size_t nelem = src1.size() + src2.size();
+    uint32_t npart = number_parts(nelem, nthread);
+    if (npart == 0) return range<Iter3_t>(dest, dest);
+
+    // The limits of all the parts are found before merging, as the merge of
+    // a part moves elements which the search of the others can read
+    std::vector<size_t> vrank(npart + 1);
+    for (uint32_t i = 0; i <= npart; ++i)
+        vrank[i] = co_rank(src1.first, src1.last, src2.first, src2.last,
+                           (i * nelem) / npart, comp);
+
+    auto merge_part = [&](uint32_t i)
+    {
+        size_t pos1 = (i * nelem) / npart, pos2 = ((i + 1) * nelem) / npart;
+        util::merge(src1.first + vrank[i], src1.first + vrank[i + 1],
+                    src2.first + (pos1 - vrank[i]),
+                    src2.first + (pos2 - vrank[i + 1]), dest + pos1, comp);
+    };
+    if (npart == 1) merge_part(0);
+    else run_threads(npart, merge_part);
+    return range<Iter3_t>(dest, dest + nelem);
+}
+//
+//-----------------------------------------------------------------------------
+//  function : parallel_move
+/// @brief move, assigning them, the elements of src to the initialized range
+///        which begins in dest, which can't overlap src
+/// @return range with the elements moved
+//-----------------------------------------------------------------------------
+template<class Iter1_t, class Iter2_t>
+range<Iter2_t> parallel_move(Iter2_t dest, const range<Iter1_t> &src,
+                             uint32_t nthread)
+{
+    run_parts(src.size(), nthread, [&](size_t pos1, size_t pos2)
+    {
+        util::move_forward(dest + pos1, src.first + pos1, src.first + pos2);
+    });
+    return range<Iter2_t>(dest, dest + src.size());
+}
+//
+//-----------------------------------------------------------------------------
+//  function : parallel_move_construct
+/// @brief move the elements of src, creating them in the uninitialized
+///        range dest
+/// @return range with the objects created
+//-----------------------------------------------------------------------------
+template<class Iter_t, class Value_t = util::value_iter<Iter_t> >
+range<Value_t *> parallel_move_construct(const range<Value_t *> &dest,
+                                         const range<Iter_t> &src,
+                                         uint32_t nthread)
+{
+    run_parts(src.size(), nthread, [&](size_t pos1, size_t pos2)
+    {
+        util::move_construct(dest.first + pos1, src.first + pos1,
+                             src.first + pos2);
+    });
+    return range<Value_t *>(dest.first, dest.first + src.size());
+}
+//
+//-----------------------------------------------------------------------------
+//  function : parallel_destroy
+/// @brief destroy the objects of the range rng
+//-----------------------------------------------------------------------------
+template<class Iter_t>
+void parallel_destroy(const range<Iter_t> &rng, uint32_t nthread)
+{
+    typedef util::value_iter<Iter_t> value_t;
+    if (std::is_trivially_destructible<value_t>::value) return;
+    run_parts(rng.size(), nthread, [&](size_t pos1, size_t pos2)
+    {
+        util::destroy(rng.first + pos1, rng.first + pos2);
+    });
+}
+//
+//-----------------------------------------------------------------------------
+//  function : parallel_merge_half
+/// @brief parallel version of merge_half. Merge src1, in a separate buffer,
+///        with src2, which is the final part of dest, and the first part of
+///        dest has the size of src1
+/// @param dest : range where finish the two ranges merged
+/// @param src1 : first range to merge, in a separate buffer, not smaller
+///               than src2
+/// @param src2 : second range to merge, in the final part of dest
+/// @param nthread : number of threads to use
+/// @return range with the two ranges merged
+/// @remarks The merge is done in two steps, each a parallel_merge to memory
+///          apart from the sources. The first fills the first part of dest,
+///          free as src1 is in the buffer. Then the rest of src2 is moved to
+///          the buffer, over the elements of src1 already merged, and the
+///          second step fills the final part of dest.
+//-----------------------------------------------------------------------------
+template<class Iter1_t, class Iter2_t, class Compare>
+range<Iter2_t> parallel_merge_half(const range<Iter2_t> &dest,
+                                   const range<Iter1_t> &src1,
+                                   const range<Iter2_t> &src2, Compare comp,
+                                   uint32_t nthread)
+{
+    size_t n1 = src1.size(), n2 = src2.size();
+    assert(n2 <= n1 && dest.size() == n1 + n2);
+
+    //------------ first step : n1 elements, to the free part of dest --------
+    size_t i1 = co_rank(src1.first, src1.last, src2.first, src2.last, n1,
+                        comp);
+    size_t i2 = n1 - i1;
+    parallel_merge(dest.first, range<Iter1_t>(src1.first, src1.first + i1),
+                   range<Iter2_t>(src2.first, src2.first + i2), comp,
+                   nthread);
+    if (i1 == n1) return dest;
+
+    //------------ second step : the rest, to the final part of dest ---------
+    // The rest of src2 has at most i1 elements, the ones of src1 merged
+    range<Iter1_t> rest2 = parallel_move(src1.first,
+                    range<Iter2_t>(src2.first + i2, src2.last), nthread);
+    parallel_merge(dest.first + n1, range<Iter1_t>(src1.first + i1, src1.last),
+                   rest2, comp, nthread);
+    return dest;
+}
+//
+//****************************************************************************
+} //    End namespace common
+} //    End namespace sort
+} //    End namespace boost
+//****************************************************************************
+//
+#endif
@@ -0,0 +1,189 @@
+//----------------------------------------------------------------------------
+/// @file presorted.hpp
+/// @brief This file contains the check of the parallel algorithms for the
+///        data already sorted or reverse sorted, and the reversal of the
+///        latter, done by several threads
+///
+/// @author Copyright (c) 2016 Francisco Jose Tapia (fjtapia@gmail.com )\n
+///         Distributed under the Boost Software License, Version 1.0.\n
+///         ( See accompanying file LICENSE_1_0.txt or copy at
+///           http://www.boost.org/LICENSE_1_0.txt  )
+/// @version 0.1
+///
+/// @remarks
+//-----------------------------------------------------------------------------
+#ifndef __BOOST_SORT_COMMON_PRESORTED_HPP
+#define __BOOST_SORT_COMMON_PRESORTED_HPP
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <boost/sort/common/thread_pool.hpp>
+
+namespace boost
+{
+namespace sort
+{
+namespace common
+{
+//
+// Bits of the state of a scan, set when a pair of consecutive elements is
+// found out of the forward order, and out of the reverse order. When both are
+// set, the scan stops
+static constexpr uint32_t scan_unsorted = 1;
+static constexpr uint32_t scan_unreversed = 2;
+static constexpr uint32_t scan_random = 3;
+
+// Number of elements checked by a thread between two reads of the state
+// shared with the other threads
+static constexpr size_t scan_step = 4096;
+
+// Number of elements checked by the calling thread before the parallel scan.
+// Most of the unsorted data is detected here, without launching threads
+static constexpr size_t scan_serial = 4096;
+
+// Minimal number of elements checked, or swapped, by each thread
+static constexpr size_t scan_min_thread = size_t(1) << 15;
+//
+//---------------------------------------------------------------------------
+/// @struct thread_runner
+/// @brief runs the chunks of the parallel scan with run_threads
+//---------------------------------------------------------------------------
+struct thread_runner
+{
+    template<class Func>
+    void operator()(uint32_t nchunk, Func func) const
+    {
+        run_threads(nchunk, func);
+    }
+};
+//
+//-----------------------------------------------------------------------------
+//  function : scan_presorted
+/// @brief check the pairs of consecutive elements in [first, last), adding
+///        to state the orders broken. Stops when state is scan_random, also
+///        when set by other threads
+/// @param strict : if true, the reverse order requires the elements to be
+///                 strictly decreasing, as the reversal of the equal elements
+///                 is not stable
+//-----------------------------------------------------------------------------
+template<class Iter_t, class Compare>
+void scan_presorted(Iter_t first, Iter_t last, Compare comp, bool strict,
+                    std::atomic<uint32_t> &state)
+{
+    uint32_t st = state.load(std::memory_order_relaxed);
+    while (st != scan_random && (last - first) > 1)
+    {
+        Iter_t end = ((last - first) > ptrdiff_t(scan_step)) ?
+                        first + scan_step : last;
+        uint32_t found = st;
+        for (Iter_t it = first + 1; it != end && found != scan_random;
+             first = it++)
+        {
+            if (comp(*it, *first))
+                found |= scan_unsorted;
+            else if (!(found & scan_unreversed) &&
+                     (strict || comp(*first, *it)))
+                found |= scan_unreversed;
+        }
+        st = (found != st) ? (state.fetch_or(found) | found)
+                           : state.load(std::memory_order_relaxed);
+    }
+}
+//
+//-----------------------------------------------------------------------------
+//  function : presorted
+/// @brief check if the range is sorted or reverse sorted. The first
+///        scan_serial elements are checked by the calling thread, and the
+///        rest is split in chunks checked in parallel, with the order broken
+///        in a chunk stopping the others
+/// @param nthread : number of threads to use
+/// @param run : run(nchunk, func) calls func(i) for each i in [0, nchunk),
+///              and returns when all are finished
+/// @return bits of the orders broken: without scan_unsorted, the range is
+///         sorted; without scan_unreversed, it is reverse sorted
+//-----------------------------------------------------------------------------
+template<class Iter_t, class Compare, class Run_t>
+uint32_t presorted(Iter_t first, Iter_t last, Compare comp, bool strict,
+                   uint32_t nthread, Run_t run)
+{
+    assert((last - first) >= 0);
+    std::atomic<uint32_t> state(0);
+    size_t nelem = size_t(last - first);
+    Iter_t mid = first + ((nelem < scan_serial) ? nelem : scan_serial);
+    scan_presorted(first, mid, comp, strict, state);
+    if (state.load() == scan_random || mid == last) return state.load();
+
+    // The chunks share their limits, so the pairs between them are checked
+    Iter_t base = mid - 1;
+    size_t nrest = size_t(last - base);
+    size_t nchunk = nrest / scan_min_thread;
+    if (nchunk > nthread) nchunk = nthread;
+    if (nchunk < 2)
+    {
+        scan_presorted(base, last, comp, strict, state);
+        return state.load();
+    }
+    run(uint32_t(nchunk), [&](uint32_t i)
+    {
+        size_t pos1 = (i * nrest) / nchunk;
+        size_t pos2 = ((i + 1) * nrest) / nchunk;
+        if (pos2 != nrest) ++pos2;
+        scan_presorted(base + pos1, base + pos2, comp, strict, state);
+    });
+    return state.load();
+}
+
+template<class Iter_t, class Compare>
+inline uint32_t presorted(Iter_t first, Iter_t last, Compare comp,
+                          bool strict, uint32_t nthread)
+{
+    return presorted(first, last, comp, strict, nthread, thread_runner());
+}
+//
+//-----------------------------------------------------------------------------
+//  function : parallel_reverse
+/// @brief reverse the elements of the range, swapping in each thread a chunk
+///        of the first half with its mirror in the second half
+/// @param nthread : number of threads to use
+/// @param run : run(nchunk, func) calls func(i) for each i in [0, nchunk),
+///              and returns when all are finished
+//-----------------------------------------------------------------------------
+template<class Iter_t, class Run_t>
+void parallel_reverse(Iter_t first, Iter_t last, uint32_t nthread, Run_t run)
+{
+    assert((last - first) >= 0);
+    size_t nhalf = size_t(last - first) >> 1;
+    if (nhalf == 0) return;
+    size_t nchunk = nhalf / scan_min_thread;
+    if (nchunk > nthread) nchunk = nthread;
+    if (nchunk == 0) nchunk = 1;
+
+    auto swap_chunk = [&](uint32_t i)
+    {
+        using std::swap;
+        size_t pos1 = (i * nhalf) / nchunk;
+        size_t pos2 = ((i + 1) * nhalf) / nchunk;
+        Iter_t it1 = first + pos1, it2 = last - (pos1 + 1);
+        for (size_t k = pos1; k < pos2; ++k)
+            swap(*(it1++), *(it2--));
+    };
+    if (nchunk == 1) swap_chunk(0);
+    else run(uint32_t(nchunk), swap_chunk);
+}
+
+template<class Iter_t>
+inline void parallel_reverse(Iter_t first, Iter_t last, uint32_t nthread)
+{
+    parallel_reverse(first, last, nthread, thread_runner());
+}
+//
+//****************************************************************************
+} //    End namespace common
+} //    End namespace sort
+} //    End namespace boost
+//****************************************************************************
+//
+#endif
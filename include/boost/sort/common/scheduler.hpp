@@ -14,15 +14,26 @@
 #ifndef __BOOST_SORT_COMMON_SCHEDULER_HPP
 #define __BOOST_SORT_COMMON_SCHEDULER_HPP
 
-#include <scoped_allocator>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <utility>
 #include <vector>
-#include <deque>
-#include <iostream>
-#include <unordered_map>
-#include <boost/sort/common/spinlock.hpp>
-#include <boost/sort/common/util/search.hpp>
-#include <boost/sort/common/util/traits.hpp>
+#include <boost/sort/common/deque_ws.hpp>
+#include <boost/sort/common/small_task.hpp>
+
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || \
+    defined(_M_X64)
+#include <immintrin.h>
+#define BOOST_SORT_CPU_RELAX() _mm_pause()
+#else
+#define BOOST_SORT_CPU_RELAX() ((void)0)
+#endif
 
 namespace boost
 {
@@ -30,7 +41,38 @@ namespace sort
 {
 namespace common
 {
+//
+//---------------------------------------------------------------------------
+/// @class backoff
+/// @brief Exponential backoff of a thread which finds no work. Each pause
+///        spins twice the previous one, and over max_spin_step yields the
+///        processor. After max_step pauses, the thread must park.
+//---------------------------------------------------------------------------
+class backoff
+{
+    uint32_t nstep;
 
+  public:
+    static constexpr uint32_t max_spin_step = 6;
+    static constexpr uint32_t max_step = 12;
+
+    backoff(void) : nstep(0) { };
+
+    void reset(void) { nstep = 0; };
+
+    bool exhausted(void) const { return nstep > max_step; };
+
+    void pause(void)
+    {
+        if (nstep <= max_spin_step)
+        {
+            for (uint32_t i = 0; i < (1u << nstep); ++i)
+                BOOST_SORT_CPU_RELAX();
+        }
+        else std::this_thread::yield();
+        ++nstep;
+    };
+};
 //
 //###########################################################################
 //                                                                         ##
@@ -41,243 +83,340 @@ namespace common
 //    ################################################################     ##
 //                                                                         ##
 //###########################################################################
-
 //
 //---------------------------------------------------------------------------
 /// @class  scheduler
-/// @brief This class is a concurrent stack controled by a spin_lock
-/// @remarks
+/// @brief Work stealing scheduler of the works of a parallel algorithm.
+///        Each thread which runs the works is bound to a slot, with its own
+///        lock-free deque. It runs the works of its deque, the last inserted
+///        first, and when empty, steals the oldest works of the other slots,
+///        beginning with one chosen at random.
+/// @remarks A thread without works backs off exponentially, and then parks
+///          in a condition variable until a work is inserted or finished.
+///          The works are Task_t objects, created with new and deleted after
+///          running them.
+///          When a work throws, the scheduler is cancelled: no more works
+///          are run, the works waiting in an exec stop by throwing, and when
+///          all the running works have stopped, the exec of each thread
+///          rethrows the first exception. A work must not throw itself while
+///          the works it inserted can still use its data.
 //---------------------------------------------------------------------------
-template<typename Func_t, typename Allocator = std::allocator<Func_t> >
-struct scheduler
+template<class Task_t = small_task<> >
+class scheduler
 {
+  public:
     //-----------------------------------------------------------------------
     //                     D E F I N I T I O N S
     //-----------------------------------------------------------------------
-    typedef std::scoped_allocator_adaptor <Allocator>   scoped_alloc;
-    template <class T>
-    using alloc_t = typename std::allocator_traits<Allocator>::
-                    template rebind_alloc<T>;
+    typedef std::atomic<uint32_t> atomic_t;
+    typedef deque_ws<Task_t> deque_t;
 
+  private:
+    // scheduler and slot to which the thread is bound, number of works
+    // nested in the thread, and if these are counted in nstopped
+    struct binding_t
+    {
+        scheduler *sch;
+        uint32_t slot;
+        uint32_t depth;
+        bool stopped;
+    };
 
-    typedef std::deque <Func_t, scoped_alloc>           deque_t;
-    typedef typename deque_t::iterator                  it_deque;
-    typedef std::thread::id                             key_t;
-    typedef std::hash <key_t>                           hash_t;
-    typedef std::equal_to <key_t>                       equal_t;
-    typedef std::unique_lock <spinlock_t>               lock_t;
-    typedef std::pair<const key_t, deque_t>             pair_t;
-
-    typedef std::unordered_map <key_t, deque_t, hash_t,
-                                equal_t, alloc_t <pair_t> >  map_t;
-    typedef typename map_t::iterator                    it_map;
+    // thrown by the exec of the works which wait after a cancellation
+    struct cancelled_t { };
 
     //-----------------------------------------------------------------------
     //                     V A R I A B L E S
     //-----------------------------------------------------------------------
-    map_t mp;
-    size_t nelem;
-    mutable spinlock_t spl;
+    std::vector<std::unique_ptr<deque_t> > vdeque;
+    // changes each time a work is inserted or finished
+    std::atomic<uint64_t> epoch;
+    // number of threads parked
+    atomic_t nparked;
+    // number of works running, and of these, stopped by a cancellation
+    atomic_t nrunning, nstopped;
+    std::atomic<bool> cancelled;
+    // first exception thrown by a work, protected by mtx
+    std::exception_ptr error;
+    std::mutex mtx;
+    std::condition_variable cv;
 
-    //------------------------------------------------------------------------
-    //  function : scheduler
-    /// @brief  constructor
-    //------------------------------------------------------------------------
-    scheduler(void) : mp(), nelem(0)  { };
+    static binding_t & binding(void)
+    {
+        static thread_local binding_t bind = { nullptr, 0, 0, false };
+        return bind;
+    };
+
+  public:
     //
     //-----------------------------------------------------------------------
     //  function : scheduler
-    /// @brief  Copy & move constructor
-    /// @param [in] VT : stack_cnc from where copy the data
+    /// @brief  constructor
+    /// @param nslot : number of threads which run the works
     //-----------------------------------------------------------------------
-    scheduler(scheduler && VT) = delete;
-    scheduler(const scheduler & VT) = delete;
+    explicit scheduler(uint32_t nslot)
+    : epoch(0), nparked(0), nrunning(0), nstopped(0), cancelled(false)
+    {
+        assert(nslot != 0);
+        vdeque.reserve(nslot);
+        for (uint32_t i = 0; i < nslot; ++i)
+            vdeque.emplace_back(new deque_t());
+    };
+
+    scheduler(const scheduler &) = delete;
+    scheduler & operator=(const scheduler &) = delete;
     //
-    //------------------------------------------------------------------------
+    //-----------------------------------------------------------------------
     //  function : ~scheduler
-    /// @brief  Destructor
-    //------------------------------------------------------------------------
-    virtual ~scheduler(void) {mp.clear();};
-    //
-    //------------------------------------------------------------------------
-    //  function : operator =
-    /// @brief Asignation operator
-    /// @param [in] VT : stack_cnc from where copy the data
-    /// @return Reference to the stack_cnc after the copy
-    //------------------------------------------------------------------------
-    scheduler & operator=(const scheduler &VT) = delete;
+    /// @brief  Destructor. Delete the works not run, which only remain after
+    ///         a cancellation
+    //-----------------------------------------------------------------------
+    ~scheduler(void)
+    {
+        for (auto &dq : vdeque)
+        {
+            for (Task_t *task = dq->steal(); task != nullptr;
+                 task = dq->steal())
+                delete task;
+        }
+    };
     //
-    //------------------------------------------------------------------------
+    //-----------------------------------------------------------------------
     //  function : size
-    /// @brief Asignation operator
-    /// @param [in] VT : stack_cnc from where copy the data
-    /// @return Reference to the stack_cnc after the copy
-    //------------------------------------------------------------------------
-    size_t size(void) const
+    /// @brief number of slots
+    //-----------------------------------------------------------------------
+    uint32_t size(void) const { return uint32_t(vdeque.size()); };
+    //
+    //-----------------------------------------------------------------------
+    //  function : emplace
+    /// @brief Insert a work in the deque of the slot of the calling thread.
+    ///        Before any thread is bound by exec, it is inserted in the slot 0
+    /// @param args : arguments for to build the Task_t
+    //-----------------------------------------------------------------------
+    template<class ... Args>
+    void emplace(Args && ... args)
     {
-        lock_t s(spl);
-        return nelem;
-    };
+        binding_t &bind = binding();
+        uint32_t slot = (bind.sch == this) ? bind.slot : 0;
+        std::unique_ptr<Task_t> ptask(new Task_t(std::forward<Args>(args) ...));
+        vdeque[slot]->push(ptask.get());
+        ptask.release();
+        signal();
+    }
     //
-    //------------------------------------------------------------------------
-    //  function : clear
-    /// @brief Delete all the elements of the stack_cnc.
-    //------------------------------------------------------------------------
-    void clear_all(void)
+    //-----------------------------------------------------------------------
+    //  function : exec
+    /// @brief bind the calling thread to slot, and run works until counter
+    ///        is zero. The previous binding is restored on return.
+    /// @exception the first exception thrown by a work, once all the
+    ///            running works have stopped
+    //-----------------------------------------------------------------------
+    void exec(uint32_t slot, atomic_t &counter)
     {
-        lock_t s(spl);
-        mp.clear();
-        nelem = 0;
-    };
+        struct restore_t
+        {
+            binding_t &bind;
+            binding_t old;
+            ~restore_t() { bind = old; }
+        } restore = { binding(), binding() };
+        restore.bind.sch = this;
+        restore.bind.slot = slot;
+        restore.bind.depth = 0;
+        restore.bind.stopped = false;
+        if (wait(counter)) return;
 
+        wait_until([this] { return nrunning.load() == 0; });
+        std::lock_guard<std::mutex> lk(mtx);
+        std::rethrow_exception(error);
+    };
     //
-    //------------------------------------------------------------------------
-    //  function : insert
-    /// @brief Insert one element in the back of the container
-    /// @param [in] D : value to insert. Can ve a value, a reference or an
-    ///                 rvalue
-    /// @return iterator to the element inserted
-    /// @remarks This operation is O ( const )
-    //------------------------------------------------------------------------
-    void insert(Func_t & f)
+    //-----------------------------------------------------------------------
+    //  function : exec
+    /// @brief run works until counter is zero, from a work, whose thread is
+    ///        already bound to a slot
+    /// @exception cancelled_t after a cancellation, once all the running
+    ///            works are stopped, so none of them can use the data of the
+    ///            works which unwind. run catches it.
+    //-----------------------------------------------------------------------
+    void exec(atomic_t &counter)
     {
-        lock_t s(spl);
-        key_t th_id = std::this_thread::get_id();
-        it_map itmp = mp.find(th_id);
-        if (itmp == mp.end())
+        binding_t &bind = binding();
+        assert(bind.sch == this);
+        if (wait(counter) && !bind.stopped) return;
+
+        // all the works nested in the thread are stopped, the first time
+        if (!bind.stopped)
         {
-            auto aux = mp.emplace(th_id, deque_t());
-            if (aux.second == false) throw std::bad_alloc();
-            itmp = aux.first;
+            bind.stopped = true;
+            nstopped += bind.depth;
+            signal();
         };
-        itmp->second.emplace_back(std::move(f));
-        nelem++;
+        wait_until([this] { return nstopped.load() == nrunning.load(); });
+        throw cancelled_t();
     };
 
+  private:
     //
-    //------------------------------------------------------------------------
-    //  function :emplace
-    /// @brief Insert one element in the back of the container
-    /// @param [in] args :group of arguments for to build the object to insert
-    /// @return iterator to the element inserted
-    /// @remarks This operation is O ( const )
-    //------------------------------------------------------------------------
-    template<class ... Args>
-    void emplace(Args && ... args)
+    //-----------------------------------------------------------------------
+    //  function : wait
+    /// @brief run works until counter is zero
+    /// @return false if the scheduler was cancelled before
+    //-----------------------------------------------------------------------
+    bool wait(atomic_t &counter)
     {
-        lock_t s(spl);
-        key_t th_id = std::this_thread::get_id();
-        it_map itmp = mp.find(th_id);
-        if (itmp == mp.end())
+        backoff boff;
+        while (counter.load() != 0)
         {
-            auto aux = mp.emplace(th_id, deque_t());
-            if (aux.second == false) throw std::bad_alloc();
-            itmp = aux.first;
+            // counted as running before taking the work, so a cancellation
+            // can't miss a work taken but not started
+            ++nrunning;
+            Task_t *task = cancelled.load() ? nullptr : get_task();
+            if (task != nullptr)
+            {
+                run(task);
+                boff.reset();
+                continue;
+            };
+            --nrunning;
+            if (cancelled.load())
+            {   // wake the threads waiting for nrunning to fall
+                signal();
+                return false;
+            };
+            if (!boff.exhausted()) boff.pause();
+            else
+            {
+                park(counter);
+                boff.reset();
+            };
         };
-        itmp->second.emplace_back(std::forward <Args>(args) ...);
-        nelem++;
+        return true;
     };
     //
-    //------------------------------------------------------------------------
-    //  function : insert
-    /// @brief Insert one element in the back of the container
-    /// @param [in] D : value to insert. Can ve a value, a reference or an rvalue
-    /// @return iterator to the element inserted
-    /// @remarks This operation is O ( const )
-    //------------------------------------------------------------------------
-    template<class it_func>
-    void insert_range(it_func first, it_func last)
+    //-----------------------------------------------------------------------
+    //  function : get_task
+    /// @brief extract a work of the deque of the thread, or if empty, steal
+    ///        one from the other slots
+    /// @return pointer to the work, or nullptr if none was found
+    //-----------------------------------------------------------------------
+    Task_t *get_task(void)
     {
-        //--------------------------------------------------------------------
-        //                    Metaprogramming
-        //--------------------------------------------------------------------
-        typedef util::value_iter<it_func> value2_t;
-        static_assert (std::is_same< Func_t, value2_t >::value,
-                        "Incompatible iterators\n");
+        const uint32_t own = binding().slot;
+        Task_t *task = vdeque[own]->pop();
+        if (task != nullptr) return task;
 
-        //--------------------------------------------------------------------
-        //                     Code
-        //--------------------------------------------------------------------
-        assert((last - first) > 0);
+        // xorshift generator of the first victim
+        static thread_local uint32_t seed = 2463534242u;
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
 
-        lock_t s(spl);
-        key_t th_id = std::this_thread::get_id();
-        it_map itmp = mp.find(th_id);
-        if (itmp == mp.end())
+        const uint32_t nslot = size();
+        for (uint32_t i = 0, victim = seed % nslot; i < nslot;
+             ++i, victim = (victim + 1 == nslot) ? 0 : victim + 1)
         {
-            auto aux = mp.emplace(th_id, deque_t());
-            if (aux.second == true) throw std::bad_alloc();
-            itmp = aux.first;
+            if (victim == own) continue;
+            task = vdeque[victim]->steal();
+            if (task != nullptr) return task;
         };
-        while (first != last)
+        return nullptr;
+    };
+    //
+    //-----------------------------------------------------------------------
+    //  function : run
+    /// @brief run and delete a work, counted in nrunning, and wake the
+    ///        parked threads, which can be waiting for it to finish. If the
+    ///        work throws, the scheduler is cancelled.
+    //-----------------------------------------------------------------------
+    void run(Task_t *task)
+    {
+        binding_t &bind = binding();
+        ++bind.depth;
+        try
+        {
+            std::unique_ptr<Task_t> ptask(task);
+            (*ptask)();
+        } catch (cancelled_t &)
+        {
+            --nstopped;
+        } catch (...)
         {
-            itmp->second.emplace_back(std::move(*(first++)));
-            nelem++;
+            std::lock_guard<std::mutex> lk(mtx);
+            if (!error) error = std::current_exception();
+            cancelled = true;
         };
+        --bind.depth;
+        --nrunning;
+        signal();
     };
     //
-    //------------------------------------------------------------------------
-    //  function : extract
-    /// @brief erase the last element of the tree and return a copy
-    /// @param [out] V : reference to a variable where copy the element
-    /// @return code of the operation
-    ///         0- Element erased
-    ///         1 - Empty tree
-    /// @remarks This operation is O(1)
-    //------------------------------------------------------------------------
-    bool extract(Func_t & f)
+    //-----------------------------------------------------------------------
+    //  function : signal
+    /// @brief notify a change to the parked threads, if any
+    //-----------------------------------------------------------------------
+    void signal(void)
     {
-        lock_t s(spl);
-        if (nelem == 0) return false;
-        key_t th_id = std::this_thread::get_id();
-        it_map itmp = mp.find(th_id);
-        if (itmp != mp.end() && ! itmp->second.empty())
+        ++epoch;
+        if (nparked.load() != 0)
         {
-            f = std::move(itmp->second.back());
-            itmp->second.pop_back();
-            --nelem;
-            return true;
+            std::lock_guard<std::mutex> lk(mtx);
+            cv.notify_all();
         };
-        for (itmp = mp.begin(); itmp != mp.end(); ++itmp)
+    };
+    //
+    //-----------------------------------------------------------------------
+    //  function : park
+    /// @brief block the thread until a work is inserted or finished, unless
+    ///        counter is zero, there are works to steal or the scheduler is
+    ///        cancelled
+    //-----------------------------------------------------------------------
+    void park(atomic_t &counter)
+    {
+        ++nparked;
+        const uint64_t old_epoch = epoch.load();
+        bool idle = counter.load() != 0 && !cancelled.load();
+        for (uint32_t i = 0; idle && i < size(); ++i)
+            idle = vdeque[i]->empty();
+        if (idle)
         {
-            if (itmp->second.empty()) continue;
-            f = std::move(itmp->second.back());
-            itmp->second.pop_back();
-            --nelem;
-            return true;
-        }
-        return false;
+            std::unique_lock<std::mutex> lk(mtx);
+            cv.wait(lk, [&] { return epoch.load() != old_epoch; });
+        };
+        --nparked;
     };
-};
-// end class scheduler
-//*************************************************************************
-//               P R I N T      F U N C T I O N S
-//************************************************************************
-template<class ... Args>
-std::ostream & operator <<(std::ostream &out, const std::deque<Args ...> & dq)
-{
-    for (uint32_t i = 0; i < dq.size(); ++i)
-        out << dq[i] << " ";
-    out << std::endl;
-    return out;
-}
-
-template<typename Func_t, typename Allocator = std::allocator<Func_t> >
-std::ostream & operator <<(std::ostream &out,
-                           const scheduler<Func_t, Allocator> &sch)
-{
-    std::unique_lock < spinlock_t > s(sch.spl);
-    out << "Nelem :" << sch.nelem << std::endl;
-    for (auto it = sch.mp.begin(); it != sch.mp.end(); ++it)
+    //
+    //-----------------------------------------------------------------------
+    //  function : wait_until
+    /// @brief back off, and then park, until done() is true. done must
+    ///        only change with a signal
+    //-----------------------------------------------------------------------
+    template<class Pred_t>
+    void wait_until(Pred_t done)
     {
-        out << it->first << "  :" << it->second << std::endl;
+        backoff boff;
+        while (!done())
+        {
+            if (!boff.exhausted())
+            {
+                boff.pause();
+                continue;
+            };
+            ++nparked;
+            const uint64_t old_epoch = epoch.load();
+            if (!done())
+            {
+                std::unique_lock<std::mutex> lk(mtx);
+                cv.wait(lk, [&] { return epoch.load() != old_epoch; });
+            };
+            --nparked;
+            boff.reset();
+        };
     }
-    return out;
-}
-
+};
+//
 //***************************************************************************
-};// end namespace common
-};// end namespace sort
-};// end namespace boost
+} // end namespace common
+} // end namespace sort
+} // end namespace boost
 //***************************************************************************
 #endif
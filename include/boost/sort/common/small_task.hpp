@@ -0,0 +1,121 @@
+//----------------------------------------------------------------------------
+/// @file small_task.hpp
+/// @brief This file contains the class small_task, a callable object without
+///        arguments, which stores the functions up to a size inside it
+///
+/// @author Copyright (c) 2016 Francisco Jose Tapia (fjtapia@gmail.com )\n
+///         Distributed under the Boost Software License, Version 1.0.\n
+///         ( See accompanying file LICENSE_1_0.txt or copy at
+///           http://www.boost.org/LICENSE_1_0.txt  )
+/// @version 0.1
+///
+/// @remarks
+//-----------------------------------------------------------------------------
+#ifndef __BOOST_SORT_COMMON_SMALL_TASK_HPP
+#define __BOOST_SORT_COMMON_SMALL_TASK_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace boost
+{
+namespace sort
+{
+namespace common
+{
+//
+//---------------------------------------------------------------------------
+/// @class small_task
+/// @brief This class stores a function without arguments, as
+///        std::function<void(void)>, but inside a buffer of Size bytes when
+///        the function fits, which is the case of the lambdas of the
+///        parallel algorithms. Larger functions are allocated apart.
+/// @remarks The objects can't be copied or moved. They are allocated once,
+///          by the thread which creates the work, and destroyed by the
+///          thread which runs it
+//---------------------------------------------------------------------------
+template<uint32_t Size = 64>
+class small_task
+{
+    //------------------------------------------------------------------------
+    //                      V A R I A B L E S
+    //------------------------------------------------------------------------
+    typename std::aligned_storage<Size, alignof(std::max_align_t)>::type data;
+    void (*pcall)(void *);
+    void (*pdestroy)(void *);
+
+    //------------------------------------------------------------------------
+    //  function : fit
+    /// @brief true if a Func_t can be stored inside data
+    //------------------------------------------------------------------------
+    template<class Func_t>
+    struct fit
+    {
+        static constexpr bool value = sizeof(Func_t) <= Size &&
+                        alignof(Func_t) <= alignof(std::max_align_t);
+    };
+
+    template<class Func_t>
+    static void call_inside(void *p) { (*static_cast<Func_t *>(p))(); }
+
+    template<class Func_t>
+    static void destroy_inside(void *p) { static_cast<Func_t *>(p)->~Func_t(); }
+
+    template<class Func_t>
+    static void call_apart(void *p) { (**static_cast<Func_t **>(p))(); }
+
+    template<class Func_t>
+    static void destroy_apart(void *p) { delete *static_cast<Func_t **>(p); }
+
+    template<class Func_t>
+    void construct(Func_t &&func, std::true_type)
+    {
+        typedef typename std::decay<Func_t>::type func_t;
+        ::new (static_cast<void *>(&data)) func_t(std::forward<Func_t>(func));
+        pcall = &call_inside<func_t>;
+        pdestroy = &destroy_inside<func_t>;
+    }
+
+    template<class Func_t>
+    void construct(Func_t &&func, std::false_type)
+    {
+        typedef typename std::decay<Func_t>::type func_t;
+        func_t *pfunc = new func_t(std::forward<Func_t>(func));
+        ::new (static_cast<void *>(&data)) func_t *(pfunc);
+        pcall = &call_apart<func_t>;
+        pdestroy = &destroy_apart<func_t>;
+    }
+
+  public:
+    //
+    //------------------------------------------------------------------------
+    //  function : small_task
+    /// @brief constructor of the class
+    /// @param func : function to store, called without arguments
+    //------------------------------------------------------------------------
+    template<class Func_t>
+    explicit small_task(Func_t &&func)
+    {
+        typedef typename std::decay<Func_t>::type func_t;
+        construct(std::forward<Func_t>(func),
+                  std::integral_constant<bool, fit<func_t>::value>());
+    }
+
+    small_task(const small_task &) = delete;
+    small_task & operator=(const small_task &) = delete;
+
+    ~small_task(void) { pdestroy(&data); }
+
+    void operator()(void) { pcall(&data); }
+};
+//
+//****************************************************************************
+} //    End namespace common
+} //    End namespace sort
+} //    End namespace boost
+//****************************************************************************
+//
+#endif
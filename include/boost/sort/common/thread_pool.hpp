@@ -0,0 +1,321 @@
+//----------------------------------------------------------------------------
+/// @file thread_pool.hpp
+/// @brief This file contains the thread_pool class, a set of worker threads
+///        parked between calls, and run_threads, which launches the threads
+///        of the parallel algorithms on the installed pool, if any
+///
+/// @author Copyright (c) 2016 Francisco Jose Tapia (fjtapia@gmail.com )\n
+///         Distributed under the Boost Software License, Version 1.0.\n
+///         ( See accompanying file LICENSE_1_0.txt or copy at
+///           http://www.boost.org/LICENSE_1_0.txt  )
+/// @version 0.1
+///
+/// @remarks
+//-----------------------------------------------------------------------------
+#ifndef __BOOST_SORT_COMMON_THREAD_POOL_HPP
+#define __BOOST_SORT_COMMON_THREAD_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace boost
+{
+namespace sort
+{
+namespace common
+{
+//
+//---------------------------------------------------------------------------
+/// @class thread_pool
+/// @brief Set of worker threads which stay parked between the calls of the
+///        parallel algorithms, avoiding the creation and destruction of the
+///        threads in each call.
+///
+/// @remarks An idle worker spins spin_count times, yielding the processor,
+///          before blocking in a condition variable. Each call to execute
+///          is a batch of tasks. The calling thread runs the tasks of its
+///          batch not taken by the workers, so a batch always finishes, even
+///          if all the workers are busy or the call is done from inside a
+///          task. Several threads can use the same pool at the same time.
+//---------------------------------------------------------------------------
+class thread_pool
+{
+  public:
+    //-----------------------------------------------------------------------
+    //                     D E F I N I T I O N S
+    //-----------------------------------------------------------------------
+    typedef std::function<void(uint32_t)> function_t;
+    typedef std::unique_lock<std::mutex> lock_t;
+
+    // Number of spins of an idle worker before blocking
+    static constexpr uint32_t default_spin_count = 4096;
+
+  private:
+    //-----------------------------------------------------------------------
+    //                     V A R I A B L E S
+    //-----------------------------------------------------------------------
+    // Tasks of one call to execute. The claimed and error fields are
+    // protected by the mutex of the pool
+    struct batch_t
+    {
+        function_t func;
+        uint32_t ntask;
+        uint32_t claimed;
+        std::atomic<uint32_t> done;
+        std::exception_ptr error;
+
+        batch_t(function_t f, uint32_t n)
+        : func(f), ntask(n), claimed(0), done(0) { };
+    };
+
+    std::vector<std::thread> vthread;
+    // batches with tasks not claimed yet
+    std::deque<batch_t *> dbatch;
+    std::atomic<uint32_t> nbatch;
+    std::atomic<bool> stop;
+    uint32_t nspin;
+    std::mutex mtx;
+    std::condition_variable cv_work, cv_done;
+
+  public:
+    //
+    //-----------------------------------------------------------------------
+    //  function : thread_pool
+    /// @brief constructor of the class, which launches the workers
+    /// @param nthread : number of worker threads
+    /// @param spin_count : number of spins of an idle worker before blocking
+    //-----------------------------------------------------------------------
+    explicit thread_pool(uint32_t nthread = std::thread::hardware_concurrency(),
+                         uint32_t spin_count = default_spin_count)
+    : nbatch(0), stop(false), nspin(spin_count)
+    {
+        vthread.reserve(nthread);
+        for (uint32_t i = 0; i < nthread; ++i)
+            vthread.emplace_back(&thread_pool::worker, this);
+    };
+
+    thread_pool(const thread_pool &) = delete;
+    thread_pool & operator=(const thread_pool &) = delete;
+    //
+    //-----------------------------------------------------------------------
+    //  function : ~thread_pool
+    /// @brief destructor of the class. Uninstalls the pool if it is the
+    ///        installed one, and joins the workers
+    //-----------------------------------------------------------------------
+    ~thread_pool(void)
+    {
+        thread_pool *self = this;
+        installed().compare_exchange_strong(self, nullptr);
+        {
+            lock_t lk(mtx);
+            stop = true;
+        }
+        cv_work.notify_all();
+        for (std::thread &t : vthread) t.join();
+    };
+    //
+    //-----------------------------------------------------------------------
+    //  function : size
+    /// @brief number of worker threads of the pool
+    //-----------------------------------------------------------------------
+    uint32_t size(void) const { return uint32_t(vthread.size()); };
+    //
+    //-----------------------------------------------------------------------
+    //  function : spin_count
+    /// @brief number of spins of an idle worker before blocking
+    //-----------------------------------------------------------------------
+    uint32_t spin_count(void) const { return nspin; };
+    //
+    //-----------------------------------------------------------------------
+    //  function : execute
+    /// @brief runs func(i) for each i in [0, ntask), in the workers and in
+    ///        the calling thread, and returns when all are finished. If a
+    ///        task throws, the first exception is rethrown here.
+    /// @param ntask : number of tasks
+    /// @param func : function to run in each task
+    /// @remarks The tasks must not wait for one another, as they can be run
+    ///          one after another in the same thread
+    //-----------------------------------------------------------------------
+    void execute(uint32_t ntask, function_t func)
+    {
+        if (ntask == 0) return;
+        batch_t bt(func, ntask);
+        {
+            lock_t lk(mtx);
+            dbatch.push_back(&bt);
+            ++nbatch;
+        }
+        uint32_t nwake = std::min(ntask - 1, size());
+        for (uint32_t i = 0; i < nwake; ++i) cv_work.notify_one();
+
+        uint32_t index = 0;
+        while (claim(bt, index)) run_task(bt, index);
+
+        for (uint32_t i = 0; i < nspin && bt.done.load() != ntask; ++i)
+            std::this_thread::yield();
+        {
+            lock_t lk(mtx);
+            cv_done.wait(lk, [&bt] { return bt.done.load() == bt.ntask; });
+        }
+        if (bt.error) std::rethrow_exception(bt.error);
+    };
+    //
+    //-----------------------------------------------------------------------
+    //  function : installed
+    /// @brief pool used by run_threads; nullptr if none is installed
+    //-----------------------------------------------------------------------
+    static std::atomic<thread_pool *> & installed(void)
+    {
+        static std::atomic<thread_pool *> pool(nullptr);
+        return pool;
+    };
+
+  private:
+    //
+    //-----------------------------------------------------------------------
+    //  function : claim
+    /// @brief claims the next task of the batch bt, for the calling thread
+    /// @return false if all the tasks of the batch are claimed
+    //-----------------------------------------------------------------------
+    bool claim(batch_t &bt, uint32_t &index)
+    {
+        lock_t lk(mtx);
+        if (bt.claimed == bt.ntask) return false;
+        index = bt.claimed++;
+        if (bt.claimed == bt.ntask)
+        {
+            dbatch.erase(std::find(dbatch.begin(), dbatch.end(), &bt));
+            --nbatch;
+        }
+        return true;
+    };
+    //
+    //-----------------------------------------------------------------------
+    //  function : run_task
+    /// @brief runs the task index of bt, and counts it as done. The batch
+    ///        can be destroyed by its caller as soon as the last task is done
+    //-----------------------------------------------------------------------
+    void run_task(batch_t &bt, uint32_t index)
+    {
+        std::exception_ptr error;
+        try
+        {
+            bt.func(index);
+        } catch (...)
+        {
+            error = std::current_exception();
+        }
+        lock_t lk(mtx);
+        if (error && !bt.error) bt.error = error;
+        if (++bt.done == bt.ntask) cv_done.notify_all();
+    };
+    //
+    //-----------------------------------------------------------------------
+    //  function : worker
+    /// @brief loop of the worker threads: spin, then block, until there is
+    ///        a task to run
+    //-----------------------------------------------------------------------
+    void worker(void)
+    {
+        while (true)
+        {
+            for (uint32_t i = 0; i < nspin && nbatch.load() == 0 &&
+                            !stop.load(); ++i)
+                std::this_thread::yield();
+
+            batch_t *pbt = nullptr;
+            uint32_t index = 0;
+            {
+                lock_t lk(mtx);
+                cv_work.wait(lk, [this] { return stop || !dbatch.empty(); });
+                if (dbatch.empty()) return;
+                pbt = dbatch.front();
+                index = pbt->claimed++;
+                if (pbt->claimed == pbt->ntask)
+                {
+                    dbatch.pop_front();
+                    --nbatch;
+                }
+            }
+            run_task(*pbt, index);
+        }
+    };
+};
+//
+//-----------------------------------------------------------------------------
+//  function : install_thread_pool
+/// @brief installs pool as the pool of all the parallel algorithms, or
+///        uninstalls the current one if pool is nullptr
+/// @return the pool installed before
+//-----------------------------------------------------------------------------
+inline thread_pool *install_thread_pool(thread_pool *pool)
+{
+    return thread_pool::installed().exchange(pool);
+}
+//
+//-----------------------------------------------------------------------------
+//  function : run_threads
+/// @brief runs func(i) for each i in [0, nthread), and returns when all are
+///        finished. If a task throws, the first exception is rethrown here.
+///        With an installed pool the tasks run in its workers; otherwise each
+///        task but the first, run by the calling thread, has its own thread.
+/// @param nthread : number of tasks
+/// @param func : function to run in each task
+//-----------------------------------------------------------------------------
+template<class Func>
+inline void run_threads(uint32_t nthread, Func func)
+{
+    if (nthread == 0) return;
+    thread_pool *pool = thread_pool::installed().load();
+    if (pool != nullptr)
+    {
+        pool->execute(nthread, func);
+        return;
+    }
+    std::vector<std::future<void> > vfuture;
+    vfuture.reserve(nthread - 1);
+    for (uint32_t i = 1; i < nthread; ++i)
+        vfuture.push_back(std::async(std::launch::async, func, i));
+    std::exception_ptr error;
+    try
+    {
+        func(0u);
+    } catch (...)
+    {
+        error = std::current_exception();
+    }
+    for (size_t i = 0; i < vfuture.size(); ++i)
+    {
+        try
+        {
+            vfuture[i].get();
+        } catch (...)
+        {
+            if (!error) error = std::current_exception();
+        }
+    }
+    if (error) std::rethrow_exception(error);
+}
+//
+//****************************************************************************
+}//    End namespace common
+//****************************************************************************
+//
+using common::thread_pool;
+using common::install_thread_pool;
+//
+//****************************************************************************
+}//    End namespace sort
+}//    End namespace boost
+//****************************************************************************
+//
+#endif
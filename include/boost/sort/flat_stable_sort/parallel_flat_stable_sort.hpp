@@ -0,0 +1,728 @@
+//----------------------------------------------------------------------------
+/// @file parallel_flat_stable_sort.hpp
+/// @brief Parallel flat stable sort algorithm, with the additional memory of
+///        the index of the blocks and a circular buffer for each thread
+///
+/// @author Copyright (c) 2017 Francisco José Tapia (fjtapia@gmail.com )\n
+///         Distributed under the Boost Software License, Version 1.0.\n
+///         ( See accompanying file LICENSE_1_0.txt or copy at
+///           http://www.boost.org/LICENSE_1_0.txt  )
+/// @version 0.1
+///
+/// @remarks
+//-----------------------------------------------------------------------------
+#ifndef __BOOST_SORT_PARALLEL_FLAT_STABLE_SORT_HPP
+#define __BOOST_SORT_PARALLEL_FLAT_STABLE_SORT_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <boost/sort/flat_stable_sort/flat_stable_sort.hpp>
+#include <boost/sort/common/merge_block.hpp>
+#include <boost/sort/common/presorted.hpp>
+#include <boost/sort/common/thread_pool.hpp>
+#include <boost/sort/common/util/algorithm.hpp>
+#include <boost/sort/common/util/traits.hpp>
+
+namespace boost
+{
+namespace sort
+{
+namespace flat_internal
+{
+namespace bsc = boost::sort::common;
+namespace bscu = boost::sort::common::util;
+//---------------------------------------------------------------------------
+/// @class parallel_flat_stable_sort
+/// @brief This class implement a parallel stable sort algorithm with the
+///        blocks and the index of flat_stable_sort.
+///
+/// @remarks Each thread sorts with flat_stable_sort a run of contiguous
+///          blocks. The runs are merged by pairs, and each merge is split
+///          at multiples of the block size of the output between the
+///          threads, which write the blocks released by the elements merged,
+///          as merge_range_pos. Finally the blocks are moved to the position
+///          of the index, with the cycles of the permutation split between
+///          the threads. The additional memory is the index, and a circular
+///          buffer of two blocks for each thread.
+//----------------------------------------------------------------------------
+template <class Iter_t, typename Compare, uint32_t Power2>
+class parallel_flat_stable_sort: public bsc::merge_block<Iter_t, Compare,
+                                                         Power2>
+{
+    //-------------------------------------------------------------------------
+    //                  D E F I N I T I O N S
+    //-------------------------------------------------------------------------
+    typedef bsc::merge_block<Iter_t, Compare, Power2> merge_block_t;
+    typedef typename merge_block_t::value_t value_t;
+    typedef typename merge_block_t::range_it range_it;
+    typedef typename merge_block_t::circular_t circular_t;
+
+    using merge_block_t::BLOCK_SIZE;
+    using merge_block_t::LOG_BLOCK;
+
+    using merge_block_t::global_range;
+    using merge_block_t::index;
+    using merge_block_t::nblock;
+    using merge_block_t::ntail;
+    using merge_block_t::cmp;
+    using merge_block_t::ptr_circ;
+
+    using merge_block_t::get_range;
+    using merge_block_t::get_group_range;
+    using merge_block_t::is_tail;
+
+    //------------------------------------------------------------------------
+    //                          CONSTANTS
+    //------------------------------------------------------------------------
+    // Minimal number of blocks sorted, merged or moved by each thread
+    static constexpr size_t min_block_thread = 32;
+
+    //------------------------------------------------------------------------
+    /// @struct part_t
+    /// @brief part of the merge of the runs of the positions [first, mid)
+    ///        and [mid, last) of the index, done by one thread. Merges the
+    ///        elements [a1, a2) of the first run with the elements [b1, b2)
+    ///        of the second, and a1 + b1 is a multiple of the block size
+    //------------------------------------------------------------------------
+    struct part_t
+    {
+        size_t first, mid, last;
+        size_t a1, a2, b1, b2;
+    };
+
+    //------------------------------------------------------------------------
+    /// @struct segment_t
+    /// @brief elements of a run, merged by a part, which are in one block.
+    ///        The blocks where two parts meet have a segment of each run,
+    ///        and nshared counts the segments of the block not merged yet
+    //------------------------------------------------------------------------
+    struct segment_t
+    {
+        Iter_t first, last;
+        size_t block;
+        uint32_t *nshared;
+    };
+
+    //------------------------------------------------------------------------
+    //                V A R I A B L E S
+    //------------------------------------------------------------------------
+    uint32_t nthread;
+
+    // circular buffers of the threads. The first is ptr_circ
+    std::vector<std::unique_ptr<circular_t> > vcirc;
+
+    // copy of the index at the beginning of a level of merges
+    std::vector<size_t> index_run;
+
+public:
+    //------------------------------------------------------------------------
+    //                   PUBLIC FUNCTIONS
+    //-------------------------------------------------------------------------
+    parallel_flat_stable_sort(Iter_t first, Iter_t last, Compare comp,
+                              uint32_t nthread);
+
+private:
+    circular_t & circ(uint32_t i)
+    {
+        return (i == 0) ? *ptr_circ : *vcirc[i - 1];
+    };
+    //
+    //------------------------------------------------------------------------
+    //  function : element
+    /// @brief iterator to the element k of the run which begins in the
+    ///        position pos of index_run
+    //------------------------------------------------------------------------
+    Iter_t element(size_t pos, size_t k) const
+    {
+        size_t block = index_run[pos + (k >> LOG_BLOCK)];
+        return global_range.first + ((block << LOG_BLOCK) +
+                                     (k & (BLOCK_SIZE - 1)));
+    };
+    //
+    //------------------------------------------------------------------------
+    //  function : run_size
+    /// @brief number of elements of the run of the positions [pos1, pos2)
+    ///        of the index. Only the last run can have the tail
+    //------------------------------------------------------------------------
+    size_t run_size(size_t pos1, size_t pos2) const
+    {
+        size_t nelem = (pos2 - pos1) << LOG_BLOCK;
+        return (pos2 == nblock && ntail != 0) ?
+                        nelem - (BLOCK_SIZE - ntail) : nelem;
+    };
+
+    size_t co_rank(size_t first, size_t mid, size_t last, size_t k) const;
+
+    void split_merge(size_t first, size_t mid, size_t last, size_t npart,
+                     std::vector<part_t> &vpart);
+
+    void merge_level(std::vector<size_t> &vlimit);
+
+    void merge_part(const part_t &pt, circular_t &cbuf);
+
+    void rearrange(void);
+};
+//----------------------------------------------------------------------------
+//  End of class parallel_flat_stable_sort
+//----------------------------------------------------------------------------
+//
+//------------------------------------------------------------------------
+//  @fn parallel_flat_stable_sort
+/// @brief constructor of the class, which sorts the elements
+/// @param first : iterator to the first element of the range to sort
+/// @param last : iterator after the last element to the range to sort
+/// @param comp : object for to compare two elements pointed by Iter_t
+///               iterators
+/// @param nthr : number of threads to use. When this value is lower than 2,
+///               or the range is small, the sorting is done with 1 thread
+//------------------------------------------------------------------------
+template <class Iter_t, typename Compare, uint32_t Power2>
+parallel_flat_stable_sort <Iter_t, Compare, Power2>
+::parallel_flat_stable_sort(Iter_t first, Iter_t last, Compare comp,
+                            uint32_t nthr)
+                : merge_block_t(first, last, comp, nullptr), nthread(nthr)
+{
+    assert ((last - first) >= 0);
+    if ((last - first) < 2) return;
+
+    size_t nrun = nblock / min_block_thread;
+    if (nrun > nthread) nrun = nthread;
+    if (nrun < 2)
+    {
+        flat_stable_sort<Iter_t, Compare, Power2>(first, last, cmp, ptr_circ);
+        return;
+    };
+
+    //------------- check if sort or reverse sort ----------------------------
+    uint32_t presort = bsc::presorted(first, last, cmp, true, nthread);
+    if (! (presort & bsc::scan_unsorted)) return;
+    if (! (presort & bsc::scan_unreversed))
+    {
+        bsc::parallel_reverse(first, last, nthread);
+        return;
+    };
+
+    nthread = uint32_t(nrun);
+    for (uint32_t i = 1; i < nthread; ++i)
+    {
+        vcirc.emplace_back(new circular_t);
+        vcirc.back()->initialize(*first);
+    };
+
+    //------------------------------------------------------------------------
+    // Each thread sorts a run of contiguous blocks, the last with the tail
+    //------------------------------------------------------------------------
+    std::vector<size_t> vlimit(nrun + 1);
+    for (size_t i = 0; i <= nrun; ++i)
+        vlimit[i] = (i * nblock) / nrun;
+
+    bsc::run_threads(nthread, [&](uint32_t i)
+    {
+        range_it rng = get_group_range(vlimit[i], vlimit[i + 1] - vlimit[i]);
+        flat_stable_sort<Iter_t, Compare, Power2>(rng.first, rng.last, cmp,
+                                                  &circ(i));
+    });
+
+    while (vlimit.size() > 2) merge_level(vlimit);
+    rearrange();
+}
+//
+//------------------------------------------------------------------------
+//  @fn co_rank
+/// @brief number of elements of the run [first, mid) of the index which are
+///        in the first k elements of its stable merge with the run
+///        [mid, last)
+//------------------------------------------------------------------------
+template <class Iter_t, typename Compare, uint32_t Power2>
+size_t parallel_flat_stable_sort <Iter_t, Compare, Power2>
+::co_rank(size_t first, size_t mid, size_t last, size_t k) const
+{
+    size_t nelemA = (mid - first) << LOG_BLOCK;
+    size_t nelemB = run_size(mid, last);
+    assert(k <= nelemA + nelemB);
+    size_t low = (k > nelemB) ? k - nelemB : 0;
+    size_t high = (k < nelemA) ? k : nelemA;
+
+    while (low < high)
+    {
+        size_t pos = low + ((high - low) >> 1);
+        if (! cmp(*element(mid, k - pos - 1), *element(first, pos)))
+            low = pos + 1;
+        else
+            high = pos;
+    };
+    return low;
+}
+//
+//------------------------------------------------------------------------
+//  @fn split_merge
+/// @brief split the merge of the runs [first, mid) and [mid, last) of the
+///        index in npart parts, appended to vpart.
+/// @remarks The limit between two parts is a multiple of the block size of
+///          the output, so the elements before it of the block of each run
+///          where it is, fill a block. They are swapped with the elements
+///          after it of the block of the first run, which becomes the last
+///          block of the first part, and the other block the first of the
+///          second part. A limit which would share a block with the previous
+///          one is skipped.
+//------------------------------------------------------------------------
+template <class Iter_t, typename Compare, uint32_t Power2>
+void parallel_flat_stable_sort <Iter_t, Compare, Power2>
+::split_merge(size_t first, size_t mid, size_t last, size_t npart,
+              std::vector<part_t> &vpart)
+{
+    const size_t mask = BLOCK_SIZE - 1;
+    size_t nelemA = (mid - first) << LOG_BLOCK;
+    size_t nelemB = run_size(mid, last);
+    size_t nfull = (nelemA + nelemB) >> LOG_BLOCK;
+    if (npart > nfull / min_block_thread) npart = nfull / min_block_thread;
+
+    size_t npart_ini = vpart.size();
+    part_t pt = { first, mid, last, 0, 0, 0, 0 };
+    for (size_t j = 1; j < npart; ++j)
+    {
+        size_t k = ((j * nfull) / npart) << LOG_BLOCK;
+        size_t a = co_rank(first, mid, last, k), b = k - a;
+        if ((a & mask) != 0 && (pt.a1 & mask) != 0 &&
+            ((a >> LOG_BLOCK) == (pt.a1 >> LOG_BLOCK) ||
+             (b >> LOG_BLOCK) == (pt.b1 >> LOG_BLOCK))) continue;
+
+        pt.a2 = a;
+        pt.b2 = b;
+        vpart.push_back(pt);
+        pt.a1 = a;
+        pt.b1 = b;
+    };
+    pt.a2 = nelemA;
+    pt.b2 = nelemB;
+    vpart.push_back(pt);
+
+    // The swaps are done after the co_rank of all the limits
+    for (size_t i = npart_ini + 1; i < vpart.size(); ++i)
+    {
+        size_t a = vpart[i].a1, b = vpart[i].b1, nswap = (b & mask);
+        if (nswap == 0) continue;
+        Iter_t itA = element(first, a);
+        Iter_t itB = element(mid, b - nswap);
+        std::swap_ranges(itA, itA + nswap, itB);
+    };
+}
+//
+//------------------------------------------------------------------------
+//  @fn merge_level
+/// @brief merge by pairs the runs of the index, delimited by vlimit, with
+///        the merges split between the threads. vlimit is updated with the
+///        runs merged
+//------------------------------------------------------------------------
+template <class Iter_t, typename Compare, uint32_t Power2>
+void parallel_flat_stable_sort <Iter_t, Compare, Power2>
+::merge_level(std::vector<size_t> &vlimit)
+{
+    index_run = index;
+    size_t nrun = vlimit.size() - 1, npair = nrun >> 1;
+    std::vector<part_t> vpart;
+    vpart.reserve(nthread);
+    for (size_t i = 0; i + 1 < nrun; i += 2)
+        split_merge(vlimit[i], vlimit[i + 1], vlimit[i + 2], nthread / npair,
+                    vpart);
+
+    bsc::run_threads(uint32_t(vpart.size()), [&](uint32_t i)
+    {
+        merge_part(vpart[i], circ(i));
+    });
+
+    std::vector<size_t> vnew;
+    for (size_t i = 0; i < vlimit.size(); i += 2)
+        vnew.push_back(vlimit[i]);
+    if (vnew.back() != vlimit.back()) vnew.push_back(vlimit.back());
+    vlimit.swap(vnew);
+}
+//
+//------------------------------------------------------------------------
+//  @fn merge_part
+/// @brief merge the elements of a part, through the circular buffer cbuf,
+///        writing the full blocks in the blocks released, and their
+///        positions in the index
+/// @remarks The elements in the buffer are always less than two blocks.
+///          They are the elements taken from the blocks not released, and
+///          at most two blocks have elements taken and are not released:
+///          the blocks where are the next elements of each run. The tail is
+///          not released, and receives the last elements of the merge.
+//------------------------------------------------------------------------
+template <class Iter_t, typename Compare, uint32_t Power2>
+void parallel_flat_stable_sort <Iter_t, Compare, Power2>
+::merge_part(const part_t &pt, circular_t &cbuf)
+{
+    const size_t mask = BLOCK_SIZE - 1;
+    uint32_t nshared_first = 0, nshared_last = 0;
+    std::vector<segment_t> vsegA, vsegB;
+    size_t nblockA = (pt.a2 >> LOG_BLOCK) - ((pt.a1 + mask) >> LOG_BLOCK);
+    size_t nblockB = (pt.b2 >> LOG_BLOCK) - ((pt.b1 + mask) >> LOG_BLOCK);
+    vsegA.reserve(nblockA + 2);
+    vsegB.reserve(nblockB + 3);
+
+    //------------------------------------------------------------------------
+    // The first block is the block of the second run where the part begins,
+    // with the elements of the first run swapped in split_merge
+    //------------------------------------------------------------------------
+    if ((pt.a1 & mask) != 0)
+    {
+        size_t nelem = BLOCK_SIZE - (pt.a1 & mask);
+        size_t block = index_run[pt.mid + (pt.b1 >> LOG_BLOCK)];
+        range_it rng = get_range(block);
+        vsegA.push_back({ rng.first, rng.first + nelem, block,
+                          &nshared_first });
+        ++nshared_first;
+        if (rng.size() > nelem)
+        {
+            vsegB.push_back({ rng.first + nelem, rng.last, block,
+                              &nshared_first });
+            ++nshared_first;
+        };
+    };
+
+    //------------------------------------------------------------------------
+    // The full blocks of the part. The last part has all the blocks until
+    // the end of the second run, with the tail, if any
+    //------------------------------------------------------------------------
+    for (size_t i = (pt.a1 + mask) >> LOG_BLOCK; i < (pt.a2 >> LOG_BLOCK); ++i)
+    {
+        range_it rng = get_range(index_run[pt.first + i]);
+        vsegA.push_back({ rng.first, rng.last, index_run[pt.first + i],
+                          nullptr });
+    };
+    bool last_part = (pt.a2 == ((pt.mid - pt.first) << LOG_BLOCK) &&
+                      pt.b2 == run_size(pt.mid, pt.last));
+    size_t endB = last_part ? (pt.last - pt.mid) : (pt.b2 >> LOG_BLOCK);
+    for (size_t i = (pt.b1 + mask) >> LOG_BLOCK; i < endB; ++i)
+    {
+        range_it rng = get_range(index_run[pt.mid + i]);
+        vsegB.push_back({ rng.first, rng.last, index_run[pt.mid + i],
+                          nullptr });
+    };
+
+    //------------------------------------------------------------------------
+    // The last block is the block of the first run where the part ends,
+    // with the elements of the second run swapped in split_merge
+    //------------------------------------------------------------------------
+    if ((pt.a2 & mask) != 0)
+    {
+        size_t nelem = pt.a2 & mask;
+        size_t block = index_run[pt.first + (pt.a2 >> LOG_BLOCK)];
+        range_it rng = get_range(block);
+        vsegA.push_back({ rng.first, rng.first + nelem, block,
+                          &nshared_last });
+        vsegB.push_back({ rng.first + nelem, rng.last, block,
+                          &nshared_last });
+        nshared_last = 2;
+    };
+
+    //------------------------------------------------------------------------
+    // The blocks released receive the elements merged, in the order of the
+    // positions of the index
+    //------------------------------------------------------------------------
+    std::vector<size_t> vfree;
+    vfree.reserve(nblockA + nblockB + 2);
+    size_t nused = 0, pos_out = pt.first + ((pt.a1 + pt.b1) >> LOG_BLOCK);
+
+    auto release = [&](const segment_t &sg)
+    {
+        if (sg.nshared != nullptr && --(*sg.nshared) != 0) return;
+        if (! is_tail(sg.block)) vfree.push_back(sg.block);
+    };
+    auto flush = [&]( )
+    {
+        while (cbuf.size() >= BLOCK_SIZE && nused != vfree.size())
+        {
+            size_t block = vfree[nused++];
+            cbuf.pop_move_front(get_range(block).first, BLOCK_SIZE);
+            index[pos_out++] = block;
+        };
+    };
+    // A full block not merged yet, whose elements go before the next
+    // element of the other run, doesn't need to be moved
+    auto pass_block = [&](const segment_t &sg, Iter_t it) -> bool
+    {
+        if (cbuf.size() != 0 || it != sg.first || sg.nshared != nullptr ||
+            is_tail(sg.block)) return false;
+        index[pos_out++] = sg.block;
+        return true;
+    };
+
+    cbuf.clear();
+    size_t ia = 0, ib = 0;
+    Iter_t itA = global_range.first, itB = global_range.first;
+    if (! vsegA.empty()) itA = vsegA[0].first;
+    if (! vsegB.empty()) itB = vsegB[0].first;
+
+    while (ia != vsegA.size() && ib != vsegB.size())
+    {
+        const segment_t &sgA = vsegA[ia], &sgB = vsegB[ib];
+        size_t nfree = cbuf.free_size();
+        assert(nfree != 0);
+        if (! cmp(*itB, *(sgA.last - 1)))
+        {
+            if (pass_block(sgA, itA)) itA = sgA.last;
+            else
+            {
+                size_t nmove = (std::min)(nfree, size_t(sgA.last - itA));
+                cbuf.push_move_back(itA, nmove);
+                itA += nmove;
+                if (itA == sgA.last) release(sgA);
+            };
+        }
+        else if (cmp(*(sgB.last - 1), *itA))
+        {
+            if (pass_block(sgB, itB)) itB = sgB.last;
+            else
+            {
+                size_t nmove = (std::min)(nfree, size_t(sgB.last - itB));
+                cbuf.push_move_back(itB, nmove);
+                itB += nmove;
+                if (itB == sgB.last) release(sgB);
+            };
+        }
+        else
+        {
+            for (; nfree != 0 && itA != sgA.last && itB != sgB.last; --nfree)
+            {
+                cbuf.push_back(cmp(*itB, *itA) ? std::move(*(itB++))
+                                               : std::move(*(itA++)));
+            };
+            if (itA == sgA.last) release(sgA);
+            if (itB == sgB.last) release(sgB);
+        };
+        if (itA == sgA.last && ++ia != vsegA.size()) itA = vsegA[ia].first;
+        if (itB == sgB.last && ++ib != vsegB.size()) itB = vsegB[ib].first;
+        flush();
+    };
+
+    //------------------------------------------------------------------------
+    // The rest of the run not finished
+    //------------------------------------------------------------------------
+    std::vector<segment_t> &vseg = (ia == vsegA.size()) ? vsegB : vsegA;
+    size_t iseg = (ia == vsegA.size()) ? ib : ia;
+    Iter_t it = (ia == vsegA.size()) ? itB : itA;
+    while (iseg != vseg.size())
+    {
+        const segment_t &sg = vseg[iseg];
+        if (! pass_block(sg, it))
+        {
+            size_t nfree = cbuf.free_size();
+            assert(nfree != 0);
+            size_t nmove = (std::min)(nfree, size_t(sg.last - it));
+            cbuf.push_move_back(it, nmove);
+            it += nmove;
+            if (it != sg.last)
+            {
+                flush();
+                continue;
+            };
+            release(sg);
+        };
+        if (++iseg != vseg.size()) it = vseg[iseg].first;
+        flush();
+    };
+
+    // The last elements of the last merge go to the tail
+    if (cbuf.size() != 0)
+    {
+        assert(cbuf.size() == ntail && pos_out == nblock - 1);
+        cbuf.pop_move_front(get_range(nblock - 1).first, ntail);
+        index[pos_out++] = nblock - 1;
+    };
+}
+//
+//------------------------------------------------------------------------
+//  @fn rearrange
+/// @brief rearrange the blocks with the positions of the index, as
+///        rearrange_with_index, with the cycles of the permutation split
+///        between the threads
+/// @remarks Each thread moves the blocks of a part of the list of the
+///          positions of the cycles. The cycles entirely in the part are
+///          moved with the second block of the circular buffer as
+///          auxiliary memory. The pieces of the other cycles are moved in
+///          three steps: the first block of each piece is saved in the
+///          circular buffer, the blocks of the piece are moved, and the
+///          last block of each piece receives the block saved by the
+///          next piece.
+//------------------------------------------------------------------------
+template <class Iter_t, typename Compare, uint32_t Power2>
+void parallel_flat_stable_sort <Iter_t, Compare, Power2>
+::rearrange(void)
+{
+    //------------------------------------------------------------------------
+    // The cycles, as lists of positions where each one receives the block
+    // of the next, and the last the block of the first
+    //------------------------------------------------------------------------
+    std::vector<size_t> vpos, vcycle;
+    vpos.reserve(nblock);
+    for (size_t i = 0; i < nblock; ++i)
+    {
+        if (index[i] == i) continue;
+        vcycle.push_back(vpos.size());
+        size_t pos = i;
+        do
+        {
+            vpos.push_back(pos);
+            size_t next = index[pos];
+            index[pos] = pos;
+            pos = next;
+        } while (pos != i);
+    };
+    vcycle.push_back(vpos.size());
+    if (vpos.empty()) return;
+
+    size_t npos = vpos.size();
+    size_t npiece = npos / min_block_thread;
+    if (npiece > nthread) npiece = nthread;
+    if (npiece == 0) npiece = 1;
+
+    auto piece_first = [&](size_t t) { return (t * npos) / npiece; };
+
+    // memory where the first block of the piece beginning in f is saved
+    auto saved = [&](size_t f) -> value_t *
+    {
+        size_t t = ((f + 1) * npiece - 1) / npos;
+        value_t *buf = circ(uint32_t(t)).get_buffer();
+        return (f == piece_first(t)) ? buf : buf + BLOCK_SIZE;
+    };
+    auto move_block = [&](size_t pos_dest, size_t pos_src)
+    {
+        range_it rng = get_range(pos_src);
+        bscu::move_forward(get_range(pos_dest).first, rng.first, rng.last);
+    };
+    // call func(f, g, cf, cg) for each piece [f, g) of the cycle [cf, cg)
+    // in the part t of the list
+    auto for_each_piece = [&](size_t t, std::function<void(size_t, size_t,
+                                                    size_t, size_t)> func)
+    {
+        size_t f = piece_first(t), last = piece_first(t + 1);
+        size_t c = size_t(std::upper_bound(vcycle.begin(), vcycle.end(), f)
+                          - vcycle.begin()) - 1;
+        for (; f < last; f = vcycle[++c])
+            func(f, (std::min)(last, vcycle[c + 1]), vcycle[c],
+                 vcycle[c + 1]);
+    };
+
+    //------------------------------------------------------------------------
+    // The cycles entirely in a part, and the saving of the first block of
+    // the pieces of the other cycles
+    //------------------------------------------------------------------------
+    bsc::run_threads(uint32_t(npiece), [&](uint32_t t)
+    {
+        for_each_piece(t, [&](size_t f, size_t g, size_t cf, size_t cg)
+        {
+            if (f != cf || g != cg)
+            {
+                range_it rng = get_range(vpos[f]);
+                bscu::move_forward(saved(f), rng.first, rng.last);
+                return;
+            };
+            value_t *aux = circ(t).get_buffer() + BLOCK_SIZE;
+            range_it rng = get_range(vpos[f]);
+            bscu::move_forward(aux, rng.first, rng.last);
+            for (size_t i = f; i + 1 < g; ++i)
+                move_block(vpos[i], vpos[i + 1]);
+            bscu::move_forward(get_range(vpos[g - 1]).first, aux,
+                               aux + BLOCK_SIZE);
+        });
+    });
+    if (npiece == 1) return;
+
+    //------------------------------------------------------------------------
+    // The blocks of the pieces, and the last block of each one
+    //------------------------------------------------------------------------
+    bsc::run_threads(uint32_t(npiece), [&](uint32_t t)
+    {
+        for_each_piece(t, [&](size_t f, size_t g, size_t cf, size_t cg)
+        {
+            if (f == cf && g == cg) return;
+            for (size_t i = f; i + 1 < g; ++i)
+                move_block(vpos[i], vpos[i + 1]);
+        });
+    });
+    bsc::run_threads(uint32_t(npiece), [&](uint32_t t)
+    {
+        for_each_piece(t, [&](size_t f, size_t g, size_t cf, size_t cg)
+        {
+            if (f == cf && g == cg) return;
+            value_t *aux = saved((g == cg) ? cf : g);
+            bscu::move_forward(get_range(vpos[g - 1]).first, aux,
+                               aux + BLOCK_SIZE);
+        });
+    });
+}
+//****************************************************************************
+}// End namespace flat_internal
+//****************************************************************************
+//
+namespace bscu = boost::sort::common::util;
+namespace flat = boost::sort::flat_internal;
+//
+///---------------------------------------------------------------------------
+//  @fn parallel_flat_stable_sort
+/// @brief parallel stable sort with the blocks of flat_stable_sort, whose
+///        size is selected depending of the type and size of the data to
+///        sort
+/// @param first : iterator to the first element of the range to sort
+/// @param last : iterator after the last element to the range to sort
+/// @param comp : object for to compare two elements pointed by Iter_t
+///               iterators
+/// @param nthread : Number of threads to use in the process. When this value
+///                  is lower than 2, the sorting is done with 1 thread
+//----------------------------------------------------------------------------
+template <class Iter_t, class Compare,
+          bscu::enable_if_string<value_iter<Iter_t> > * = nullptr>
+inline void parallel_flat_stable_sort (Iter_t first, Iter_t last,
+                                       Compare comp, uint32_t nthread)
+{
+    flat::parallel_flat_stable_sort<Iter_t, Compare, 6>
+        (first, last, comp, nthread);
+}
+
+template <class Iter_t, class Compare,
+          bscu::enable_if_not_string<value_iter<Iter_t> > * = nullptr>
+inline void parallel_flat_stable_sort (Iter_t first, Iter_t last,
+                                       Compare comp, uint32_t nthread)
+{
+    flat::parallel_flat_stable_sort<Iter_t, Compare,
+                            block_size_fss<sizeof(value_iter<Iter_t> )>::data>
+        (first, last, comp, nthread);
+}
+//
+///---------------------------------------------------------------------------
+//  @fn parallel_flat_stable_sort
+/// @brief parallel_flat_stable_sort with the number of threads of the
+///        machine, or the comparison object of the type, or both
+//----------------------------------------------------------------------------
+template <class Iter_t, class Compare = bscu::compare_iter<Iter_t>,
+          bscu::enable_if_not_integral<Compare> * = nullptr>
+inline void parallel_flat_stable_sort (Iter_t first, Iter_t last,
+                                       Compare comp = Compare())
+{
+    parallel_flat_stable_sort(first, last, comp,
+                              std::thread::hardware_concurrency());
+}
+
+template <class Iter_t>
+inline void parallel_flat_stable_sort (Iter_t first, Iter_t last,
+                                       uint32_t nthread)
+{
+    parallel_flat_stable_sort(first, last, bscu::compare_iter<Iter_t>(),
+                              nthread);
+}
+//
+//****************************************************************************
+}//    End namespace sort
+}//    End namepspace boost
+//****************************************************************************
+//
+#endif
@@ -0,0 +1,812 @@
+//----------------------------------------------------------------------------
+/// @file inplace_sample_sort.hpp
+/// @brief In place parallel super scalar sample sort. The elements are
+///        distributed in buckets by blocks, inside the data, and the
+///        additional memory is a few blocks for each bucket and thread
+///
+/// @author Copyright (c) 2017 Francisco José Tapia (fjtapia@gmail.com )\n
+///         Distributed under the Boost Software License, Version 1.0.\n
+///         ( See accompanying file LICENSE_1_0.txt or copy at
+///           http://www.boost.org/LICENSE_1_0.txt  )
+/// @version 0.1
+///
+/// @remarks
+//-----------------------------------------------------------------------------
+#ifndef __BOOST_SORT_PARALLEL_DETAIL_INPLACE_SAMPLE_SORT_HPP
+#define __BOOST_SORT_PARALLEL_DETAIL_INPLACE_SAMPLE_SORT_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <boost/sort/pdqsort/pdqsort.hpp>
+#include <boost/sort/common/presorted.hpp>
+#include <boost/sort/common/spinlock.hpp>
+#include <boost/sort/common/thread_pool.hpp>
+#include <boost/sort/common/util/algorithm.hpp>
+#include <boost/sort/common/util/traits.hpp>
+
+namespace boost
+{
+namespace sort
+{
+namespace inplace_detail
+{
+//---------------------------------------------------------------------------
+//                    USING SENTENCES
+//---------------------------------------------------------------------------
+namespace bsc = boost::sort::common;
+namespace bscu = boost::sort::common::util;
+using bscu::nbits64;
+//
+//---------------------------------------------------------------------------
+//                        C O N S T A N T S
+//---------------------------------------------------------------------------
+//
+/// Maximum of the logarithm of the number of splitters + 1
+static constexpr const uint32_t max_log_bucket = 8;
+
+/// Ranges of this size or smaller are sorted with pdqsort
+static constexpr const size_t max_base_case = 1 << 12;
+
+/// Number of elements classified together, for to overlap the searchs
+static constexpr const uint32_t nbatch = 16;
+//
+//---------------------------------------------------------------------------
+/// @struct block_size_ips
+/// @brief number of elements of the blocks moved in the distribution, for
+///        blocks of about 2 KB
+//---------------------------------------------------------------------------
+template<size_t Size>
+struct block_size_ips
+{
+    static constexpr const uint32_t data =
+                    (Size >= 2048) ? 1 : uint32_t(2048 / Size);
+};
+//
+//---------------------------------------------------------------------------
+//  function : log_bucket
+/// @brief logarithm of the number of buckets used for to split a range
+/// @param nelem : number of elements of the range
+//---------------------------------------------------------------------------
+inline uint32_t log_bucket(size_t nelem)
+{
+    uint32_t nbits = nbits64(nelem >> 11);
+    if (nbits < 2) return 2;
+    return (nbits > max_log_bucket) ? max_log_bucket : nbits;
+};
+//
+//---------------------------------------------------------------------------
+/// @class classifier
+/// @brief Search tree of the splitters, for to find the bucket of the
+///        elements without branches
+///
+/// @remarks The k - 1 splitters are in a complete binary tree stored as an
+///          array (tree[1] is the root, and the children of tree[i] are
+///          tree[2i] and tree[2i+1]), and the search of an element descends
+///          the log2(k) levels with i = 2i + comp(tree[i], x). When the
+///          sample has repeated splitters, each splitter has an additional
+///          bucket for the elements equal to it, which is not sorted again
+//---------------------------------------------------------------------------
+template<class Iter_t, class Compare>
+class classifier
+{
+    //------------------------------------------------------------------------
+    //                  D E F I N I T I O N S
+    //------------------------------------------------------------------------
+    typedef bscu::value_iter<Iter_t> value_t;
+
+    //------------------------------------------------------------------------
+    //                   V A R I A B L E S
+    //------------------------------------------------------------------------
+    std::vector<value_t> tree, splitter;
+    Compare cmp;
+
+  public:
+    uint32_t log_k, nbucket;
+    size_t k;
+    bool equal;
+
+    classifier(Compare comp) : cmp(comp), log_k(0), nbucket(0), k(0),
+                    equal(false) { };
+
+    void build(Iter_t sample, size_t step, uint32_t log_b);
+    //
+    //------------------------------------------------------------------------
+    //  function : bucket
+    /// @brief obtain the bucket of the element x
+    //------------------------------------------------------------------------
+    size_t bucket(const value_t &x) const
+    {
+        size_t i = 1;
+        for (uint32_t l = 0; l < log_k; ++l)
+            i = 2 * i + size_t(cmp(tree[i], x));
+        i -= k;
+        if (equal)
+            i = 2 * i + size_t((i + 1 < k) & !cmp(x, splitter[i]));
+        return i;
+    };
+    //
+    //------------------------------------------------------------------------
+    //  function : classify
+    /// @brief call to func(b, it) for each iterator it of [first, last), and
+    ///        its bucket b, in the order of the range
+    /// @remarks The elements are searched by groups of nbatch, level by
+    ///          level, for the processor overlaps the comparisons
+    //------------------------------------------------------------------------
+    template<class Func>
+    void classify(Iter_t first, Iter_t last, Func func) const
+    {
+        size_t vidx[nbatch];
+        while ((last - first) >= std::ptrdiff_t(nbatch))
+        {
+            for (uint32_t j = 0; j < nbatch; ++j) vidx[j] = 1;
+            for (uint32_t l = 0; l < log_k; ++l)
+            {
+                for (uint32_t j = 0; j < nbatch; ++j)
+                    vidx[j] = 2 * vidx[j] + size_t(cmp(tree[vidx[j]],
+                                                       first[j]));
+            };
+            for (uint32_t j = 0; j < nbatch; ++j)
+            {
+                size_t b = vidx[j] - k;
+                if (equal)
+                    b = 2 * b + size_t((b + 1 < k) &
+                                       !cmp(first[j], splitter[b]));
+                func(b, first + j);
+            };
+            first += nbatch;
+        };
+        for (; first != last; ++first) func(bucket(*first), first);
+    }
+
+  private:
+    void fill_tree(size_t node, size_t &pos);
+};
+//
+//-----------------------------------------------------------------------------
+//  function : build
+/// @brief select the splitters from the sorted sample, and build the tree
+///
+/// @param sample : iterator to the sorted sample
+/// @param step : distance between the splitters in the sample
+/// @param log_b : logarithm of the number of buckets, without repeated
+///                splitters
+//-----------------------------------------------------------------------------
+template<class Iter_t, class Compare>
+void classifier<Iter_t, Compare>::build(Iter_t sample, size_t step,
+                                        uint32_t log_b)
+{
+    size_t nsplit = (size_t(1) << log_b) - 1;
+    splitter.reserve(nsplit + 1);
+    for (size_t i = 1; i <= nsplit; ++i)
+    {
+        Iter_t it = sample + (i * step - 1);
+        if (splitter.empty() || cmp(splitter.back(), *it))
+            splitter.push_back(*it);
+        else
+            equal = true;
+    };
+
+    //------------------------------------------------------------------------
+    // With repeated splitters, the number of buckets is reduced to the
+    // power of two greater than the number of different splitters, and the
+    // tree is filled repeating the last one
+    //------------------------------------------------------------------------
+    log_k = (equal) ? nbits64(splitter.size()) : log_b;
+    k = size_t(1) << log_k;
+    nbucket = uint32_t((equal) ? 2 * k - 1 : k);
+    while (splitter.size() < k) splitter.push_back(splitter.back());
+
+    tree.assign(k, splitter[0]);
+    size_t pos = 0;
+    fill_tree(1, pos);
+};
+//
+//-----------------------------------------------------------------------------
+//  function : fill_tree
+/// @brief fill the subtree of node with the splitters from pos, in order
+//-----------------------------------------------------------------------------
+template<class Iter_t, class Compare>
+void classifier<Iter_t, Compare>::fill_tree(size_t node, size_t &pos)
+{
+    if (node >= k) return;
+    fill_tree(2 * node, pos);
+    tree[node] = splitter[pos++];
+    fill_tree(2 * node + 1, pos);
+};
+//
+//---------------------------------------------------------------------------
+/// @struct thread_buffer
+/// @brief Memory of a thread for the distribution : a block for each
+///        bucket, two blocks for to swap, and the overflow block
+///
+/// @remarks All the elements of the memory are constructed at the beginning
+///          moving the same value through them, and are moved by assignment
+///          as the elements of the range to sort
+//---------------------------------------------------------------------------
+template<uint32_t Block_size, class Iter_t>
+struct thread_buffer
+{
+    //------------------------------------------------------------------------
+    //                  D E F I N I T I O N S
+    //------------------------------------------------------------------------
+    typedef bscu::value_iter<Iter_t> value_t;
+
+    //------------------------------------------------------------------------
+    //                   V A R I A B L E S
+    //------------------------------------------------------------------------
+    value_t *ptr;
+    size_t nbucket_max, nelem;
+    std::vector<size_t> vcount; // elements in the block of each bucket
+    std::vector<size_t> vtotal; // elements of the stripe in each bucket
+
+    //
+    //------------------------------------------------------------------------
+    //  function : thread_buffer
+    /// @brief constructor of the class
+    /// @param nbucket : maximum number of buckets of the distributions
+    /// @param val : value used for to initialize the memory
+    //------------------------------------------------------------------------
+    thread_buffer(size_t nbucket, value_t &val)
+    : ptr(nullptr), nbucket_max(nbucket), nelem((nbucket + 3) * Block_size),
+      vcount(nbucket, 0), vtotal(nbucket, 0)
+    {
+        ptr = static_cast<value_t *>(std::malloc(nelem * sizeof(value_t)));
+        if (ptr == nullptr) throw std::bad_alloc();
+        bscu::initialize(ptr, ptr + nelem, val);
+    };
+    //
+    //------------------------------------------------------------------------
+    //  function : ~thread_buffer
+    /// @brief destructor of the class
+    //------------------------------------------------------------------------
+    ~thread_buffer(void)
+    {
+        bscu::destroy(ptr, ptr + nelem);
+        std::free(static_cast<void *>(ptr));
+    };
+
+    thread_buffer(const thread_buffer &) = delete;
+    thread_buffer & operator=(const thread_buffer &) = delete;
+
+    value_t *bucket(size_t b) { return ptr + b * Block_size; };
+    value_t *swap_block(uint32_t i)
+    {
+        return ptr + (nbucket_max + i) * Block_size;
+    };
+    value_t *overflow(void) { return swap_block(2); };
+};
+//
+///---------------------------------------------------------------------------
+/// @class inplace_sample_sort
+/// @brief This class implement an in place parallel sample sort, with the
+///        super scalar classification and the block distribution of IPS4o
+///
+/// @tparam Block_size : number of elements of the blocks of the distribution
+///
+/// @remarks Each step takes a random sample, sorted with pdqsort, from which
+///          are selected the splitters of up to 256 buckets. Then :
+///          1. Each thread classifies a stripe of the range, moving the
+///             elements to its block of the bucket, and when a block is full
+///             it is written at the beginning of the stripe.
+///          2. The full blocks of the area of each bucket, aligned with the
+///             blocks, are moved to the beginning of the area.
+///          3. The threads move the full blocks to the area of their bucket,
+///             swapping them with the blocks not processed yet.
+///          4. The parts of the buckets which are not whole blocks are
+///             filled with the blocks of the threads, and with the elements
+///             of the last block of the previous bucket which overflow it.
+///          The big buckets are split again with all the threads, and the
+///          others are sorted with only one thread each.
+//----------------------------------------------------------------------------
+template<uint32_t Block_size, class Iter_t, class Compare>
+class inplace_sample_sort
+{
+    //------------------------------------------------------------------------
+    //                  D E F I N I T I O N S
+    //------------------------------------------------------------------------
+    typedef bscu::value_iter<Iter_t> value_t;
+    typedef thread_buffer<Block_size, Iter_t> buffer_t;
+    typedef classifier<Iter_t, Compare> classifier_t;
+    typedef std::pair<Iter_t, size_t> task_t;
+
+    static constexpr const size_t BLOCK = Block_size;
+
+    //------------------------------------------------------------------------
+    //                   V A R I A B L E S
+    //------------------------------------------------------------------------
+    size_t nelem;
+    Compare cmp;
+    uint32_t nthread;
+    std::vector<std::unique_ptr<buffer_t> > vbuf;
+    std::vector<buffer_t *> vptr;
+    std::vector<task_t> vtask;
+
+  public:
+    inplace_sample_sort(Iter_t first, Iter_t last, Compare comp,
+                        uint32_t nthr);
+
+  private:
+    void sample(Iter_t first, size_t n, classifier_t &cl);
+
+    void partition(Iter_t first, size_t n, uint32_t nth,
+                   buffer_t *const *pbuf, classifier_t &cl,
+                   std::vector<size_t> &vlimit);
+
+    void parallel_sort(Iter_t first, size_t n, uint32_t level);
+
+    void sequential_sort(Iter_t first, size_t n, buffer_t *pb,
+                         uint32_t level);
+};
+//
+//****************************************************************************
+//                    M E M B E R   F U N C T I O N S
+//****************************************************************************
+//
+//-----------------------------------------------------------------------------
+//  function : inplace_sample_sort
+/// @brief constructor of the class, which sort the range
+///
+/// @param first : iterator to the first element of the range to sort
+/// @param last : iterator after the last element to the range to sort
+/// @param comp : object for to compare two elements pointed by Iter_t
+///               iterators
+/// @param nthr : Number of threads to use in the process. When this value
+///               is lower than 2, the sorting is done with 1 thread
+//-----------------------------------------------------------------------------
+template<uint32_t Block_size, class Iter_t, class Compare>
+inplace_sample_sort<Block_size, Iter_t, Compare>
+::inplace_sample_sort(Iter_t first, Iter_t last, Compare comp, uint32_t nthr)
+: nelem(0), cmp(comp), nthread(nthr)
+{
+    assert((last - first) >= 0);
+    nelem = size_t(last - first);
+    if (nelem < 2) return;
+    if (nthread < 2) nthread = 1;
+
+    //------------- check if sort or reverse sort -----------------------------
+    uint32_t presort = bsc::presorted(first, last, cmp, false, nthread);
+    if (! (presort & bsc::scan_unsorted)) return;
+    if (! (presort & bsc::scan_unreversed))
+    {
+        bsc::parallel_reverse(first, last, nthread);
+        return;
+    };
+    if (nelem <= max_base_case)
+    {
+        boost::sort::pdqsort(first, last, cmp);
+        return;
+    };
+
+    //------------------------------------------------------------------------
+    // Each thread needs ranges of several blocks in the distribution
+    //------------------------------------------------------------------------
+    size_t nthread_max = nelem / max_base_case;
+    if (nthread > nthread_max) nthread = uint32_t(nthread_max);
+
+    size_t nbucket_max = (size_t(2) << log_bucket(nelem)) - 1;
+    vbuf.reserve(nthread);
+    for (uint32_t i = 0; i < nthread; ++i)
+    {
+        vbuf.emplace_back(new buffer_t(nbucket_max, *first));
+        vptr.push_back(vbuf.back().get());
+    };
+
+    //------------------------------------------------------------------------
+    // The levels of recursion are limited, as in the introsort, and then the
+    // ranges are sorted with pdqsort
+    //------------------------------------------------------------------------
+    uint32_t level = nbits64(nelem);
+    if (nthread == 1)
+    {
+        sequential_sort(first, nelem, vptr[0], level);
+        return;
+    };
+    parallel_sort(first, nelem, level);
+
+    //------------------------------------------------------------------------
+    // The small buckets are sorted by the threads, the biggest first
+    //------------------------------------------------------------------------
+    std::sort(vtask.begin(), vtask.end(), [](const task_t &a, const task_t &b)
+    {
+        return a.second > b.second;
+    });
+    std::atomic<size_t> counter(0);
+    bsc::run_threads(nthread, [&](uint32_t i)
+    {
+        size_t ntask;
+        while ((ntask = counter++) < vtask.size())
+            sequential_sort(vtask[ntask].first, vtask[ntask].second, vptr[i],
+                            level);
+    });
+};
+//
+//-----------------------------------------------------------------------------
+//  function : sample
+/// @brief move a random sample to the beginning of the range, sort it, and
+///        build the classifier with it
+//-----------------------------------------------------------------------------
+template<uint32_t Block_size, class Iter_t, class Compare>
+void inplace_sample_sort<Block_size, Iter_t, Compare>
+::sample(Iter_t first, size_t n, classifier_t &cl)
+{
+    uint32_t log_b = log_bucket(n);
+    size_t step = nbits64(n) / 5;
+    if (step == 0) step = 1;
+    size_t nsample = (step << log_b) - 1;
+
+    uint64_t seed = uint64_t(n) * 0x9E3779B97F4A7C15ULL + 1;
+    for (size_t i = 0; i < nsample; ++i)
+    {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        std::swap(first[i], first[i + size_t(seed % (n - i))]);
+    };
+    boost::sort::pdqsort(first, first + nsample, cmp);
+    cl.build(first, step, log_b);
+};
+//
+//-----------------------------------------------------------------------------
+//  function : partition
+/// @brief distribute the elements of a range in buckets
+///
+/// @param first : iterator to the first element of the range
+/// @param n : number of elements of the range
+/// @param nth : number of threads
+/// @param pbuf : memory of each thread
+/// @param cl : classifier, built by this function
+/// @param vlimit : position of the first element of each bucket, and the
+///                 size of the range at the end
+//-----------------------------------------------------------------------------
+template<uint32_t Block_size, class Iter_t, class Compare>
+void inplace_sample_sort<Block_size, Iter_t, Compare>
+::partition(Iter_t first, size_t n, uint32_t nth, buffer_t *const *pbuf,
+            classifier_t &cl, std::vector<size_t> &vlimit)
+{
+    sample(first, n, cl);
+    const size_t nbucket = cl.nbucket;
+    const size_t nblock = n / BLOCK;
+    if (nth > nblock) nth = uint32_t(nblock);
+
+    //------------------------------------------------------------------------
+    // 1. Local classification. The stripe of the thread i are the blocks
+    //    [vstripe[i], vstripe[i + 1]), and the last has the incomplete block
+    //------------------------------------------------------------------------
+    std::vector<size_t> vstripe(nth + 1), vwrite(nth);
+    for (uint32_t i = 0; i <= nth; ++i) vstripe[i] = (i * nblock) / nth;
+
+    bsc::run_threads(nth, [&](uint32_t i)
+    {
+        buffer_t &bf = *pbuf[i];
+        size_t write = vstripe[i] * BLOCK;
+        size_t end = (i + 1 == nth) ? n : vstripe[i + 1] * BLOCK;
+        std::fill(bf.vcount.begin(), bf.vcount.begin() + nbucket, 0);
+        std::fill(bf.vtotal.begin(), bf.vtotal.begin() + nbucket, 0);
+
+        cl.classify(first + write, first + end, [&](size_t b, Iter_t it)
+        {
+            value_t *pb = bf.bucket(b);
+            pb[bf.vcount[b]] = std::move(*it);
+            if (++bf.vcount[b] == BLOCK)
+            {
+                bscu::move_forward(first + write, pb, pb + BLOCK);
+                write += BLOCK;
+                bf.vtotal[b] += BLOCK;
+                bf.vcount[b] = 0;
+            };
+        });
+        for (size_t b = 0; b < nbucket; ++b) bf.vtotal[b] += bf.vcount[b];
+        vwrite[i] = write;
+    });
+
+    vlimit.assign(nbucket + 1, 0);
+    for (size_t b = 0; b < nbucket; ++b)
+    {
+        vlimit[b + 1] = vlimit[b];
+        for (uint32_t i = 0; i < nth; ++i) vlimit[b + 1] += pbuf[i]->vtotal[b];
+    };
+
+    //------------------------------------------------------------------------
+    // 2. The area of the bucket b are the blocks [vfirst[b], vfirst[b + 1]).
+    //    Its full blocks are moved to the beginning of the area, and the
+    //    blocks [vwrite_blk[b], vread[b]) are the blocks to process
+    //------------------------------------------------------------------------
+    std::vector<size_t> vfirst(nbucket + 1), vwrite_blk(nbucket),
+                        vread(nbucket);
+    for (size_t b = 0; b <= nbucket; ++b)
+        vfirst[b] = (vlimit[b] + BLOCK - 1) / BLOCK;
+
+    auto is_full = [&](size_t blk) -> bool
+    {
+        size_t i = size_t(std::upper_bound(vstripe.begin(), vstripe.end(),
+                                           blk) - vstripe.begin()) - 1;
+        return i < nth && (blk + 1) * BLOCK <= vwrite[i];
+    };
+    auto move_block = [&](size_t dest, size_t src)
+    {
+        Iter_t it = first + src * BLOCK;
+        bscu::move_forward(first + dest * BLOCK, it, it + BLOCK);
+    };
+
+    bsc::run_threads(nth, [&](uint32_t i)
+    {
+        for (size_t b = (i * nbucket) / nth; b < ((i + 1) * nbucket) / nth;
+                        ++b)
+        {
+            size_t lo = vfirst[b], hi = vfirst[b + 1];
+            while (true)
+            {
+                while (lo < hi && is_full(lo)) ++lo;
+                while (lo < hi && ! is_full(hi - 1)) --hi;
+                if (lo == hi) break;
+                move_block(lo++, --hi);
+            };
+            vwrite_blk[b] = vfirst[b];
+            vread[b] = lo;
+        };
+    });
+
+    //------------------------------------------------------------------------
+    // 3. Block permutation. The threads take the blocks to process, and move
+    //    them to the next block of their bucket. If this block is not
+    //    processed, it is swapped, and the thread continues with it
+    //------------------------------------------------------------------------
+    std::unique_ptr<bsc::spinlock_t[]> vlock(new bsc::spinlock_t[nbucket]);
+    value_t *overflow = nullptr;
+
+    bsc::run_threads(nth, [&](uint32_t i)
+    {
+        buffer_t &bf = *pbuf[i];
+        value_t *blk1 = bf.swap_block(0), *blk2 = bf.swap_block(1);
+
+        auto read_block = [&](size_t b) -> bool
+        {
+            std::lock_guard<bsc::spinlock_t> lk(vlock[b]);
+            if (vread[b] <= vwrite_blk[b]) return false;
+            Iter_t it = first + (--vread[b]) * BLOCK;
+            bscu::move_forward(blk1, it, it + BLOCK);
+            return true;
+        };
+
+        for (size_t c = 0; c < nbucket; ++c)
+        {
+            size_t b_read = ((i * nbucket) / nth + c) % nbucket;
+            while (read_block(b_read))
+            {
+                size_t b = cl.bucket(*blk1);
+                while (true)
+                {
+                    size_t blk;
+                    bool full;
+                    {
+                        std::lock_guard<bsc::spinlock_t> lk(vlock[b]);
+                        blk = vwrite_blk[b]++;
+                        full = blk < vread[b];
+                    };
+                    Iter_t it = first + blk * BLOCK;
+                    if (! full)
+                    {
+                        if ((blk + 1) * BLOCK > n)
+                        {
+                            bscu::move_forward(bf.overflow(), blk1,
+                                               blk1 + BLOCK);
+                            overflow = bf.overflow();
+                        }
+                        else
+                            bscu::move_forward(it, blk1, blk1 + BLOCK);
+                        break;
+                    };
+                    bscu::move_forward(blk2, it, it + BLOCK);
+                    bscu::move_forward(it, blk1, blk1 + BLOCK);
+                    std::swap(blk1, blk2);
+                    b = cl.bucket(*blk1);
+                };
+            };
+        };
+    });
+
+    //------------------------------------------------------------------------
+    // 4. Cleanup. The bucket b has the blocks [vfirst[b], vwrite_blk[b]),
+    //    and the last can exceed the end of the bucket. The rest of the
+    //    bucket is filled with this excess and the blocks of the threads.
+    //    The excess of the last bucket is in the overflow block
+    //------------------------------------------------------------------------
+    size_t pos_overflow = 0;
+    if (overflow != nullptr)
+    {
+        pos_overflow = (vwrite_blk[nbucket - 1] - 1) * BLOCK;
+        bscu::move_forward(first + pos_overflow, overflow,
+                           overflow + (n - pos_overflow));
+    };
+
+    // Each thread fills the buckets [vbk[i], vbk[i + 1]), and the excess of
+    // the last bucket of the previous threads is inside the incomplete
+    // block at the beginning of them, which is saved before
+    uint32_t nclean = (nth < nbucket) ? nth : uint32_t(nbucket);
+    std::vector<size_t> vbk(nclean + 1);
+    for (uint32_t i = 0; i <= nclean; ++i) vbk[i] = (i * nbucket) / nclean;
+
+    auto save_end = [&](uint32_t i) -> size_t
+    {
+        return std::min(vfirst[vbk[i]] * BLOCK, vlimit[vbk[i + 1]]);
+    };
+    bsc::run_threads(nclean, [&](uint32_t i)
+    {
+        Iter_t it = first + vlimit[vbk[i]];
+        bscu::move_forward(pbuf[i]->swap_block(0), it,
+                           first + save_end(i));
+    });
+
+    bsc::run_threads(nclean, [&](uint32_t i)
+    {
+        auto source = [&](size_t pos) -> value_t &
+        {
+            if (pos >= n) return overflow[pos - pos_overflow];
+            if (pos < vlimit[vbk[i + 1]]) return first[pos];
+            uint32_t j = i + 1;
+            while (pos >= vlimit[vbk[j + 1]]) ++j;
+            assert(pos < save_end(j));
+            return pbuf[j]->swap_block(0)[pos - vlimit[vbk[j]]];
+        };
+
+        for (size_t b = vbk[i]; b < vbk[i + 1]; ++b)
+        {
+            size_t end = vlimit[b + 1];
+            size_t head_end = std::min(vfirst[b] * BLOCK, end);
+            size_t blk_end = vwrite_blk[b] * BLOCK;
+            size_t pos = vlimit[b];
+
+            auto put = [&](value_t &val)
+            {
+                if (pos == head_end) pos = blk_end;
+                first[pos++] = std::move(val);
+            };
+            if (vwrite_blk[b] > vfirst[b])
+            {
+                for (size_t k = end; k < blk_end; ++k) put(source(k));
+            };
+            for (uint32_t j = 0; j < nth; ++j)
+            {
+                value_t *pb = pbuf[j]->bucket(b);
+                for (size_t k = 0; k < pbuf[j]->vcount[b]; ++k) put(pb[k]);
+            };
+        };
+    });
+};
+//
+//-----------------------------------------------------------------------------
+//  function : parallel_sort
+/// @brief split a range with all the threads. The buckets big enough are
+///        split again in the same way, and the others are stored in vtask
+//-----------------------------------------------------------------------------
+template<uint32_t Block_size, class Iter_t, class Compare>
+void inplace_sample_sort<Block_size, Iter_t, Compare>
+::parallel_sort(Iter_t first, size_t n, uint32_t level)
+{
+    classifier_t cl(cmp);
+    std::vector<size_t> vlimit;
+    partition(first, n, nthread, vptr.data(), cl, vlimit);
+
+    for (size_t b = 0; b < cl.nbucket; ++b)
+    {
+        if (cl.equal && (b & 1) != 0) continue;
+        size_t nb = vlimit[b + 1] - vlimit[b];
+        if (nb > nelem / nthread && nb > max_base_case * nthread && level > 1)
+            parallel_sort(first + vlimit[b], nb, level - 1);
+        else if (nb > 1)
+            vtask.emplace_back(first + vlimit[b], nb);
+    };
+};
+//
+//-----------------------------------------------------------------------------
+//  function : sequential_sort
+/// @brief sort a range with one thread, using the memory pb
+//-----------------------------------------------------------------------------
+template<uint32_t Block_size, class Iter_t, class Compare>
+void inplace_sample_sort<Block_size, Iter_t, Compare>
+::sequential_sort(Iter_t first, size_t n, buffer_t *pb, uint32_t level)
+{
+    if (n <= max_base_case || level == 0)
+    {
+        boost::sort::pdqsort(first, first + n, cmp);
+        return;
+    };
+    classifier_t cl(cmp);
+    std::vector<size_t> vlimit;
+    partition(first, n, 1, &pb, cl, vlimit);
+
+    for (size_t b = 0; b < cl.nbucket; ++b)
+    {
+        if (cl.equal && (b & 1) != 0) continue;
+        size_t nb = vlimit[b + 1] - vlimit[b];
+        if (nb > 1) sequential_sort(first + vlimit[b], nb, pb, level - 1);
+    };
+};
+//
+//****************************************************************************
+}//    End namespace inplace_detail
+//****************************************************************************
+//
+namespace bscu = boost::sort::common::util;
+//
+//############################################################################
+//                                                                          ##
+//                                                                          ##
+//               I N P L A C E _ S A M P L E _ S O R T                      ##
+//                                                                          ##
+//                                                                          ##
+//############################################################################
+//
+//-----------------------------------------------------------------------------
+//  function : inplace_sample_sort
+/// @brief in place parallel sample sort algorithm (unstable sort)
+///
+/// @param first : iterator to the first element of the range to sort
+/// @param last : iterator after the last element to the range to sort
+/// @param comp : object for to compare two elements pointed by Iter_t
+///               iterators
+/// @param nthread : Number of threads to use in the process. When this value
+///                  is lower than 2, the sorting is done with 1 thread
+/// @remarks The elements must be copy constructible, because the splitters
+///          are copied out of the range
+//-----------------------------------------------------------------------------
+template<class Iter_t, class Compare>
+void inplace_sample_sort(Iter_t first, Iter_t last, Compare comp,
+                         uint32_t nthread)
+{
+    typedef bscu::value_iter<Iter_t> value_t;
+    inplace_detail::inplace_sample_sort<
+                    inplace_detail::block_size_ips<sizeof(value_t)>::data,
+                    Iter_t, Compare>(first, last, comp, nthread);
+}
+//
+//-----------------------------------------------------------------------------
+//  function : inplace_sample_sort
+/// @brief in place parallel sample sort algorithm (unstable sort)
+///
+/// @param first : iterator to the first element of the range to sort
+/// @param last : iterator after the last element to the range to sort
+/// @param comp : object for to compare two elements pointed by Iter_t
+///               iterators
+//-----------------------------------------------------------------------------
+template<class Iter_t, class Compare = bscu::compare_iter<Iter_t>,
+         bscu::enable_if_not_integral<Compare> * = nullptr>
+void inplace_sample_sort(Iter_t first, Iter_t last, Compare comp = Compare())
+{
+    inplace_sample_sort(first, last, comp,
+                        std::thread::hardware_concurrency());
+}
+//
+//-----------------------------------------------------------------------------
+//  function : inplace_sample_sort
+/// @brief in place parallel sample sort algorithm (unstable sort)
+///
+/// @param first : iterator to the first element of the range to sort
+/// @param last : iterator after the last element to the range to sort
+/// @param nthread : Number of threads to use in the process. When this value
+///                  is lower than 2, the sorting is done with 1 thread
+//-----------------------------------------------------------------------------
+template<class Iter_t>
+void inplace_sample_sort(Iter_t first, Iter_t last, uint32_t nthread)
+{
+    inplace_sample_sort(first, last, bscu::compare_iter<Iter_t>(), nthread);
+}
+//
+//****************************************************************************
+}//    End namespace sort
+}//    End namespace boost
+//****************************************************************************
+//
+#endif
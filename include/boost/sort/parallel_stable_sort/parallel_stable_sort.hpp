@@ -20,6 +20,8 @@
 #include <type_traits>
 #include <vector>
 #include <boost/sort/sample_sort/sample_sort.hpp>
+#include <boost/sort/common/merge_path.hpp>
+#include <boost/sort/common/presorted.hpp>
 #include <boost/sort/common/util/traits.hpp>
 
 
@@ -37,6 +39,9 @@ namespace bsc = boost::sort::common;
 namespace bss = boost::sort::spin_detail;
 using bsc::range;
 using bsc::merge_half;
+using bsc::parallel_merge_half;
+using bsc::parallel_move_construct;
+using bsc::parallel_destroy;
 using boost::sort::sample_detail::sample_sort;
 //
 ///---------------------------------------------------------------------------
@@ -137,23 +142,12 @@ parallel_stable_sort <Iter_t, Compare>
         return;
     };
 
-    //------------------- check if sort --------------------------------------
-    bool sw = true;
-    for (Iter_t it1 = first, it2 = first + 1;
-         it2 != last && (sw = ! comp(*it2, *it1)); it1 = it2++);
-    if (sw) return;
-
-    //------------------- check if reverse sort ---------------------------
-    sw = true;
-    for (Iter_t it1 = first, it2 = first + 1;
-         it2 != last && (sw = comp(*it2, *it1)); it1 = it2++);
-    if (sw)
+    //------------- check if sort or reverse sort ----------------------------
+    uint32_t presort = bsc::presorted(first, last, comp, true, nthread);
+    if (! (presort & bsc::scan_unsorted)) return;
+    if (! (presort & bsc::scan_unreversed))
     {
-	using std::swap;
-        size_t nelem2 = nelem >> 1;
-        Iter_t it1 = first, it2 = last - 1;
-        for (size_t i = 0; i < nelem2; ++i)
-            swap(*(it1++), *(it2--));
+        bsc::parallel_reverse(first, last, nthread);
         return;
     };
 
@@ -193,9 +187,12 @@ parallel_stable_sort <Iter_t, Compare>
         throw std::bad_alloc();
     };
 
-    range_buffer = move_construct(range_buffer, range_first);
-    range_initial = merge_half(range_initial, range_buffer, range_second, comp);
-    destroy (range_buffer);
+    // The final merge, as the move to the buffer and its destruction, is
+    // split between the threads
+    range_buffer = parallel_move_construct(range_buffer, range_first, nthread);
+    range_initial = parallel_merge_half(range_initial, range_buffer,
+                                        range_second, comp, nthread);
+    parallel_destroy(range_buffer, nthread);
 
 
     
@@ -26,7 +26,9 @@
 #include <boost/sort/common/util/atomic.hpp>
 #include <boost/sort/common/merge_four.hpp>
 #include <boost/sort/common/merge_vector.hpp>
+#include <boost/sort/common/presorted.hpp>
 #include <boost/sort/common/range.hpp>
+#include <boost/sort/common/thread_pool.hpp>
 
 namespace boost
 {
@@ -89,9 +91,6 @@ struct sample_sort
     // range with the auxiliary memory
     range_buf global_buf;
 
-    // vector of futures
-    std::vector<std::future<void>> vfuture;
-
     // vector of vectors which contains the ranges to merge obtained in the
     // subdivision
     std::vector<std::vector<range_it>> vv_range_it;
@@ -184,14 +183,7 @@ struct sample_sort
     void first_merge(void)
     { //---------------------------------- begin --------------------------
         njob = 0;
-
-        for (uint32_t i = 0; i < nthread; ++i)
-        {
-            vfuture[i] = std::async(std::launch::async, &this_t::execute_first,
-                            this);
-        };
-        for (uint32_t i = 0; i < nthread; ++i)
-            vfuture[i].get();
+        bsc::run_threads(nthread, [this](uint32_t) { execute_first(); });
     }
     //
     //-----------------------------------------------------------------------
@@ -201,13 +193,7 @@ struct sample_sort
     void final_merge(void)
     { //---------------------------------- begin --------------------------
         njob = 0;
-
-        for (uint32_t i = 0; i < nthread; ++i)
-        {
-            vfuture[i] = std::async(std::launch::async, &this_t::execute, this);
-        }
-        for (uint32_t i = 0; i < nthread; ++i)
-            vfuture[i].get();
+        bsc::run_threads(nthread, [this](uint32_t) { execute(); });
     }
     //----------------------------------------------------------------------------
 };
@@ -245,7 +231,6 @@ sample_sort<Iter_t, Compare>
     size_t nelem = size_t(last - first);
     construct = false;
     njob = 0;
-    vfuture.resize(nthread);
 
     // Adjust when have many threads and only a few elements
     while (nelem > thread_min && (nthread * nthread) > (nelem >> 3))
@@ -260,23 +245,12 @@ sample_sort<Iter_t, Compare>
         return;
     }
 
-    //------------------- check if sort --------------------------------------
-    bool sw = true;
-    for (Iter_t it1 = first, it2 = first + 1;
-                    it2 != last && (sw = ! comp(*it2, *it1)); it1 = it2++);
-    if (sw) return;
-
-    //------------------- check if reverse sort ---------------------------
-    sw = true;
-    for (Iter_t it1 = first, it2 = first + 1;
-                    it2 != last && (sw = comp(*it2, *it1)); it1 = it2++);
-    if (sw)
+    //------------- check if sort or reverse sort ----------------------------
+    uint32_t presort = bsc::presorted(first, last, comp, true, nthread);
+    if (! (presort & bsc::scan_unsorted)) return;
+    if (! (presort & bsc::scan_unreversed))
     {
-	using std::swap;
-        size_t nelem2 = nelem >> 1;
-        Iter_t it1 = first, it2 = last - 1;
-        for (size_t i = 0; i < nelem2; ++i)
-            swap(*(it1++), *(it2--));
+        bsc::parallel_reverse(first, last, nthread);
         return;
     }
 
@@ -369,21 +343,13 @@ void sample_sort<Iter_t, Compare>::initial_configuration(void)
     //------------------------------------------------------------------------
     // Sorting of the ranges
     //------------------------------------------------------------------------
-    std::vector<std::future<void>> vfuture(nthread);
-
-    for (uint32_t i = 0; i < nthread; ++i)
+    auto func = [this, &vmem_thread, &vbuf_thread](uint32_t i)
     {
-        auto func = [this, &vmem_thread, i,  &vbuf_thread]()
-        {
-            bss::spinsort<Iter_t, Compare> (vmem_thread[i].first,
-                            vmem_thread[i].last, this->comp,
-                            vbuf_thread[i]);
-        };
-        vfuture[i] = std::async(std::launch::async, func);
+        bss::spinsort<Iter_t, Compare> (vmem_thread[i].first,
+                        vmem_thread[i].last, this->comp,
+                        vbuf_thread[i]);
     };
-
-    for (uint32_t i = 0; i < nthread; ++i)
-        vfuture[i].get();
+    bsc::run_threads(nthread, func);
 
     //------------------------------------------------------------------------
     // Obtain the vector of milestones
@@ -14,11 +14,17 @@
 Cumulative include for the Boost Sort library
 */
 #include <boost/sort/spreadsort/spreadsort.hpp>
+#include <boost/sort/spreadsort/parallel_integer_sort.hpp>
+#include <boost/sort/spreadsort/parallel_float_sort.hpp>
+#include <boost/sort/spreadsort/parallel_string_sort.hpp>
+#include <boost/sort/spreadsort/parallel_string_sample_sort.hpp>
 #include <boost/sort/spinsort/spinsort.hpp>
 #include <boost/sort/flat_stable_sort/flat_stable_sort.hpp>
+#include <boost/sort/flat_stable_sort/parallel_flat_stable_sort.hpp>
 #include <boost/sort/pdqsort/pdqsort.hpp>
 #include <boost/sort/block_indirect_sort/block_indirect_sort.hpp>
 #include <boost/sort/sample_sort/sample_sort.hpp>
+#include <boost/sort/inplace_sample_sort/inplace_sample_sort.hpp>
 #include <boost/sort/parallel_stable_sort/parallel_stable_sort.hpp>
 
 #endif
@@ -38,7 +38,29 @@ float_log_min_split_count = 8,
 //iteration.  Make this larger the faster boost::sort::pdqsort is relative to float_sort.
 float_log_finishing_count = 4,
 //There is a minimum size below which it is not worth using spreadsort
-min_sort_size = 1000 };
+min_sort_size = 1000,
+//Bits per digit for integer_sort_lsd.  Wider digits mean fewer passes,
+//but each pass scatters into 1 << lsd_digit_bits bins, which should fit
+//in the L1 cache; 11 makes 3 passes for 32-bit keys and 6 for 64-bit.
+lsd_digit_bits = 11,
+//Minimum number of elements per thread for the parallel variants;
+//with fewer, starting a thread costs more than it saves
+parallel_min_thread_size = 1 << 14,
+//parallel_string_sample_sort takes this many samples per splitter
+string_sample_oversampling = 16,
+//Number of splitters per thread for parallel_string_sample_sort.  More
+//splitters leave smaller buckets, but make classifying a string slower.
+string_sample_buckets_per_thread = 32,
+//Bucket numbers are stored in 16 bits, two per splitter
+max_string_sample_buckets = (1 << 14) - 1,
+//stable_integer_sort and stable_float_sort insertion sort bins this small
+stable_insertion_count = 16,
+//integer_sort counts integers whose range is under 1 << this and the
+//number of elements, and rewrites them from the counts
+counting_sort_log_range = 16,
+//Up to this many bins, bin sizes are counted in two histograms, which
+//speeds up counting skewed data; this is 32KB of stack for 64-bit size_t
+max_dual_count_bins = 1 << max_finishing_splits };
 }
 }
 }
@@ -25,11 +25,15 @@ Scott McMurray
 #include <boost/sort/spreadsort/detail/constants.hpp>
 #include <boost/sort/spreadsort/detail/integer_sort.hpp>
 #include <boost/sort/spreadsort/detail/spreadsort_common.hpp>
+#include <boost/sort/spreadsort/detail/tuning.hpp>
 #include <boost/cstdint.hpp>
 
 namespace boost {
 namespace sort {
 namespace spreadsort {
+  //! Where @c float_sort_total_order puts NaNs.
+  enum nan_position { nans_first, nans_last };
+
   namespace detail {
     //Casts a RandomAccessIter to the specified integer type
     template<class Cast_type, class RandomAccessIter>
@@ -47,6 +51,36 @@ namespace spreadsort {
       return result;
     }
 
+    //Gets the bin of a float as its bits cast to Div_type, >> log_divisor,
+    //minus div_min
+    template <class RandomAccessIter, class Div_type>
+    struct float_cast_bin {
+      float_cast_bin(unsigned log_divisor_, Div_type div_min_)
+        : log_divisor(log_divisor_), div_min(div_min_) {}
+      size_t operator()(RandomAccessIter iter) const
+      {
+        return unsigned((cast_float_iter<Div_type, RandomAccessIter>(iter)
+                         >> log_divisor) - div_min);
+      }
+      unsigned log_divisor;
+      Div_type div_min;
+    };
+
+    //Gets the value of an element as rshift(*iter, 0)
+    template <class RandomAccessIter, class Div_type, class Right_shift>
+    struct rshift_value {
+      explicit rshift_value(Right_shift rshift_) : rshift(rshift_) {}
+      Div_type operator()(RandomAccessIter iter) { return rshift(*iter, 0); }
+      Right_shift rshift;
+    };
+
+    //Gets the value of an element cast to Cast_type
+    template <class RandomAccessIter, class Cast_type>
+    struct cast_value {
+      Cast_type operator()(RandomAccessIter iter) const
+      { return cast_float_iter<Cast_type, RandomAccessIter>(iter); }
+    };
+
     // Return true if the list is sorted.  Otherwise, find the minimum and
     // maximum.  Values are Right_shifted 0 bits before comparison.
     template <class RandomAccessIter, class Div_type, class Right_shift>
@@ -55,18 +89,13 @@ namespace spreadsort {
                   Div_type & max, Div_type & min, Right_shift rshift)
     {
       min = max = rshift(*current, 0);
-      RandomAccessIter prev = current;
-      bool sorted = true;
-      while (++current < last) {
-        Div_type value = rshift(*current, 0);
-        sorted &= *current >= *prev;
-        prev = current;
-        if (max < value)
-          max = value;
-        else if (value < min)
-          min = value;
+      find_value_extremes(current + 1, last, max, min,
+        rshift_value<RandomAccessIter, Div_type, Right_shift>(rshift));
+      for (RandomAccessIter prev = current; ++current < last; ++prev) {
+        if (!(*current >= *prev))
+          return false;
       }
-      return sorted;
+      return true;
     }
 
     // Return true if the list is sorted.  Otherwise, find the minimum and
@@ -79,18 +108,13 @@ namespace spreadsort {
                                Right_shift rshift, Compare comp)
     {
       min = max = rshift(*current, 0);
-      RandomAccessIter prev = current;
-      bool sorted = true;
-      while (++current < last) {
-        Div_type value = rshift(*current, 0);
-        sorted &= !comp(*current, *prev);
-        prev = current;
-        if (max < value)
-          max = value;
-        else if (value < min)
-          min = value;
+      find_value_extremes(current + 1, last, max, min,
+        rshift_value<RandomAccessIter, Div_type, Right_shift>(rshift));
+      for (RandomAccessIter prev = current; ++current < last; ++prev) {
+        if (comp(*current, *prev))
+          return false;
       }
-      return sorted;
+      return true;
     }
 
     //Specialized swap loops for floating-point casting
@@ -146,22 +170,18 @@ namespace spreadsort {
                   Cast_type & max, Cast_type & min)
     {
       min = max = cast_float_iter<Cast_type, RandomAccessIter>(current);
-      RandomAccessIter prev = current;
-      bool sorted = true;
-      while (++current < last) {
-        Cast_type value = cast_float_iter<Cast_type, RandomAccessIter>(current);
-        sorted &= *current >= *prev;
-        prev = current;
-        if (max < value)
-          max = value;
-        else if (value < min)
-          min = value;
+      find_value_extremes(current + 1, last, max, min,
+                          cast_value<RandomAccessIter, Cast_type>());
+      for (RandomAccessIter prev = current; ++current < last; ++prev) {
+        if (!(*current >= *prev))
+          return false;
       }
-      return sorted;
+      return true;
     }
 
     //Special-case sorting of positive floats with casting
-    template <class RandomAccessIter, class Div_type, class Size_type>
+    template <class RandomAccessIter, class Div_type, class Size_type,
+              class Tuning>
     inline void
     positive_float_sort_rec(RandomAccessIter first, RandomAccessIter last,
               std::vector<RandomAccessIter> &bin_cache, unsigned cache_offset
@@ -171,8 +191,9 @@ namespace spreadsort {
       if (is_sorted_or_find_extremes<RandomAccessIter, Div_type>(first, last, 
                                                                 max, min))
         return;
-      unsigned log_divisor = get_log_divisor<float_log_mean_bin_size>(
-          last - first, rough_log_2_size(Size_type(max - min)));
+      unsigned log_divisor = get_log_divisor<Tuning::float_log_mean_bin_size>(
+          last - first, rough_log_2_size(Size_type(max - min)),
+          Tuning());
       Div_type div_min = min >> log_divisor;
       Div_type div_max = max >> log_divisor;
       unsigned bin_count = unsigned(div_max - div_min) + 1;
@@ -181,9 +202,8 @@ namespace spreadsort {
                                           cache_end, bin_count);
 
       //Calculating the size of each bin
-      for (RandomAccessIter current = first; current != last;)
-        bin_sizes[unsigned((cast_float_iter<Div_type, RandomAccessIter>(
-            current++) >> log_divisor) - div_min)]++;
+      count_bins(first, last, bin_sizes, bin_count,
+          float_cast_bin<RandomAccessIter, Div_type>(log_divisor, div_min));
       bins[0] = first;
       for (unsigned u = 0; u < bin_count - 1; u++)
         bins[u + 1] = bins[u] + bin_sizes[u];
@@ -201,9 +221,10 @@ namespace spreadsort {
         return;
 
       //Recursing
-      size_t max_count = get_min_count<float_log_mean_bin_size,
-                                       float_log_min_split_count,
-                                       float_log_finishing_count>(log_divisor);
+      size_t max_count = get_min_count<Tuning::float_log_mean_bin_size,
+                                       Tuning::float_log_min_split_count,
+                                       Tuning::float_log_finishing_count>
+                                         (log_divisor, Tuning());
       RandomAccessIter lastPos = first;
       for (unsigned u = cache_offset; u < cache_end; lastPos = bin_cache[u],
           ++u) {
@@ -213,14 +234,15 @@ namespace spreadsort {
         if (count < max_count)
           boost::sort::pdqsort(lastPos, bin_cache[u]);
         else
-          positive_float_sort_rec<RandomAccessIter, Div_type, Size_type>
+          positive_float_sort_rec<RandomAccessIter, Div_type, Size_type, Tuning>
             (lastPos, bin_cache[u], bin_cache, cache_end, bin_sizes);
       }
     }
 
     //Sorting negative floats
     //Bins are iterated in reverse because max_neg_float = min_neg_int
-    template <class RandomAccessIter, class Div_type, class Size_type>
+    template <class RandomAccessIter, class Div_type, class Size_type,
+              class Tuning>
     inline void
     negative_float_sort_rec(RandomAccessIter first, RandomAccessIter last,
                         std::vector<RandomAccessIter> &bin_cache,
@@ -231,8 +253,9 @@ namespace spreadsort {
                                                                  max, min))
         return;
 
-      unsigned log_divisor = get_log_divisor<float_log_mean_bin_size>(
-          last - first, rough_log_2_size(Size_type(max - min)));
+      unsigned log_divisor = get_log_divisor<Tuning::float_log_mean_bin_size>(
+          last - first, rough_log_2_size(Size_type(max - min)),
+          Tuning());
       Div_type div_min = min >> log_divisor;
       Div_type div_max = max >> log_divisor;
       unsigned bin_count = unsigned(div_max - div_min) + 1;
@@ -241,9 +264,8 @@ namespace spreadsort {
                                           cache_end, bin_count);
 
       //Calculating the size of each bin
-      for (RandomAccessIter current = first; current != last;)
-        bin_sizes[unsigned((cast_float_iter<Div_type, RandomAccessIter>(
-            current++) >> log_divisor) - div_min)]++;
+      count_bins(first, last, bin_sizes, bin_count,
+          float_cast_bin<RandomAccessIter, Div_type>(log_divisor, div_min));
       bins[bin_count - 1] = first;
       for (int ii = bin_count - 2; ii >= 0; --ii)
         bins[ii] = bins[ii + 1] + bin_sizes[ii + 1];
@@ -262,9 +284,10 @@ namespace spreadsort {
         return;
 
       //Recursing
-      size_t max_count = get_min_count<float_log_mean_bin_size,
-                                       float_log_min_split_count,
-                                       float_log_finishing_count>(log_divisor);
+      size_t max_count = get_min_count<Tuning::float_log_mean_bin_size,
+                                       Tuning::float_log_min_split_count,
+                                       Tuning::float_log_finishing_count>
+                                         (log_divisor, Tuning());
       RandomAccessIter lastPos = first;
       for (int ii = cache_end - 1; ii >= static_cast<int>(cache_offset);
           lastPos = bin_cache[ii], --ii) {
@@ -274,7 +297,7 @@ namespace spreadsort {
         if (count < max_count)
           boost::sort::pdqsort(lastPos, bin_cache[ii]);
         else
-          negative_float_sort_rec<RandomAccessIter, Div_type, Size_type>
+          negative_float_sort_rec<RandomAccessIter, Div_type, Size_type, Tuning>
             (lastPos, bin_cache[ii], bin_cache, cache_end, bin_sizes);
       }
     }
@@ -282,7 +305,7 @@ namespace spreadsort {
     //Sorting negative floats
     //Bins are iterated in reverse order because max_neg_float = min_neg_int
     template <class RandomAccessIter, class Div_type, class Right_shift,
-              class Size_type>
+              class Size_type, class Tuning>
     inline void
     negative_float_sort_rec(RandomAccessIter first, RandomAccessIter last,
               std::vector<RandomAccessIter> &bin_cache, unsigned cache_offset
@@ -291,8 +314,9 @@ namespace spreadsort {
       Div_type max, min;
       if (is_sorted_or_find_extremes(first, last, max, min, rshift))
         return;
-      unsigned log_divisor = get_log_divisor<float_log_mean_bin_size>(
-          last - first, rough_log_2_size(Size_type(max - min)));
+      unsigned log_divisor = get_log_divisor<Tuning::float_log_mean_bin_size>(
+          last - first, rough_log_2_size(Size_type(max - min)),
+          Tuning());
       Div_type div_min = min >> log_divisor;
       Div_type div_max = max >> log_divisor;
       unsigned bin_count = unsigned(div_max - div_min) + 1;
@@ -301,8 +325,9 @@ namespace spreadsort {
                                           cache_end, bin_count);
 
       //Calculating the size of each bin
-      for (RandomAccessIter current = first; current != last;)
-        bin_sizes[unsigned(rshift(*(current++), log_divisor) - div_min)]++;
+      count_bins(first, last, bin_sizes, bin_count,
+          rshift_bin<RandomAccessIter, Div_type, Right_shift>(log_divisor,
+                                                             div_min, rshift));
       bins[bin_count - 1] = first;
       for (int ii = bin_count - 2; ii >= 0; --ii)
         bins[ii] = bins[ii + 1] + bin_sizes[ii + 1];
@@ -321,9 +346,10 @@ namespace spreadsort {
         return;
 
       //Recursing
-      size_t max_count = get_min_count<float_log_mean_bin_size,
-                                       float_log_min_split_count,
-                                       float_log_finishing_count>(log_divisor);
+      size_t max_count = get_min_count<Tuning::float_log_mean_bin_size,
+                                       Tuning::float_log_min_split_count,
+                                       Tuning::float_log_finishing_count>
+                                         (log_divisor, Tuning());
       RandomAccessIter lastPos = first;
       for (int ii = cache_end - 1; ii >= static_cast<int>(cache_offset);
           lastPos = bin_cache[ii], --ii) {
@@ -334,13 +360,13 @@ namespace spreadsort {
           boost::sort::pdqsort(lastPos, bin_cache[ii]);
         else
           negative_float_sort_rec<RandomAccessIter, Div_type, Right_shift,
-                                  Size_type>
+                                  Size_type, Tuning>
             (lastPos, bin_cache[ii], bin_cache, cache_end, bin_sizes, rshift);
       }
     }
 
     template <class RandomAccessIter, class Div_type, class Right_shift,
-              class Compare, class Size_type>
+              class Compare, class Size_type, class Tuning>
     inline void
     negative_float_sort_rec(RandomAccessIter first, RandomAccessIter last,
             std::vector<RandomAccessIter> &bin_cache, unsigned cache_offset,
@@ -349,8 +375,9 @@ namespace spreadsort {
       Div_type max, min;
       if (is_sorted_or_find_extremes(first, last, max, min, rshift, comp))
         return;
-      unsigned log_divisor = get_log_divisor<float_log_mean_bin_size>(
-          last - first, rough_log_2_size(Size_type(max - min)));
+      unsigned log_divisor = get_log_divisor<Tuning::float_log_mean_bin_size>(
+          last - first, rough_log_2_size(Size_type(max - min)),
+          Tuning());
       Div_type div_min = min >> log_divisor;
       Div_type div_max = max >> log_divisor;
       unsigned bin_count = unsigned(div_max - div_min) + 1;
@@ -359,8 +386,9 @@ namespace spreadsort {
                                           cache_end, bin_count);
 
       //Calculating the size of each bin
-      for (RandomAccessIter current = first; current != last;)
-        bin_sizes[unsigned(rshift(*(current++), log_divisor) - div_min)]++;
+      count_bins(first, last, bin_sizes, bin_count,
+          rshift_bin<RandomAccessIter, Div_type, Right_shift>(log_divisor,
+                                                             div_min, rshift));
       bins[bin_count - 1] = first;
       for (int ii = bin_count - 2; ii >= 0; --ii)
         bins[ii] = bins[ii + 1] + bin_sizes[ii + 1];
@@ -379,9 +407,10 @@ namespace spreadsort {
         return;
 
       //Recursing
-      size_t max_count = get_min_count<float_log_mean_bin_size,
-                                       float_log_min_split_count,
-                                       float_log_finishing_count>(log_divisor);
+      size_t max_count = get_min_count<Tuning::float_log_mean_bin_size,
+                                       Tuning::float_log_min_split_count,
+                                       Tuning::float_log_finishing_count>
+                                         (log_divisor, Tuning());
       RandomAccessIter lastPos = first;
       for (int ii = cache_end - 1; ii >= static_cast<int>(cache_offset);
           lastPos = bin_cache[ii], --ii) {
@@ -392,14 +421,16 @@ namespace spreadsort {
           boost::sort::pdqsort(lastPos, bin_cache[ii], comp);
         else
           negative_float_sort_rec<RandomAccessIter, Div_type, Right_shift,
-                                  Compare, Size_type>(lastPos, bin_cache[ii],
+                                  Compare, Size_type, Tuning>(lastPos,
+                                                      bin_cache[ii],
                                                       bin_cache, cache_end,
                                                       bin_sizes, rshift, comp);
       }
     }
 
     //Casting special-case for floating-point sorting
-    template <class RandomAccessIter, class Div_type, class Size_type>
+    template <class RandomAccessIter, class Div_type, class Size_type,
+              class Tuning>
     inline void
     float_sort_rec(RandomAccessIter first, RandomAccessIter last,
                 std::vector<RandomAccessIter> &bin_cache, unsigned cache_offset
@@ -409,8 +440,9 @@ namespace spreadsort {
       if (is_sorted_or_find_extremes<RandomAccessIter, Div_type>(first, last, 
                                                                 max, min))
         return;
-      unsigned log_divisor = get_log_divisor<float_log_mean_bin_size>(
-          last - first, rough_log_2_size(Size_type(max/2 - min/2)) + 1);
+      unsigned log_divisor = get_log_divisor<Tuning::float_log_mean_bin_size>(
+          last - first, rough_log_2_size(Size_type(max/2 - min/2)) + 1,
+          Tuning());
       Div_type div_min = min >> log_divisor;
       Div_type div_max = max >> log_divisor;
       unsigned bin_count = unsigned(div_max - div_min) + 1;
@@ -419,9 +451,8 @@ namespace spreadsort {
                                           cache_end, bin_count);
 
       //Calculating the size of each bin
-      for (RandomAccessIter current = first; current != last;)
-        bin_sizes[unsigned((cast_float_iter<Div_type, RandomAccessIter>(
-            current++) >> log_divisor) - div_min)]++;
+      count_bins(first, last, bin_sizes, bin_count,
+          float_cast_bin<RandomAccessIter, Div_type>(log_divisor, div_min));
       //The index of the first positive bin
       //Must be divided small enough to fit into an integer
       unsigned first_positive = (div_min < 0) ? unsigned(-div_min) : 0;
@@ -463,9 +494,10 @@ namespace spreadsort {
         return;
 
       //Handling negative values first
-      size_t max_count = get_min_count<float_log_mean_bin_size,
-                                       float_log_min_split_count,
-                                       float_log_finishing_count>(log_divisor);
+      size_t max_count = get_min_count<Tuning::float_log_mean_bin_size,
+                                       Tuning::float_log_min_split_count,
+                                       Tuning::float_log_finishing_count>
+                                         (log_divisor, Tuning());
       RandomAccessIter lastPos = first;
       for (int ii = cache_offset + first_positive - 1; 
            ii >= static_cast<int>(cache_offset);
@@ -477,7 +509,7 @@ namespace spreadsort {
           boost::sort::pdqsort(lastPos, bin_cache[ii]);
         //sort negative values using reversed-bin spreadsort
         else
-          negative_float_sort_rec<RandomAccessIter, Div_type, Size_type>
+          negative_float_sort_rec<RandomAccessIter, Div_type, Size_type, Tuning>
             (lastPos, bin_cache[ii], bin_cache, cache_end, bin_sizes);
       }
 
@@ -490,14 +522,14 @@ namespace spreadsort {
           boost::sort::pdqsort(lastPos, bin_cache[u]);
         //sort positive values using normal spreadsort
         else
-          positive_float_sort_rec<RandomAccessIter, Div_type, Size_type>
+          positive_float_sort_rec<RandomAccessIter, Div_type, Size_type, Tuning>
             (lastPos, bin_cache[u], bin_cache, cache_end, bin_sizes);
       }
     }
 
     //Functor implementation for recursive sorting
     template <class RandomAccessIter, class Div_type, class Right_shift
-      , class Size_type>
+      , class Size_type, class Tuning>
     inline void
     float_sort_rec(RandomAccessIter first, RandomAccessIter last,
               std::vector<RandomAccessIter> &bin_cache, unsigned cache_offset
@@ -506,8 +538,9 @@ namespace spreadsort {
       Div_type max, min;
       if (is_sorted_or_find_extremes(first, last, max, min, rshift))
         return;
-      unsigned log_divisor = get_log_divisor<float_log_mean_bin_size>(
-          last - first, rough_log_2_size(Size_type(max/2 - min/2)) + 1);
+      unsigned log_divisor = get_log_divisor<Tuning::float_log_mean_bin_size>(
+          last - first, rough_log_2_size(Size_type(max/2 - min/2)) + 1,
+          Tuning());
       Div_type div_min = min >> log_divisor;
       Div_type div_max = max >> log_divisor;
       unsigned bin_count = unsigned(div_max - div_min) + 1;
@@ -516,8 +549,9 @@ namespace spreadsort {
                                           cache_end, bin_count);
 
       //Calculating the size of each bin
-      for (RandomAccessIter current = first; current != last;)
-        bin_sizes[unsigned(rshift(*(current++), log_divisor) - div_min)]++;
+      count_bins(first, last, bin_sizes, bin_count,
+          rshift_bin<RandomAccessIter, Div_type, Right_shift>(log_divisor,
+                                                             div_min, rshift));
       //The index of the first positive bin
       unsigned first_positive = (div_min < 0) ? unsigned(-div_min) : 0;
       //Resetting if all bins are negative
@@ -559,9 +593,10 @@ namespace spreadsort {
         return;
 
       //Handling negative values first
-      size_t max_count = get_min_count<float_log_mean_bin_size,
-                                       float_log_min_split_count,
-                                       float_log_finishing_count>(log_divisor);
+      size_t max_count = get_min_count<Tuning::float_log_mean_bin_size,
+                                       Tuning::float_log_min_split_count,
+                                       Tuning::float_log_finishing_count>
+                                         (log_divisor, Tuning());
       RandomAccessIter lastPos = first;
       for (int ii = cache_offset + first_positive - 1; 
            ii >= static_cast<int>(cache_offset);
@@ -574,7 +609,7 @@ namespace spreadsort {
         //sort negative values using reversed-bin spreadsort
         else
           negative_float_sort_rec<RandomAccessIter, Div_type,
-            Right_shift, Size_type>(lastPos, bin_cache[ii], bin_cache,
+            Right_shift, Size_type, Tuning>(lastPos, bin_cache[ii], bin_cache,
                                     cache_end, bin_sizes, rshift);
       }
 
@@ -588,14 +623,15 @@ namespace spreadsort {
         //sort positive values using normal spreadsort
         else
           spreadsort_rec<RandomAccessIter, Div_type, Right_shift, Size_type,
-                          float_log_mean_bin_size, float_log_min_split_count,
-                          float_log_finishing_count>
+                          Tuning::float_log_mean_bin_size,
+                          Tuning::float_log_min_split_count,
+                          Tuning::float_log_finishing_count, Tuning>
             (lastPos, bin_cache[u], bin_cache, cache_end, bin_sizes, rshift);
       }
     }
 
     template <class RandomAccessIter, class Div_type, class Right_shift,
-              class Compare, class Size_type>
+              class Compare, class Size_type, class Tuning>
     inline void
     float_sort_rec(RandomAccessIter first, RandomAccessIter last,
             std::vector<RandomAccessIter> &bin_cache, unsigned cache_offset,
@@ -604,8 +640,9 @@ namespace spreadsort {
       Div_type max, min;
       if (is_sorted_or_find_extremes(first, last, max, min, rshift, comp))
         return;
-      unsigned log_divisor = get_log_divisor<float_log_mean_bin_size>(
-          last - first, rough_log_2_size(Size_type(max/2 - min/2)) + 1);
+      unsigned log_divisor = get_log_divisor<Tuning::float_log_mean_bin_size>(
+          last - first, rough_log_2_size(Size_type(max/2 - min/2)) + 1,
+          Tuning());
       Div_type div_min = min >> log_divisor;
       Div_type div_max = max >> log_divisor;
       unsigned bin_count = unsigned(div_max - div_min) + 1;
@@ -614,8 +651,9 @@ namespace spreadsort {
                                           cache_end, bin_count);
 
       //Calculating the size of each bin
-      for (RandomAccessIter current = first; current != last;)
-        bin_sizes[unsigned(rshift(*(current++), log_divisor) - div_min)]++;
+      count_bins(first, last, bin_sizes, bin_count,
+          rshift_bin<RandomAccessIter, Div_type, Right_shift>(log_divisor,
+                                                             div_min, rshift));
       //The index of the first positive bin
       unsigned first_positive = 
         (div_min < 0) ? static_cast<unsigned>(-div_min) : 0;
@@ -658,9 +696,10 @@ namespace spreadsort {
         return;
 
       //Handling negative values first
-      size_t max_count = get_min_count<float_log_mean_bin_size,
-                                       float_log_min_split_count,
-                                       float_log_finishing_count>(log_divisor);
+      size_t max_count = get_min_count<Tuning::float_log_mean_bin_size,
+                                       Tuning::float_log_min_split_count,
+                                       Tuning::float_log_finishing_count>
+                                         (log_divisor, Tuning());
       RandomAccessIter lastPos = first;
       for (int ii = cache_offset + first_positive - 1; 
            ii >= static_cast<int>(cache_offset);
@@ -673,7 +712,8 @@ namespace spreadsort {
         //sort negative values using reversed-bin spreadsort
         else
           negative_float_sort_rec<RandomAccessIter, Div_type, Right_shift,
-                                  Compare, Size_type>(lastPos, bin_cache[ii],
+                                  Compare, Size_type, Tuning>(lastPos,
+                                                      bin_cache[ii],
                                                       bin_cache, cache_end,
                                                       bin_sizes, rshift, comp);
       }
@@ -688,43 +728,46 @@ namespace spreadsort {
         //sort positive values using normal spreadsort
         else
           spreadsort_rec<RandomAccessIter, Div_type, Right_shift, Compare,
-                          Size_type, float_log_mean_bin_size,
-                          float_log_min_split_count, float_log_finishing_count>
+                          Size_type, Tuning::float_log_mean_bin_size,
+                          Tuning::float_log_min_split_count,
+                          Tuning::float_log_finishing_count, Tuning>
       (lastPos, bin_cache[u], bin_cache, cache_end, bin_sizes, rshift, comp);
       }
     }
 
     //Checking whether the value type is a float, and trying a 32-bit integer
-    template <class RandomAccessIter>
+    template <class Tuning, class RandomAccessIter>
     inline typename boost::enable_if_c< sizeof(boost::uint32_t) ==
       sizeof(typename std::iterator_traits<RandomAccessIter>::value_type)
       && std::numeric_limits<typename
       std::iterator_traits<RandomAccessIter>::value_type>::is_iec559,
       void >::type
-    float_sort(RandomAccessIter first, RandomAccessIter last)
+    float_sort(RandomAccessIter first, RandomAccessIter last,
+               spreadsort_workspace<RandomAccessIter> *workspace = 0)
     {
-      size_t bin_sizes[1 << max_finishing_splits];
-      std::vector<RandomAccessIter> bin_cache;
-      float_sort_rec<RandomAccessIter, boost::int32_t, boost::uint32_t>
-        (first, last, bin_cache, 0, bin_sizes);
+      bin_storage<RandomAccessIter, 1 << Tuning::max_finishing_splits>
+        bins(workspace);
+      float_sort_rec<RandomAccessIter, boost::int32_t, boost::uint32_t, Tuning>
+        (first, last, bins.cache, 0, bins.sizes);
     }
 
     //Checking whether the value type is a double, and using a 64-bit integer
-    template <class RandomAccessIter>
+    template <class Tuning, class RandomAccessIter>
     inline typename boost::enable_if_c< sizeof(boost::uint64_t) ==
       sizeof(typename std::iterator_traits<RandomAccessIter>::value_type)
       && std::numeric_limits<typename
       std::iterator_traits<RandomAccessIter>::value_type>::is_iec559,
       void >::type
-    float_sort(RandomAccessIter first, RandomAccessIter last)
+    float_sort(RandomAccessIter first, RandomAccessIter last,
+               spreadsort_workspace<RandomAccessIter> *workspace = 0)
     {
-      size_t bin_sizes[1 << max_finishing_splits];
-      std::vector<RandomAccessIter> bin_cache;
-      float_sort_rec<RandomAccessIter, boost::int64_t, boost::uint64_t>
-        (first, last, bin_cache, 0, bin_sizes);
+      bin_storage<RandomAccessIter, 1 << Tuning::max_finishing_splits>
+        bins(workspace);
+      float_sort_rec<RandomAccessIter, boost::int64_t, boost::uint64_t, Tuning>
+        (first, last, bins.cache, 0, bins.sizes);
     }
 
-    template <class RandomAccessIter>
+    template <class Tuning, class RandomAccessIter>
     inline typename boost::disable_if_c< (sizeof(boost::uint64_t) ==
       sizeof(typename std::iterator_traits<RandomAccessIter>::value_type)
       || sizeof(boost::uint32_t) ==
@@ -732,7 +775,8 @@ namespace spreadsort {
       && std::numeric_limits<typename
       std::iterator_traits<RandomAccessIter>::value_type>::is_iec559,
       void >::type
-    float_sort(RandomAccessIter first, RandomAccessIter last)
+    float_sort(RandomAccessIter first, RandomAccessIter last,
+               spreadsort_workspace<RandomAccessIter> * = 0)
     {
       BOOST_STATIC_ASSERT(!(sizeof(boost::uint64_t) ==
       sizeof(typename std::iterator_traits<RandomAccessIter>::value_type)
@@ -745,81 +789,154 @@ namespace spreadsort {
 
     //These approaches require the user to do the typecast
     //with rshift but default comparision
-    template <class RandomAccessIter, class Div_type, class Right_shift>
+    template <class Tuning, class RandomAccessIter, class Div_type,
+              class Right_shift>
     inline typename boost::enable_if_c< sizeof(size_t) >= sizeof(Div_type),
       void >::type
     float_sort(RandomAccessIter first, RandomAccessIter last, Div_type,
-               Right_shift rshift)
+               Right_shift rshift,
+               spreadsort_workspace<RandomAccessIter> *workspace = 0)
     {
-      size_t bin_sizes[1 << max_finishing_splits];
-      std::vector<RandomAccessIter> bin_cache;
-      float_sort_rec<RandomAccessIter, Div_type, Right_shift, size_t>
-        (first, last, bin_cache, 0, bin_sizes, rshift);
+      bin_storage<RandomAccessIter, 1 << Tuning::max_finishing_splits>
+        bins(workspace);
+      float_sort_rec<RandomAccessIter, Div_type, Right_shift, size_t, Tuning>
+        (first, last, bins.cache, 0, bins.sizes, rshift);
     }
 
     //maximum integer size with rshift but default comparision
-    template <class RandomAccessIter, class Div_type, class Right_shift>
+    template <class Tuning, class RandomAccessIter, class Div_type,
+              class Right_shift>
     inline typename boost::enable_if_c< sizeof(size_t) < sizeof(Div_type)
       && sizeof(boost::uintmax_t) >= sizeof(Div_type), void >::type
     float_sort(RandomAccessIter first, RandomAccessIter last, Div_type,
-               Right_shift rshift)
+               Right_shift rshift,
+               spreadsort_workspace<RandomAccessIter> *workspace = 0)
     {
-      size_t bin_sizes[1 << max_finishing_splits];
-      std::vector<RandomAccessIter> bin_cache;
-      float_sort_rec<RandomAccessIter, Div_type, Right_shift, boost::uintmax_t>
-        (first, last, bin_cache, 0, bin_sizes, rshift);
+      bin_storage<RandomAccessIter, 1 << Tuning::max_finishing_splits>
+        bins(workspace);
+      float_sort_rec<RandomAccessIter, Div_type, Right_shift, boost::uintmax_t,
+                     Tuning>
+        (first, last, bins.cache, 0, bins.sizes, rshift);
     }
 
     //sizeof(Div_type) doesn't match, so use boost::sort::pdqsort
-    template <class RandomAccessIter, class Div_type, class Right_shift>
+    template <class Tuning, class RandomAccessIter, class Div_type,
+              class Right_shift>
     inline typename boost::disable_if_c< sizeof(boost::uintmax_t) >=
       sizeof(Div_type), void >::type
     float_sort(RandomAccessIter first, RandomAccessIter last, Div_type,
-               Right_shift /* rshift */)
+               Right_shift /* rshift */,
+               spreadsort_workspace<RandomAccessIter> * = 0)
     {
       boost::sort::pdqsort(first, last);
     }
 
     //specialized comparison
-    template <class RandomAccessIter, class Div_type, class Right_shift,
-              class Compare>
+    template <class Tuning, class RandomAccessIter, class Div_type,
+              class Right_shift, class Compare>
     inline typename boost::enable_if_c< sizeof(size_t) >= sizeof(Div_type),
       void >::type
     float_sort(RandomAccessIter first, RandomAccessIter last, Div_type,
-               Right_shift rshift, Compare comp)
+               Right_shift rshift, Compare comp,
+               spreadsort_workspace<RandomAccessIter> *workspace = 0)
     {
-      size_t bin_sizes[1 << max_finishing_splits];
-      std::vector<RandomAccessIter> bin_cache;
+      bin_storage<RandomAccessIter, 1 << Tuning::max_finishing_splits>
+        bins(workspace);
       float_sort_rec<RandomAccessIter, Div_type, Right_shift, Compare,
-        size_t>
-        (first, last, bin_cache, 0, bin_sizes, rshift, comp);
+        size_t, Tuning>
+        (first, last, bins.cache, 0, bins.sizes, rshift, comp);
     }
 
     //max-sized integer with specialized comparison
-    template <class RandomAccessIter, class Div_type, class Right_shift,
-              class Compare>
+    template <class Tuning, class RandomAccessIter, class Div_type,
+              class Right_shift, class Compare>
     inline typename boost::enable_if_c< sizeof(size_t) < sizeof(Div_type)
       && sizeof(boost::uintmax_t) >= sizeof(Div_type), void >::type
     float_sort(RandomAccessIter first, RandomAccessIter last, Div_type,
-               Right_shift rshift, Compare comp)
+               Right_shift rshift, Compare comp,
+               spreadsort_workspace<RandomAccessIter> *workspace = 0)
     {
-      size_t bin_sizes[1 << max_finishing_splits];
-      std::vector<RandomAccessIter> bin_cache;
+      bin_storage<RandomAccessIter, 1 << Tuning::max_finishing_splits>
+        bins(workspace);
       float_sort_rec<RandomAccessIter, Div_type, Right_shift, Compare,
-        boost::uintmax_t>
-        (first, last, bin_cache, 0, bin_sizes, rshift, comp);
+        boost::uintmax_t, Tuning>
+        (first, last, bins.cache, 0, bins.sizes, rshift, comp);
     }
 
     //sizeof(Div_type) doesn't match, so use boost::sort::pdqsort
-    template <class RandomAccessIter, class Div_type, class Right_shift,
-              class Compare>
+    template <class Tuning, class RandomAccessIter, class Div_type,
+              class Right_shift, class Compare>
     inline typename boost::disable_if_c< sizeof(boost::uintmax_t) >=
       sizeof(Div_type), void >::type
     float_sort(RandomAccessIter first, RandomAccessIter last, Div_type,
-               Right_shift /* rshift */, Compare comp)
+               Right_shift /* rshift */, Compare comp,
+               spreadsort_workspace<RandomAccessIter> * = 0)
     {
       boost::sort::pdqsort(first, last, comp);
     }
+
+    //Unsigned integer type with the same size as a float type
+    template <size_t Size> struct total_order_key_type;
+    template <> struct total_order_key_type<4> { typedef boost::uint32_t type; };
+    template <> struct total_order_key_type<8> { typedef boost::uint64_t type; };
+
+    //Maps a float to an unsigned integer in IEEE 754 totalOrder, except that
+    //all NaNs go to the end chosen by the caller, without any branches
+    template <class Data_type>
+    struct total_order_key {
+      typedef typename total_order_key_type<sizeof(Data_type)>::type Key_type;
+      explicit total_order_key(nan_position nans)
+        : nan_sign(nans == nans_first ? sign_bit() : Key_type(0)) {}
+      static Key_type sign_bit()
+      { return Key_type(1) << (8 * sizeof(Key_type) - 1); }
+      Key_type operator()(const Data_type &x) const
+      {
+        BOOST_STATIC_ASSERT(std::numeric_limits<Data_type>::is_iec559);
+        const Key_type sign = sign_bit();
+        const Data_type inf = std::numeric_limits<Data_type>::infinity();
+        Key_type bits = cast_float_iter<Key_type, const Data_type *>(&x);
+        //NaNs are above infinity in magnitude; give them the caller's sign
+        Key_type nan_mask = Key_type(0) - Key_type((bits & ~sign) >
+            cast_float_iter<Key_type, const Data_type *>(&inf));
+        bits = (bits & ~(nan_mask & sign)) | (nan_mask & nan_sign);
+        //Flip every bit of negatives and just the sign bit of positives
+        return bits ^ ((Key_type(0) - (bits >> (8 * sizeof(Key_type) - 1)))
+                       | sign);
+      }
+      Key_type nan_sign;
+    };
+
+    template <class Data_type>
+    struct total_order_shift {
+      typedef typename total_order_key<Data_type>::Key_type Key_type;
+      explicit total_order_shift(nan_position nans) : key(nans) {}
+      Key_type operator()(const Data_type &x, unsigned offset) const
+      { return key(x) >> offset; }
+      total_order_key<Data_type> key;
+    };
+
+    template <class Data_type>
+    struct total_order_less {
+      explicit total_order_less(nan_position nans) : key(nans) {}
+      bool operator()(const Data_type &x, const Data_type &y) const
+      { return key(x) < key(y); }
+      total_order_key<Data_type> key;
+    };
+
+    //Radix sorts on the total order key, which is computed on the fly in
+    //each pass, so NaNs need no separate pass
+    template <class Tuning, class RandomAccessIter>
+    inline void
+    float_sort_total_order(RandomAccessIter first, RandomAccessIter last,
+                           nan_position nans)
+    {
+      typedef typename std::iterator_traits<RandomAccessIter>::value_type
+        Data_type;
+      typedef typename total_order_key<Data_type>::Key_type Key_type;
+      integer_sort<Tuning>(first, last, Key_type(0),
+                           total_order_shift<Data_type>(nans),
+                           total_order_less<Data_type>(nans));
+    }
   }
 }
 }
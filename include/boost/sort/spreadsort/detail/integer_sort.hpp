@@ -20,8 +20,12 @@ Phil Endecott and Frank Gennari
 #include <functional>
 #include <boost/static_assert.hpp>
 #include <boost/utility/enable_if.hpp>
+#include <boost/type_traits/is_integral.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/type_traits/make_unsigned.hpp>
 #include <boost/sort/spreadsort/detail/constants.hpp>
 #include <boost/sort/spreadsort/detail/spreadsort_common.hpp>
+#include <boost/sort/spreadsort/detail/tuning.hpp>
 #include <boost/cstdint.hpp>
 
 namespace boost {
@@ -46,12 +50,7 @@ namespace spreadsort {
       //The maximum is the last sorted element
       max = current;
       //Start from the first unsorted element
-      while (++current < last) {
-        if (*max < *current)
-          max = current;
-        else if (*current < *min)
-          min = current;
-      }
+      find_extremes(current + 1, last, max, min, less_than());
       return false;
     }
 
@@ -72,42 +71,113 @@ namespace spreadsort {
 
       //The maximum is the last sorted element
       max = current;
-      while (++current < last) {
-        if (comp(*max, *current))
-          max = current;
-        else if (comp(*current, *min))
-          min = current;
-      }
+      find_extremes(current + 1, last, max, min, comp);
       return false;
     }
 
     //Gets a non-negative right bit shift to operate as a logarithmic divisor
-    template<unsigned log_mean_bin_size>
+    template<unsigned log_mean_bin_size, class Tuning>
     inline int
-    get_log_divisor(size_t count, int log_range)
+    get_log_divisor(size_t count, int log_range, Tuning)
     {
       int log_divisor;
       //If we can finish in one iteration without exceeding either
       //(2 to the max_finishing_splits) or n bins, do so
       if ((log_divisor = log_range - rough_log_2_size(count)) <= 0 && 
-         log_range <= max_finishing_splits)
+         log_range <= Tuning::max_finishing_splits)
         log_divisor = 0; 
       else {
         //otherwise divide the data into an optimized number of pieces
         log_divisor += log_mean_bin_size;
         //Cannot exceed max_splits or cache misses slow down bin lookups
-        if ((log_range - log_divisor) > max_splits)
-          log_divisor = log_range - max_splits;
+        if ((log_range - log_divisor) > Tuning::max_splits)
+          log_divisor = log_range - Tuning::max_splits;
       }
       return log_divisor;
     }
 
+    //Uses the default tuning
+    template<unsigned log_mean_bin_size>
+    inline int
+    get_log_divisor(size_t count, int log_range)
+    {
+      return get_log_divisor<log_mean_bin_size>(count, log_range,
+                                                default_tuning());
+    }
+
+    //Integral types other than bool, whose equal values are interchangeable
+    //and can be rebuilt from a count
+    template <class T>
+    struct is_counting_type {
+      static const bool value = boost::is_integral<T>::value &&
+                                !boost::is_same<T, bool>::value;
+    };
+
+    //Returns min_value + offset, computed without signed overflow
+    template <class Data_type>
+    inline Data_type
+    counting_value(Data_type min_value, size_t offset)
+    {
+      typedef typename boost::make_unsigned<Data_type>::type Unsigned_type;
+      return Data_type(Unsigned_type(Unsigned_type(min_value) + offset));
+    }
+
+    //Range of values that integer_sort sorts by counting, or 0 if there are
+    //too many possible values to count, or fewer elements than values
+    template <class Data_type>
+    inline size_t
+    counting_range(Data_type min_value, Data_type max_value, size_t count)
+    {
+      typedef typename boost::make_unsigned<Data_type>::type Unsigned_type;
+      boost::uintmax_t range =
+        Unsigned_type(Unsigned_type(max_value) - Unsigned_type(min_value));
+      if ((range >> counting_sort_log_range) || range >= count)
+        return 0;
+      return size_t(range) + 1;
+    }
+
+    //Counts the elements of each value, and rewrites [first, last) from the
+    //counts.  For a few hundred distinct values this takes two reads and one
+    //sequential write of the data, instead of swapping every element.
+    //counts keeps its capacity between calls.
+    template <class RandomAccessIter, class Data_type>
+    inline typename boost::enable_if_c<is_counting_type<Data_type>::value,
+                                       bool>::type
+    counting_sort(RandomAccessIter first, RandomAccessIter last,
+                  Data_type min_value, Data_type max_value,
+                  std::vector<size_t> &counts)
+    {
+      size_t bin_count = counting_range(min_value, max_value, last - first);
+      if (!bin_count)
+        return false;
+      counts.assign(bin_count, 0);
+      count_bins(first, last, &counts[0], unsigned(bin_count),
+                 shift_bin<RandomAccessIter, Data_type>(0, min_value));
+      for (size_t u = 0; u < bin_count; ++u) {
+        const Data_type value = counting_value(min_value, u);
+        for (size_t remaining = counts[u]; remaining; --remaining)
+          *first++ = value;
+      }
+      return true;
+    }
+
+    //Other types can't be rebuilt from counts
+    template <class RandomAccessIter, class Data_type>
+    inline typename boost::disable_if_c<is_counting_type<Data_type>::value,
+                                        bool>::type
+    counting_sort(RandomAccessIter, RandomAccessIter, Data_type, Data_type,
+                  std::vector<size_t> &)
+    {
+      return false;
+    }
+
     //Implementation for recursive integer sorting
-    template <class RandomAccessIter, class Div_type, class Size_type>
+    template <class RandomAccessIter, class Div_type, class Size_type,
+              class Tuning>
     inline void
     spreadsort_rec(RandomAccessIter first, RandomAccessIter last,
               std::vector<RandomAccessIter> &bin_cache, unsigned cache_offset
-              , size_t *bin_sizes)
+              , size_t *bin_sizes, std::vector<size_t> &counts)
     {
       //This step is roughly 10% of runtime, but it helps avoid worst-case
       //behavior and improve behavior with real data
@@ -116,9 +186,13 @@ namespace spreadsort {
       RandomAccessIter max, min;
       if (is_sorted_or_find_extremes(first, last, max, min))
         return;
+      //Few distinct integers are counted instead of binned
+      if (counting_sort(first, last, *min, *max, counts))
+        return;
       RandomAccessIter * target_bin;
-      unsigned log_divisor = get_log_divisor<int_log_mean_bin_size>(
-          last - first, rough_log_2_size(Size_type((*max >> 0) - (*min >> 0))));
+      unsigned log_divisor = get_log_divisor<Tuning::int_log_mean_bin_size>(
+          last - first, rough_log_2_size(Size_type((*max >> 0) - (*min >> 0))),
+          Tuning());
       Div_type div_min = *min >> log_divisor;
       Div_type div_max = *max >> log_divisor;
       unsigned bin_count = unsigned(div_max - div_min) + 1;
@@ -127,8 +201,8 @@ namespace spreadsort {
         size_bins(bin_sizes, bin_cache, cache_offset, cache_end, bin_count);
 
       //Calculating the size of each bin; this takes roughly 10% of runtime
-      for (RandomAccessIter current = first; current != last;)
-        bin_sizes[size_t((*(current++) >> log_divisor) - div_min)]++;
+      count_bins(first, last, bin_sizes, bin_count,
+                 shift_bin<RandomAccessIter, Div_type>(log_divisor, div_min));
       //Assign the bin positions
       bins[0] = first;
       for (unsigned u = 0; u < bin_count - 1; u++)
@@ -174,8 +248,9 @@ namespace spreadsort {
         return;
       //log_divisor is the remaining range; calculating the comparison threshold
       size_t max_count =
-        get_min_count<int_log_mean_bin_size, int_log_min_split_count,
-                      int_log_finishing_count>(log_divisor);
+        get_min_count<Tuning::int_log_mean_bin_size,
+                      Tuning::int_log_min_split_count,
+                      Tuning::int_log_finishing_count>(log_divisor, Tuning());
 
       //Recursing
       RandomAccessIter lastPos = first;
@@ -189,11 +264,9 @@ namespace spreadsort {
         if (count < max_count)
           boost::sort::pdqsort(lastPos, bin_cache[u]);
         else
-          spreadsort_rec<RandomAccessIter, Div_type, Size_type>(lastPos,
-                                                                 bin_cache[u],
-                                                                 bin_cache,
-                                                                 cache_end,
-                                                                 bin_sizes);
+          spreadsort_rec<RandomAccessIter, Div_type, Size_type, Tuning>(
+              lastPos, bin_cache[u], bin_cache, cache_end, bin_sizes,
+              counts);
       }
     }
 
@@ -247,7 +320,8 @@ namespace spreadsort {
     //Functor implementation for recursive sorting
     template <class RandomAccessIter, class Div_type, class Right_shift,
               class Compare, class Size_type, unsigned log_mean_bin_size,
-                unsigned log_min_split_count, unsigned log_finishing_count>
+                unsigned log_min_split_count, unsigned log_finishing_count,
+              class Tuning>
     inline void
     spreadsort_rec(RandomAccessIter first, RandomAccessIter last,
           std::vector<RandomAccessIter> &bin_cache, unsigned cache_offset
@@ -257,7 +331,8 @@ namespace spreadsort {
       if (is_sorted_or_find_extremes(first, last, max, min, comp))
         return;
       unsigned log_divisor = get_log_divisor<log_mean_bin_size>(last - first,
-            rough_log_2_size(Size_type(rshift(*max, 0) - rshift(*min, 0))));
+            rough_log_2_size(Size_type(rshift(*max, 0) - rshift(*min, 0))),
+            Tuning());
       Div_type div_min = rshift(*min, log_divisor);
       Div_type div_max = rshift(*max, log_divisor);
       unsigned bin_count = unsigned(div_max - div_min) + 1;
@@ -266,8 +341,9 @@ namespace spreadsort {
                                           cache_end, bin_count);
 
       //Calculating the size of each bin
-      for (RandomAccessIter current = first; current != last;)
-        bin_sizes[unsigned(rshift(*(current++), log_divisor) - div_min)]++;
+      count_bins(first, last, bin_sizes, bin_count,
+          rshift_bin<RandomAccessIter, Div_type, Right_shift>(log_divisor,
+                                                             div_min, rshift));
       bins[0] = first;
       for (unsigned u = 0; u < bin_count - 1; u++)
         bins[u + 1] = bins[u] + bin_sizes[u];
@@ -285,7 +361,7 @@ namespace spreadsort {
 
       //Recursing
       size_t max_count = get_min_count<log_mean_bin_size, log_min_split_count,
-                          log_finishing_count>(log_divisor);
+                          log_finishing_count>(log_divisor, Tuning());
       RandomAccessIter lastPos = first;
       for (unsigned u = cache_offset; u < cache_end; lastPos = bin_cache[u],
           ++u) {
@@ -296,7 +372,8 @@ namespace spreadsort {
           boost::sort::pdqsort(lastPos, bin_cache[u], comp);
         else
           spreadsort_rec<RandomAccessIter, Div_type, Right_shift, Compare,
-        Size_type, log_mean_bin_size, log_min_split_count, log_finishing_count>
+        Size_type, log_mean_bin_size, log_min_split_count, log_finishing_count,
+        Tuning>
       (lastPos, bin_cache[u], bin_cache, cache_end, bin_sizes, rshift, comp);
       }
     }
@@ -304,7 +381,8 @@ namespace spreadsort {
     //Functor implementation for recursive sorting with only Shift overridden
     template <class RandomAccessIter, class Div_type, class Right_shift,
               class Size_type, unsigned log_mean_bin_size,
-              unsigned log_min_split_count, unsigned log_finishing_count>
+              unsigned log_min_split_count, unsigned log_finishing_count,
+              class Tuning>
     inline void
     spreadsort_rec(RandomAccessIter first, RandomAccessIter last,
               std::vector<RandomAccessIter> &bin_cache, unsigned cache_offset
@@ -314,7 +392,8 @@ namespace spreadsort {
       if (is_sorted_or_find_extremes(first, last, max, min))
         return;
       unsigned log_divisor = get_log_divisor<log_mean_bin_size>(last - first,
-            rough_log_2_size(Size_type(rshift(*max, 0) - rshift(*min, 0))));
+            rough_log_2_size(Size_type(rshift(*max, 0) - rshift(*min, 0))),
+            Tuning());
       Div_type div_min = rshift(*min, log_divisor);
       Div_type div_max = rshift(*max, log_divisor);
       unsigned bin_count = unsigned(div_max - div_min) + 1;
@@ -323,8 +402,9 @@ namespace spreadsort {
                                           cache_end, bin_count);
 
       //Calculating the size of each bin
-      for (RandomAccessIter current = first; current != last;)
-        bin_sizes[unsigned(rshift(*(current++), log_divisor) - div_min)]++;
+      count_bins(first, last, bin_sizes, bin_count,
+          rshift_bin<RandomAccessIter, Div_type, Right_shift>(log_divisor,
+                                                             div_min, rshift));
       bins[0] = first;
       for (unsigned u = 0; u < bin_count - 1; u++)
         bins[u + 1] = bins[u] + bin_sizes[u];
@@ -342,7 +422,7 @@ namespace spreadsort {
 
       //Recursing
       size_t max_count = get_min_count<log_mean_bin_size, log_min_split_count,
-                          log_finishing_count>(log_divisor);
+                          log_finishing_count>(log_divisor, Tuning());
       RandomAccessIter lastPos = first;
       for (unsigned u = cache_offset; u < cache_end; lastPos = bin_cache[u],
           ++u) {
@@ -353,132 +433,309 @@ namespace spreadsort {
           boost::sort::pdqsort(lastPos, bin_cache[u]);
         else
           spreadsort_rec<RandomAccessIter, Div_type, Right_shift, Size_type,
-          log_mean_bin_size, log_min_split_count, log_finishing_count>(lastPos,
-                      bin_cache[u], bin_cache, cache_end, bin_sizes, rshift);
+          log_mean_bin_size, log_min_split_count, log_finishing_count, Tuning>
+                     (lastPos, bin_cache[u], bin_cache, cache_end, bin_sizes,
+                      rshift);
       }
     }
 
     //Holds the bin vector and makes the initial recursive call
-    template <class RandomAccessIter, class Div_type>
+    template <class Tuning, class RandomAccessIter, class Div_type>
     //Only use spreadsort if the integer can fit in a size_t
     inline typename boost::enable_if_c< sizeof(Div_type) <= sizeof(size_t),
                                                             void >::type
-    integer_sort(RandomAccessIter first, RandomAccessIter last, Div_type)
+    integer_sort(RandomAccessIter first, RandomAccessIter last, Div_type,
+                 spreadsort_workspace<RandomAccessIter> *workspace = 0)
     {
-      size_t bin_sizes[1 << max_finishing_splits];
-      std::vector<RandomAccessIter> bin_cache;
-      spreadsort_rec<RandomAccessIter, Div_type, size_t>(first, last,
-          bin_cache, 0, bin_sizes);
+      bin_storage<RandomAccessIter, 1 << Tuning::max_finishing_splits>
+        bins(workspace);
+      spreadsort_rec<RandomAccessIter, Div_type, size_t, Tuning>(first, last,
+          bins.cache, 0, bins.sizes, bins.counts);
     }
 
     //Holds the bin vector and makes the initial recursive call
-    template <class RandomAccessIter, class Div_type>
+    template <class Tuning, class RandomAccessIter, class Div_type>
     //Only use spreadsort if the integer can fit in a uintmax_t
     inline typename boost::enable_if_c< (sizeof(Div_type) > sizeof(size_t))
       && sizeof(Div_type) <= sizeof(boost::uintmax_t), void >::type
-    integer_sort(RandomAccessIter first, RandomAccessIter last, Div_type)
+    integer_sort(RandomAccessIter first, RandomAccessIter last, Div_type,
+                 spreadsort_workspace<RandomAccessIter> *workspace = 0)
     {
-      size_t bin_sizes[1 << max_finishing_splits];
-      std::vector<RandomAccessIter> bin_cache;
-      spreadsort_rec<RandomAccessIter, Div_type, boost::uintmax_t>(first,
-          last, bin_cache, 0, bin_sizes);
+      bin_storage<RandomAccessIter, 1 << Tuning::max_finishing_splits>
+        bins(workspace);
+      spreadsort_rec<RandomAccessIter, Div_type, boost::uintmax_t, Tuning>(
+          first, last, bins.cache, 0, bins.sizes, bins.counts);
     }
 
-    template <class RandomAccessIter, class Div_type>
+    //Integer types wider than boost::uintmax_t that are sorted as two words
+    template <class Div_type>
+    struct is_two_word_integer { enum { value = false }; };
+#ifdef BOOST_HAS_INT128
+    template <>
+    struct is_two_word_integer<boost::int128_type> { enum { value = true }; };
+    template <>
+    struct is_two_word_integer<boost::uint128_type> { enum { value = true }; };
+#endif
+
+    template <class Tuning, class RandomAccessIter, class Div_type>
     inline typename boost::disable_if_c< sizeof(Div_type) <= sizeof(size_t)
-      || sizeof(Div_type) <= sizeof(boost::uintmax_t), void >::type
+      || sizeof(Div_type) <= sizeof(boost::uintmax_t)
+      || is_two_word_integer<Div_type>::value, void >::type
     //defaulting to boost::sort::pdqsort when integer_sort won't work
-    integer_sort(RandomAccessIter first, RandomAccessIter last, Div_type)
+    integer_sort(RandomAccessIter first, RandomAccessIter last, Div_type,
+                 spreadsort_workspace<RandomAccessIter> * = 0)
     {
       boost::sort::pdqsort(first, last);
     }
 
 
     //Same for the full functor version
-    template <class RandomAccessIter, class Div_type, class Right_shift,
-              class Compare>
+    template <class Tuning, class RandomAccessIter, class Div_type,
+              class Right_shift, class Compare>
     //Only use spreadsort if the integer can fit in a size_t
     inline typename boost::enable_if_c< sizeof(Div_type) <= sizeof(size_t),
                                  void >::type
     integer_sort(RandomAccessIter first, RandomAccessIter last, Div_type,
-                Right_shift shift, Compare comp)
+                Right_shift shift, Compare comp,
+                spreadsort_workspace<RandomAccessIter> *workspace = 0)
     {
-      size_t bin_sizes[1 << max_finishing_splits];
-      std::vector<RandomAccessIter> bin_cache;
+      bin_storage<RandomAccessIter, 1 << Tuning::max_finishing_splits>
+        bins(workspace);
       spreadsort_rec<RandomAccessIter, Div_type, Right_shift, Compare,
-          size_t, int_log_mean_bin_size, int_log_min_split_count, 
-                        int_log_finishing_count>
-          (first, last, bin_cache, 0, bin_sizes, shift, comp);
+          size_t, Tuning::int_log_mean_bin_size,
+          Tuning::int_log_min_split_count, Tuning::int_log_finishing_count,
+          Tuning>
+          (first, last, bins.cache, 0, bins.sizes, shift, comp);
     }
 
-    template <class RandomAccessIter, class Div_type, class Right_shift,
-              class Compare>
+    template <class Tuning, class RandomAccessIter, class Div_type,
+              class Right_shift, class Compare>
     //Only use spreadsort if the integer can fit in a uintmax_t
     inline typename boost::enable_if_c< (sizeof(Div_type) > sizeof(size_t))
       && sizeof(Div_type) <= sizeof(boost::uintmax_t), void >::type
     integer_sort(RandomAccessIter first, RandomAccessIter last, Div_type,
-                Right_shift shift, Compare comp)
+                Right_shift shift, Compare comp,
+                spreadsort_workspace<RandomAccessIter> *workspace = 0)
     {
-      size_t bin_sizes[1 << max_finishing_splits];
-      std::vector<RandomAccessIter> bin_cache;
+      bin_storage<RandomAccessIter, 1 << Tuning::max_finishing_splits>
+        bins(workspace);
       spreadsort_rec<RandomAccessIter, Div_type, Right_shift, Compare,
-                        boost::uintmax_t, int_log_mean_bin_size,
-                        int_log_min_split_count, int_log_finishing_count>
-          (first, last, bin_cache, 0, bin_sizes, shift, comp);
+                        boost::uintmax_t, Tuning::int_log_mean_bin_size,
+                        Tuning::int_log_min_split_count,
+                        Tuning::int_log_finishing_count, Tuning>
+          (first, last, bins.cache, 0, bins.sizes, shift, comp);
     }
 
-    template <class RandomAccessIter, class Div_type, class Right_shift,
-              class Compare>
+    template <class Tuning, class RandomAccessIter, class Div_type,
+              class Right_shift, class Compare>
     inline typename boost::disable_if_c< sizeof(Div_type) <= sizeof(size_t)
-      || sizeof(Div_type) <= sizeof(boost::uintmax_t), void >::type
+      || sizeof(Div_type) <= sizeof(boost::uintmax_t)
+      || is_two_word_integer<Div_type>::value, void >::type
     //defaulting to boost::sort::pdqsort when integer_sort won't work
     integer_sort(RandomAccessIter first, RandomAccessIter last, Div_type,
-                Right_shift /* shift */, Compare comp)
+                Right_shift /* shift */, Compare comp,
+                spreadsort_workspace<RandomAccessIter> * = 0)
     {
       boost::sort::pdqsort(first, last, comp);
     }
 
 
     //Same for the right shift version
-    template <class RandomAccessIter, class Div_type, class Right_shift>
+    template <class Tuning, class RandomAccessIter, class Div_type,
+              class Right_shift>
     //Only use spreadsort if the integer can fit in a size_t
     inline typename boost::enable_if_c< sizeof(Div_type) <= sizeof(size_t),
                                  void >::type
     integer_sort(RandomAccessIter first, RandomAccessIter last, Div_type,
-                Right_shift shift)
+                Right_shift shift,
+                spreadsort_workspace<RandomAccessIter> *workspace = 0)
     {
-      size_t bin_sizes[1 << max_finishing_splits];
-      std::vector<RandomAccessIter> bin_cache;
+      bin_storage<RandomAccessIter, 1 << Tuning::max_finishing_splits>
+        bins(workspace);
       spreadsort_rec<RandomAccessIter, Div_type, Right_shift, size_t,
-          int_log_mean_bin_size, int_log_min_split_count, 
-                        int_log_finishing_count>
-          (first, last, bin_cache, 0, bin_sizes, shift);
+          Tuning::int_log_mean_bin_size, Tuning::int_log_min_split_count,
+          Tuning::int_log_finishing_count, Tuning>
+          (first, last, bins.cache, 0, bins.sizes, shift);
     }
 
-    template <class RandomAccessIter, class Div_type, class Right_shift>
+    template <class Tuning, class RandomAccessIter, class Div_type,
+              class Right_shift>
     //Only use spreadsort if the integer can fit in a uintmax_t
     inline typename boost::enable_if_c< (sizeof(Div_type) > sizeof(size_t))
       && sizeof(Div_type) <= sizeof(boost::uintmax_t), void >::type
     integer_sort(RandomAccessIter first, RandomAccessIter last, Div_type,
-                Right_shift shift)
+                Right_shift shift,
+                spreadsort_workspace<RandomAccessIter> *workspace = 0)
     {
-      size_t bin_sizes[1 << max_finishing_splits];
-      std::vector<RandomAccessIter> bin_cache;
+      bin_storage<RandomAccessIter, 1 << Tuning::max_finishing_splits>
+        bins(workspace);
       spreadsort_rec<RandomAccessIter, Div_type, Right_shift,
-                        boost::uintmax_t, int_log_mean_bin_size,
-                        int_log_min_split_count, int_log_finishing_count>
-          (first, last, bin_cache, 0, bin_sizes, shift);
+                        boost::uintmax_t, Tuning::int_log_mean_bin_size,
+                        Tuning::int_log_min_split_count,
+                        Tuning::int_log_finishing_count, Tuning>
+          (first, last, bins.cache, 0, bins.sizes, shift);
     }
 
-    template <class RandomAccessIter, class Div_type, class Right_shift>
+    template <class Tuning, class RandomAccessIter, class Div_type,
+              class Right_shift>
     inline typename boost::disable_if_c< sizeof(Div_type) <= sizeof(size_t)
-      || sizeof(Div_type) <= sizeof(boost::uintmax_t), void >::type
+      || sizeof(Div_type) <= sizeof(boost::uintmax_t)
+      || is_two_word_integer<Div_type>::value, void >::type
     //defaulting to boost::sort::pdqsort when integer_sort won't work
     integer_sort(RandomAccessIter first, RandomAccessIter last, Div_type,
-                Right_shift /* shift */)
+                Right_shift /* shift */,
+                spreadsort_workspace<RandomAccessIter> * = 0)
     {
       boost::sort::pdqsort(first, last);
     }
+
+    //Shifts word number word of a composite key
+    template <class Data_type, class Word, class Get_word>
+    struct composite_word_shift {
+      composite_word_shift(Get_word get_word_, unsigned word_)
+        : get_word(get_word_), word(word_) {}
+      Word operator()(const Data_type &x, unsigned offset)
+      { return Word(get_word(x, word)) >> offset; }
+      Get_word get_word;
+      unsigned word;
+    };
+
+    //Compares word number word of two composite keys
+    template <class Data_type, class Word, class Get_word>
+    struct composite_word_less {
+      composite_word_less(Get_word get_word_, unsigned word_)
+        : get_word(get_word_), word(word_) {}
+      bool operator()(const Data_type &x, const Data_type &y)
+      { return Word(get_word(x, word)) < Word(get_word(y, word)); }
+      Get_word get_word;
+      unsigned word;
+    };
+
+    //Compares words [word, word_count) of two composite keys in order
+    template <class Data_type, class Word, class Get_word>
+    struct composite_less {
+      composite_less(Get_word get_word_, unsigned word_, unsigned word_count_)
+        : get_word(get_word_), word(word_), word_count(word_count_) {}
+      bool operator()(const Data_type &x, const Data_type &y)
+      {
+        for (unsigned u = word; u < word_count; ++u) {
+          Word x_word = get_word(x, u);
+          Word y_word = get_word(y, u);
+          if (x_word != y_word)
+            return x_word < y_word;
+        }
+        return false;
+      }
+      Get_word get_word;
+      unsigned word, word_count;
+    };
+
+    //Radix sorts on one word at a time, most significant first; each run of
+    //elements with an equal word is then sorted on the next word.
+    //Only ranges below min_sort_size are sorted by comparison.
+    //All the radix sorts share one workspace.
+    template <class Tuning, class RandomAccessIter, class Word, class Get_word>
+    inline void
+    integer_sort_composite(RandomAccessIter first, RandomAccessIter last,
+                           Word, Get_word get_word, unsigned word,
+                           unsigned word_count,
+                           spreadsort_workspace<RandomAccessIter> &workspace)
+    {
+      typedef typename std::iterator_traits<RandomAccessIter>::value_type
+        Data_type;
+      if (last - first < Tuning::min_sort_size) {
+        boost::sort::pdqsort(first, last,
+            composite_less<Data_type, Word, Get_word>(get_word, word,
+                                                      word_count));
+        return;
+      }
+      integer_sort<Tuning>(first, last, Word(0),
+          composite_word_shift<Data_type, Word, Get_word>(get_word, word),
+          composite_word_less<Data_type, Word, Get_word>(get_word, word),
+          &workspace);
+      if (++word == word_count)
+        return;
+      while (first != last) {
+        const Word value = get_word(*first, word - 1);
+        RandomAccessIter run_end = first;
+        while (++run_end != last && Word(get_word(*run_end, word - 1)) == value);
+        if (run_end - first > 1)
+          integer_sort_composite<Tuning>(first, run_end, Word(0), get_word,
+                                         word, word_count, workspace);
+        first = run_end;
+      }
+    }
+
+#ifdef BOOST_HAS_INT128
+    //Splits a 128-bit integer into two 64-bit words, flipping the sign bit of
+    //signed integers so that negative numbers come first
+    template <class Data_type>
+    struct int128_words {
+      boost::uint64_t operator()(const Data_type &x, unsigned word) const
+      {
+        const boost::uint64_t sign_flip =
+          Data_type(-1) < Data_type(0) ? boost::uint64_t(1) << 63 : 0;
+        if (word)
+          return boost::uint64_t(x);
+        return boost::uint64_t(boost::uint128_type(x) >> 64) ^ sign_flip;
+      }
+    };
+
+    template <class Tuning, class RandomAccessIter, class Div_type>
+    inline typename boost::enable_if_c< (sizeof(Div_type) >
+      sizeof(boost::uintmax_t)) && is_two_word_integer<Div_type>::value,
+      void >::type
+    integer_sort(RandomAccessIter first, RandomAccessIter last, Div_type,
+                 spreadsort_workspace<RandomAccessIter> *workspace = 0)
+    {
+      spreadsort_workspace<RandomAccessIter> local_workspace;
+      integer_sort_composite<Tuning>(first, last, boost::uint64_t(0),
+          int128_words<Div_type>(), 0, 2,
+          workspace ? *workspace : local_workspace);
+    }
+
+    //The words of the 128-bit key shift(x, 0) given by a user right shift
+    template <class Div_type, class Right_shift>
+    struct shifted_int128_words {
+      explicit shifted_int128_words(Right_shift shift_) : shift(shift_) {}
+      template <class Data_type>
+      boost::uint64_t operator()(const Data_type &x, unsigned word)
+      { return int128_words<Div_type>()(Div_type(shift(x, 0)), word); }
+      Right_shift shift;
+    };
+
+    //The comparison functor orders the elements as their keys, so the words
+    //of the keys are enough
+    template <class Tuning, class RandomAccessIter, class Div_type,
+              class Right_shift, class Compare>
+    inline typename boost::enable_if_c< (sizeof(Div_type) >
+      sizeof(boost::uintmax_t)) && is_two_word_integer<Div_type>::value,
+      void >::type
+    integer_sort(RandomAccessIter first, RandomAccessIter last, Div_type,
+                 Right_shift shift, Compare /* comp */,
+                 spreadsort_workspace<RandomAccessIter> *workspace = 0)
+    {
+      spreadsort_workspace<RandomAccessIter> local_workspace;
+      integer_sort_composite<Tuning>(first, last, boost::uint64_t(0),
+          shifted_int128_words<Div_type, Right_shift>(shift), 0, 2,
+          workspace ? *workspace : local_workspace);
+    }
+
+    template <class Tuning, class RandomAccessIter, class Div_type,
+              class Right_shift>
+    inline typename boost::enable_if_c< (sizeof(Div_type) >
+      sizeof(boost::uintmax_t)) && is_two_word_integer<Div_type>::value,
+      void >::type
+    integer_sort(RandomAccessIter first, RandomAccessIter last, Div_type,
+                 Right_shift shift,
+                 spreadsort_workspace<RandomAccessIter> *workspace = 0)
+    {
+      spreadsort_workspace<RandomAccessIter> local_workspace;
+      integer_sort_composite<Tuning>(first, last, boost::uint64_t(0),
+          shifted_int128_words<Div_type, Right_shift>(shift), 0, 2,
+          workspace ? *workspace : local_workspace);
+    }
+#endif
   }
 }
 }
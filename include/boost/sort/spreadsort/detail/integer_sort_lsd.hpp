@@ -0,0 +1,130 @@
+// Details for the least-significant-digit radix variant of integer_sort.
+
+//          Copyright Steven J. Ross 2001 - 2014.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// See http://www.boost.org/libs/sort for library home page.
+
+#ifndef BOOST_SORT_SPREADSORT_DETAIL_INTEGER_SORT_LSD_HPP
+#define BOOST_SORT_SPREADSORT_DETAIL_INTEGER_SORT_LSD_HPP
+#include <algorithm>
+#include <vector>
+#include <limits>
+#include <climits>
+#include <iterator>
+#include <boost/sort/spreadsort/detail/constants.hpp>
+
+namespace boost {
+namespace sort {
+namespace spreadsort {
+  namespace detail {
+    //Shifts the value itself, so the key has the width of the value_type
+    struct lsd_default_shift {
+      template <class T>
+      inline T operator()(const T &x, unsigned offset) const {
+        return static_cast<T>(x >> offset);
+      }
+    };
+
+    //Number and width of the digits of a Div_type key
+    template <class Div_type>
+    struct lsd_key_traits {
+      enum { key_bits = sizeof(Div_type) * CHAR_BIT,
+             pass_count = (key_bits + lsd_digit_bits - 1) / lsd_digit_bits,
+             //The most significant digit may be narrower than the others
+             top_bits = key_bits - (pass_count - 1) * lsd_digit_bits };
+    };
+
+    //Returns digit number pass of the key, counting from the least
+    //significant.  The sign bit of a signed key is flipped so that negative
+    //keys sort before positive ones.
+    template <class Div_type, class Data_type, class Right_shift>
+    inline unsigned
+    lsd_get_digit(const Data_type &x, unsigned pass, Right_shift &shift)
+    {
+      typedef lsd_key_traits<Div_type> traits;
+      unsigned digit = static_cast<unsigned>(shift(x, pass * lsd_digit_bits));
+      if (pass + 1 < static_cast<unsigned>(traits::pass_count))
+        return digit & ((1u << lsd_digit_bits) - 1);
+      digit &= (1u << traits::top_bits) - 1;
+      if (std::numeric_limits<Div_type>::is_signed)
+        digit ^= 1u << (traits::top_bits - 1);
+      return digit;
+    }
+
+    //Stably moves [first, last) to out, ordered by digit number pass;
+    //offsets holds the start of each digit's bin and is advanced
+    template <class Div_type, class Source_iter, class Dest_iter,
+              class Right_shift>
+    inline void
+    lsd_scatter(Source_iter first, Source_iter last, Dest_iter out,
+                size_t *offsets, unsigned pass, Right_shift &shift)
+    {
+      for (; first != last; ++first)
+        out[offsets[lsd_get_digit<Div_type>(*first, pass, shift)]++] = *first;
+    }
+
+    //Sorts [first, last) by alternately scattering between it and the
+    //buffer, one digit at a time.  All the digit histograms are taken in one
+    //read pass, and digits that are the same for every key are skipped.
+    template <class RandomAccessIter, class Buffer_iter, class Div_type,
+              class Right_shift>
+    inline void
+    integer_sort_lsd(RandomAccessIter first, RandomAccessIter last,
+                     Buffer_iter buffer, Div_type, Right_shift shift)
+    {
+      const unsigned pass_count = lsd_key_traits<Div_type>::pass_count;
+      const unsigned digit_count = 1u << lsd_digit_bits;
+      const size_t count = last - first;
+      //Too large for the stack with wide keys
+      std::vector<size_t> histograms(pass_count * digit_count, 0);
+      for (RandomAccessIter current = first; current != last; ++current) {
+        for (unsigned pass = 0; pass < pass_count; ++pass)
+          ++histograms[pass * digit_count +
+                       lsd_get_digit<Div_type>(*current, pass, shift)];
+      }
+
+      bool in_buffer = false;
+      size_t offsets[digit_count];
+      for (unsigned pass = 0; pass < pass_count; ++pass) {
+        const size_t *histogram = &histograms[pass * digit_count];
+        //Every key has this digit, so this pass wouldn't change the order.
+        //Any element will do for the check, even one left behind in the
+        //range the data was last moved out of.
+        if (histogram[lsd_get_digit<Div_type>(*first, pass, shift)] == count)
+          continue;
+        size_t total = 0;
+        for (unsigned u = 0; u < digit_count; ++u) {
+          offsets[u] = total;
+          total += histogram[u];
+        }
+        if (in_buffer)
+          lsd_scatter<Div_type>(buffer, buffer + count, first, offsets, pass,
+                                shift);
+        else
+          lsd_scatter<Div_type>(first, last, buffer, offsets, pass, shift);
+        in_buffer = !in_buffer;
+      }
+      if (in_buffer)
+        std::copy(buffer, buffer + count, first);
+    }
+
+    //Allocates the buffer
+    template <class RandomAccessIter, class Div_type, class Right_shift>
+    inline void
+    integer_sort_lsd(RandomAccessIter first, RandomAccessIter last,
+                     Div_type key, Right_shift shift)
+    {
+      typedef typename std::iterator_traits<RandomAccessIter>::value_type
+        Data_type;
+      std::vector<Data_type> buffer(last - first);
+      integer_sort_lsd(first, last, buffer.begin(), key, shift);
+    }
+  }
+}
+}
+}
+
+#endif
@@ -0,0 +1,410 @@
+// Details for the multithreaded Spreadsort-based parallel_float_sort.
+
+//          Copyright Steven J. Ross 2001 - 2014.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// See http://www.boost.org/libs/sort for library home page.
+
+#ifndef BOOST_SORT_SPREADSORT_DETAIL_PARALLEL_FLOAT_SORT_HPP
+#define BOOST_SORT_SPREADSORT_DETAIL_PARALLEL_FLOAT_SORT_HPP
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <vector>
+#include <boost/utility/enable_if.hpp>
+#include <boost/sort/block_indirect_sort/block_indirect_sort.hpp>
+#include <boost/sort/spreadsort/detail/constants.hpp>
+#include <boost/sort/spreadsort/detail/spreadsort_common.hpp>
+#include <boost/sort/spreadsort/detail/integer_sort.hpp>
+#include <boost/sort/spreadsort/detail/float_sort.hpp>
+#include <boost/sort/spreadsort/detail/parallel_spreadsort_common.hpp>
+#include <boost/cstdint.hpp>
+
+namespace boost {
+namespace sort {
+namespace spreadsort {
+  namespace detail {
+    //Casts a float to Div_type and shifts it, like the default float_sort
+    template <class Div_type>
+    struct float_cast_shift {
+      template <class Data_type>
+      inline Div_type operator()(const Data_type &x, unsigned offset) const
+      {
+        return cast_float_iter<Div_type, const Data_type *>(&x) >> offset;
+      }
+    };
+
+    // Return true if the list is sorted.  Otherwise, find the minimum and
+    // maximum keys.  Each of the nthread chunks is scanned with
+    // find_extremes(first, last, max, min), and in_order(prev, current)
+    // checks the chunk boundaries.
+    template <class RandomAccessIter, class Div_type, class Find_extremes,
+              class In_order>
+    inline bool
+    parallel_float_extremes(RandomAccessIter first, RandomAccessIter last,
+                            Div_type & max, Div_type & min,
+                            Find_extremes find_extremes, In_order in_order,
+                            unsigned nthread)
+    {
+      const size_t count = last - first;
+      std::vector<Div_type> maxes(nthread), mins(nthread);
+      std::vector<char> sorted(nthread);
+      parallel_for_threads(nthread, [&](unsigned t) {
+        sorted[t] = find_extremes(first + thread_split(count, t, nthread),
+                                  first + thread_split(count, t + 1, nthread),
+                                  maxes[t], mins[t]);
+      });
+      max = maxes[0];
+      min = mins[0];
+      bool all_sorted = sorted[0];
+      for (unsigned t = 1; t < nthread; ++t) {
+        RandomAccessIter chunk_first = first + thread_split(count, t, nthread);
+        all_sorted = all_sorted && sorted[t] &&
+          in_order(*(chunk_first - 1), *chunk_first);
+        if (max < maxes[t])
+          max = maxes[t];
+        if (mins[t] < min)
+          min = mins[t];
+      }
+      return all_sorted;
+    }
+
+    //Maps a float to the position of its bin, with the negative bins
+    //reversed so they are laid out in ascending order of value
+    template <class Div_type, class Right_shift>
+    struct float_bin {
+      Right_shift rshift;
+      unsigned log_divisor;
+      Div_type div_min;
+      unsigned first_positive;
+
+      float_bin(Right_shift shift, unsigned log_div, Div_type min_value,
+                unsigned positive_bin)
+        : rshift(shift), log_divisor(log_div), div_min(min_value),
+          first_positive(positive_bin) { }
+
+      template <class T>
+      inline unsigned operator()(const T &x)
+      {
+        unsigned bin = unsigned(rshift(x, log_divisor) - div_min);
+        return bin < first_positive ? first_positive - 1 - bin : bin;
+      }
+    };
+
+    //Distributes the top level in parallel, then sorts the bins in parallel
+    //with sort_bin(first, last, is_negative, max_count, bin_cache, bin_sizes)
+    template <class RandomAccessIter, class Div_type, class Size_type,
+              class Right_shift, class Find_extremes, class In_order,
+              class Sort_bin>
+    inline void
+    parallel_float_sort_rec(RandomAccessIter first, RandomAccessIter last,
+                            Right_shift rshift, Find_extremes find_extremes,
+                            In_order in_order, Sort_bin sort_bin,
+                            unsigned nthread)
+    {
+      Div_type max, min;
+      if (parallel_float_extremes(first, last, max, min, find_extremes,
+                                  in_order, nthread))
+        return;
+      unsigned log_divisor = get_log_divisor<float_log_mean_bin_size>(
+          last - first, rough_log_2_size(Size_type(max/2 - min/2)) + 1);
+      Div_type div_min = min >> log_divisor;
+      Div_type div_max = max >> log_divisor;
+      unsigned bin_count = unsigned(div_max - div_min) + 1;
+      //The index of the first positive bin
+      unsigned first_positive = (div_min < 0) ? unsigned(-div_min) : 0;
+      //Resetting if all bins are negative
+      if (first_positive > bin_count)
+        first_positive = bin_count;
+      std::vector<size_t> bin_bounds;
+      parallel_distribute(first, last, bin_count,
+        float_bin<Div_type, Right_shift>(rshift, log_divisor, div_min,
+                                         first_positive),
+        nthread, bin_bounds);
+
+      //Return if we've completed bucketsorting
+      if (!log_divisor)
+        return;
+
+      size_t max_count = get_min_count<float_log_mean_bin_size,
+                                       float_log_min_split_count,
+                                       float_log_finishing_count>(log_divisor);
+      parallel_sort_bins(first, bin_bounds, nthread,
+                         size_t(1) << max_finishing_splits,
+        [&](RandomAccessIter lo, RandomAccessIter hi, unsigned bin,
+            std::vector<RandomAccessIter> &bin_cache, size_t *bin_sizes) {
+          sort_bin(lo, hi, bin < first_positive, max_count, bin_cache,
+                   bin_sizes);
+        },
+        [&](RandomAccessIter lo, RandomAccessIter hi, unsigned) {
+          parallel_float_sort_rec<RandomAccessIter, Div_type, Size_type>(lo,
+            hi, rshift, find_extremes, in_order, sort_bin,
+            get_thread_count(hi - lo, nthread));
+        });
+    }
+
+    //Casting version for float and double, with the same bin recursion
+    //as float_sort_rec
+    template <class RandomAccessIter, class Div_type, class Size_type>
+    inline void
+    parallel_float_sort_cast(RandomAccessIter first, RandomAccessIter last,
+                             unsigned nthread)
+    {
+      typedef typename std::iterator_traits<RandomAccessIter>::value_type
+        Data_type;
+      nthread = get_thread_count(last - first, nthread);
+      if (nthread < 2) {
+        size_t bin_sizes[1 << max_finishing_splits];
+        std::vector<RandomAccessIter> bin_cache;
+        float_sort_rec<RandomAccessIter, Div_type, Size_type, default_tuning>
+          (first, last, bin_cache, 0, bin_sizes);
+        return;
+      }
+      parallel_float_sort_rec<RandomAccessIter, Div_type, Size_type>(first,
+        last, float_cast_shift<Div_type>(),
+        [](RandomAccessIter lo, RandomAccessIter hi, Div_type &max,
+           Div_type &min) {
+          return is_sorted_or_find_extremes<RandomAccessIter, Div_type>(lo,
+            hi, max, min);
+        },
+        [](const Data_type &prev, const Data_type &current) {
+          return current >= prev;
+        },
+        [](RandomAccessIter lo, RandomAccessIter hi, bool negative,
+           size_t max_count, std::vector<RandomAccessIter> &bin_cache,
+           size_t *bin_sizes) {
+          if (size_t(hi - lo) < max_count)
+            boost::sort::pdqsort(lo, hi);
+          //sort negative values using reversed-bin spreadsort
+          else if (negative)
+            negative_float_sort_rec<RandomAccessIter, Div_type, Size_type,
+                                    default_tuning>
+              (lo, hi, bin_cache, 0, bin_sizes);
+          //sort positive values using normal spreadsort
+          else
+            positive_float_sort_rec<RandomAccessIter, Div_type, Size_type,
+                                    default_tuning>
+              (lo, hi, bin_cache, 0, bin_sizes);
+        }, nthread);
+    }
+
+    //Checking whether the value type is a float, and trying a 32-bit integer
+    template <class RandomAccessIter>
+    inline typename boost::enable_if_c< sizeof(boost::uint32_t) ==
+      sizeof(typename std::iterator_traits<RandomAccessIter>::value_type)
+      && std::numeric_limits<typename
+      std::iterator_traits<RandomAccessIter>::value_type>::is_iec559,
+      void >::type
+    parallel_float_sort(RandomAccessIter first, RandomAccessIter last,
+                        unsigned nthread)
+    {
+      parallel_float_sort_cast<RandomAccessIter, boost::int32_t,
+                               boost::uint32_t>(first, last, nthread);
+    }
+
+    //Checking whether the value type is a double, and using a 64-bit integer
+    template <class RandomAccessIter>
+    inline typename boost::enable_if_c< sizeof(boost::uint64_t) ==
+      sizeof(typename std::iterator_traits<RandomAccessIter>::value_type)
+      && std::numeric_limits<typename
+      std::iterator_traits<RandomAccessIter>::value_type>::is_iec559,
+      void >::type
+    parallel_float_sort(RandomAccessIter first, RandomAccessIter last,
+                        unsigned nthread)
+    {
+      parallel_float_sort_cast<RandomAccessIter, boost::int64_t,
+                               boost::uint64_t>(first, last, nthread);
+    }
+
+    template <class RandomAccessIter>
+    inline typename boost::disable_if_c< (sizeof(boost::uint64_t) ==
+      sizeof(typename std::iterator_traits<RandomAccessIter>::value_type)
+      || sizeof(boost::uint32_t) ==
+      sizeof(typename std::iterator_traits<RandomAccessIter>::value_type))
+      && std::numeric_limits<typename
+      std::iterator_traits<RandomAccessIter>::value_type>::is_iec559,
+      void >::type
+    parallel_float_sort(RandomAccessIter first, RandomAccessIter last,
+                        unsigned nthread)
+    {
+      BOOST_STATIC_ASSERT(!(sizeof(boost::uint64_t) ==
+      sizeof(typename std::iterator_traits<RandomAccessIter>::value_type)
+      || sizeof(boost::uint32_t) ==
+      sizeof(typename std::iterator_traits<RandomAccessIter>::value_type))
+      || !std::numeric_limits<typename
+      std::iterator_traits<RandomAccessIter>::value_type>::is_iec559);
+      boost::sort::block_indirect_sort(first, last, nthread);
+    }
+
+    //Functor version with the same bin recursion as float_sort_rec
+    template <class RandomAccessIter, class Div_type, class Size_type,
+              class Right_shift, class Compare>
+    inline void
+    parallel_float_sort_functor(RandomAccessIter first, RandomAccessIter last,
+                                Right_shift rshift, Compare comp,
+                                unsigned nthread)
+    {
+      typedef typename std::iterator_traits<RandomAccessIter>::value_type
+        Data_type;
+      nthread = get_thread_count(last - first, nthread);
+      if (nthread < 2) {
+        size_t bin_sizes[1 << max_finishing_splits];
+        std::vector<RandomAccessIter> bin_cache;
+        float_sort_rec<RandomAccessIter, Div_type, Right_shift, Compare,
+          Size_type, default_tuning>(first, last, bin_cache, 0, bin_sizes,
+                                     rshift, comp);
+        return;
+      }
+      parallel_float_sort_rec<RandomAccessIter, Div_type, Size_type>(first,
+        last, rshift,
+        [=](RandomAccessIter lo, RandomAccessIter hi, Div_type &max,
+            Div_type &min) {
+          return is_sorted_or_find_extremes(lo, hi, max, min, rshift, comp);
+        },
+        [=](const Data_type &prev, const Data_type &current) {
+          return !comp(current, prev);
+        },
+        [=](RandomAccessIter lo, RandomAccessIter hi, bool negative,
+            size_t max_count, std::vector<RandomAccessIter> &bin_cache,
+            size_t *bin_sizes) {
+          if (size_t(hi - lo) < max_count)
+            boost::sort::pdqsort(lo, hi, comp);
+          //sort negative values using reversed-bin spreadsort
+          else if (negative)
+            negative_float_sort_rec<RandomAccessIter, Div_type, Right_shift,
+              Compare, Size_type, default_tuning>(lo, hi, bin_cache, 0,
+                                                  bin_sizes, rshift, comp);
+          //sort positive values using normal spreadsort
+          else
+            spreadsort_rec<RandomAccessIter, Div_type, Right_shift, Compare,
+                           Size_type, float_log_mean_bin_size,
+                           float_log_min_split_count,
+                           float_log_finishing_count, default_tuning>
+              (lo, hi, bin_cache, 0, bin_sizes, rshift, comp);
+        }, nthread);
+    }
+
+    //Functor version using < for comparisons
+    template <class RandomAccessIter, class Div_type, class Size_type,
+              class Right_shift>
+    inline void
+    parallel_float_sort_functor(RandomAccessIter first, RandomAccessIter last,
+                                Right_shift rshift, unsigned nthread)
+    {
+      typedef typename std::iterator_traits<RandomAccessIter>::value_type
+        Data_type;
+      nthread = get_thread_count(last - first, nthread);
+      if (nthread < 2) {
+        size_t bin_sizes[1 << max_finishing_splits];
+        std::vector<RandomAccessIter> bin_cache;
+        float_sort_rec<RandomAccessIter, Div_type, Right_shift, Size_type,
+                       default_tuning>
+          (first, last, bin_cache, 0, bin_sizes, rshift);
+        return;
+      }
+      parallel_float_sort_rec<RandomAccessIter, Div_type, Size_type>(first,
+        last, rshift,
+        [=](RandomAccessIter lo, RandomAccessIter hi, Div_type &max,
+            Div_type &min) {
+          return is_sorted_or_find_extremes(lo, hi, max, min, rshift);
+        },
+        [](const Data_type &prev, const Data_type &current) {
+          return current >= prev;
+        },
+        [=](RandomAccessIter lo, RandomAccessIter hi, bool negative,
+            size_t max_count, std::vector<RandomAccessIter> &bin_cache,
+            size_t *bin_sizes) {
+          if (size_t(hi - lo) < max_count)
+            boost::sort::pdqsort(lo, hi);
+          //sort negative values using reversed-bin spreadsort
+          else if (negative)
+            negative_float_sort_rec<RandomAccessIter, Div_type, Right_shift,
+              Size_type, default_tuning>(lo, hi, bin_cache, 0, bin_sizes,
+                                         rshift);
+          //sort positive values using normal spreadsort
+          else
+            spreadsort_rec<RandomAccessIter, Div_type, Right_shift, Size_type,
+                           float_log_mean_bin_size, float_log_min_split_count,
+                           float_log_finishing_count, default_tuning>
+              (lo, hi, bin_cache, 0, bin_sizes, rshift);
+        }, nthread);
+    }
+
+    //These approaches require the user to do the typecast
+    //with rshift but default comparision
+    template <class RandomAccessIter, class Div_type, class Right_shift>
+    inline typename boost::enable_if_c< sizeof(size_t) >= sizeof(Div_type),
+      void >::type
+    parallel_float_sort(RandomAccessIter first, RandomAccessIter last,
+                        Div_type, Right_shift rshift, unsigned nthread)
+    {
+      parallel_float_sort_functor<RandomAccessIter, Div_type, size_t>
+        (first, last, rshift, nthread);
+    }
+
+    //maximum integer size with rshift but default comparision
+    template <class RandomAccessIter, class Div_type, class Right_shift>
+    inline typename boost::enable_if_c< sizeof(size_t) < sizeof(Div_type)
+      && sizeof(boost::uintmax_t) >= sizeof(Div_type), void >::type
+    parallel_float_sort(RandomAccessIter first, RandomAccessIter last,
+                        Div_type, Right_shift rshift, unsigned nthread)
+    {
+      parallel_float_sort_functor<RandomAccessIter, Div_type,
+        boost::uintmax_t>(first, last, rshift, nthread);
+    }
+
+    //sizeof(Div_type) doesn't match, so use boost::sort::block_indirect_sort
+    template <class RandomAccessIter, class Div_type, class Right_shift>
+    inline typename boost::disable_if_c< sizeof(boost::uintmax_t) >=
+      sizeof(Div_type), void >::type
+    parallel_float_sort(RandomAccessIter first, RandomAccessIter last,
+                        Div_type, Right_shift /* rshift */, unsigned nthread)
+    {
+      boost::sort::block_indirect_sort(first, last, nthread);
+    }
+
+    //specialized comparison
+    template <class RandomAccessIter, class Div_type, class Right_shift,
+              class Compare>
+    inline typename boost::enable_if_c< sizeof(size_t) >= sizeof(Div_type),
+      void >::type
+    parallel_float_sort(RandomAccessIter first, RandomAccessIter last,
+                        Div_type, Right_shift rshift, Compare comp,
+                        unsigned nthread)
+    {
+      parallel_float_sort_functor<RandomAccessIter, Div_type, size_t>
+        (first, last, rshift, comp, nthread);
+    }
+
+    //max-sized integer with specialized comparison
+    template <class RandomAccessIter, class Div_type, class Right_shift,
+              class Compare>
+    inline typename boost::enable_if_c< sizeof(size_t) < sizeof(Div_type)
+      && sizeof(boost::uintmax_t) >= sizeof(Div_type), void >::type
+    parallel_float_sort(RandomAccessIter first, RandomAccessIter last,
+                        Div_type, Right_shift rshift, Compare comp,
+                        unsigned nthread)
+    {
+      parallel_float_sort_functor<RandomAccessIter, Div_type,
+        boost::uintmax_t>(first, last, rshift, comp, nthread);
+    }
+
+    //sizeof(Div_type) doesn't match, so use boost::sort::block_indirect_sort
+    template <class RandomAccessIter, class Div_type, class Right_shift,
+              class Compare>
+    inline typename boost::disable_if_c< sizeof(boost::uintmax_t) >=
+      sizeof(Div_type), void >::type
+    parallel_float_sort(RandomAccessIter first, RandomAccessIter last,
+                        Div_type, Right_shift /* rshift */, Compare comp,
+                        unsigned nthread)
+    {
+      boost::sort::block_indirect_sort(first, last, comp, nthread);
+    }
+  }
+}
+}
+}
+
+#endif
@@ -0,0 +1,261 @@
+// Details for the multithreaded Spreadsort-based parallel_integer_sort.
+
+//          Copyright Steven J. Ross 2001 - 2014.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// See http://www.boost.org/libs/sort for library home page.
+
+#ifndef BOOST_SORT_SPREADSORT_DETAIL_PARALLEL_INTEGER_SORT_HPP
+#define BOOST_SORT_SPREADSORT_DETAIL_PARALLEL_INTEGER_SORT_HPP
+#include <algorithm>
+#include <vector>
+#include <iterator>
+#include <functional>
+#include <boost/utility/enable_if.hpp>
+#include <boost/sort/block_indirect_sort/block_indirect_sort.hpp>
+#include <boost/sort/spreadsort/detail/constants.hpp>
+#include <boost/sort/spreadsort/detail/spreadsort_common.hpp>
+#include <boost/sort/spreadsort/detail/integer_sort.hpp>
+#include <boost/sort/spreadsort/detail/parallel_spreadsort_common.hpp>
+#include <boost/cstdint.hpp>
+
+namespace boost {
+namespace sort {
+namespace spreadsort {
+  namespace detail {
+    //Right shift used when none is supplied
+    struct default_right_shift {
+      template <class T>
+      inline auto operator()(const T &x, unsigned offset) const
+        -> decltype(x >> offset)
+      {
+        return x >> offset;
+      }
+    };
+
+    // Return true if the list is sorted.  Otherwise, find the minimum and
+    // maximum, splitting the work across nthread threads.
+    // Each thread needs at least 2 elements.
+    template <class RandomAccessIter, class Compare>
+    inline bool
+    parallel_is_sorted_or_find_extremes(RandomAccessIter first,
+                RandomAccessIter last, RandomAccessIter & max,
+                RandomAccessIter & min, Compare comp, unsigned nthread)
+    {
+      const size_t count = last - first;
+      std::vector<RandomAccessIter> maxes(nthread), mins(nthread);
+      std::vector<char> sorted(nthread);
+      parallel_for_threads(nthread, [&](unsigned t) {
+        RandomAccessIter chunk_first = first + thread_split(count, t, nthread);
+        RandomAccessIter chunk_last =
+          first + thread_split(count, t + 1, nthread);
+        sorted[t] = is_sorted_or_find_extremes(chunk_first, chunk_last,
+                                               maxes[t], mins[t], comp);
+        //A sorted chunk reports its first element as both extremes
+        if (sorted[t])
+          maxes[t] = chunk_last - 1;
+      });
+      bool all_sorted = true;
+      for (unsigned t = 0; t < nthread && all_sorted; ++t)
+        all_sorted = sorted[t] && (!t ||
+          !comp(*(first + thread_split(count, t, nthread)),
+                *(first + thread_split(count, t, nthread) - 1)));
+      if (all_sorted)
+        return true;
+
+      max = maxes[0];
+      min = mins[0];
+      for (unsigned t = 1; t < nthread; ++t) {
+        if (comp(*max, *maxes[t]))
+          max = maxes[t];
+        if (comp(*mins[t], *min))
+          min = mins[t];
+      }
+      return false;
+    }
+
+    //Maps an element to its bin for a given shift and minimum
+    template <class Div_type, class Right_shift>
+    struct int_bin {
+      Right_shift rshift;
+      unsigned log_divisor;
+      Div_type div_min;
+
+      int_bin(Right_shift shift, unsigned log_div, Div_type min_value)
+        : rshift(shift), log_divisor(log_div), div_min(min_value) { }
+
+      template <class T>
+      inline unsigned operator()(const T &x)
+      {
+        return unsigned(rshift(x, log_divisor) - div_min);
+      }
+    };
+
+    //Only integers sorted with the default shift and comparison can be
+    //rebuilt from their counts
+    template <class RandomAccessIter, class Right_shift, class Compare>
+    inline bool
+    parallel_counting_sort(RandomAccessIter, RandomAccessIter,
+                           RandomAccessIter, RandomAccessIter, Right_shift,
+                           Compare, unsigned)
+    {
+      return false;
+    }
+
+    //Counting sort as in integer_sort: each thread counts its chunk, and
+    //then rewrites its chunk from the summed counts
+    template <class RandomAccessIter>
+    inline typename boost::enable_if_c<is_counting_type<typename
+      std::iterator_traits<RandomAccessIter>::value_type>::value, bool>::type
+    parallel_counting_sort(RandomAccessIter first, RandomAccessIter last,
+      RandomAccessIter max, RandomAccessIter min, default_right_shift,
+      std::less<typename std::iterator_traits<RandomAccessIter>::value_type>,
+      unsigned nthread)
+    {
+      typedef typename std::iterator_traits<RandomAccessIter>::value_type
+        Data_type;
+      const size_t count = last - first;
+      const Data_type min_value = *min;
+      const size_t bin_count = counting_range(min_value, *max, count);
+      if (!bin_count)
+        return false;
+      std::vector<size_t> counts(bin_count * nthread);
+      parallel_for_threads(nthread, [&](unsigned t) {
+        count_bins(first + thread_split(count, t, nthread),
+                   first + thread_split(count, t + 1, nthread),
+                   &counts[t * bin_count], unsigned(bin_count),
+                   shift_bin<RandomAccessIter, Data_type>(0, min_value));
+      });
+      //starts[u] is the position of the first element of value u
+      std::vector<size_t> starts(bin_count + 1);
+      for (size_t u = 0; u < bin_count; ++u) {
+        size_t total = 0;
+        for (unsigned t = 0; t < nthread; ++t)
+          total += counts[t * bin_count + u];
+        starts[u + 1] = starts[u] + total;
+      }
+      parallel_for_threads(nthread, [&](unsigned t) {
+        size_t position = thread_split(count, t, nthread);
+        const size_t end = thread_split(count, t + 1, nthread);
+        size_t u = std::upper_bound(starts.begin(), starts.end(), position)
+                   - starts.begin() - 1;
+        for (; position < end; ++u) {
+          const size_t stop = (std::min)(end, starts[u + 1]);
+          std::fill(first + position, first + stop,
+                    counting_value(min_value, u));
+          position = stop;
+        }
+      });
+      return true;
+    }
+
+    //Distributes the top level in parallel, then sorts the bins in parallel
+    template <class RandomAccessIter, class Div_type, class Right_shift,
+              class Compare, class Size_type>
+    inline void
+    parallel_spreadsort_rec(RandomAccessIter first, RandomAccessIter last,
+                            Right_shift rshift, Compare comp, unsigned nthread)
+    {
+      RandomAccessIter max, min;
+      if (parallel_is_sorted_or_find_extremes(first, last, max, min, comp,
+                                              nthread))
+        return;
+      //Few distinct integers are counted instead of binned
+      if (parallel_counting_sort(first, last, max, min, rshift, comp,
+                                 nthread))
+        return;
+      unsigned log_divisor = get_log_divisor<int_log_mean_bin_size>(
+          last - first,
+          rough_log_2_size(Size_type(rshift(*max, 0) - rshift(*min, 0))));
+      Div_type div_min = rshift(*min, log_divisor);
+      Div_type div_max = rshift(*max, log_divisor);
+      unsigned bin_count = unsigned(div_max - div_min) + 1;
+      std::vector<size_t> bin_bounds;
+      parallel_distribute(first, last, bin_count,
+        int_bin<Div_type, Right_shift>(rshift, log_divisor, div_min), nthread,
+        bin_bounds);
+
+      //If we've bucketsorted, the array is sorted
+      if (!log_divisor)
+        return;
+
+      size_t max_count = get_min_count<int_log_mean_bin_size,
+                          int_log_min_split_count,
+                          int_log_finishing_count>(log_divisor);
+      parallel_sort_bins(first, bin_bounds, nthread,
+                         size_t(1) << max_finishing_splits,
+        [&](RandomAccessIter lo, RandomAccessIter hi, unsigned,
+            std::vector<RandomAccessIter> &bin_cache, size_t *bin_sizes) {
+          if (size_t(hi - lo) < max_count)
+            boost::sort::pdqsort(lo, hi, comp);
+          else
+            spreadsort_rec<RandomAccessIter, Div_type, Right_shift, Compare,
+                           Size_type, int_log_mean_bin_size,
+                           int_log_min_split_count, int_log_finishing_count,
+                           default_tuning>
+              (lo, hi, bin_cache, 0, bin_sizes, rshift, comp);
+        },
+        [&](RandomAccessIter lo, RandomAccessIter hi, unsigned) {
+          if (size_t(hi - lo) < max_count)
+            boost::sort::block_indirect_sort(lo, hi, comp, nthread);
+          else
+            parallel_spreadsort_rec<RandomAccessIter, Div_type, Right_shift,
+              Compare, Size_type>(lo, hi, rshift, comp,
+                                  get_thread_count(hi - lo, nthread));
+        });
+    }
+
+    //Only use spreadsort if the integer can fit in a size_t
+    template <class RandomAccessIter, class Div_type, class Right_shift,
+              class Compare>
+    inline typename boost::enable_if_c< sizeof(Div_type) <= sizeof(size_t),
+                                 void >::type
+    parallel_integer_sort(RandomAccessIter first, RandomAccessIter last,
+                          Div_type div_type, Right_shift shift, Compare comp,
+                          unsigned nthread)
+    {
+      nthread = get_thread_count(last - first, nthread);
+      if (nthread < 2)
+        integer_sort<default_tuning>(first, last, div_type, shift, comp);
+      else
+        parallel_spreadsort_rec<RandomAccessIter, Div_type, Right_shift,
+          Compare, size_t>(first, last, shift, comp, nthread);
+    }
+
+    //Only use spreadsort if the integer can fit in a uintmax_t
+    template <class RandomAccessIter, class Div_type, class Right_shift,
+              class Compare>
+    inline typename boost::enable_if_c< (sizeof(Div_type) > sizeof(size_t))
+      && sizeof(Div_type) <= sizeof(boost::uintmax_t), void >::type
+    parallel_integer_sort(RandomAccessIter first, RandomAccessIter last,
+                          Div_type div_type, Right_shift shift, Compare comp,
+                          unsigned nthread)
+    {
+      nthread = get_thread_count(last - first, nthread);
+      if (nthread < 2)
+        integer_sort<default_tuning>(first, last, div_type, shift, comp);
+      else
+        parallel_spreadsort_rec<RandomAccessIter, Div_type, Right_shift,
+          Compare, boost::uintmax_t>(first, last, shift, comp, nthread);
+    }
+
+    //defaulting to boost::sort::block_indirect_sort when integer_sort won't
+    //work
+    template <class RandomAccessIter, class Div_type, class Right_shift,
+              class Compare>
+    inline typename boost::disable_if_c< sizeof(Div_type) <= sizeof(size_t)
+      || sizeof(Div_type) <= sizeof(boost::uintmax_t), void >::type
+    parallel_integer_sort(RandomAccessIter first, RandomAccessIter last,
+                          Div_type, Right_shift /* shift */, Compare comp,
+                          unsigned nthread)
+    {
+      boost::sort::block_indirect_sort(first, last, comp, nthread);
+    }
+  }
+}
+}
+}
+
+#endif
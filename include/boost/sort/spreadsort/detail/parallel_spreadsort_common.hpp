@@ -0,0 +1,257 @@
+// Multithreaded building blocks shared by the parallel spreadsort variants:
+// thread launching, in-place parallel distribution into bins, and scheduling
+// of the resulting bins across threads.
+
+//          Copyright Steven J. Ross 2001 - 2014.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// See http://www.boost.org/libs/sort for library home page.
+
+/*
+The in-place distribution follows the PARADIS approach:
+Cho, Brand, Bordawekar, Finkler, Kulandaisamy and Puri,
+"PARADIS: An Efficient Parallel Algorithm for In-place Radix Sort", VLDB 2015
+*/
+
+#ifndef BOOST_SORT_SPREADSORT_DETAIL_PARALLEL_SPREADSORT_COMMON_HPP
+#define BOOST_SORT_SPREADSORT_DETAIL_PARALLEL_SPREADSORT_COMMON_HPP
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <future>
+#include <iterator>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <boost/sort/common/thread_pool.hpp>
+#include <boost/sort/spreadsort/detail/constants.hpp>
+#include <boost/sort/spreadsort/detail/spreadsort_common.hpp>
+
+namespace boost {
+namespace sort {
+namespace spreadsort {
+  namespace detail {
+    //Limits the number of threads so each one has enough elements to be
+    //worth starting.  A result below 2 means sort with the calling thread.
+    inline unsigned
+    get_thread_count(size_t count, unsigned nthread)
+    {
+      size_t max_thread = count / parallel_min_thread_size;
+      if (nthread > max_thread)
+        nthread = static_cast<unsigned>(max_thread);
+      return nthread ? nthread : 1;
+    }
+
+    //Runs func(thread_index) for every index in [0, nthread); index 0 runs
+    //on the calling thread, or all of them on the installed thread_pool.
+    //All the threads are joined before returning, and the first exception
+    //thrown by any of them is rethrown.
+    template <class Func>
+    inline void
+    parallel_for_threads(unsigned nthread, Func func)
+    {
+      boost::sort::common::run_threads(nthread, func);
+    }
+
+    //Position of the start of the part of [0, count) handled by thread
+    //index when split evenly across nthread threads.
+    inline size_t
+    thread_split(size_t count, unsigned index, unsigned nthread)
+    {
+      return static_cast<size_t>(
+        (static_cast<boost::uintmax_t>(count) * index) / nthread);
+    }
+
+    //Moves every element of [first, last) into its bin, in place, using
+    //nthread threads.  get_bin(x) returns the bin of x, in [0, bin_count).
+    //On return bin u is [first + bin_bounds[u], first + bin_bounds[u + 1]).
+    //
+    //Each thread counts its own chunk.  Then every thread gets a stripe of
+    //each bin's unfilled space and swaps elements into place within its own
+    //stripes, leaving the ones it can't place at the end of each stripe.
+    //The leftovers are gathered at the end of each bin and the pass repeats
+    //on them while it keeps making progress; the small remainder is swapped
+    //into place serially like the single-threaded swap loop.
+    template <class RandomAccessIter, class Get_bin>
+    inline void
+    parallel_distribute(RandomAccessIter first, RandomAccessIter last,
+                        unsigned bin_count, Get_bin get_bin, unsigned nthread,
+                        std::vector<size_t> &bin_bounds)
+    {
+      const size_t count = last - first;
+      //Calculating the size of each bin; each thread counts its own chunk
+      std::vector<size_t> thread_sizes(size_t(nthread) * bin_count, 0);
+      parallel_for_threads(nthread, [&](unsigned t) {
+        Get_bin bin_of = get_bin;
+        size_t *sizes = &thread_sizes[size_t(t) * bin_count];
+        RandomAccessIter chunk_end = first + thread_split(count, t + 1,
+                                                          nthread);
+        for (RandomAccessIter current = first + thread_split(count, t,
+             nthread); current != chunk_end; ++current)
+          sizes[bin_of(*current)]++;
+      });
+      bin_bounds.assign(bin_count + 1, 0);
+      for (unsigned u = 0; u < bin_count; ++u) {
+        size_t bin_size = 0;
+        for (unsigned t = 0; t < nthread; ++t)
+          bin_size += thread_sizes[size_t(t) * bin_count + u];
+        bin_bounds[u + 1] = bin_bounds[u] + bin_size;
+      }
+
+      //heads[u] is the first position of bin u that may hold an element
+      //belonging to another bin
+      std::vector<size_t> heads(bin_bounds.begin(), bin_bounds.end() - 1);
+      //stripe_heads and stripe_ends hold each thread's stripe of every bin
+      std::vector<size_t> &stripe_heads = thread_sizes;
+      std::vector<size_t> stripe_ends(size_t(nthread) * bin_count);
+      size_t remaining = count;
+      while (remaining >= parallel_min_thread_size) {
+        for (unsigned u = 0; u < bin_count; ++u) {
+          size_t space = bin_bounds[u + 1] - heads[u];
+          for (unsigned t = 0; t < nthread; ++t) {
+            stripe_heads[size_t(t) * bin_count + u] =
+              heads[u] + thread_split(space, t, nthread);
+            stripe_ends[size_t(t) * bin_count + u] =
+              heads[u] + thread_split(space, t + 1, nthread);
+          }
+        }
+
+        //Swap into place; elements are only exchanged between the stripes
+        //of one thread, so no locking is needed
+        parallel_for_threads(nthread, [&](unsigned t) {
+          Get_bin bin_of = get_bin;
+          size_t *bins = &stripe_heads[size_t(t) * bin_count];
+          const size_t *bin_ends = &stripe_ends[size_t(t) * bin_count];
+          for (unsigned u = 0; u < bin_count; ++u) {
+            //[stripe start, bins[u]) holds elements of bin u, and
+            //[bins[u], current) elements that couldn't be placed
+            for (size_t current = bins[u]; current < bin_ends[u];
+                ++current) {
+              unsigned target = bin_of(*(first + current));
+              while (target != u && bins[target] < bin_ends[target]) {
+                std::iter_swap(first + current, first + bins[target]++);
+                target = bin_of(*(first + current));
+              }
+              if (target == u) {
+                if (current != bins[u])
+                  std::iter_swap(first + current, first + bins[u]);
+                ++bins[u];
+              }
+            }
+          }
+        });
+
+        //Gather the elements placed in each stripe at the start of their bin
+        std::vector<size_t> placed(nthread, 0);
+        parallel_for_threads(nthread, [&](unsigned t) {
+          for (unsigned u = t; u < bin_count; u += nthread) {
+            size_t space = bin_bounds[u + 1] - heads[u];
+            if (!space)
+              continue;
+            size_t bin_placed = 0;
+            for (unsigned v = 0; v < nthread; ++v)
+              bin_placed += stripe_heads[size_t(v) * bin_count + u] -
+                (heads[u] + thread_split(space, v, nthread));
+            const size_t new_head = heads[u] + bin_placed;
+            //Unplaced elements before new_head are exchanged with placed
+            //elements after it; there are as many of one as of the other
+            std::vector<std::pair<size_t, size_t> > unplaced, misplaced;
+            for (unsigned v = 0; v < nthread; ++v) {
+              size_t start = heads[u] + thread_split(space, v, nthread);
+              size_t mid = stripe_heads[size_t(v) * bin_count + u];
+              size_t end = stripe_ends[size_t(v) * bin_count + u];
+              if (mid < (std::min)(end, new_head))
+                unplaced.push_back(std::make_pair(mid, (std::min)(end,
+                                                                  new_head)));
+              if (mid > (std::max)(start, new_head))
+                misplaced.push_back(std::make_pair((std::max)(start,
+                                                              new_head), mid));
+            }
+            size_t lo_range = 0, hi_range = 0;
+            while (lo_range < unplaced.size() && hi_range < misplaced.size()) {
+              std::pair<size_t, size_t> &lo = unplaced[lo_range];
+              std::pair<size_t, size_t> &hi = misplaced[hi_range];
+              std::iter_swap(first + lo.first++, first + hi.first++);
+              if (lo.first == lo.second)
+                ++lo_range;
+              if (hi.first == hi.second)
+                ++hi_range;
+            }
+            heads[u] = new_head;
+            placed[t] += bin_placed;
+          }
+        });
+        size_t total_placed = 0;
+        for (unsigned t = 0; t < nthread; ++t)
+          total_placed += placed[t];
+        remaining -= total_placed;
+        //Stop once a pass places less than half of what was left
+        if (total_placed * 2 < remaining + total_placed)
+          break;
+      }
+
+      //Swap the remainder into place with a single thread
+      for (unsigned u = 0; u < bin_count; ++u) {
+        while (heads[u] < bin_bounds[u + 1]) {
+          unsigned target = get_bin(*(first + heads[u]));
+          if (target == u)
+            ++heads[u];
+          else
+            std::iter_swap(first + heads[u], first + heads[target]++);
+        }
+      }
+    }
+
+    //Sorts the bins produced by parallel_distribute.  Bins too big for one
+    //thread are passed to split_bin(bin_first, bin_last, bin), one at a
+    //time, to be sorted with every thread.  The rest are handed out largest
+    //first and sorted by
+    //sort_bin(bin_first, bin_last, bin, bin_cache, bin_sizes), where
+    //bin_cache and bin_sizes (bin_sizes_count long) belong to the thread.
+    template <class RandomAccessIter, class Sort_bin, class Split_bin>
+    inline void
+    parallel_sort_bins(RandomAccessIter first,
+                       const std::vector<size_t> &bin_bounds, unsigned nthread,
+                       size_t bin_sizes_count, Sort_bin sort_bin,
+                       Split_bin split_bin)
+    {
+      const unsigned bin_count = unsigned(bin_bounds.size() - 1);
+      const size_t max_thread_count = bin_bounds.back() / nthread;
+      std::vector<unsigned> jobs;
+      jobs.reserve(bin_count);
+      for (unsigned u = 0; u < bin_count; ++u) {
+        size_t count = bin_bounds[u + 1] - bin_bounds[u];
+        //don't sort unless there are at least two items to Compare
+        if (count < 2)
+          continue;
+        if (count > max_thread_count &&
+            get_thread_count(count, nthread) > 1)
+          split_bin(first + bin_bounds[u], first + bin_bounds[u + 1], u);
+        else
+          jobs.push_back(u);
+      }
+      std::sort(jobs.begin(), jobs.end(), [&](unsigned x, unsigned y) {
+        return bin_bounds[x + 1] - bin_bounds[x] >
+          bin_bounds[y + 1] - bin_bounds[y];
+      });
+
+      std::atomic<size_t> next_job(0);
+      parallel_for_threads(nthread, [&](unsigned) {
+        Sort_bin sort_one = sort_bin;
+        std::vector<RandomAccessIter> bin_cache;
+        std::vector<size_t> bin_sizes(bin_sizes_count);
+        for (size_t job = next_job++; job < jobs.size(); job = next_job++) {
+          unsigned u = jobs[job];
+          sort_one(first + bin_bounds[u], first + bin_bounds[u + 1], u,
+                   bin_cache, &bin_sizes[0]);
+        }
+      });
+    }
+  }
+}
+}
+}
+
+#endif
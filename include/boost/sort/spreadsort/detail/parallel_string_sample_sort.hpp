@@ -0,0 +1,374 @@
+// Details for parallel_string_sample_sort, a multithreaded string sample
+// sort that keeps track of the prefixes it knows the strings share.
+
+//          Copyright Steven J. Ross 2001 - 2014.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// See http://www.boost.org/libs/sort for library home page.
+
+/*
+The splitter classification follows parallel super scalar string sample sort:
+Bingmann and Sanders, "Parallel String Sample Sort", ESA 2013
+*/
+
+#ifndef BOOST_SORT_SPREADSORT_DETAIL_PARALLEL_STRING_SAMPLE_SORT_HPP
+#define BOOST_SORT_SPREADSORT_DETAIL_PARALLEL_STRING_SAMPLE_SORT_HPP
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <utility>
+#include <vector>
+#include <boost/cstdint.hpp>
+#include <boost/utility/enable_if.hpp>
+#include <boost/sort/block_indirect_sort/block_indirect_sort.hpp>
+#include <boost/sort/spreadsort/detail/constants.hpp>
+#include <boost/sort/spreadsort/detail/string_sort.hpp>
+#include <boost/sort/spreadsort/detail/parallel_spreadsort_common.hpp>
+#include <boost/sort/spreadsort/detail/parallel_string_sort.hpp>
+
+namespace boost {
+namespace sort {
+namespace spreadsort {
+  namespace detail {
+    //Compares x with y, both known to match up to offset.  Returns -1, 0 or
+    //1, and sets match to the length of their common prefix.
+    template <class Data_type, class Get_char, class Get_length>
+    inline int
+    compare_from(const Data_type &x, const Data_type &y, size_t offset,
+                 size_t &match, Get_char &get_character, Get_length &length)
+    {
+      const size_t x_size = length(x);
+      const size_t y_size = length(y);
+      const size_t min_size = (std::min)(x_size, y_size);
+      for (; offset < min_size; ++offset) {
+        if (get_character(x, offset) != get_character(y, offset)) {
+          match = offset;
+          return get_character(x, offset) < get_character(y, offset) ? -1 : 1;
+        }
+      }
+      match = min_size;
+      return x_size < y_size ? -1 : (x_size > y_size ? 1 : 0);
+    }
+
+    //Sorted, distinct splitters and the common prefix length of each
+    //neighbouring pair.  A string that falls strictly between splitters
+    //u - 1 and u goes in bucket 2u, and one equal to splitter u in bucket
+    //2u + 1, so the equal buckets need no further sorting.
+    template <class Data_type, class Get_char, class Get_length>
+    struct string_splitters {
+      typedef Get_char char_functor;
+      typedef Get_length length_functor;
+      std::vector<Data_type> splitters;
+      //prefixes[u] is the common prefix of bucket 2u; the buckets at the
+      //ends only have the prefix all the strings share
+      std::vector<size_t> prefixes;
+      Get_char get_character;
+      Get_length length;
+
+      string_splitters(Get_char get_char, Get_length get_length)
+        : get_character(get_char), length(get_length) { }
+
+      unsigned bucket_count() const
+      {
+        return unsigned(splitters.size() * 2 + 1);
+      }
+
+      //Binary search that starts each comparison after the characters x is
+      //already known to share with both ends of the remaining interval,
+      //so a shared prefix is only read once per string.  The functors are
+      //passed in so that each thread can use its own copies.
+      unsigned classify(const Data_type &x, size_t char_offset,
+                        Get_char &get_char, Get_length &get_length) const
+      {
+        size_t lo = 0, hi = splitters.size() + 1;
+        size_t lo_match = char_offset, hi_match = char_offset;
+        while (hi - lo > 1) {
+          const size_t mid = lo + (hi - lo) / 2;
+          size_t match;
+          int order = compare_from(x, splitters[mid - 1],
+                                   (std::min)(lo_match, hi_match), match,
+                                   get_char, get_length);
+          if (!order)
+            return unsigned(2 * mid - 1);
+          if (order < 0) {
+            hi = mid;
+            hi_match = match;
+          }
+          else {
+            lo = mid;
+            lo_match = match;
+          }
+        }
+        return unsigned(2 * lo);
+      }
+    };
+
+    //Picks about bucket_goal splitters from a random sample, sorted with
+    //sort_sample the way the buckets are
+    template <class RandomAccessIter, class Splitters, class Sort_bin>
+    inline void
+    pick_splitters(RandomAccessIter first, RandomAccessIter last,
+                   size_t char_offset, unsigned bucket_goal,
+                   size_t bin_sizes_count, Splitters &result,
+                   Sort_bin &sort_sample)
+    {
+      typedef typename std::iterator_traits<RandomAccessIter>::value_type
+        Data_type;
+      const size_t count = last - first;
+      const size_t sample_count = (std::min)(count,
+        size_t(bucket_goal) * string_sample_oversampling);
+      std::vector<Data_type> sample;
+      sample.reserve(sample_count);
+      //Fixed seed, so that the run time doesn't vary from call to call
+      std::minstd_rand generator(static_cast<unsigned>(count));
+      std::uniform_int_distribution<size_t> position(0, count - 1);
+      for (size_t u = 0; u < sample_count; ++u)
+        sample.push_back(first[position(generator)]);
+      std::vector<typename std::vector<Data_type>::iterator> bin_cache;
+      std::vector<size_t> bin_sizes(bin_sizes_count);
+      sort_sample(sample.begin(), sample.end(), char_offset, bin_cache,
+                  &bin_sizes[0]);
+
+      result.splitters.clear();
+      for (size_t u = string_sample_oversampling / 2; u < sample.size();
+           u += string_sample_oversampling) {
+        size_t match;
+        if (result.splitters.empty() ||
+            compare_from(result.splitters.back(), sample[u], char_offset,
+                         match, result.get_character, result.length))
+          result.splitters.push_back(sample[u]);
+      }
+      result.prefixes.assign(result.splitters.size() + 1, char_offset);
+      for (size_t u = 1; u < result.splitters.size(); ++u)
+        compare_from(result.splitters[u - 1], result.splitters[u],
+                     char_offset, result.prefixes[u], result.get_character,
+                     result.length);
+    }
+
+    //Moves every string to its bucket.  Each thread classifies its own
+    //chunk once, storing the buckets, then moves its strings out to a
+    //buffer at its precomputed place within each bucket, and back.
+    template <class RandomAccessIter, class Splitters>
+    inline void
+    distribute_by_splitters(RandomAccessIter first, RandomAccessIter last,
+                            size_t char_offset, const Splitters &splitters,
+                            unsigned nthread,
+                            std::vector<size_t> &bin_bounds)
+    {
+      typedef typename std::iterator_traits<RandomAccessIter>::value_type
+        Data_type;
+      const size_t count = last - first;
+      const unsigned bucket_count = splitters.bucket_count();
+      std::vector<boost::uint16_t> buckets(count);
+      std::vector<size_t> thread_sizes(size_t(nthread) * bucket_count, 0);
+      parallel_for_threads(nthread, [&](unsigned t) {
+        typename Splitters::char_functor get_character =
+          splitters.get_character;
+        typename Splitters::length_functor length = splitters.length;
+        size_t *sizes = &thread_sizes[size_t(t) * bucket_count];
+        const size_t chunk_end = thread_split(count, t + 1, nthread);
+        for (size_t u = thread_split(count, t, nthread); u < chunk_end; ++u) {
+          buckets[u] = static_cast<boost::uint16_t>(
+            splitters.classify(first[u], char_offset, get_character,
+                               length));
+          sizes[buckets[u]]++;
+        }
+      });
+
+      //Turn the sizes into each thread's starting position in each bucket
+      bin_bounds.assign(bucket_count + 1, 0);
+      size_t total = 0;
+      for (unsigned u = 0; u < bucket_count; ++u) {
+        for (unsigned t = 0; t < nthread; ++t) {
+          size_t &size = thread_sizes[size_t(t) * bucket_count + u];
+          const size_t start = total;
+          total += size;
+          size = start;
+        }
+        bin_bounds[u + 1] = total;
+      }
+
+      std::vector<Data_type> buffer(count);
+      parallel_for_threads(nthread, [&](unsigned t) {
+        size_t *positions = &thread_sizes[size_t(t) * bucket_count];
+        const size_t chunk_end = thread_split(count, t + 1, nthread);
+        for (size_t u = thread_split(count, t, nthread); u < chunk_end; ++u)
+          buffer[positions[buckets[u]]++] = std::move(first[u]);
+      });
+      parallel_for_threads(nthread, [&](unsigned t) {
+        std::move(buffer.begin() + thread_split(count, t, nthread),
+                  buffer.begin() + thread_split(count, t + 1, nthread),
+                  first + thread_split(count, t, nthread));
+      });
+    }
+
+    //Sorts a bucket, or the sample, whose strings match up to char_offset,
+    //with string_sort, or boost::sort::pdqsort if its worst-case is better
+    template <class Unsigned_char_type>
+    struct sample_bucket_sort {
+      template <class RandomAccessIter>
+      inline void
+      operator()(RandomAccessIter lo, RandomAccessIter hi, size_t char_offset,
+                 std::vector<RandomAccessIter> &bin_cache,
+                 size_t *bin_sizes) const
+      {
+        typedef typename std::iterator_traits<RandomAccessIter>::value_type
+          Data_type;
+        if (size_t(hi - lo) < (size_t(1) << (sizeof(Unsigned_char_type)*8)))
+          boost::sort::pdqsort(lo, hi,
+            offset_less_than<Data_type, Unsigned_char_type>(char_offset));
+        else
+          string_sort_rec<RandomAccessIter, Unsigned_char_type>(lo, hi,
+            char_offset, bin_cache, 0, bin_sizes);
+      }
+    };
+
+    template <class Unsigned_char_type, class Get_char, class Get_length>
+    struct sample_bucket_char_sort {
+      Get_char get_character;
+      Get_length length;
+
+      sample_bucket_char_sort(Get_char get_char, Get_length get_length)
+        : get_character(get_char), length(get_length) { }
+
+      template <class RandomAccessIter>
+      inline void
+      operator()(RandomAccessIter lo, RandomAccessIter hi, size_t char_offset,
+                 std::vector<RandomAccessIter> &bin_cache,
+                 size_t *bin_sizes) const
+      {
+        typedef typename std::iterator_traits<RandomAccessIter>::value_type
+          Data_type;
+        if (size_t(hi - lo) < (size_t(1) << (sizeof(Unsigned_char_type)*8)))
+          boost::sort::pdqsort(lo, hi, offset_char_less_than<Data_type,
+                               Get_char, Get_length>(char_offset));
+        else
+          string_sort_rec<RandomAccessIter, Unsigned_char_type, Get_char,
+            Get_length>(lo, hi, char_offset, bin_cache, 0, bin_sizes,
+                        get_character, length);
+      }
+    };
+
+    //Distributes on splitters in parallel, then sorts the buckets between
+    //the splitters in parallel with sort_bin, starting each at the prefix
+    //its two splitters share
+    template <class RandomAccessIter, class Unsigned_char_type, class Get_char,
+              class Get_length, class Update_offset, class Sort_bin>
+    inline void
+    parallel_string_sample_sort_rec(RandomAccessIter first,
+                                    RandomAccessIter last,
+                                    size_t char_offset,
+                                    Get_char get_character, Get_length length,
+                                    Update_offset update, Sort_bin sort_bin,
+                                    unsigned nthread)
+    {
+      typedef typename std::iterator_traits<RandomAccessIter>::value_type
+        Data_type;
+      //If all empty, return
+      if (!parallel_update_offset(first, last, char_offset, get_character,
+                                  length, update, nthread))
+        return;
+
+      const size_t membin_count =
+        (size_t(1) << (sizeof(Unsigned_char_type)*8)) + 1;
+      string_splitters<Data_type, Get_char, Get_length>
+        splitters(get_character, length);
+      const unsigned bucket_goal = (std::min)(
+        unsigned(nthread * string_sample_buckets_per_thread),
+        unsigned(max_string_sample_buckets));
+      pick_splitters(first, last, char_offset, bucket_goal, membin_count,
+                     splitters, sort_bin);
+      std::vector<size_t> bin_bounds;
+      distribute_by_splitters(first, last, char_offset, splitters, nthread,
+                              bin_bounds);
+
+      parallel_sort_bins(first, bin_bounds, nthread, membin_count,
+        [&](RandomAccessIter lo, RandomAccessIter hi, unsigned bucket,
+            std::vector<RandomAccessIter> &bin_cache, size_t *bin_sizes) {
+          //Strings equal to a splitter are already in place
+          if (!(bucket & 1))
+            sort_bin(lo, hi, splitters.prefixes[bucket / 2], bin_cache,
+                     bin_sizes);
+        },
+        [&](RandomAccessIter lo, RandomAccessIter hi, unsigned bucket) {
+          if (!(bucket & 1))
+            parallel_string_sample_sort_rec<RandomAccessIter,
+              Unsigned_char_type>(lo, hi, splitters.prefixes[bucket / 2],
+                                  get_character, length, update, sort_bin,
+                                  get_thread_count(hi - lo, nthread));
+        });
+    }
+
+    //Holds the per-variant bucket sort and makes the initial recursive call
+    template <class RandomAccessIter, class Unsigned_char_type>
+    inline typename boost::enable_if_c< sizeof(Unsigned_char_type) <= 2, void
+                                                                      >::type
+    parallel_string_sample_sort(RandomAccessIter first, RandomAccessIter last,
+                                Unsigned_char_type unused, unsigned nthread)
+    {
+      nthread = get_thread_count(last - first, nthread);
+      if (nthread < 2) {
+        string_sort(first, last, unused);
+        return;
+      }
+      parallel_string_sample_sort_rec<RandomAccessIter, Unsigned_char_type>
+        (first, last, 0, bracket_char<Unsigned_char_type>(), size_length(),
+        [](RandomAccessIter lo, RandomAccessIter hi, size_t &char_offset) {
+          update_offset<RandomAccessIter, Unsigned_char_type>(lo, hi,
+                                                              char_offset);
+        }, sample_bucket_sort<Unsigned_char_type>(), nthread);
+    }
+
+    template <class RandomAccessIter, class Unsigned_char_type>
+    inline typename boost::disable_if_c< sizeof(Unsigned_char_type) <= 2, void
+                                                                       >::type
+    parallel_string_sample_sort(RandomAccessIter first, RandomAccessIter last,
+                                Unsigned_char_type, unsigned nthread)
+    {
+      // Use boost::sort::block_indirect_sort if the char_type is too large
+      // for string_sort.
+      boost::sort::block_indirect_sort(first, last, nthread);
+    }
+
+    //Holds the per-variant bucket sort and makes the initial recursive call
+    template <class RandomAccessIter, class Get_char, class Get_length,
+              class Unsigned_char_type>
+    inline typename boost::enable_if_c< sizeof(Unsigned_char_type) <= 2, void
+                                                                      >::type
+    parallel_string_sample_sort(RandomAccessIter first, RandomAccessIter last,
+                                Get_char get_character, Get_length length,
+                                Unsigned_char_type unused, unsigned nthread)
+    {
+      nthread = get_thread_count(last - first, nthread);
+      if (nthread < 2) {
+        string_sort(first, last, get_character, length, unused);
+        return;
+      }
+      parallel_string_sample_sort_rec<RandomAccessIter, Unsigned_char_type>
+        (first, last, 0, get_character, length,
+        [=](RandomAccessIter lo, RandomAccessIter hi, size_t &char_offset) {
+          update_offset(lo, hi, char_offset, get_character, length);
+        }, sample_bucket_char_sort<Unsigned_char_type, Get_char, Get_length>
+             (get_character, length), nthread);
+    }
+
+    template <class RandomAccessIter, class Get_char, class Get_length,
+              class Unsigned_char_type>
+    inline typename boost::disable_if_c< sizeof(Unsigned_char_type) <= 2, void
+                                                                       >::type
+    parallel_string_sample_sort(RandomAccessIter first, RandomAccessIter last,
+                                Get_char, Get_length, Unsigned_char_type,
+                                unsigned nthread)
+    {
+      // Use boost::sort::block_indirect_sort if the char_type is too large
+      // for string_sort.
+      boost::sort::block_indirect_sort(first, last, nthread);
+    }
+  }
+}
+}
+}
+
+#endif
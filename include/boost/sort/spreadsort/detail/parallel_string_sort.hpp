@@ -0,0 +1,295 @@
+// Details for the multithreaded hybrid-radix parallel_string_sort.
+
+//          Copyright Steven J. Ross 2001 - 2014.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// See http://www.boost.org/libs/sort for library home page.
+
+#ifndef BOOST_SORT_SPREADSORT_DETAIL_PARALLEL_STRING_SORT_HPP
+#define BOOST_SORT_SPREADSORT_DETAIL_PARALLEL_STRING_SORT_HPP
+#include <algorithm>
+#include <iterator>
+#include <vector>
+#include <boost/utility/enable_if.hpp>
+#include <boost/sort/block_indirect_sort/block_indirect_sort.hpp>
+#include <boost/sort/spreadsort/detail/constants.hpp>
+#include <boost/sort/spreadsort/detail/spreadsort_common.hpp>
+#include <boost/sort/spreadsort/detail/string_sort.hpp>
+#include <boost/sort/spreadsort/detail/parallel_spreadsort_common.hpp>
+
+namespace boost {
+namespace sort {
+namespace spreadsort {
+  namespace detail {
+    //Reads a character the way string_sort does, using operator[]
+    template <class Unsigned_char_type>
+    struct bracket_char {
+      template <class Data_type>
+      inline Unsigned_char_type
+      operator()(const Data_type &x, size_t offset) const
+      {
+        return static_cast<Unsigned_char_type>(x[offset]);
+      }
+    };
+
+    //Reads a length the way string_sort does, using size()
+    struct size_length {
+      template <class Data_type>
+      inline size_t operator()(const Data_type &x) const
+      {
+        return x.size();
+      }
+    };
+
+    //Maps a string to its bin at char_offset; bin 0 holds the empties
+    template <class Get_char, class Get_length>
+    struct string_bin {
+      Get_char get_character;
+      Get_length length;
+      size_t char_offset;
+
+      string_bin(Get_char get_char, Get_length get_length, size_t offset)
+        : get_character(get_char), length(get_length), char_offset(offset) { }
+
+      template <class Data_type>
+      inline unsigned operator()(const Data_type &x)
+      {
+        if (length(x) <= char_offset)
+          return 0;
+        return unsigned(get_character(x, char_offset)) + 1;
+      }
+    };
+
+    //Offsetting on identical characters, with each thread finding the
+    //common prefix of its own chunk using update(first, finish, offset).
+    //The chunk prefixes are then cut to where each chunk's first non-empty
+    //string differs from the first non-empty string overall.
+    //Returns false if all the strings are empty at char_offset.
+    template <class RandomAccessIter, class Get_char, class Get_length,
+              class Update_offset>
+    inline bool
+    parallel_update_offset(RandomAccessIter first, RandomAccessIter last,
+                           size_t &char_offset, Get_char get_character,
+                           Get_length length, Update_offset update,
+                           unsigned nthread)
+    {
+      const size_t count = last - first;
+      std::vector<size_t> offsets(nthread);
+      std::vector<RandomAccessIter> nonempty(nthread, last);
+      parallel_for_threads(nthread, [&](unsigned t) {
+        Get_length chunk_length = length;
+        RandomAccessIter current = first + thread_split(count, t, nthread);
+        RandomAccessIter chunk_last =
+          first + thread_split(count, t + 1, nthread);
+        //Iterate to the end of the empties
+        while (current != chunk_last && chunk_length(*current) <= char_offset)
+          ++current;
+        if (current == chunk_last)
+          return;
+        //Getting the last non-empty
+        RandomAccessIter finish = chunk_last - 1;
+        for (; chunk_length(*finish) <= char_offset; --finish);
+        ++finish;
+        offsets[t] = char_offset;
+        update(current, finish, offsets[t]);
+        nonempty[t] = current;
+      });
+
+      unsigned base = 0;
+      for (; base < nthread && nonempty[base] == last; ++base);
+      if (base == nthread)
+        return false;
+      size_t new_offset = offsets[base];
+      for (unsigned t = base + 1; t < nthread; ++t) {
+        if (nonempty[t] != last && offsets[t] < new_offset)
+          new_offset = offsets[t];
+      }
+      for (unsigned t = base + 1; t < nthread; ++t) {
+        if (nonempty[t] == last)
+          continue;
+        size_t u = char_offset;
+        while (u < new_offset && get_character(*nonempty[t], u) ==
+               get_character(*nonempty[base], u))
+          ++u;
+        new_offset = u;
+      }
+      char_offset = new_offset;
+      return true;
+    }
+
+    //Distributes on one character in parallel, then sorts the bins in
+    //parallel with sort_bin(first, last, char_offset, bin_cache, bin_sizes)
+    template <class RandomAccessIter, class Unsigned_char_type, class Get_char,
+              class Get_length, class Update_offset, class Sort_bin>
+    inline void
+    parallel_string_sort_rec(RandomAccessIter first, RandomAccessIter last,
+                             size_t char_offset, Get_char get_character,
+                             Get_length length, Update_offset update,
+                             Sort_bin sort_bin, unsigned nthread)
+    {
+      //If all empty, return
+      if (!parallel_update_offset(first, last, char_offset, get_character,
+                                  length, update, nthread))
+        return;
+
+      const unsigned bin_count = (1 << (sizeof(Unsigned_char_type)*8));
+      const unsigned membin_count = bin_count + 1;
+      std::vector<size_t> bin_bounds;
+      parallel_distribute(first, last, membin_count,
+        string_bin<Get_char, Get_length>(get_character, length, char_offset),
+        nthread, bin_bounds);
+      //Skip the empties; they are identical
+      bin_bounds.erase(bin_bounds.begin());
+
+      parallel_sort_bins(first, bin_bounds, nthread, membin_count,
+        [&](RandomAccessIter lo, RandomAccessIter hi, unsigned,
+            std::vector<RandomAccessIter> &bin_cache, size_t *bin_sizes) {
+          sort_bin(lo, hi, char_offset + 1, bin_cache, bin_sizes);
+        },
+        [&](RandomAccessIter lo, RandomAccessIter hi, unsigned) {
+          parallel_string_sort_rec<RandomAccessIter, Unsigned_char_type>
+            (lo, hi, char_offset + 1, get_character, length, update, sort_bin,
+             get_thread_count(hi - lo, nthread));
+        });
+    }
+
+    //Holds the per-variant bin sort and makes the initial recursive call
+    template <class RandomAccessIter, class Unsigned_char_type>
+    inline typename boost::enable_if_c< sizeof(Unsigned_char_type) <= 2, void
+                                                                      >::type
+    parallel_string_sort(RandomAccessIter first, RandomAccessIter last,
+                         Unsigned_char_type unused, unsigned nthread)
+    {
+      typedef typename std::iterator_traits<RandomAccessIter>::value_type
+        Data_type;
+      nthread = get_thread_count(last - first, nthread);
+      if (nthread < 2) {
+        string_sort(first, last, unused);
+        return;
+      }
+      parallel_string_sort_rec<RandomAccessIter, Unsigned_char_type>(first,
+        last, 0, bracket_char<Unsigned_char_type>(), size_length(),
+        [](RandomAccessIter lo, RandomAccessIter hi, size_t &char_offset) {
+          update_offset<RandomAccessIter, Unsigned_char_type>(lo, hi,
+                                                              char_offset);
+        },
+        [](RandomAccessIter lo, RandomAccessIter hi, size_t char_offset,
+           std::vector<RandomAccessIter> &bin_cache, size_t *bin_sizes) {
+          //using boost::sort::pdqsort if its worst-case is better
+          if (size_t(hi - lo) < (size_t(1) << (sizeof(Unsigned_char_type)*8)))
+            boost::sort::pdqsort(lo, hi,
+              offset_less_than<Data_type, Unsigned_char_type>(char_offset));
+          else
+            string_sort_rec<RandomAccessIter, Unsigned_char_type>(lo, hi,
+              char_offset, bin_cache, 0, bin_sizes);
+        }, nthread);
+    }
+
+    template <class RandomAccessIter, class Unsigned_char_type>
+    inline typename boost::disable_if_c< sizeof(Unsigned_char_type) <= 2, void
+                                                                       >::type
+    parallel_string_sort(RandomAccessIter first, RandomAccessIter last,
+                         Unsigned_char_type, unsigned nthread)
+    {
+      // Use boost::sort::block_indirect_sort if the char_type is too large
+      // for string_sort.
+      boost::sort::block_indirect_sort(first, last, nthread);
+    }
+
+    //Holds the per-variant bin sort and makes the initial recursive call
+    template <class RandomAccessIter, class Get_char, class Get_length,
+              class Unsigned_char_type>
+    inline typename boost::enable_if_c< sizeof(Unsigned_char_type) <= 2, void
+                                                                      >::type
+    parallel_string_sort(RandomAccessIter first, RandomAccessIter last,
+                         Get_char get_character, Get_length length,
+                         Unsigned_char_type unused, unsigned nthread)
+    {
+      typedef typename std::iterator_traits<RandomAccessIter>::value_type
+        Data_type;
+      nthread = get_thread_count(last - first, nthread);
+      if (nthread < 2) {
+        string_sort(first, last, get_character, length, unused);
+        return;
+      }
+      parallel_string_sort_rec<RandomAccessIter, Unsigned_char_type>(first,
+        last, 0, get_character, length,
+        [=](RandomAccessIter lo, RandomAccessIter hi, size_t &char_offset) {
+          update_offset(lo, hi, char_offset, get_character, length);
+        },
+        [=](RandomAccessIter lo, RandomAccessIter hi, size_t char_offset,
+            std::vector<RandomAccessIter> &bin_cache, size_t *bin_sizes) {
+          if (size_t(hi - lo) < (size_t(1) << (sizeof(Unsigned_char_type)*8)))
+            boost::sort::pdqsort(lo, hi, offset_char_less_than<Data_type,
+                                 Get_char, Get_length>(char_offset));
+          else
+            string_sort_rec<RandomAccessIter, Unsigned_char_type, Get_char,
+              Get_length>(lo, hi, char_offset, bin_cache, 0, bin_sizes,
+                          get_character, length);
+        }, nthread);
+    }
+
+    template <class RandomAccessIter, class Get_char, class Get_length,
+              class Unsigned_char_type>
+    inline typename boost::disable_if_c< sizeof(Unsigned_char_type) <= 2, void
+                                                                       >::type
+    parallel_string_sort(RandomAccessIter first, RandomAccessIter last,
+                         Get_char, Get_length, Unsigned_char_type,
+                         unsigned nthread)
+    {
+      // Use boost::sort::block_indirect_sort if the char_type is too large
+      // for string_sort.
+      boost::sort::block_indirect_sort(first, last, nthread);
+    }
+
+    //Holds the per-variant bin sort and makes the initial recursive call
+    template <class RandomAccessIter, class Get_char, class Get_length,
+              class Compare, class Unsigned_char_type>
+    inline typename boost::enable_if_c< sizeof(Unsigned_char_type) <= 2, void
+                                                                      >::type
+    parallel_string_sort(RandomAccessIter first, RandomAccessIter last,
+                         Get_char get_character, Get_length length,
+                         Compare comp, Unsigned_char_type unused,
+                         unsigned nthread)
+    {
+      nthread = get_thread_count(last - first, nthread);
+      if (nthread < 2) {
+        string_sort(first, last, get_character, length, comp, unused);
+        return;
+      }
+      parallel_string_sort_rec<RandomAccessIter, Unsigned_char_type>(first,
+        last, 0, get_character, length,
+        [=](RandomAccessIter lo, RandomAccessIter hi, size_t &char_offset) {
+          update_offset(lo, hi, char_offset, get_character, length);
+        },
+        [=](RandomAccessIter lo, RandomAccessIter hi, size_t char_offset,
+            std::vector<RandomAccessIter> &bin_cache, size_t *bin_sizes) {
+          if (size_t(hi - lo) < (size_t(1) << (sizeof(Unsigned_char_type)*8)))
+            boost::sort::pdqsort(lo, hi, comp);
+          else
+            string_sort_rec<RandomAccessIter, Unsigned_char_type, Get_char,
+              Get_length, Compare>(lo, hi, char_offset, bin_cache, 0,
+                                   bin_sizes, get_character, length, comp);
+        }, nthread);
+    }
+
+    template <class RandomAccessIter, class Get_char, class Get_length,
+              class Compare, class Unsigned_char_type>
+    inline typename boost::disable_if_c< sizeof(Unsigned_char_type) <= 2, void
+                                                                       >::type
+    parallel_string_sort(RandomAccessIter first, RandomAccessIter last,
+                         Get_char, Get_length, Compare comp,
+                         Unsigned_char_type, unsigned nthread)
+    {
+      // Use boost::sort::block_indirect_sort if the char_type is too large
+      // for string_sort.
+      boost::sort::block_indirect_sort(first, last, comp, nthread);
+    }
+  }
+}
+}
+}
+
+#endif
@@ -0,0 +1,335 @@
+// Details for the key/value variants of integer_sort, float_sort and
+// string_sort.
+
+//          Copyright Steven J. Ross 2001 - 2014.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// See http://www.boost.org/libs/sort for library home page.
+
+#ifndef BOOST_SORT_SPREADSORT_DETAIL_SORT_BY_KEY_HPP
+#define BOOST_SORT_SPREADSORT_DETAIL_SORT_BY_KEY_HPP
+#include <algorithm>
+#include <vector>
+#include <limits>
+#include <iterator>
+#include <functional>
+#include <boost/cstdint.hpp>
+#include <boost/sort/spreadsort/integer_sort.hpp>
+#include <boost/sort/spreadsort/float_sort.hpp>
+#include <boost/sort/spreadsort/string_sort.hpp>
+
+#if __cplusplus >= 201103L
+  #include <utility>
+  #define BOOST_SORT_BY_KEY_MOVE(x) std::move(x)
+#else
+  #define BOOST_SORT_BY_KEY_MOVE(x) (x)
+#endif
+
+namespace boost {
+namespace sort {
+namespace spreadsort {
+  namespace detail {
+    //A key and the position it started at, sorted in place of the key so
+    //that the values don't have to move until the final order is known
+    template <class Key_type, class Index_type>
+    struct key_index {
+      Key_type key;
+      Index_type index;
+    };
+
+    //Applies a right shift functor for keys to a key_index
+    template <class Key_index, class Div_type, class Right_shift>
+    struct key_index_shift {
+      Right_shift shift;
+      explicit key_index_shift(Right_shift s) : shift(s) {}
+      Div_type operator()(const Key_index &x, unsigned offset) {
+        return shift(x.key, offset);
+      }
+    };
+
+    //Applies a comparison functor for keys to a key_index
+    template <class Key_index, class Compare>
+    struct key_index_compare {
+      Compare comp;
+      explicit key_index_compare(Compare c) : comp(c) {}
+      bool operator()(const Key_index &x, const Key_index &y) {
+        return comp(x.key, y.key);
+      }
+    };
+
+    //Right shift of a floating-point key cast to Cast_type, as float_sort does
+    template <class Key_type, class Cast_type>
+    struct float_key_shift {
+      Cast_type operator()(const Key_type &x, unsigned offset) const {
+        return float_mem_cast<Key_type, Cast_type>(x) >> offset;
+      }
+    };
+
+    //The signed integer type float_sort casts a floating-point type to
+    template <size_t Size> struct float_key_cast;
+    template <> struct float_key_cast<sizeof(boost::int32_t)> {
+      typedef boost::int32_t type;
+    };
+    template <> struct float_key_cast<sizeof(boost::int64_t)> {
+      typedef boost::int64_t type;
+    };
+
+    //Character access to a key through its index
+    template <class Key_iter, class Index_type, class Get_char,
+              class Unsigned_char_type>
+    struct indexed_get_char {
+      Key_iter keys;
+      Get_char get_character;
+      indexed_get_char(Key_iter k, Get_char g) : keys(k), get_character(g) {}
+      Unsigned_char_type operator()(Index_type x, size_t offset) {
+        return get_character(keys[x], offset);
+      }
+    };
+
+    template <class Key_iter, class Index_type, class Get_length>
+    struct indexed_length {
+      Key_iter keys;
+      Get_length length;
+      indexed_length(Key_iter k, Get_length l) : keys(k), length(l) {}
+      size_t operator()(Index_type x) { return length(keys[x]); }
+    };
+
+    template <class Key_iter, class Index_type, class Compare>
+    struct indexed_compare {
+      Key_iter keys;
+      Compare comp;
+      indexed_compare(Key_iter k, Compare c) : keys(k), comp(c) {}
+      bool operator()(Index_type x, Index_type y) {
+        return comp(keys[x], keys[y]);
+      }
+    };
+
+    //Default string key access, the same as string_sort uses
+    struct key_bracket {
+      template <class Key_type>
+      unsigned char operator()(const Key_type &x, size_t offset) const {
+        return x[offset];
+      }
+    };
+
+    struct key_size {
+      template <class Key_type>
+      size_t operator()(const Key_type &x) const { return x.size(); }
+    };
+
+    //Moves the elements of one array into their sorted positions.
+    //Gathering into a buffer is faster than following the cycles of the
+    //permutation in place: the reads don't depend on each other, so many
+    //cache misses can be outstanding at once.
+    template <class Value_iter>
+    struct permutation_mover {
+      Value_iter values;
+      explicit permutation_mover(Value_iter v) : values(v) {}
+      //Moves the element at positions[u] to u, for every u
+      template <class Index_type>
+      void apply(const std::vector<Index_type> &positions) {
+        typedef typename std::iterator_traits<Value_iter>::value_type
+          Value_type;
+        std::vector<Value_type> buffer;
+        buffer.reserve(positions.size());
+        for (size_t u = 0; u < positions.size(); ++u)
+          buffer.push_back(BOOST_SORT_BY_KEY_MOVE(values[positions[u]]));
+        for (size_t u = 0; u < positions.size(); ++u)
+          values[u] = BOOST_SORT_BY_KEY_MOVE(buffer[u]);
+      }
+    };
+
+    //Moves the elements of two arrays, one after the other
+    template <class First_mover, class Second_mover>
+    struct permutation_mover_pair {
+      First_mover first;
+      Second_mover second;
+      permutation_mover_pair(First_mover f, Second_mover s)
+        : first(f), second(s) {}
+      template <class Index_type>
+      void apply(const std::vector<Index_type> &positions) {
+        first.apply(positions);
+        second.apply(positions);
+      }
+    };
+
+    template <class Value_iter>
+    inline permutation_mover<Value_iter> make_mover(Value_iter values)
+    {
+      return permutation_mover<Value_iter>(values);
+    }
+
+    template <class First_mover, class Second_mover>
+    inline permutation_mover_pair<First_mover, Second_mover>
+    make_mover_pair(First_mover first, Second_mover second)
+    {
+      return permutation_mover_pair<First_mover, Second_mover>(first, second);
+    }
+
+    //Sorts key_index pairs with Sort_keys, then writes the keys back in
+    //order and moves the values to match
+    template <class Index_type, class Key_iter, class Mover,
+              class Sort_keys>
+    inline void
+    sort_key_index(Key_iter keys_first, Key_iter keys_last,
+                   Mover values, Sort_keys sort_keys)
+    {
+      typedef typename std::iterator_traits<Key_iter>::value_type Key_type;
+      typedef key_index<Key_type, Index_type> Key_index;
+      const size_t count = keys_last - keys_first;
+      std::vector<Key_index> pairs(count);
+      for (size_t u = 0; u < count; ++u) {
+        pairs[u].key = keys_first[u];
+        pairs[u].index = static_cast<Index_type>(u);
+      }
+      sort_keys(pairs.begin(), pairs.end());
+      std::vector<Index_type> positions(count);
+      for (size_t u = 0; u < count; ++u) {
+        keys_first[u] = pairs[u].key;
+        positions[u] = pairs[u].index;
+      }
+      //Free the pairs before the values are moved
+      std::vector<Key_index>().swap(pairs);
+      values.apply(positions);
+    }
+
+    //Sorts key_index pairs with integer_sort
+    template <class Div_type, class Right_shift, class Compare>
+    struct integer_key_sorter {
+      Right_shift shift;
+      Compare comp;
+      integer_key_sorter(Right_shift s, Compare c) : shift(s), comp(c) {}
+      template <class Pair_iter>
+      void operator()(Pair_iter first, Pair_iter last) {
+        typedef typename std::iterator_traits<Pair_iter>::value_type
+          Key_index;
+        boost::sort::spreadsort::integer_sort(first, last,
+                     key_index_shift<Key_index, Div_type, Right_shift>(shift),
+                     key_index_compare<Key_index, Compare>(comp));
+      }
+    };
+
+    //Sorts key_index pairs with integer_sort_lsd, which is stable and,
+    //with no comparison to call, usually faster on these small elements
+    template <class Div_type, class Right_shift>
+    struct integer_lsd_key_sorter {
+      Right_shift shift;
+      explicit integer_lsd_key_sorter(Right_shift s) : shift(s) {}
+      template <class Pair_iter>
+      void operator()(Pair_iter first, Pair_iter last) {
+        typedef typename std::iterator_traits<Pair_iter>::value_type
+          Key_index;
+        detail::integer_sort_lsd(first, last, Div_type(),
+            key_index_shift<Key_index, Div_type, Right_shift>(shift));
+      }
+    };
+
+    //Sorts key_index pairs with float_sort
+    template <class Div_type, class Right_shift, class Compare>
+    struct float_key_sorter {
+      Right_shift shift;
+      Compare comp;
+      float_key_sorter(Right_shift s, Compare c) : shift(s), comp(c) {}
+      template <class Pair_iter>
+      void operator()(Pair_iter first, Pair_iter last) {
+        typedef typename std::iterator_traits<Pair_iter>::value_type
+          Key_index;
+        boost::sort::spreadsort::float_sort(first, last,
+                   key_index_shift<Key_index, Div_type, Right_shift>(shift),
+                   key_index_compare<Key_index, Compare>(comp));
+      }
+    };
+
+    //Uses 32-bit indices when they are enough, to move fewer bytes
+    template <class Key_iter, class Mover, class Sort_keys>
+    inline void
+    sort_by_key(Key_iter keys_first, Key_iter keys_last, Mover values,
+                Sort_keys sort_keys)
+    {
+      if (static_cast<boost::uintmax_t>(keys_last - keys_first) <=
+          (std::numeric_limits<boost::uint32_t>::max)())
+        sort_key_index<boost::uint32_t>(keys_first, keys_last, values,
+                                        sort_keys);
+      else
+        sort_key_index<size_t>(keys_first, keys_last, values, sort_keys);
+    }
+
+    template <class Key_iter, class Mover, class Div_type,
+              class Right_shift, class Compare>
+    inline void
+    integer_sort_by_key(Key_iter keys_first, Key_iter keys_last,
+                        Mover values, Div_type, Right_shift shift,
+                        Compare comp)
+    {
+      sort_by_key(keys_first, keys_last, values,
+          integer_key_sorter<Div_type, Right_shift, Compare>(shift, comp));
+    }
+
+    template <class Key_iter, class Mover, class Div_type,
+              class Right_shift>
+    inline void
+    integer_sort_by_key(Key_iter keys_first, Key_iter keys_last,
+                        Mover values, Div_type, Right_shift shift)
+    {
+      sort_by_key(keys_first, keys_last, values,
+          integer_lsd_key_sorter<Div_type, Right_shift>(shift));
+    }
+
+    template <class Key_iter, class Mover, class Div_type,
+              class Right_shift, class Compare>
+    inline void
+    float_sort_by_key(Key_iter keys_first, Key_iter keys_last,
+                      Mover values, Div_type, Right_shift shift,
+                      Compare comp)
+    {
+      sort_by_key(keys_first, keys_last, values,
+          float_key_sorter<Div_type, Right_shift, Compare>(shift, comp));
+    }
+
+    //Strings are already indirect, so the indices are sorted alone, with
+    //the keys read through them, and the keys are moved with the values
+    template <class Index_type, class Key_iter, class Mover,
+              class Get_char, class Get_length, class Compare,
+              class Unsigned_char_type>
+    inline void
+    string_sort_by_key(Key_iter keys_first, Key_iter keys_last,
+                       Mover values, Get_char get_character,
+                       Get_length length, Compare comp, Unsigned_char_type)
+    {
+      const size_t count = keys_last - keys_first;
+      std::vector<Index_type> positions(count);
+      for (size_t u = 0; u < count; ++u)
+        positions[u] = static_cast<Index_type>(u);
+      boost::sort::spreadsort::string_sort(positions.begin(), positions.end(),
+          indexed_get_char<Key_iter, Index_type, Get_char,
+                           Unsigned_char_type>(keys_first, get_character),
+          indexed_length<Key_iter, Index_type, Get_length>(keys_first,
+                                                           length),
+          indexed_compare<Key_iter, Index_type, Compare>(keys_first, comp));
+      make_mover_pair(make_mover(keys_first), values).apply(positions);
+    }
+
+    template <class Key_iter, class Mover, class Get_char,
+              class Get_length, class Compare, class Unsigned_char_type>
+    inline void
+    string_sort_by_key(Key_iter keys_first, Key_iter keys_last,
+                       Mover values, Get_char get_character,
+                       Get_length length, Compare comp,
+                       Unsigned_char_type unused)
+    {
+      if (static_cast<boost::uintmax_t>(keys_last - keys_first) <=
+          (std::numeric_limits<boost::uint32_t>::max)())
+        string_sort_by_key<boost::uint32_t>(keys_first, keys_last,
+            values, get_character, length, comp, unused);
+      else
+        string_sort_by_key<size_t>(keys_first, keys_last, values,
+            get_character, length, comp, unused);
+    }
+  }
+}
+}
+}
+
+#endif
@@ -23,6 +23,8 @@ Phil Endecott and Frank Gennari
 #include <boost/static_assert.hpp>
 #include <boost/sort/pdqsort/pdqsort.hpp>
 #include <boost/sort/spreadsort/detail/constants.hpp>
+#include <boost/sort/spreadsort/detail/tuning.hpp>
+#include <boost/sort/spreadsort/detail/workspace.hpp>
 #include <boost/cstdint.hpp>
 
 namespace boost {
@@ -46,20 +48,22 @@ namespace spreadsort {
     //runtime overhead.
     //This could be replaced by a lookup table of sizeof(Div_type)*8 but this
     //function is more general.
+    //max_splits and max_finishing_splits come from Tuning.
     template<unsigned log_mean_bin_size,
-      unsigned log_min_split_count, unsigned log_finishing_count>
+      unsigned log_min_split_count, unsigned log_finishing_count, class Tuning>
     inline size_t
-    get_min_count(unsigned log_range)
+    get_min_count(unsigned log_range, Tuning)
     {
       const size_t typed_one = 1;
       const unsigned min_size = log_mean_bin_size + log_min_split_count;
+      const unsigned max_splits = Tuning::max_splits;
       //Assuring that constants have valid settings
-      BOOST_STATIC_ASSERT(log_min_split_count <= max_splits &&
+      BOOST_STATIC_ASSERT(log_min_split_count <= Tuning::max_splits &&
                           log_min_split_count > 0);
-      BOOST_STATIC_ASSERT(max_splits > 1 &&
-                          max_splits < (8 * sizeof(unsigned)));
-      BOOST_STATIC_ASSERT(max_finishing_splits >= max_splits &&
-                          max_finishing_splits < (8 * sizeof(unsigned)));
+      BOOST_STATIC_ASSERT(Tuning::max_splits > 1 &&
+                          Tuning::max_splits < (8 * sizeof(unsigned)));
+      BOOST_STATIC_ASSERT(Tuning::max_finishing_splits > Tuning::max_splits &&
+                          Tuning::max_finishing_splits < (8 * sizeof(unsigned)));
       BOOST_STATIC_ASSERT(log_mean_bin_size >= 0);
       BOOST_STATIC_ASSERT(log_finishing_count >= 0);
       //if we can complete in one iteration, do so
@@ -100,6 +104,16 @@ namespace spreadsort {
       return typed_one << bit_length;
     }
 
+    //Uses the default tuning
+    template<unsigned log_mean_bin_size,
+      unsigned log_min_split_count, unsigned log_finishing_count>
+    inline size_t
+    get_min_count(unsigned log_range)
+    {
+      return get_min_count<log_mean_bin_size, log_min_split_count,
+                           log_finishing_count>(log_range, default_tuning());
+    }
+
     // Resizes the bin cache and bin sizes, and initializes each bin size to 0.
     // This generates the memory overhead to use in radix sorting.
     template <class RandomAccessIter>
@@ -116,6 +130,121 @@ namespace spreadsort {
         bin_cache.resize(cache_end);
       return &(bin_cache[cache_offset]);
     }
+
+    //Compares with operator<, as the sorts without a comparison object do
+    struct less_than {
+      template <class T>
+      bool operator()(T & x, T & y) const { return x < y; }
+    };
+
+    //Widens [*min, *max] to the elements of [first, last).  Alternate
+    //elements go to two pairs of extremes, merged at the end, so the
+    //comparisons of consecutive elements don't wait on each other.
+    template <class RandomAccessIter, class Compare>
+    inline void
+    find_extremes(RandomAccessIter first, RandomAccessIter last,
+                  RandomAccessIter & max, RandomAccessIter & min,
+                  Compare comp)
+    {
+      RandomAccessIter max2 = max, min2 = min;
+      for (; last - first >= 2; first += 2) {
+        if (comp(*max, *first))
+          max = first;
+        else if (comp(*first, *min))
+          min = first;
+        if (comp(*max2, *(first + 1)))
+          max2 = first + 1;
+        else if (comp(*(first + 1), *min2))
+          min2 = first + 1;
+      }
+      if (first != last) {
+        if (comp(*max, *first))
+          max = first;
+        else if (comp(*first, *min))
+          min = first;
+      }
+      if (comp(*max, *max2))
+        max = max2;
+      if (comp(*min2, *min))
+        min = min2;
+    }
+
+    //The same for values: widens [min, max] to the get_value(iter) of the
+    //iterators of [first, last)
+    template <class RandomAccessIter, class Value, class Get_value>
+    inline void
+    find_value_extremes(RandomAccessIter first, RandomAccessIter last,
+                        Value & max, Value & min, Get_value get_value)
+    {
+      Value max2 = max, min2 = min;
+      for (; last - first >= 2; first += 2) {
+        Value value = get_value(first);
+        Value value2 = get_value(first + 1);
+        max = (max < value) ? value : max;
+        min = (value < min) ? value : min;
+        max2 = (max2 < value2) ? value2 : max2;
+        min2 = (value2 < min2) ? value2 : min2;
+      }
+      if (first != last) {
+        Value value = get_value(first);
+        max = (max < value) ? value : max;
+        min = (value < min) ? value : min;
+      }
+      max = (max < max2) ? max2 : max;
+      min = (min2 < min) ? min2 : min;
+    }
+
+    //Gets the bin of an element as (*iter >> log_divisor) - div_min
+    template <class RandomAccessIter, class Div_type>
+    struct shift_bin {
+      shift_bin(unsigned log_divisor_, Div_type div_min_)
+        : log_divisor(log_divisor_), div_min(div_min_) {}
+      size_t operator()(RandomAccessIter iter) const
+      { return size_t((*iter >> log_divisor) - div_min); }
+      unsigned log_divisor;
+      Div_type div_min;
+    };
+
+    //Gets the bin of an element as rshift(*iter, log_divisor) - div_min
+    template <class RandomAccessIter, class Div_type, class Right_shift>
+    struct rshift_bin {
+      rshift_bin(unsigned log_divisor_, Div_type div_min_, Right_shift rshift_)
+        : log_divisor(log_divisor_), div_min(div_min_), rshift(rshift_) {}
+      size_t operator()(RandomAccessIter iter)
+      { return size_t(unsigned(rshift(*iter, log_divisor) - div_min)); }
+      unsigned log_divisor;
+      Div_type div_min;
+      Right_shift rshift;
+    };
+
+    // Adds the number of elements in [first, last) that get_bin puts in each
+    // of the bin_count bins to bin_sizes; this takes roughly 10% of runtime.
+    // When there are enough elements, every other element is counted in a
+    // second histogram, so that runs of elements in the same bin, which are
+    // common in skewed data, don't wait on each increment of one counter.
+    template <class RandomAccessIter, class Get_bin>
+    inline void
+    count_bins(RandomAccessIter first, RandomAccessIter last,
+               size_t *bin_sizes, unsigned bin_count, Get_bin get_bin)
+    {
+      if (bin_count > max_dual_count_bins ||
+          size_t(last - first) < 2 * size_t(bin_count)) {
+        for (; first != last; ++first)
+          bin_sizes[get_bin(first)]++;
+        return;
+      }
+      size_t odd_sizes[max_dual_count_bins];
+      for (unsigned u = 0; u < bin_count; ++u)
+        odd_sizes[u] = 0;
+      for (; last - first >= 2; first += 2) {
+        bin_sizes[get_bin(first)]++;
+        odd_sizes[get_bin(first + 1)]++;
+      }
+      if (first != last)
+        bin_sizes[get_bin(first)]++;
+      for (unsigned u = 0; u < bin_count; ++u)
+        bin_sizes[u] += odd_sizes[u];
+    }
   }
 }
 }
@@ -0,0 +1,206 @@
+// Details for integer_nth_element, integer_partial_sort, float_nth_element
+// and float_partial_sort.
+
+//          Copyright Steven J. Ross 2001 - 2014.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// See http://www.boost.org/libs/sort for library home page.
+
+#ifndef BOOST_SORT_SPREADSORT_DETAIL_SPREADSORT_SELECT_HPP
+#define BOOST_SORT_SPREADSORT_DETAIL_SPREADSORT_SELECT_HPP
+#include <algorithm>
+#include <vector>
+#include <iterator>
+#include <boost/sort/spreadsort/detail/constants.hpp>
+#include <boost/sort/spreadsort/detail/spreadsort_common.hpp>
+#include <boost/sort/spreadsort/detail/integer_sort.hpp>
+#include <boost/sort/spreadsort/detail/stable_spreadsort.hpp>
+#include <boost/sort/pdqsort/pdqsort.hpp>
+
+namespace boost {
+namespace sort {
+namespace spreadsort {
+  namespace detail {
+    //Right shift functor on the unsigned key that Get_key maps elements to
+    template <class Get_key>
+    struct key_shift {
+      typedef typename Get_key::Key_type Key_type;
+      explicit key_shift(Get_key get_key_) : get_key(get_key_) {}
+      template <class Data_type>
+      Key_type operator()(const Data_type &x, unsigned offset)
+      { return get_key(x) >> offset; }
+      Get_key get_key;
+    };
+
+    //Compares the unsigned keys that Get_key maps elements to
+    template <class Get_key>
+    struct key_less {
+      explicit key_less(Get_key get_key_) : get_key(get_key_) {}
+      template <class Data_type>
+      bool operator()(const Data_type &x, const Data_type &y)
+      { return get_key(x) < get_key(y); }
+      Get_key get_key;
+    };
+
+    //True for the elements of the bins before bin
+    template <class Key_type, class Right_shift>
+    struct bin_before {
+      bin_before(Right_shift &rshift_, unsigned log_divisor_,
+                 Key_type div_min_, size_t bin_)
+        : rshift(rshift_), log_divisor(log_divisor_), div_min(div_min_),
+          bin(bin_) {}
+      template <class Data_type>
+      bool operator()(const Data_type &x)
+      { return size_t(Key_type(rshift(x, log_divisor) - div_min)) < bin; }
+      Right_shift rshift;
+      unsigned log_divisor;
+      Key_type div_min;
+      size_t bin;
+    };
+
+    //Bins [first, last) as spreadsort_rec does, but then only moves the
+    //elements of the bins before the one holding nth to the front, and those
+    //after it to the back, and recurses into that bin alone.  The front is
+    //sorted if sort_before, for partial sorting.
+    template <class Tuning, class Key_type, class RandomAccessIter,
+              class Right_shift, class Compare>
+    inline void
+    spreadsort_select_rec(RandomAccessIter first, RandomAccessIter nth,
+                          RandomAccessIter last, bool sort_before,
+                          std::vector<RandomAccessIter> &bin_cache,
+                          size_t *bin_sizes, Right_shift &rshift,
+                          Compare &comp)
+    {
+      RandomAccessIter max, min;
+      if (is_sorted_or_find_extremes(first, last, max, min, comp))
+        return;
+      unsigned log_divisor =
+        get_log_divisor<Tuning::int_log_mean_bin_size>(last - first,
+            rough_log_2_size(Key_type(rshift(*max, 0) - rshift(*min, 0))),
+            Tuning());
+      Key_type div_min = rshift(*min, log_divisor);
+      Key_type div_max = rshift(*max, log_divisor);
+      unsigned bin_count = unsigned(div_max - div_min) + 1;
+      for (unsigned u = 0; u < bin_count; ++u)
+        bin_sizes[u] = 0;
+      rshift_bin<RandomAccessIter, Key_type, Right_shift>
+        get_bin(log_divisor, div_min, rshift);
+      count_bins(first, last, bin_sizes, bin_count, get_bin);
+
+      //Finding the bin that holds nth
+      size_t rank = nth - first;
+      size_t target = 0;
+      size_t before = 0;
+      for (; before + bin_sizes[target] <= rank; before += bin_sizes[target++]);
+      size_t target_size = bin_sizes[target];
+      //Splitting into the bins before the target, the target, and those
+      //after it: the smaller side is split off from the rest of the data
+      //first, and then the target bin from it
+      typedef bin_before<Key_type, Right_shift> Before;
+      RandomAccessIter lower, upper;
+      if (rank < size_t(last - first) / 2) {
+        upper = std::partition(first, last, Before(rshift, log_divisor,
+                                                   div_min, target + 1));
+        lower = std::partition(first, upper, Before(rshift, log_divisor,
+                                                    div_min, target));
+      }
+      else {
+        lower = std::partition(first, last, Before(rshift, log_divisor,
+                                                   div_min, target));
+        upper = std::partition(lower, last, Before(rshift, log_divisor,
+                                                   div_min, target + 1));
+      }
+
+      if (sort_before && before > 1) {
+        if (before < static_cast<size_t>(Tuning::min_sort_size))
+          boost::sort::pdqsort(first, lower, comp);
+        else
+          spreadsort_rec<RandomAccessIter, Key_type, Right_shift, Compare,
+                         size_t, Tuning::int_log_mean_bin_size,
+                         Tuning::int_log_min_split_count,
+                         Tuning::int_log_finishing_count, Tuning>
+            (first, lower, bin_cache, 0, bin_sizes, rshift, comp);
+      }
+      //If we've bucketsorted, every key in the target bin is equal
+      if (!log_divisor || target_size < 2)
+        return;
+      //Small bins are handled by comparison, as at the top level
+      if (target_size < static_cast<size_t>(Tuning::min_sort_size)) {
+        if (sort_before)
+          std::partial_sort(lower, nth + 1, upper, comp);
+        else
+          std::nth_element(lower, nth, upper, comp);
+        return;
+      }
+      spreadsort_select_rec<Tuning, Key_type>(lower, nth, upper, sort_before,
+                                              bin_cache, bin_sizes, rshift,
+                                              comp);
+    }
+
+    //Places the element that sorting would put at nth there, with no greater
+    //element before it and no lesser one after it; if sort_before, the
+    //elements before it are sorted too
+    template <class Tuning, class RandomAccessIter, class Right_shift,
+              class Compare>
+    inline void
+    spreadsort_select(RandomAccessIter first, RandomAccessIter nth,
+                      RandomAccessIter last, bool sort_before,
+                      Right_shift rshift, Compare comp)
+    {
+      typedef typename Right_shift::Key_type Key_type;
+      if (nth == last)
+        return;
+      if (last - first < Tuning::min_sort_size) {
+        if (sort_before)
+          std::partial_sort(first, nth + 1, last, comp);
+        else
+          std::nth_element(first, nth, last, comp);
+        return;
+      }
+      bin_storage<RandomAccessIter, 1 << Tuning::max_finishing_splits>
+        bins(0);
+      spreadsort_select_rec<Tuning, Key_type>(first, nth, last, sort_before,
+                                              bins.cache, bins.sizes, rshift,
+                                              comp);
+    }
+
+    //Selects on integer keys mapped to unsigned, so that the range of the
+    //keys can't overflow
+    template <class RandomAccessIter, class Div_type, class Right_shift,
+              class Compare>
+    inline void
+    integer_select(RandomAccessIter first, RandomAccessIter nth,
+                   RandomAccessIter last, bool sort_before, Div_type,
+                   Right_shift shift, Compare comp)
+    {
+      typedef typename std::iterator_traits<RandomAccessIter>::value_type
+        Data_type;
+      typedef stable_integer_key<Data_type, Div_type, Right_shift> Get_key;
+      spreadsort_select<default_tuning>(first, nth, last, sort_before,
+                                        key_shift<Get_key>(Get_key(shift)),
+                                        comp);
+    }
+
+    //Selects on floats mapped to unsigned keys in the same order, and
+    //compares those keys, so that -0.0 and 0.0 are told apart consistently
+    template <class RandomAccessIter, class Div_type, class Right_shift>
+    inline void
+    float_select(RandomAccessIter first, RandomAccessIter nth,
+                 RandomAccessIter last, bool sort_before, Div_type,
+                 Right_shift rshift)
+    {
+      typedef typename std::iterator_traits<RandomAccessIter>::value_type
+        Data_type;
+      typedef stable_float_key<Data_type, Div_type, Right_shift> Get_key;
+      spreadsort_select<default_tuning>(first, nth, last, sort_before,
+                                        key_shift<Get_key>(Get_key(rshift)),
+                                        key_less<Get_key>(Get_key(rshift)));
+    }
+  }
+}
+}
+}
+
+#endif
@@ -0,0 +1,223 @@
+// Details for stable_integer_sort and stable_float_sort.
+
+//          Copyright Steven J. Ross 2001 - 2014.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// See http://www.boost.org/libs/sort for library home page.
+
+#ifndef BOOST_SORT_SPREADSORT_DETAIL_STABLE_SPREADSORT_HPP
+#define BOOST_SORT_SPREADSORT_DETAIL_STABLE_SPREADSORT_HPP
+#include <algorithm>
+#include <vector>
+#include <limits>
+#include <climits>
+#include <cstring>
+#include <iterator>
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/make_unsigned.hpp>
+#include <boost/sort/spreadsort/detail/constants.hpp>
+#include <boost/sort/spreadsort/detail/spreadsort_common.hpp>
+
+namespace boost {
+namespace sort {
+namespace spreadsort {
+  namespace detail {
+    //Gets an unsigned key from an integer right shift functor, flipping the
+    //sign bit of signed keys so that negative keys sort first
+    template <class Data_type, class Div_type, class Right_shift>
+    struct stable_integer_key {
+      typedef typename boost::make_unsigned<Div_type>::type Key_type;
+      explicit stable_integer_key(Right_shift shift_) : shift(shift_) {}
+      Key_type operator()(const Data_type &x)
+      {
+        const Key_type sign_flip = std::numeric_limits<Div_type>::is_signed ?
+          Key_type(Key_type(1) << (sizeof(Key_type) * CHAR_BIT - 1)) : 0;
+        return Key_type(shift(x, 0)) ^ sign_flip;
+      }
+      Right_shift shift;
+    };
+
+    //Gets an unsigned key from a float right shift functor, which returns
+    //the bits of the float as a signed integer; negative floats have all
+    //their bits flipped, and positive ones just the sign bit
+    template <class Data_type, class Div_type, class Right_shift>
+    struct stable_float_key {
+      typedef typename boost::make_unsigned<Div_type>::type Key_type;
+      explicit stable_float_key(Right_shift rshift_) : rshift(rshift_) {}
+      Key_type operator()(const Data_type &x)
+      {
+        const unsigned top_bit = sizeof(Key_type) * CHAR_BIT - 1;
+        Key_type bits = Key_type(rshift(x, 0));
+        return bits ^ ((Key_type(0) - (bits >> top_bit))
+                       | Key_type(Key_type(1) << top_bit));
+      }
+      Right_shift rshift;
+    };
+
+    //Right shift functor for float_mem_cast to the same-sized integer
+    template <class Div_type>
+    struct stable_float_cast {
+      template <class Data_type>
+      Div_type operator()(const Data_type &x, unsigned offset) const
+      {
+        BOOST_STATIC_ASSERT(sizeof(Div_type) == sizeof(Data_type));
+        BOOST_STATIC_ASSERT(std::numeric_limits<Data_type>::is_iec559);
+        Div_type result;
+        std::memcpy(&result, &x, sizeof(Div_type));
+        return result >> offset;
+      }
+    };
+
+    //Gets the bin of an element as (key - key_min) >> log_divisor
+    template <class Iter, class Key_type, class Get_key>
+    struct stable_key_bin {
+      stable_key_bin(Get_key &get_key_, Key_type key_min_,
+                     unsigned log_divisor_)
+        : get_key(get_key_), key_min(key_min_), log_divisor(log_divisor_) {}
+      size_t operator()(Iter iter)
+      { return size_t((get_key(*iter) - key_min) >> log_divisor); }
+      Get_key &get_key;
+      Key_type key_min;
+      unsigned log_divisor;
+    };
+
+    //Stable insertion sort by key, for small bins
+    template <class Iter, class Get_key>
+    inline void
+    stable_insertion_sort(Iter first, Iter last, Get_key &get_key)
+    {
+      typedef typename std::iterator_traits<Iter>::value_type Data_type;
+      if (first == last)
+        return;
+      for (Iter current = first + 1; current != last; ++current) {
+        if (!(get_key(*current) < get_key(*(current - 1))))
+          continue;
+        Data_type value = *current;
+        Iter hole = current;
+        do {
+          *hole = *(hole - 1);
+        } while (--hole != first && get_key(value) < get_key(*(hole - 1)));
+        *hole = value;
+      }
+    }
+
+    //Sorts the count elements at source by key.  Each pass stably scatters
+    //them by the top bits of key - minimum key into other, and the bins are
+    //then sorted the same way with the two ranges swapped; the sorted data
+    //ends up in source if result_in_source, and in other otherwise.
+    template <class Key_type, class Source_iter, class Other_iter,
+              class Get_key>
+    inline void
+    stable_spreadsort_rec(Source_iter source, Other_iter other, size_t count,
+                          bool result_in_source,
+                          std::vector<size_t> &bin_cache,
+                          unsigned cache_offset, size_t *bin_sizes,
+                          Get_key &get_key)
+    {
+      if (count <= stable_insertion_count) {
+        stable_insertion_sort(source, source + count, get_key);
+        if (!result_in_source)
+          std::copy(source, source + count, other);
+        return;
+      }
+      Key_type key_min = get_key(*source);
+      Key_type key_max = key_min;
+      for (Source_iter current = source + 1; current != source + count;
+           ++current) {
+        Key_type key = get_key(*current);
+        key_min = key < key_min ? key : key_min;
+        key_max = key_max < key ? key : key_max;
+      }
+      //All the keys are equal, so the data is already sorted
+      if (key_min == key_max) {
+        if (!result_in_source)
+          std::copy(source, source + count, other);
+        return;
+      }
+      //Splitting into no more bins than elements, and at most max_splits
+      //bits at a time, so that the bin counts stay in the L1 cache
+      unsigned log_range = rough_log_2_size(Key_type(key_max - key_min));
+      unsigned log_bins = (std::min)(rough_log_2_size(count),
+                                     unsigned(max_splits));
+      unsigned log_divisor = log_range > log_bins ? log_range - log_bins : 0;
+      unsigned bin_count =
+        unsigned(Key_type(key_max - key_min) >> log_divisor) + 1;
+      unsigned cache_end;
+      size_t *bins = size_bins(bin_sizes, bin_cache, cache_offset, cache_end,
+                               bin_count);
+      stable_key_bin<Source_iter, Key_type, Get_key>
+        get_bin(get_key, key_min, log_divisor);
+      count_bins(source, source + count, bin_sizes, bin_count, get_bin);
+      size_t bin_start = 0;
+      for (unsigned u = 0; u < bin_count; ++u) {
+        bins[u] = bin_start;
+        bin_start += bin_sizes[u];
+        bin_sizes[u] = bins[u];
+      }
+      for (Source_iter current = source; current != source + count;
+           ++current)
+        other[bin_sizes[get_bin(current)]++] = *current;
+
+      //Each bin holds a single key
+      if (!log_divisor) {
+        if (result_in_source)
+          std::copy(other, other + count, source);
+        return;
+      }
+      //bin_cache may be reallocated by the recursive calls
+      for (unsigned u = 0; u < bin_count; ++u) {
+        size_t start = bin_cache[cache_offset + u];
+        size_t end = u + 1 < bin_count ? bin_cache[cache_offset + u + 1]
+                                       : count;
+        if (end != start)
+          stable_spreadsort_rec<Key_type>(other + start, source + start,
+              end - start, !result_in_source, bin_cache, cache_end,
+              bin_sizes, get_key);
+      }
+    }
+
+    //Allocates the buffer and makes the initial recursive call
+    template <class RandomAccessIter, class Get_key>
+    inline void
+    stable_spreadsort(RandomAccessIter first, RandomAccessIter last,
+                      Get_key get_key)
+    {
+      typedef typename std::iterator_traits<RandomAccessIter>::value_type
+        Data_type;
+      typedef typename Get_key::Key_type Key_type;
+      std::vector<Data_type> buffer(last - first);
+      std::vector<size_t> bin_cache;
+      size_t bin_sizes[1 << max_splits];
+      stable_spreadsort_rec<Key_type>(first, buffer.begin(), last - first,
+                                      true, bin_cache, 0, bin_sizes, get_key);
+    }
+
+    template <class RandomAccessIter, class Div_type, class Right_shift>
+    inline void
+    stable_integer_sort(RandomAccessIter first, RandomAccessIter last,
+                        Div_type, Right_shift shift)
+    {
+      typedef typename std::iterator_traits<RandomAccessIter>::value_type
+        Data_type;
+      stable_spreadsort(first, last,
+          stable_integer_key<Data_type, Div_type, Right_shift>(shift));
+    }
+
+    template <class RandomAccessIter, class Div_type, class Right_shift>
+    inline void
+    stable_float_sort(RandomAccessIter first, RandomAccessIter last,
+                      Div_type, Right_shift rshift)
+    {
+      typedef typename std::iterator_traits<RandomAccessIter>::value_type
+        Data_type;
+      stable_spreadsort(first, last,
+          stable_float_key<Data_type, Div_type, Right_shift>(rshift));
+    }
+  }
+}
+}
+}
+
+#endif
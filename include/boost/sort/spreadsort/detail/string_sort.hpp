@@ -31,6 +31,45 @@ namespace spreadsort {
   namespace detail {
     static const int max_step_size = 64;
 
+    //Gets the bin of a string from its character at char_offset.  Strings
+    //not longer than char_offset go to bin 0, or to the last bin when
+    //sorting in reverse, where the characters are counted from max_bin down.
+    template <class RandomAccessIter, class Unsigned_char_type, bool Reverse>
+    struct char_bin {
+      char_bin(size_t char_offset_, unsigned max_bin_)
+        : char_offset(char_offset_), max_bin(max_bin_) {}
+      size_t operator()(RandomAccessIter iter) const
+      {
+        if ((*iter).size() <= char_offset)
+          return Reverse ? max_bin + 1 : 0;
+        unsigned c = static_cast<Unsigned_char_type>((*iter)[char_offset]);
+        return Reverse ? max_bin - c : c + 1;
+      }
+      size_t char_offset;
+      unsigned max_bin;
+    };
+
+    //The same, with the character and length given by functors
+    template <class RandomAccessIter, class Get_char, class Get_length,
+              bool Reverse>
+    struct functor_char_bin {
+      functor_char_bin(size_t char_offset_, unsigned max_bin_,
+                       Get_char get_character_, Get_length length_)
+        : char_offset(char_offset_), max_bin(max_bin_),
+          get_character(get_character_), length(length_) {}
+      size_t operator()(RandomAccessIter iter)
+      {
+        if (length(*iter) <= char_offset)
+          return Reverse ? max_bin + 1 : 0;
+        unsigned c = get_character((*iter), char_offset);
+        return Reverse ? max_bin - c : c + 1;
+      }
+      size_t char_offset;
+      unsigned max_bin;
+      Get_char get_character;
+      Get_length length;
+    };
+
     //Offsetting on identical characters.  This function works a chunk of
     //characters at a time for cache efficiency and optimal worst-case
     //performance.
@@ -190,14 +229,9 @@ namespace spreadsort {
                                           cache_end, membin_count) + 1;
 
       //Calculating the size of each bin; this takes roughly 10% of runtime
-      for (RandomAccessIter current = first; current != last; ++current) {
-        if ((*current).size() <= char_offset) {
-          bin_sizes[0]++;
-        }
-        else
-          bin_sizes[static_cast<Unsigned_char_type>((*current)[char_offset])
-                    + 1]++;
-      }
+      count_bins(first, last, bin_sizes, membin_count,
+                 char_bin<RandomAccessIter, Unsigned_char_type, false>(
+                   char_offset, bin_count - 1));
       //Assign the bin positions
       bin_cache[cache_offset] = first;
       for (unsigned u = 0; u < membin_count - 1; u++)
@@ -299,14 +333,9 @@ namespace spreadsort {
       RandomAccessIter * end_bin = &(bin_cache[cache_offset + max_bin]);
 
       //Calculating the size of each bin; this takes roughly 10% of runtime
-      for (RandomAccessIter current = first; current != last; ++current) {
-        if ((*current).size() <= char_offset) {
-          bin_sizes[bin_count]++;
-        }
-        else
-          bin_sizes[max_bin - static_cast<Unsigned_char_type>
-            ((*current)[char_offset])]++;
-      }
+      count_bins(first, last, bin_sizes, membin_count,
+                 char_bin<RandomAccessIter, Unsigned_char_type, true>(
+                   char_offset, max_bin));
       //Assign the bin positions
       bin_cache[cache_offset] = first;
       for (unsigned u = 0; u < membin_count - 1; u++)
@@ -404,13 +433,10 @@ namespace spreadsort {
                                           cache_end, membin_count) + 1;
 
       //Calculating the size of each bin; this takes roughly 10% of runtime
-      for (RandomAccessIter current = first; current != last; ++current) {
-        if (length(*current) <= char_offset) {
-          bin_sizes[0]++;
-        }
-        else
-          bin_sizes[get_character((*current), char_offset) + 1]++;
-      }
+      count_bins(first, last, bin_sizes, membin_count,
+                 functor_char_bin<RandomAccessIter, Get_char, Get_length,
+                                  false>(char_offset, bin_count - 1,
+                                         get_character, length));
       //Assign the bin positions
       bin_cache[cache_offset] = first;
       for (unsigned u = 0; u < membin_count - 1; u++)
@@ -505,13 +531,10 @@ namespace spreadsort {
                                           cache_end, membin_count) + 1;
 
       //Calculating the size of each bin; this takes roughly 10% of runtime
-      for (RandomAccessIter current = first; current != last; ++current) {
-        if (length(*current) <= char_offset) {
-          bin_sizes[0]++;
-        }
-        else
-          bin_sizes[get_character((*current), char_offset) + 1]++;
-      }
+      count_bins(first, last, bin_sizes, membin_count,
+                 functor_char_bin<RandomAccessIter, Get_char, Get_length,
+                                  false>(char_offset, bin_count - 1,
+                                         get_character, length));
       //Assign the bin positions
       bin_cache[cache_offset] = first;
       for (unsigned u = 0; u < membin_count - 1; u++)
@@ -610,13 +633,10 @@ namespace spreadsort {
       RandomAccessIter *end_bin = &(bin_cache[cache_offset + max_bin]);
 
       //Calculating the size of each bin; this takes roughly 10% of runtime
-      for (RandomAccessIter current = first; current != last; ++current) {
-        if (length(*current) <= char_offset) {
-          bin_sizes[bin_count]++;
-        }
-        else
-          bin_sizes[max_bin - get_character((*current), char_offset)]++;
-      }
+      count_bins(first, last, bin_sizes, membin_count,
+                 functor_char_bin<RandomAccessIter, Get_char, Get_length,
+                                  true>(char_offset, max_bin,
+                                        get_character, length));
       //Assign the bin positions
       bin_cache[cache_offset] = first;
       for (unsigned u = 0; u < membin_count - 1; u++)
@@ -685,19 +705,21 @@ namespace spreadsort {
     inline typename boost::enable_if_c< sizeof(Unsigned_char_type) <= 2, void
                                                                       >::type
     string_sort(RandomAccessIter first, RandomAccessIter last,
-                Unsigned_char_type)
+                Unsigned_char_type,
+                spreadsort_workspace<RandomAccessIter> *workspace = 0)
     {
-      size_t bin_sizes[(1 << (8 * sizeof(Unsigned_char_type))) + 1];
-      std::vector<RandomAccessIter> bin_cache;
+      bin_storage<RandomAccessIter,
+                  (1 << (8 * sizeof(Unsigned_char_type))) + 1> bins(workspace);
       string_sort_rec<RandomAccessIter, Unsigned_char_type>
-        (first, last, 0, bin_cache, 0, bin_sizes);
+        (first, last, 0, bins.cache, 0, bins.sizes);
     }
 
     template <class RandomAccessIter, class Unsigned_char_type>
     inline typename boost::disable_if_c< sizeof(Unsigned_char_type) <= 2, void
                                                                        >::type
     string_sort(RandomAccessIter first, RandomAccessIter last,
-                Unsigned_char_type)
+                Unsigned_char_type,
+                spreadsort_workspace<RandomAccessIter> * = 0)
     {
       // Use boost::sort::pdqsort if the char_type is too large for string_sort.
       boost::sort::pdqsort(first, last);
@@ -708,19 +730,21 @@ namespace spreadsort {
     inline typename boost::enable_if_c< sizeof(Unsigned_char_type) <= 2, void
                                                                       >::type
     reverse_string_sort(RandomAccessIter first, RandomAccessIter last,
-                        Unsigned_char_type)
+                        Unsigned_char_type,
+                        spreadsort_workspace<RandomAccessIter> *workspace = 0)
     {
-      size_t bin_sizes[(1 << (8 * sizeof(Unsigned_char_type))) + 1];
-      std::vector<RandomAccessIter> bin_cache;
+      bin_storage<RandomAccessIter,
+                  (1 << (8 * sizeof(Unsigned_char_type))) + 1> bins(workspace);
       reverse_string_sort_rec<RandomAccessIter, Unsigned_char_type>
-        (first, last, 0, bin_cache, 0, bin_sizes);
+        (first, last, 0, bins.cache, 0, bins.sizes);
     }
 
     template <class RandomAccessIter, class Unsigned_char_type>
     inline typename boost::disable_if_c< sizeof(Unsigned_char_type) <= 2, void
                                                                        >::type
     reverse_string_sort(RandomAccessIter first, RandomAccessIter last,
-                Unsigned_char_type)
+                Unsigned_char_type,
+                spreadsort_workspace<RandomAccessIter> * = 0)
     {
       typedef typename std::iterator_traits<RandomAccessIter>::value_type
         Data_type;
@@ -734,12 +758,13 @@ namespace spreadsort {
     inline typename boost::enable_if_c< sizeof(Unsigned_char_type) <= 2, void
                                                                       >::type
     string_sort(RandomAccessIter first, RandomAccessIter last,
-                Get_char get_character, Get_length length, Unsigned_char_type)
+                Get_char get_character, Get_length length, Unsigned_char_type,
+                spreadsort_workspace<RandomAccessIter> *workspace = 0)
     {
-      size_t bin_sizes[(1 << (8 * sizeof(Unsigned_char_type))) + 1];
-      std::vector<RandomAccessIter> bin_cache;
+      bin_storage<RandomAccessIter,
+                  (1 << (8 * sizeof(Unsigned_char_type))) + 1> bins(workspace);
       string_sort_rec<RandomAccessIter, Unsigned_char_type, Get_char,
-        Get_length>(first, last, 0, bin_cache, 0, bin_sizes, get_character, length);
+        Get_length>(first, last, 0, bins.cache, 0, bins.sizes, get_character, length);
     }
 
     template <class RandomAccessIter, class Get_char, class Get_length,
@@ -747,7 +772,8 @@ namespace spreadsort {
     inline typename boost::disable_if_c< sizeof(Unsigned_char_type) <= 2, void
                                                                        >::type
     string_sort(RandomAccessIter first, RandomAccessIter last,
-                Get_char /* get_character */, Get_length /* length */, Unsigned_char_type)
+                Get_char /* get_character */, Get_length /* length */, Unsigned_char_type,
+                spreadsort_workspace<RandomAccessIter> * = 0)
     {
       // Use boost::sort::pdqsort if the char_type is too large for string_sort.
       boost::sort::pdqsort(first, last);
@@ -759,13 +785,14 @@ namespace spreadsort {
     inline typename boost::enable_if_c< sizeof(Unsigned_char_type) <= 2, void
                                                                       >::type
     string_sort(RandomAccessIter first, RandomAccessIter last,
-        Get_char get_character, Get_length length, Compare comp, Unsigned_char_type)
+        Get_char get_character, Get_length length, Compare comp, Unsigned_char_type,
+        spreadsort_workspace<RandomAccessIter> *workspace = 0)
     {
-      size_t bin_sizes[(1 << (8 * sizeof(Unsigned_char_type))) + 1];
-      std::vector<RandomAccessIter> bin_cache;
+      bin_storage<RandomAccessIter,
+                  (1 << (8 * sizeof(Unsigned_char_type))) + 1> bins(workspace);
       string_sort_rec<RandomAccessIter, Unsigned_char_type, Get_char
         , Get_length, Compare>
-        (first, last, 0, bin_cache, 0, bin_sizes, get_character, length, comp);
+        (first, last, 0, bins.cache, 0, bins.sizes, get_character, length, comp);
     }
 
     //disable_if_c was refusing to compile, so rewrote to use enable_if_c
@@ -774,7 +801,8 @@ namespace spreadsort {
     inline typename boost::enable_if_c< (sizeof(Unsigned_char_type) > 2), void
                                         >::type
     string_sort(RandomAccessIter first, RandomAccessIter last,
-        Get_char /* get_character */, Get_length /* length */, Compare comp, Unsigned_char_type)
+        Get_char /* get_character */, Get_length /* length */, Compare comp, Unsigned_char_type,
+        spreadsort_workspace<RandomAccessIter> * = 0)
     {
       // Use boost::sort::pdqsort if the char_type is too large for string_sort.
       boost::sort::pdqsort(first, last, comp);
@@ -786,13 +814,14 @@ namespace spreadsort {
     inline typename boost::enable_if_c< sizeof(Unsigned_char_type) <= 2, void
                                                                       >::type
     reverse_string_sort(RandomAccessIter first, RandomAccessIter last,
-        Get_char get_character, Get_length length, Compare comp, Unsigned_char_type)
+        Get_char get_character, Get_length length, Compare comp, Unsigned_char_type,
+        spreadsort_workspace<RandomAccessIter> *workspace = 0)
     {
-      size_t bin_sizes[(1 << (8 * sizeof(Unsigned_char_type))) + 1];
-      std::vector<RandomAccessIter> bin_cache;
+      bin_storage<RandomAccessIter,
+                  (1 << (8 * sizeof(Unsigned_char_type))) + 1> bins(workspace);
       reverse_string_sort_rec<RandomAccessIter, Unsigned_char_type, Get_char,
                               Get_length, Compare>
-        (first, last, 0, bin_cache, 0, bin_sizes, get_character, length, comp);
+        (first, last, 0, bins.cache, 0, bins.sizes, get_character, length, comp);
     }
 
     template <class RandomAccessIter, class Get_char, class Get_length,
@@ -800,7 +829,8 @@ namespace spreadsort {
     inline typename boost::disable_if_c< sizeof(Unsigned_char_type) <= 2, void
                                                                        >::type
     reverse_string_sort(RandomAccessIter first, RandomAccessIter last,
-        Get_char /* get_character */, Get_length /* length */, Compare comp, Unsigned_char_type)
+        Get_char /* get_character */, Get_length /* length */, Compare comp, Unsigned_char_type,
+        spreadsort_workspace<RandomAccessIter> * = 0)
     {
       // Use boost::sort::pdqsort if the char_type is too large for string_sort.
       boost::sort::pdqsort(first, last, comp);
@@ -0,0 +1,235 @@
+// Details for string_sort_cached, a string_sort that radix sorts cached
+// key prefixes instead of reading the strings on every pass.
+
+//          Copyright Steven J. Ross 2001 - 2009.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// See http://www.boost.org/libs/sort/ for library home page.
+
+#ifndef BOOST_SORT_SPREADSORT_DETAIL_STRING_SORT_CACHED_HPP
+#define BOOST_SORT_SPREADSORT_DETAIL_STRING_SORT_CACHED_HPP
+#include <algorithm>
+#include <vector>
+#include <limits>
+#include <climits>
+#include <iterator>
+#include <boost/static_assert.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/type_traits/make_unsigned.hpp>
+#include <boost/sort/spreadsort/detail/constants.hpp>
+#include <boost/sort/spreadsort/integer_sort.hpp>
+#include <boost/sort/pdqsort/pdqsort.hpp>
+
+namespace boost {
+namespace sort {
+namespace spreadsort {
+  namespace detail {
+    //The next characters of a string, packed big-endian so that comparing
+    //prefixes compares the strings, and the string it came from
+    template <class Index_type>
+    struct prefix_entry {
+      boost::uint64_t prefix;
+      Index_type index;
+    };
+
+    struct prefix_shift {
+      template <class Entry>
+      boost::uint64_t operator()(const Entry &x, unsigned offset) const {
+        return x.prefix >> offset;
+      }
+    };
+
+    struct prefix_less {
+      template <class Entry>
+      bool operator()(const Entry &x, const Entry &y) const {
+        return x.prefix < y.prefix;
+      }
+    };
+
+    //Number of characters of Unsigned_char_type in a prefix
+    template <class Unsigned_char_type>
+    struct prefix_traits {
+      BOOST_STATIC_ASSERT(sizeof(Unsigned_char_type) < sizeof(boost::uint64_t));
+      enum { char_bits = sizeof(Unsigned_char_type) * CHAR_BIT,
+             prefix_chars = sizeof(boost::uint64_t) / sizeof(Unsigned_char_type) };
+    };
+
+    //Packs the characters starting at offset, padding past the end with 0;
+    //strings whose prefixes are equal must be checked for which ended first
+    template <class Unsigned_char_type, class Data_type, class Get_char,
+              class Get_length>
+    inline boost::uint64_t
+    load_prefix(const Data_type &x, size_t offset, Get_char &get_character,
+                Get_length &length)
+    {
+      typedef prefix_traits<Unsigned_char_type> traits;
+      const size_t size = length(x);
+      boost::uint64_t prefix = 0;
+      for (unsigned u = 0; u < static_cast<unsigned>(traits::prefix_chars);
+           ++u) {
+        prefix <<= static_cast<unsigned>(traits::char_bits);
+        //Through the unsigned type, so that a signed type isn't sign-extended
+        if (offset + u < size)
+          prefix |= static_cast<typename boost::make_unsigned<
+            Unsigned_char_type>::type>(get_character(x, offset + u));
+      }
+      return prefix;
+    }
+
+    //True if the string ends at or before offset
+    template <class RandomAccessIter, class Get_length>
+    struct ends_by {
+      RandomAccessIter strings;
+      Get_length length;
+      size_t offset;
+      ends_by(RandomAccessIter s, Get_length l, size_t o)
+        : strings(s), length(l), offset(o) {}
+      template <class Entry>
+      bool operator()(const Entry &x) { return length(strings[x.index]) <= offset; }
+    };
+
+    template <class RandomAccessIter, class Get_length>
+    struct shorter {
+      RandomAccessIter strings;
+      Get_length length;
+      shorter(RandomAccessIter s, Get_length l) : strings(s), length(l) {}
+      template <class Entry>
+      bool operator()(const Entry &x, const Entry &y) {
+        return length(strings[x.index]) < length(strings[y.index]);
+      }
+    };
+
+    //Entries whose strings all match up to offset, still to be sorted
+    template <class Entry_iter>
+    struct cached_range {
+      Entry_iter first;
+      Entry_iter last;
+      size_t offset;
+      cached_range(Entry_iter f, Entry_iter l, size_t o)
+        : first(f), last(l), offset(o) {}
+    };
+
+    //Sorts [first, last) on the cached prefixes of the characters.  Only
+    //runs of equal prefixes go back to the strings, to refill their
+    //prefixes.  The runs wait on an explicit stack instead of recursing,
+    //as strings with a long shared prefix take one step per prefix.
+    template <class Unsigned_char_type, class Entry_iter,
+              class RandomAccessIter, class Get_char, class Get_length>
+    inline void
+    string_sort_cached_rec(Entry_iter first, Entry_iter last,
+                           RandomAccessIter strings,
+                           Get_char &get_character, Get_length &length)
+    {
+      typedef cached_range<Entry_iter> Range;
+      std::vector<Range> pending(1, Range(first, last, 0));
+      while (!pending.empty()) {
+        const Range range = pending.back();
+        pending.pop_back();
+        const size_t next_offset = range.offset +
+          prefix_traits<Unsigned_char_type>::prefix_chars;
+        boost::sort::spreadsort::integer_sort(range.first, range.last,
+                                              prefix_shift(), prefix_less());
+        Entry_iter run = range.first;
+        while (run != range.last) {
+          Entry_iter run_end = run + 1;
+          while (run_end != range.last && run_end->prefix == run->prefix)
+            ++run_end;
+          if (run_end - run > 1) {
+            //A string that ends within the prefix is a prefix of the others
+            //in the run, padded with 0, so these go first, shortest first
+            Entry_iter rest = std::partition(run, run_end,
+                ends_by<RandomAccessIter, Get_length>(strings, length,
+                                                      next_offset));
+            if (rest - run > 1)
+              boost::sort::pdqsort(run, rest,
+                  shorter<RandomAccessIter, Get_length>(strings, length));
+            if (run_end - rest > 1) {
+              for (Entry_iter current = rest; current != run_end; ++current)
+                current->prefix = load_prefix<Unsigned_char_type>(
+                    strings[current->index], next_offset, get_character,
+                    length);
+              pending.push_back(Range(rest, run_end, next_offset));
+            }
+          }
+          run = run_end;
+        }
+      }
+    }
+
+    //Moves strings[entries[u].index] to u, for every u, by following the
+    //cycles of the permutation with swaps, which are cheap for strings
+    template <class Entry_iter, class RandomAccessIter>
+    inline void
+    apply_string_order(Entry_iter entries, size_t count,
+                       RandomAccessIter strings)
+    {
+      for (size_t u = 0; u < count; ++u) {
+        size_t current = u;
+        while (entries[current].index != u) {
+          size_t next = entries[current].index;
+          std::iter_swap(strings + current, strings + next);
+          entries[current].index = current;
+          current = next;
+        }
+        entries[current].index = current;
+      }
+    }
+
+    template <class Index_type, class RandomAccessIter, class Get_char,
+              class Get_length, class Unsigned_char_type>
+    inline void
+    string_sort_cached(RandomAccessIter first, RandomAccessIter last,
+                       Get_char get_character, Get_length length,
+                       Unsigned_char_type)
+    {
+      typedef prefix_entry<Index_type> Entry;
+      const size_t count = last - first;
+      std::vector<Entry> entries(count);
+      for (size_t u = 0; u < count; ++u) {
+        entries[u].prefix = load_prefix<Unsigned_char_type>(first[u], 0,
+            get_character, length);
+        entries[u].index = static_cast<Index_type>(u);
+      }
+      string_sort_cached_rec<Unsigned_char_type>(entries.begin(),
+          entries.end(), first, get_character, length);
+      apply_string_order(entries.begin(), count, first);
+    }
+
+    //Uses 32-bit indices when they are enough, for smaller entries
+    template <class RandomAccessIter, class Get_char, class Get_length,
+              class Unsigned_char_type>
+    inline void
+    string_sort_cached(RandomAccessIter first, RandomAccessIter last,
+                       Get_char get_character, Get_length length,
+                       Unsigned_char_type unused)
+    {
+      if (static_cast<boost::uintmax_t>(last - first) <=
+          (std::numeric_limits<boost::uint32_t>::max)())
+        string_sort_cached<boost::uint32_t>(first, last, get_character,
+                                            length, unused);
+      else
+        string_sort_cached<size_t>(first, last, get_character, length,
+                                   unused);
+    }
+
+    //Default character access, the same as string_sort uses
+    template <class Unsigned_char_type>
+    struct cached_bracket {
+      template <class Data_type>
+      Unsigned_char_type operator()(const Data_type &x, size_t offset) const {
+        return x[offset];
+      }
+    };
+
+    struct cached_size {
+      template <class Data_type>
+      size_t operator()(const Data_type &x) const { return x.size(); }
+    };
+  }
+}
+}
+}
+
+#endif
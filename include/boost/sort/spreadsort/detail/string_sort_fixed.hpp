@@ -0,0 +1,265 @@
+// Details for string_sort_fixed, a string_sort for keys of a fixed number
+// of bytes.
+
+//          Copyright Steven J. Ross 2001 - 2009.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// See http://www.boost.org/libs/sort/ for library home page.
+
+#ifndef BOOST_SORT_SPREADSORT_DETAIL_STRING_SORT_FIXED_HPP
+#define BOOST_SORT_SPREADSORT_DETAIL_STRING_SORT_FIXED_HPP
+#include <algorithm>
+#include <vector>
+#include <iterator>
+#include <cstddef>
+#include <boost/static_assert.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/array.hpp>
+#include <boost/config.hpp>
+#include <boost/sort/spreadsort/detail/constants.hpp>
+#include <boost/sort/spreadsort/detail/spreadsort_common.hpp>
+#include <boost/sort/pdqsort/pdqsort.hpp>
+#ifndef BOOST_NO_CXX11_HDR_ARRAY
+#include <array>
+#endif
+
+namespace boost {
+namespace sort {
+namespace spreadsort {
+  namespace detail {
+    //Loads count <= 8 bytes big-endian, so that comparing the results
+    //compares the bytes in memcmp order; compilers turn the full-word case
+    //into a single load and byte swap
+    inline boost::uint64_t
+    load_big_endian(const unsigned char *bytes, size_t count)
+    {
+      boost::uint64_t result = 0;
+      for (size_t u = 0; u < count; ++u)
+        result = (result << 8) | bytes[u];
+      return result;
+    }
+
+    inline boost::uint64_t
+    load_big_endian(const unsigned char *bytes)
+    {
+      return (boost::uint64_t(bytes[0]) << 56) |
+             (boost::uint64_t(bytes[1]) << 48) |
+             (boost::uint64_t(bytes[2]) << 40) |
+             (boost::uint64_t(bytes[3]) << 32) |
+             (boost::uint64_t(bytes[4]) << 24) |
+             (boost::uint64_t(bytes[5]) << 16) |
+             (boost::uint64_t(bytes[6]) << 8) |
+              boost::uint64_t(bytes[7]);
+    }
+
+    //Gets the key bytes of an element, whatever byte type get_key points to
+    template <class Get_key>
+    struct fixed_key_bytes {
+      explicit fixed_key_bytes(Get_key get_key_) : get_key(get_key_) {}
+      template <class Data_type>
+      const unsigned char *operator()(const Data_type &x)
+      {
+        BOOST_STATIC_ASSERT(sizeof(*get_key(x)) == 1);
+        return reinterpret_cast<const unsigned char *>(get_key(x));
+      }
+      Get_key get_key;
+    };
+
+    //Returns the offset of the first byte from offset that differs between
+    //the keys x and y, which are equal before offset, or Width if they are
+    //equal from offset on.  The last partial word is read as the last 8
+    //bytes of the keys, as the bytes before offset don't differ.
+    template <size_t Width>
+    inline size_t
+    fixed_mismatch(const unsigned char *x, const unsigned char *y,
+                   size_t offset)
+    {
+      if (Width < 8) {
+        for (; offset < Width && x[offset] == y[offset]; ++offset);
+        return offset;
+      }
+      while (offset < Width) {
+        if (offset > Width - 8)
+          offset = Width - 8;
+        boost::uint64_t diff = load_big_endian(x + offset) ^
+                               load_big_endian(y + offset);
+        if (diff) {
+          for (; !(diff >> 56); diff <<= 8)
+            ++offset;
+          return offset;
+        }
+        offset += 8;
+      }
+      return Width;
+    }
+
+    //Compares keys identical up to char_offset, a word at a time
+    template <size_t Width, class Get_key>
+    struct fixed_offset_less_than {
+      fixed_offset_less_than(size_t char_offset, Get_key get_key_)
+        : fchar_offset(char_offset), get_key(get_key_) {}
+      template <class Data_type>
+      inline bool operator()(const Data_type &x, const Data_type &y)
+      {
+        const unsigned char *x_key = get_key(x);
+        const unsigned char *y_key = get_key(y);
+        size_t offset = fchar_offset;
+        if (Width < 8)
+          return offset < Width &&
+            load_big_endian(x_key + offset, Width - offset) <
+            load_big_endian(y_key + offset, Width - offset);
+        //As in fixed_mismatch, the last word ends at the end of the keys
+        for (; offset < Width; offset += 8) {
+          if (offset > Width - 8)
+            offset = Width - 8;
+          boost::uint64_t x_word = load_big_endian(x_key + offset);
+          boost::uint64_t y_word = load_big_endian(y_key + offset);
+          if (x_word != y_word)
+            return x_word < y_word;
+        }
+        return false;
+      }
+      size_t fchar_offset;
+      Get_key get_key;
+    };
+
+    //Gets the bin of an element as its key byte at char_offset
+    template <class RandomAccessIter, class Get_key>
+    struct fixed_char_bin {
+      fixed_char_bin(size_t char_offset_, Get_key &get_key_)
+        : char_offset(char_offset_), get_key(get_key_) {}
+      size_t operator()(RandomAccessIter iter)
+      { return get_key(*iter)[char_offset]; }
+      size_t char_offset;
+      Get_key &get_key;
+    };
+
+    //String sorting recursive implementation.  As every key has Width bytes,
+    //there is no bin of empties and no length to check.
+    template <size_t Width, class RandomAccessIter, class Get_key>
+    inline void
+    string_sort_fixed_rec(RandomAccessIter first, RandomAccessIter last,
+                          size_t char_offset,
+                          std::vector<RandomAccessIter> &bin_cache,
+                          unsigned cache_offset, size_t *bin_sizes,
+                          Get_key &get_key)
+    {
+      //Offsetting on identical characters, up to the first byte in which
+      //some key differs from the first
+      const unsigned char *first_key = get_key(*first);
+      size_t mismatch = Width;
+      for (RandomAccessIter current = first + 1;
+           current != last && mismatch != char_offset; ++current)
+        mismatch = (std::min)(mismatch, fixed_mismatch<Width>(first_key,
+                                            get_key(*current), char_offset));
+      //All the keys are equal
+      if (mismatch == Width)
+        return;
+      char_offset = mismatch;
+
+      const unsigned bin_count = 1 << 8;
+      //Equal worst-case of radix and comparison is when bin_count = n*log(n).
+      const unsigned max_size = bin_count;
+      unsigned cache_end;
+      RandomAccessIter * bins = size_bins(bin_sizes, bin_cache, cache_offset,
+                                          cache_end, bin_count);
+      fixed_char_bin<RandomAccessIter, Get_key> get_bin(char_offset, get_key);
+      count_bins(first, last, bin_sizes, bin_count, get_bin);
+      //Assign the bin positions
+      bins[0] = first;
+      for (unsigned u = 0; u < bin_count - 1; u++)
+        bins[u + 1] = bins[u] + bin_sizes[u];
+
+      //iterate backwards to find the last bin with elements in it
+      //this saves iterations in multiple loops
+      unsigned last_bin = bin_count - 1;
+      for (; last_bin && !bin_sizes[last_bin]; --last_bin);
+      //Swap into place
+      RandomAccessIter next_bin_start = first;
+      for (unsigned u = 0; u < last_bin; ++u) {
+        RandomAccessIter * local_bin = bins + u;
+        next_bin_start += bin_sizes[u];
+        //Iterating over each element in this bin
+        for (RandomAccessIter current = *local_bin; current < next_bin_start;
+            ++current) {
+          //Swapping into place until the correct element has been swapped in
+          for (RandomAccessIter * target_bin = bins + get_bin(current);
+               target_bin != local_bin; target_bin = bins + get_bin(current))
+            iter_swap(current, (*target_bin)++);
+        }
+        *local_bin = next_bin_start;
+      }
+      bins[last_bin] = last;
+      //All the keys are equal within each bin
+      if (char_offset + 1 == Width)
+        return;
+      //Recursing
+      RandomAccessIter lastPos = first;
+      for (unsigned u = cache_offset; u <= cache_offset + last_bin;
+          lastPos = bin_cache[u], ++u) {
+        size_t count = bin_cache[u] - lastPos;
+        //don't sort unless there are at least two items to Compare
+        if (count < 2)
+          continue;
+        //using boost::sort::pdqsort if its worst-case is better
+        if (count < max_size)
+          boost::sort::pdqsort(lastPos, bin_cache[u],
+              fixed_offset_less_than<Width, Get_key>(char_offset + 1,
+                                                     get_key));
+        else
+          string_sort_fixed_rec<Width>(lastPos, bin_cache[u],
+              char_offset + 1, bin_cache, cache_end, bin_sizes, get_key);
+      }
+    }
+
+    //Holds the bin vector and makes the initial recursive call
+    template <size_t Width, class RandomAccessIter, class Get_key>
+    inline void
+    string_sort_fixed(RandomAccessIter first, RandomAccessIter last,
+                      Get_key get_key)
+    {
+      BOOST_STATIC_ASSERT(Width > 0);
+      typedef fixed_key_bytes<Get_key> Get_bytes;
+      Get_bytes get_bytes(get_key);
+      if (last - first < min_sort_size) {
+        boost::sort::pdqsort(first, last,
+            fixed_offset_less_than<Width, Get_bytes>(0, get_bytes));
+        return;
+      }
+      bin_storage<RandomAccessIter, 1 << 8> bins(0);
+      string_sort_fixed_rec<Width>(first, last, 0, bins.cache, 0, bins.sizes,
+                                   get_bytes);
+    }
+
+    //The width of arrays of bytes, which string_sort_fixed can sort
+    //without a key functor
+    template <class Data_type>
+    struct fixed_string_width;
+
+    template <class Char_type, std::size_t N>
+    struct fixed_string_width<boost::array<Char_type, N> > {
+      BOOST_STATIC_ASSERT(sizeof(Char_type) == 1);
+      static const std::size_t value = N;
+    };
+
+#ifndef BOOST_NO_CXX11_HDR_ARRAY
+    template <class Char_type, std::size_t N>
+    struct fixed_string_width<std::array<Char_type, N> > {
+      BOOST_STATIC_ASSERT(sizeof(Char_type) == 1);
+      static const std::size_t value = N;
+    };
+#endif
+
+    struct fixed_array_data {
+      template <class Data_type>
+      const typename Data_type::value_type *operator()(const Data_type &x) const
+      { return x.data(); }
+    };
+  }
+}
+}
+}
+
+#endif
@@ -0,0 +1,49 @@
+//Tuning policy for integer_sort, float_sort and string_sort
+
+//          Copyright Steven J. Ross 2001 - 2014
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+//  See http://www.boost.org/libs/sort for library home page.
+#ifndef BOOST_SORT_SPREADSORT_DETAIL_TUNING_HPP
+#define BOOST_SORT_SPREADSORT_DETAIL_TUNING_HPP
+#include <boost/type_traits/is_base_of.hpp>
+#include <boost/utility/enable_if.hpp>
+#include <boost/sort/spreadsort/detail/constants.hpp>
+
+namespace boost {
+namespace sort {
+namespace spreadsort {
+/*! \brief The tuning constants used by default, from detail/constants.hpp.
+
+  \details To use other settings, derive from @c default_tuning, redeclare
+  the constants to change in an enum, and pass the result as the first
+  template argument, as in <tt>integer_sort<my_tuning>(first, last)</tt>.
+  Every policy is a separate instantiation, so one program can pick between
+  several at runtime, for instance by the cache size of the host.
+*/
+struct default_tuning {
+  enum { max_splits = detail::max_splits,
+         max_finishing_splits = detail::max_finishing_splits,
+         int_log_mean_bin_size = detail::int_log_mean_bin_size,
+         int_log_min_split_count = detail::int_log_min_split_count,
+         int_log_finishing_count = detail::int_log_finishing_count,
+         float_log_mean_bin_size = detail::float_log_mean_bin_size,
+         float_log_min_split_count = detail::float_log_min_split_count,
+         float_log_finishing_count = detail::float_log_finishing_count,
+         min_sort_size = detail::min_sort_size };
+};
+
+namespace detail {
+  //Only allows a policy derived from default_tuning, so that calls that
+  //name the iterator type explicitly are not ambiguous
+  template <class Tuning, class T = void>
+  struct enable_if_tuning
+    : boost::enable_if_c<boost::is_base_of<default_tuning, Tuning>::value, T>
+  { };
+}
+}
+}
+}
+#endif
@@ -0,0 +1,76 @@
+//Reusable bin storage for integer_sort, float_sort and string_sort
+
+//          Copyright Steven J. Ross 2001 - 2014
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+//  See http://www.boost.org/libs/sort for library home page.
+#ifndef BOOST_SORT_SPREADSORT_DETAIL_WORKSPACE_HPP
+#define BOOST_SORT_SPREADSORT_DETAIL_WORKSPACE_HPP
+#include <vector>
+#include <cstddef>
+
+namespace boost {
+namespace sort {
+namespace spreadsort {
+/*! \brief The bin cache and bin sizes of spreadsort, kept between calls.
+
+  \details Each call of @c integer_sort, @c float_sort or @c string_sort
+  otherwise allocates a new bin cache.  Passing the same workspace to
+  repeated calls on the same iterator type grows its storage to the largest
+  size needed, after which those calls make no heap allocations.
+  A workspace must not be used by two sorts at the same time.
+*/
+template <class RandomAccessIter>
+class spreadsort_workspace {
+public:
+  //! Frees the storage.
+  void clear()
+  {
+    std::vector<RandomAccessIter>().swap(cache_);
+    std::vector<std::size_t>().swap(sizes_);
+    std::vector<std::size_t>().swap(counts_);
+  }
+
+  //! The bin cache, of which the sorts use and grow the front.
+  std::vector<RandomAccessIter> &bin_cache() { return cache_; }
+
+  //! Space for @c count bin sizes.
+  std::size_t *bin_sizes(std::size_t count)
+  {
+    if (sizes_.size() < count)
+      sizes_.resize(count);
+    return &sizes_[0];
+  }
+
+  //! The value counts of the counting sort of @c integer_sort.
+  std::vector<std::size_t> &counts() { return counts_; }
+
+private:
+  std::vector<RandomAccessIter> cache_;
+  std::vector<std::size_t> sizes_;
+  std::vector<std::size_t> counts_;
+};
+
+namespace detail {
+  //The bin cache, bin sizes and value counts for one sort: those of the
+  //workspace if there is one, and otherwise local vectors and an array
+  template <class RandomAccessIter, std::size_t Bin_count>
+  struct bin_storage {
+    explicit bin_storage(spreadsort_workspace<RandomAccessIter> *workspace)
+      : cache(workspace ? workspace->bin_cache() : local_cache),
+        sizes(workspace ? workspace->bin_sizes(Bin_count) : local_sizes),
+        counts(workspace ? workspace->counts() : local_counts) {}
+    std::vector<RandomAccessIter> local_cache;
+    std::size_t local_sizes[Bin_count];
+    std::vector<std::size_t> local_counts;
+    std::vector<RandomAccessIter> &cache;
+    std::size_t *sizes;
+    std::vector<std::size_t> &counts;
+  };
+}
+}
+}
+}
+#endif
@@ -21,10 +21,15 @@ Scott McMurray
 #include <cstring>
 #include <limits>
 #include <boost/static_assert.hpp>
+#include <boost/type_traits/make_signed.hpp>
 #include <boost/sort/spreadsort/detail/constants.hpp>
+#include <boost/sort/spreadsort/detail/tuning.hpp>
 #include <boost/sort/spreadsort/detail/float_sort.hpp>
+#include <boost/sort/spreadsort/detail/stable_spreadsort.hpp>
+#include <boost/sort/spreadsort/detail/spreadsort_select.hpp>
 #include <boost/range/begin.hpp>
 #include <boost/range/end.hpp>
+#include <boost/range/iterator.hpp>
 
 namespace boost {
 namespace sort {
@@ -89,7 +94,7 @@ Some performance plots of runtime vs. n and log(range) are provided:\n
     if (last - first < detail::min_sort_size)
       boost::sort::pdqsort(first, last);
     else
-      detail::float_sort(first, last);
+      detail::float_sort<default_tuning>(first, last);
   }
 
     /*!
@@ -119,7 +124,8 @@ Some performance plots of runtime vs. n and log(range) are provided:\n
     if (last - first < detail::min_sort_size)
       boost::sort::pdqsort(first, last);
     else
-      detail::float_sort(first, last, rshift(*first, 0), rshift);
+      detail::float_sort<default_tuning>(first, last, rshift(*first, 0),
+                                         rshift);
   }
 
     /*!
@@ -152,7 +158,8 @@ Some performance plots of runtime vs. n and log(range) are provided:\n
     if (last - first < detail::min_sort_size)
       boost::sort::pdqsort(first, last, comp);
     else
-      detail::float_sort(first, last, rshift(*first, 0), rshift, comp);
+      detail::float_sort<default_tuning>(first, last, rshift(*first, 0),
+                                         rshift, comp);
   }
 
 
@@ -169,6 +176,388 @@ Some performance plots of runtime vs. n and log(range) are provided:\n
   {
       float_sort(boost::begin(range), boost::end(range), rshift, comp);
   }
+
+  /*!
+    \brief Floating-point sort algorithm using random access iterators, with a reusable workspace.
+
+    \details Same as @c float_sort(first, last), but the bin cache and bin sizes are kept in
+    @c workspace instead of being allocated for each call, so once the workspace has grown to
+    the largest size needed, repeated sorts make no heap allocations.
+
+    \param[in] first Iterator pointer to first element.
+    \param[in] last Iterator pointing to one beyond the end of data.
+    \param[in,out] workspace Storage reused between calls; not used by other threads at the same time.
+  */
+  template <class RandomAccessIter>
+  inline void float_sort(RandomAccessIter first, RandomAccessIter last,
+                         spreadsort_workspace<RandomAccessIter> &workspace)
+  {
+    if (last - first < detail::min_sort_size)
+      boost::sort::pdqsort(first, last);
+    else
+      detail::float_sort<default_tuning>(first, last, &workspace);
+  }
+
+  /*!
+    \brief Floating-point sort algorithm using random access iterators with just right-shift functor,
+    and a reusable workspace.
+
+    \param[in] first Iterator pointer to first element.
+    \param[in] last Iterator pointing to one beyond the end of data.
+    \param[in] rshift Functor that returns the result of shifting the value_type right a specified number of bits.
+    \param[in,out] workspace Storage reused between calls; not used by other threads at the same time.
+  */
+  template <class RandomAccessIter, class Right_shift>
+  inline void float_sort(RandomAccessIter first, RandomAccessIter last,
+                         Right_shift rshift,
+                         spreadsort_workspace<RandomAccessIter> &workspace)
+  {
+    if (last - first < detail::min_sort_size)
+      boost::sort::pdqsort(first, last);
+    else
+      detail::float_sort<default_tuning>(first, last, rshift(*first, 0),
+                                         rshift, &workspace);
+  }
+
+  /*!
+   \brief Float sort algorithm using random access iterators with both right-shift and user-defined comparison operator,
+   and a reusable workspace.
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] last Iterator pointing to one beyond the end of data.
+   \param[in] rshift Functor that returns the result of shifting the value_type right a specified number of bits.
+   \param[in] comp A binary functor that returns whether the first element passed to it should go before the second in order.
+   \param[in,out] workspace Storage reused between calls; not used by other threads at the same time.
+  */
+  template <class RandomAccessIter, class Right_shift, class Compare>
+  inline void float_sort(RandomAccessIter first, RandomAccessIter last,
+                         Right_shift rshift, Compare comp,
+                         spreadsort_workspace<RandomAccessIter> &workspace)
+  {
+    if (last - first < detail::min_sort_size)
+      boost::sort::pdqsort(first, last, comp);
+    else
+      detail::float_sort<default_tuning>(first, last, rshift(*first, 0),
+                                         rshift, comp, &workspace);
+  }
+
+  /*!
+    \brief Floating-point sort algorithm using random access iterators, with the tuning constants taken from a policy.
+
+    \details Same as @c float_sort(first, last), but with @c max_splits, @c max_finishing_splits,
+    the @c float_log_* constants and @c min_sort_size read from @c Tuning, a class derived from
+    @c default_tuning, which is passed as the first template argument:
+    <tt>float_sort<my_tuning>(first, last)</tt>.
+    @c Tuning::min_sort_size must be at least 2 to the power of @c Tuning::float_log_mean_bin_size + 1.
+
+    \param[in] first Iterator pointer to first element.
+    \param[in] last Iterator pointing to one beyond the end of data.
+  */
+  template <class Tuning, class RandomAccessIter>
+  inline typename detail::enable_if_tuning<Tuning>::type
+  float_sort(RandomAccessIter first, RandomAccessIter last)
+  {
+    //Keeps the first shift narrower than the key
+    BOOST_STATIC_ASSERT((2 << Tuning::float_log_mean_bin_size) <=
+                        Tuning::min_sort_size);
+    if (last - first < Tuning::min_sort_size)
+      boost::sort::pdqsort(first, last);
+    else
+      detail::float_sort<Tuning>(first, last);
+  }
+
+  /*!
+    \brief Floating-point sort algorithm using random access iterators with just right-shift functor,
+    with the tuning constants taken from a policy.
+
+    \param[in] first Iterator pointer to first element.
+    \param[in] last Iterator pointing to one beyond the end of data.
+    \param[in] rshift Functor that returns the result of shifting the value_type right a specified number of bits.
+  */
+  template <class Tuning, class RandomAccessIter, class Right_shift>
+  inline typename detail::enable_if_tuning<Tuning>::type
+  float_sort(RandomAccessIter first, RandomAccessIter last,
+             Right_shift rshift)
+  {
+    //Keeps the first shift narrower than the key
+    BOOST_STATIC_ASSERT((2 << Tuning::float_log_mean_bin_size) <=
+                        Tuning::min_sort_size);
+    if (last - first < Tuning::min_sort_size)
+      boost::sort::pdqsort(first, last);
+    else
+      detail::float_sort<Tuning>(first, last, rshift(*first, 0), rshift);
+  }
+
+  /*!
+   \brief Float sort algorithm using random access iterators with both right-shift and user-defined comparison operator,
+   with the tuning constants taken from a policy.
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] last Iterator pointing to one beyond the end of data.
+   \param[in] rshift Functor that returns the result of shifting the value_type right a specified number of bits.
+   \param[in] comp A binary functor that returns whether the first element passed to it should go before the second in order.
+  */
+  template <class Tuning, class RandomAccessIter, class Right_shift,
+            class Compare>
+  inline typename detail::enable_if_tuning<Tuning>::type
+  float_sort(RandomAccessIter first, RandomAccessIter last,
+             Right_shift rshift, Compare comp)
+  {
+    //Keeps the first shift narrower than the key
+    BOOST_STATIC_ASSERT((2 << Tuning::float_log_mean_bin_size) <=
+                        Tuning::min_sort_size);
+    if (last - first < Tuning::min_sort_size)
+      boost::sort::pdqsort(first, last, comp);
+    else
+      detail::float_sort<Tuning>(first, last, rshift(*first, 0), rshift,
+                                 comp);
+  }
+
+  /*!
+   \brief Stable floating-point sort algorithm using random access iterators.
+
+   \details The stable counterpart of @c float_sort: an out-of-place radix sort that
+   stably scatters the elements between the data and a buffer of @c last - @c first elements,
+   splitting the range of the keys in each bin on at most @c detail::max_splits bits per pass,
+   and insertion sorting bins of at most @c detail::stable_insertion_count elements.
+   -0.0 sorts before 0.0.
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] last Iterator pointing to one beyond the end of data.
+
+   \pre [@c first, @c last) is a valid range.
+   \pre @c RandomAccessIter @c value_type is a 32-bit or 64-bit IEEE 754 floating-point type.
+   \post The elements in the range [@c first, @c last) are sorted in ascending order,
+   and equal elements keep their relative order.
+  */
+  template <class RandomAccessIter>
+  inline void stable_float_sort(RandomAccessIter first, RandomAccessIter last)
+  {
+    typedef typename std::iterator_traits<RandomAccessIter>::value_type
+      Data_type;
+    typedef typename boost::make_signed<typename
+      detail::total_order_key_type<sizeof(Data_type)>::type>::type Div_type;
+    if (last - first > 1)
+      detail::stable_float_sort(first, last, Div_type(0),
+                                detail::stable_float_cast<Div_type>());
+  }
+
+  /*!
+   \brief Stable floating-point sort algorithm using range.
+
+   \param[in] range Range [first, last) for sorting.
+  */
+  template <class Range>
+  inline void stable_float_sort(Range& range)
+  {
+    stable_float_sort(boost::begin(range), boost::end(range));
+  }
+
+  /*!
+   \brief Stable floating-point sort algorithm using random access iterators with a right-shift functor.
+
+   \details Takes the same @c rshift functors as @c float_sort, which return the bits of the key
+   cast to a signed integer with @c float_mem_cast, shifted right; only @c rshift(x, 0) is called.
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] last Iterator pointing to one beyond the end of data.
+   \param[in] rshift Functor that returns the result of shifting the value_type right a specified number of bits.
+
+   \post The elements in the range [@c first, @c last) are sorted in ascending order of their keys,
+   and elements with equal keys keep their relative order.
+  */
+  template <class RandomAccessIter, class Right_shift>
+  inline void stable_float_sort(RandomAccessIter first, RandomAccessIter last,
+                                Right_shift rshift)
+  {
+    if (last - first > 1)
+      detail::stable_float_sort(first, last, rshift(*first, 0), rshift);
+  }
+
+  /*!
+   \brief Stable floating-point sort algorithm using range with a right-shift functor.
+
+   \param[in] range Range [first, last) for sorting.
+   \param[in] rshift Functor that returns the result of shifting the value_type right a specified number of bits.
+  */
+  template <class Range, class Right_shift>
+  inline void stable_float_sort(Range& range, Right_shift rshift)
+  {
+    stable_float_sort(boost::begin(range), boost::end(range), rshift);
+  }
+
+  /*!
+   \brief Floating-point sort algorithm using random access iterators that orders every value,
+   including NaNs, following IEEE 754 totalOrder.
+
+   \details Each value is mapped to an unsigned integer of the same size that keeps its order,
+   and those keys are radix sorted as by @c integer_sort, so -0.0 sorts before +0.0 and
+   NaNs need no separate filtering pass.  All NaNs, whatever their sign, are placed together
+   at the end chosen by @c nans.
+   Falls back to @c boost::sort::pdqsort on the same keys below @c min_sort_size elements.
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] last Iterator pointing to one beyond the end of data.
+   \param[in] nans @c nans_first or @c nans_last.
+
+   \pre [@c first, @c last) is a valid range.
+   \pre @c RandomAccessIter @c value_type is a 32-bit or 64-bit IEEE 754 floating-point type,
+   such as @c float or @c double.
+   \post The elements in the range [@c first, @c last) are sorted in ascending total order,
+   with NaNs at the requested end.
+  */
+  template <class RandomAccessIter>
+  inline void float_sort_total_order(RandomAccessIter first,
+                                     RandomAccessIter last,
+                                     nan_position nans = nans_last)
+  {
+    typedef typename std::iterator_traits<RandomAccessIter>::value_type
+      Data_type;
+    if (last - first < detail::min_sort_size)
+      boost::sort::pdqsort(first, last,
+                           detail::total_order_less<Data_type>(nans));
+    else
+      detail::float_sort_total_order<default_tuning>(first, last, nans);
+  }
+
+  /*!
+   \brief Floating-point sort algorithm using range that orders every value, including NaNs.
+
+   \param[in] range Range [first, last) for sorting.
+   \param[in] nans @c nans_first or @c nans_last.
+  */
+  template <class Range>
+  inline void float_sort_total_order(Range& range,
+                                     nan_position nans = nans_last)
+  {
+    float_sort_total_order(boost::begin(range), boost::end(range), nans);
+  }
+
+  /*!
+   \brief Floating-point selection algorithm using random access iterators, like @c std::nth_element.
+   (Falls back to @c std::nth_element on the same keys if the data size is too small, < @c detail::min_sort_size).
+
+   \details Each float is mapped to an unsigned integer of the same size that keeps its order,
+   and the keys are binned as by @c integer_sort; the elements of the bins before the one holding @c nth
+   are moved to the front and those after it to the back, and only that bin is split further.
+   The keys are also what is compared, so -0.0 is ordered before 0.0.
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] nth Iterator to the position to select the element for.
+   \param[in] last Iterator pointing to one beyond the end of data.
+
+   \pre [@c first, @c nth) and [@c nth, @c last) are valid ranges.
+   \pre @c RandomAccessIter @c value_type is a 32-bit or 64-bit IEEE 754 floating-point type, without NaNs.
+   \post @c *nth is the element that would be there if [@c first, @c last) were sorted,
+   no element before @c nth is greater than it, and no element after it is less.
+  */
+  template <class RandomAccessIter>
+  inline void float_nth_element(RandomAccessIter first, RandomAccessIter nth,
+                                RandomAccessIter last)
+  {
+    typedef typename std::iterator_traits<RandomAccessIter>::value_type
+      Data_type;
+    typedef typename boost::make_signed<typename
+      detail::total_order_key_type<sizeof(Data_type)>::type>::type Div_type;
+    if (nth != last)
+      detail::float_select(first, nth, last, false, Div_type(0),
+                           detail::stable_float_cast<Div_type>());
+  }
+
+  /*!
+   \brief Floating-point selection algorithm using range.
+
+   \param[in] range Range [first, last) to select from.
+   \param[in] nth Iterator to the position to select the element for.
+  */
+  template <class Range>
+  inline void float_nth_element(Range& range,
+                                typename boost::range_iterator<Range>::type nth)
+  {
+    float_nth_element(boost::begin(range), nth, boost::end(range));
+  }
+
+  /*!
+   \brief Floating-point selection algorithm using random access iterators with a right-shift functor.
+
+   \details Takes the same @c rshift functors as @c float_sort, which return the bits of the key
+   cast to a signed integer with @c float_mem_cast, shifted right; only @c rshift(x, 0) is called,
+   and the elements are compared by their keys.
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] nth Iterator to the position to select the element for.
+   \param[in] last Iterator pointing to one beyond the end of data.
+   \param[in] rshift Functor that returns the result of shifting the value_type right a specified number of bits.
+  */
+  template <class RandomAccessIter, class Right_shift>
+  inline void float_nth_element(RandomAccessIter first, RandomAccessIter nth,
+                                RandomAccessIter last, Right_shift rshift)
+  {
+    if (nth != last)
+      detail::float_select(first, nth, last, false, rshift(*first, 0), rshift);
+  }
+
+  /*!
+   \brief Floating-point partial sort algorithm using random access iterators, like @c std::partial_sort.
+   (Falls back to @c std::partial_sort on the same keys if the data size is too small, < @c detail::min_sort_size).
+
+   \details Selects the element that goes before @c middle as @c float_nth_element does,
+   and radix sorts the bins before its bin as they are moved to the front.
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] middle Iterator pointing to one beyond the end of the elements to sort.
+   \param[in] last Iterator pointing to one beyond the end of data.
+
+   \pre Same as @c float_nth_element(first, nth, last).
+   \post [@c first, @c middle) holds the @c middle - @c first least elements in ascending order;
+   the order of the rest is unspecified.
+  */
+  template <class RandomAccessIter>
+  inline void float_partial_sort(RandomAccessIter first,
+                                 RandomAccessIter middle,
+                                 RandomAccessIter last)
+  {
+    typedef typename std::iterator_traits<RandomAccessIter>::value_type
+      Data_type;
+    typedef typename boost::make_signed<typename
+      detail::total_order_key_type<sizeof(Data_type)>::type>::type Div_type;
+    if (middle != first)
+      detail::float_select(first, middle - 1, last, true, Div_type(0),
+                           detail::stable_float_cast<Div_type>());
+  }
+
+  /*!
+   \brief Floating-point partial sort algorithm using range.
+
+   \param[in] range Range [first, last) to sort the start of.
+   \param[in] middle Iterator pointing to one beyond the end of the elements to sort.
+  */
+  template <class Range>
+  inline void float_partial_sort(Range& range,
+                        typename boost::range_iterator<Range>::type middle)
+  {
+    float_partial_sort(boost::begin(range), middle, boost::end(range));
+  }
+
+  /*!
+   \brief Floating-point partial sort algorithm using random access iterators with a right-shift functor.
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] middle Iterator pointing to one beyond the end of the elements to sort.
+   \param[in] last Iterator pointing to one beyond the end of data.
+   \param[in] rshift Functor that returns the result of shifting the value_type right a specified number of bits.
+
+   \pre Same as @c float_nth_element(first, nth, last, rshift).
+  */
+  template <class RandomAccessIter, class Right_shift>
+  inline void float_partial_sort(RandomAccessIter first,
+                                 RandomAccessIter middle,
+                                 RandomAccessIter last, Right_shift rshift)
+  {
+    if (middle != first)
+      detail::float_select(first, middle - 1, last, true, rshift(*first, 0),
+                           rshift);
+  }
 }
 }
 }
@@ -21,11 +21,17 @@ Doxygen comments by Paul A. Bristow Jan 2015
 #include <vector>
 #include <cstring>
 #include <limits>
+#include <functional>
 #include <boost/static_assert.hpp>
 #include <boost/sort/spreadsort/detail/constants.hpp>
+#include <boost/sort/spreadsort/detail/tuning.hpp>
 #include <boost/sort/spreadsort/detail/integer_sort.hpp>
+#include <boost/sort/spreadsort/detail/integer_sort_lsd.hpp>
+#include <boost/sort/spreadsort/detail/stable_spreadsort.hpp>
+#include <boost/sort/spreadsort/detail/spreadsort_select.hpp>
 #include <boost/range/begin.hpp>
 #include <boost/range/end.hpp>
+#include <boost/range/iterator.hpp>
 
 namespace boost {
 namespace sort {
@@ -79,7 +85,7 @@ Some performance plots of runtime vs. n and log(range) are provided:\n
     if (last - first < detail::min_sort_size)
       boost::sort::pdqsort(first, last);
     else
-      detail::integer_sort(first, last, *first >> 0);
+      detail::integer_sort<default_tuning>(first, last, *first >> 0);
   }
 
 /*! \brief Integer sort algorithm using range.
@@ -168,7 +174,8 @@ Some performance plots of runtime vs. n and log(range) are provided:\n
     if (last - first < detail::min_sort_size)
       boost::sort::pdqsort(first, last, comp);
     else
-      detail::integer_sort(first, last, shift(*first, 0), shift, comp);
+      detail::integer_sort<default_tuning>(first, last, shift(*first, 0),
+                                           shift, comp);
   }
 
 /*! \brief Integer sort algorithm using range with both right-shift and user-defined comparison operator.
@@ -261,7 +268,8 @@ Some performance plots of runtime vs. n and log(range) are provided:\n
     if (last - first < detail::min_sort_size)
       boost::sort::pdqsort(first, last);
     else
-      detail::integer_sort(first, last, shift(*first, 0), shift);
+      detail::integer_sort<default_tuning>(first, last, shift(*first, 0),
+                                           shift);
   }
 
 
@@ -307,6 +315,640 @@ inline void integer_sort(Range& range, Right_shift shift)
 {
   integer_sort(boost::begin(range), boost::end(range), shift);
 }
+
+/*! \brief Integer sort algorithm using random access iterators, with a reusable workspace.
+  (Falls back to @c boost::sort::pdqsort if the data size is too small, < @c detail::min_sort_size).
+
+  \details Same as @c integer_sort(first, last), but the bin cache and bin sizes are kept in
+@c workspace instead of being allocated for each call, so once the workspace has grown to
+the largest size needed, repeated sorts make no heap allocations.
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] last Iterator pointing to one beyond the end of data.
+   \param[in,out] workspace Storage reused between calls; not used by other threads at the same time.
+
+   \pre Same as @c integer_sort(first, last).
+   \post The elements in the range [@c first, @c last) are sorted in ascending order.
+*/
+  template <class RandomAccessIter>
+  inline void integer_sort(RandomAccessIter first, RandomAccessIter last,
+                           spreadsort_workspace<RandomAccessIter> &workspace)
+  {
+    if (last - first < detail::min_sort_size)
+      boost::sort::pdqsort(first, last);
+    else
+      detail::integer_sort<default_tuning>(first, last, *first >> 0,
+                                           &workspace);
+  }
+
+/*! \brief Integer sort algorithm using random access iterators with just right-shift functor,
+  and a reusable workspace.
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] last Iterator pointing to one beyond the end of data.
+   \param[in] shift Functor that returns the result of shifting the value_type right a specified number of bits.
+   \param[in,out] workspace Storage reused between calls; not used by other threads at the same time.
+
+   \pre Same as @c integer_sort(first, last, shift).
+   \post The elements in the range [@c first, @c last) are sorted in ascending order.
+*/
+  template <class RandomAccessIter, class Right_shift>
+  inline void integer_sort(RandomAccessIter first, RandomAccessIter last,
+                           Right_shift shift,
+                           spreadsort_workspace<RandomAccessIter> &workspace)
+  {
+    if (last - first < detail::min_sort_size)
+      boost::sort::pdqsort(first, last);
+    else
+      detail::integer_sort<default_tuning>(first, last, shift(*first, 0),
+                                           shift, &workspace);
+  }
+
+/*! \brief Integer sort algorithm using random access iterators with both right-shift and user-defined comparison operator,
+  and a reusable workspace.
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] last Iterator pointing to one beyond the end of data.
+   \param[in] shift Functor that returns the result of shifting the value_type right a specified number of bits.
+   \param[in] comp A binary functor that returns whether the first element passed to it should go before the second in order.
+   \param[in,out] workspace Storage reused between calls; not used by other threads at the same time.
+
+   \pre Same as @c integer_sort(first, last, shift, comp).
+   \post The elements in the range [@c first, @c last) are sorted in ascending order.
+*/
+  template <class RandomAccessIter, class Right_shift, class Compare>
+  inline void integer_sort(RandomAccessIter first, RandomAccessIter last,
+                           Right_shift shift, Compare comp,
+                           spreadsort_workspace<RandomAccessIter> &workspace)
+  {
+    if (last - first < detail::min_sort_size)
+      boost::sort::pdqsort(first, last, comp);
+    else
+      detail::integer_sort<default_tuning>(first, last, shift(*first, 0),
+                                           shift, comp, &workspace);
+  }
+
+/*! \brief Integer sort algorithm using random access iterators, with the tuning constants taken from a policy.
+  (Falls back to @c boost::sort::pdqsort if the data size is too small, < @c Tuning::min_sort_size).
+
+  \details Same as @c integer_sort(first, last), but with @c max_splits, @c max_finishing_splits,
+the @c int_log_* constants and @c min_sort_size read from @c Tuning instead of detail/constants.hpp.
+The policy is passed explicitly as the first template argument:
+\code
+struct my_tuning : boost::sort::spreadsort::default_tuning {
+  enum { max_splits = 9, min_sort_size = 1000 };
+};
+integer_sort<my_tuning>(vec.begin(), vec.end());
+\endcode
+
+   \tparam Tuning A class derived from @c default_tuning.
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] last Iterator pointing to one beyond the end of data.
+
+   \pre Same as @c integer_sort(first, last).
+   \pre 1 < @c Tuning::max_splits < @c Tuning::max_finishing_splits < 32, 0 < @c Tuning::int_log_min_split_count <= @c Tuning::max_splits,
+   and 2 to the @c Tuning::int_log_mean_bin_size <= @c Tuning::min_sort_size (all checked at compile time).
+   \post The elements in the range [@c first, @c last) are sorted in ascending order.
+*/
+  template <class Tuning, class RandomAccessIter>
+  inline typename detail::enable_if_tuning<Tuning>::type
+  integer_sort(RandomAccessIter first, RandomAccessIter last)
+  {
+    //Keeps the first shift narrower than the key
+    BOOST_STATIC_ASSERT((1 << Tuning::int_log_mean_bin_size) <=
+                        Tuning::min_sort_size);
+    if (last - first < Tuning::min_sort_size)
+      boost::sort::pdqsort(first, last);
+    else
+      detail::integer_sort<Tuning>(first, last, *first >> 0);
+  }
+
+/*! \brief Integer sort algorithm using random access iterators with just right-shift functor,
+  with the tuning constants taken from a policy.
+
+   \tparam Tuning A class derived from @c default_tuning.
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] last Iterator pointing to one beyond the end of data.
+   \param[in] shift Functor that returns the result of shifting the value_type right a specified number of bits.
+
+   \pre Same as @c integer_sort(first, last, shift) and @c integer_sort<Tuning>(first, last).
+   \post The elements in the range [@c first, @c last) are sorted in ascending order.
+*/
+  template <class Tuning, class RandomAccessIter, class Right_shift>
+  inline typename detail::enable_if_tuning<Tuning>::type
+  integer_sort(RandomAccessIter first, RandomAccessIter last,
+               Right_shift shift)
+  {
+    //Keeps the first shift narrower than the key
+    BOOST_STATIC_ASSERT((1 << Tuning::int_log_mean_bin_size) <=
+                        Tuning::min_sort_size);
+    if (last - first < Tuning::min_sort_size)
+      boost::sort::pdqsort(first, last);
+    else
+      detail::integer_sort<Tuning>(first, last, shift(*first, 0), shift);
+  }
+
+/*! \brief Integer sort algorithm using random access iterators with both right-shift and user-defined comparison operator,
+  with the tuning constants taken from a policy.
+
+   \tparam Tuning A class derived from @c default_tuning.
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] last Iterator pointing to one beyond the end of data.
+   \param[in] shift Functor that returns the result of shifting the value_type right a specified number of bits.
+   \param[in] comp A binary functor that returns whether the first element passed to it should go before the second in order.
+
+   \pre Same as @c integer_sort(first, last, shift, comp) and @c integer_sort<Tuning>(first, last).
+   \post The elements in the range [@c first, @c last) are sorted in ascending order.
+*/
+  template <class Tuning, class RandomAccessIter, class Right_shift,
+            class Compare>
+  inline typename detail::enable_if_tuning<Tuning>::type
+  integer_sort(RandomAccessIter first, RandomAccessIter last,
+               Right_shift shift, Compare comp)
+  {
+    //Keeps the first shift narrower than the key
+    BOOST_STATIC_ASSERT((1 << Tuning::int_log_mean_bin_size) <=
+                        Tuning::min_sort_size);
+    if (last - first < Tuning::min_sort_size)
+      boost::sort::pdqsort(first, last, comp);
+    else
+      detail::integer_sort<Tuning>(first, last, shift(*first, 0), shift,
+                                   comp);
+  }
+
+/*! \brief Least-significant-digit radix sort for integers, using random access iterators.
+  (Falls back to @c boost::sort::pdqsort if the data size is too small, < @c detail::min_sort_size).
+
+  \details @c integer_sort_lsd is a stable out-of-place radix sort that handles the key
+@c detail::lsd_digit_bits (11) bits at a time, starting from the least significant digit.
+It takes all the digit histograms in one read pass over the data,
+then makes one scattering pass per digit, alternating between the data and a buffer of
+@c last - @c first elements; digits that are the same for every key are skipped.
+Unlike @c integer_sort it does not adapt to the distribution, so its runtime depends
+only on N and the size of the key, but for large inputs of uniformly random keys,
+which @c integer_sort handles worst, it is usually considerably faster.
+It is not a good choice for small inputs or for keys where
+@c integer_sort can stop early because of a narrow range.
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] last Iterator pointing to one beyond the end of data.
+
+   \pre [@c first, @c last) is a valid range.
+   \pre @c RandomAccessIter @c value_type is mutable, default-constructible and an integral type,
+   or a type that supports right-shifting and conversion to @c unsigned as if it were one.
+   \post The elements in the range [@c first, @c last) are sorted in ascending order.
+
+   \return @c void.
+
+   \throws std::exception Propagates exceptions if the buffer allocation, the element copies,
+   the right shift, or any operations on iterators throw.
+
+   \warning Throwing an exception may cause data loss.
+   \warning Invalid arguments cause undefined behaviour.
+
+   \remark <em> O(N * K/D) </em> operations and <em> O(N) </em> extra memory, where:
+   \remark  *  N is @c last - @c first,
+   \remark  *  K is the size of the key in bits,
+   \remark  *  D is @c detail::lsd_digit_bits.
+*/
+  template <class RandomAccessIter>
+  inline void integer_sort_lsd(RandomAccessIter first, RandomAccessIter last)
+  {
+    if (last - first < detail::min_sort_size)
+      boost::sort::pdqsort(first, last);
+    else
+      detail::integer_sort_lsd(first, last, *first,
+                               detail::lsd_default_shift());
+  }
+
+/*! \brief Least-significant-digit radix sort for integers, using range.
+  (Falls back to @c boost::sort::pdqsort if the data size is too small, < @c detail::min_sort_size).
+
+   \param[in] range Range [first, last) for sorting.
+
+   \pre Same as @c integer_sort_lsd(first, last).
+   \post The elements in the range [@c first, @c last) are sorted in ascending order.
+*/
+template <class Range>
+inline void integer_sort_lsd(Range& range)
+{
+  integer_sort_lsd(boost::begin(range), boost::end(range));
+}
+
+/*! \brief Least-significant-digit radix sort for integers, using random access iterators with a right-shift functor.
+
+  \details The key is what @c shift returns for a shift of 0, and its size sets the number of digits,
+so @c shift should return the narrowest type that holds the key.
+As with @c integer_sort, @c shift(x, n) must return the key shifted right by @c n bits.
+Only ascending order of the key is supported.
+There is no comparison-based fallback for small inputs, as that would need a comparison and
+would not be stable.
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] last Iterator pointing to one beyond the end of data.
+   \param[in] shift Functor that returns the result of shifting the value_type right a specified number of bits.
+
+   \pre [@c first, @c last) is a valid range.
+   \pre @c RandomAccessIter @c value_type is mutable and default-constructible.
+   \post The elements in the range [@c first, @c last) are sorted in ascending order of their keys,
+   and elements with equal keys keep their relative order.
+
+   \throws std::exception Propagates exceptions if the buffer allocation, the element copies,
+   the right shift, or any operations on iterators throw.
+
+   \warning Throwing an exception may cause data loss.
+*/
+  template <class RandomAccessIter, class Right_shift>
+  inline void integer_sort_lsd(RandomAccessIter first, RandomAccessIter last,
+                               Right_shift shift)
+  {
+    if (last - first > 1)
+      detail::integer_sort_lsd(first, last, shift(*first, 0), shift);
+  }
+
+/*! \brief Least-significant-digit radix sort for integers, using range with a right-shift functor.
+
+   \param[in] range Range [first, last) for sorting.
+   \param[in] shift Functor that returns the result of shifting the value_type right a specified number of bits.
+*/
+template <class Range, class Right_shift>
+inline void integer_sort_lsd(Range& range, Right_shift shift)
+{
+  integer_sort_lsd(boost::begin(range), boost::end(range), shift);
+}
+
+/*! \brief Least-significant-digit radix sort for integers, using random access iterators with a right-shift functor and a caller-supplied buffer.
+
+  \details Same as @c integer_sort_lsd(first, last, shift), but the elements are scattered
+into @c buffer instead of a newly allocated vector, so repeated sorts can reuse one buffer.
+Its contents afterwards are unspecified.
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] last Iterator pointing to one beyond the end of data.
+   \param[in] shift Functor that returns the result of shifting the value_type right a specified number of bits.
+   \param[in] buffer Random access iterator to the start of at least @c last - @c first
+   assignable elements of the same type, not overlapping [@c first, @c last).
+
+   \pre [@c first, @c last) is a valid range.
+   \post The elements in the range [@c first, @c last) are sorted in ascending order of their keys,
+   and elements with equal keys keep their relative order.
+
+   \throws std::exception Propagates exceptions if the element copies,
+   the right shift, or any operations on iterators throw.
+
+   \warning Throwing an exception may cause data loss.
+*/
+  template <class RandomAccessIter, class Right_shift, class Buffer_iter>
+  inline void integer_sort_lsd(RandomAccessIter first, RandomAccessIter last,
+                               Right_shift shift, Buffer_iter buffer)
+  {
+    if (last - first > 1)
+      detail::integer_sort_lsd(first, last, buffer, shift(*first, 0), shift);
+  }
+
+/*! \brief Stable integer sort algorithm using random access iterators.
+
+  \details @c stable_integer_sort is an out-of-place radix sort that, like @c integer_sort,
+finds the range of the keys in each bin and splits it on its top @c detail::max_splits (11) bits
+or fewer, so narrow ranges take few passes.
+Each pass stably scatters the elements between the data and a buffer of @c last - @c first elements,
+and bins of at most @c detail::stable_insertion_count elements are insertion sorted,
+so elements with equal keys keep their relative order.
+Unlike @c integer_sort_lsd it stops splitting a bin once all its keys are equal.
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] last Iterator pointing to one beyond the end of data.
+
+   \pre [@c first, @c last) is a valid range.
+   \pre @c RandomAccessIter @c value_type is mutable, copy assignable, default-constructible and an integral type.
+   \post The elements in the range [@c first, @c last) are sorted in ascending order,
+   and equal elements keep their relative order.
+
+   \throws std::exception Propagates exceptions if the buffer allocation, the element copies,
+   or any operations on iterators throw.
+
+   \warning Throwing an exception may cause data loss.
+
+   \remark <em> O(N*K/S) </em> operations worst-case and <em> O(N) </em> extra memory, where:
+   \remark  *  N is @c last - @c first,
+   \remark  *  K is the log of the range in bits,
+   \remark  *  S is a constant called max_splits, defaulting to 11.
+*/
+  template <class RandomAccessIter>
+  inline void stable_integer_sort(RandomAccessIter first,
+                                  RandomAccessIter last)
+  {
+    if (last - first > 1)
+      detail::stable_integer_sort(first, last, *first >> 0,
+                                  detail::lsd_default_shift());
+  }
+
+/*! \brief Stable integer sort algorithm using range.
+
+   \param[in] range Range [first, last) for sorting.
+
+   \pre Same as @c stable_integer_sort(first, last).
+   \post The elements in the range [@c first, @c last) are sorted in ascending order,
+   and equal elements keep their relative order.
+*/
+template <class Range>
+inline void stable_integer_sort(Range& range)
+{
+  stable_integer_sort(boost::begin(range), boost::end(range));
+}
+
+/*! \brief Stable integer sort algorithm using random access iterators with a right-shift functor.
+
+  \details Takes the same @c shift functors as @c integer_sort; only @c shift(x, 0), the key itself,
+is called, and the key is split with ordinary shifts.
+The type @c shift returns sets whether the key is signed.
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] last Iterator pointing to one beyond the end of data.
+   \param[in] shift Functor that returns the result of shifting the value_type right a specified number of bits.
+
+   \pre [@c first, @c last) is a valid range.
+   \pre @c RandomAccessIter @c value_type is mutable, copy assignable and default-constructible.
+   \post The elements in the range [@c first, @c last) are sorted in ascending order of their keys,
+   and elements with equal keys keep their relative order.
+
+   \throws std::exception Propagates exceptions if the buffer allocation, the element copies,
+   the right shift, or any operations on iterators throw.
+
+   \warning Throwing an exception may cause data loss.
+*/
+  template <class RandomAccessIter, class Right_shift>
+  inline void stable_integer_sort(RandomAccessIter first,
+                                  RandomAccessIter last, Right_shift shift)
+  {
+    if (last - first > 1)
+      detail::stable_integer_sort(first, last, shift(*first, 0), shift);
+  }
+
+/*! \brief Stable integer sort algorithm using range with a right-shift functor.
+
+   \param[in] range Range [first, last) for sorting.
+   \param[in] shift Functor that returns the result of shifting the value_type right a specified number of bits.
+
+   \pre Same as @c stable_integer_sort(first, last, shift).
+*/
+template <class Range, class Right_shift>
+inline void stable_integer_sort(Range& range, Right_shift shift)
+{
+  stable_integer_sort(boost::begin(range), boost::end(range), shift);
+}
+
+/*! \brief Integer selection algorithm using random access iterators, like @c std::nth_element.
+  (Falls back to @c std::nth_element if the data size is too small, < @c detail::min_sort_size).
+
+  \details Bins the elements on the top bits of their range as @c integer_sort does, then moves the elements
+of the bins before the one holding @c nth to the front and those after it to the back,
+and repeats on that bin alone, so each pass only handles the elements that could still end up at @c nth.
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] nth Iterator to the position to select the element for.
+   \param[in] last Iterator pointing to one beyond the end of data.
+
+   \pre [@c first, @c nth) and [@c nth, @c last) are valid ranges.
+   \pre @c RandomAccessIter @c value_type is mutable, swappable and an integral type.
+   \post @c *nth is the element that would be there if [@c first, @c last) were sorted,
+   no element before @c nth is greater than it, and no element after it is less.
+
+   \throws std::exception Propagates exceptions if any of the element comparisons, the element swaps,
+   or any operations on iterators throw.
+
+   \warning Throwing an exception may cause data loss.
+
+   \remark <em> O(N*K/S) </em> operations worst-case, where:
+   \remark  *  N is @c last - @c first,
+   \remark  *  K is the log of the range in bits,
+   \remark  *  S is a constant called max_splits, defaulting to 11.
+*/
+  template <class RandomAccessIter>
+  inline void integer_nth_element(RandomAccessIter first, RandomAccessIter nth,
+                                  RandomAccessIter last)
+  {
+    typedef typename std::iterator_traits<RandomAccessIter>::value_type
+      Data_type;
+    if (nth != last)
+      detail::integer_select(first, nth, last, false, *first >> 0,
+                             detail::lsd_default_shift(),
+                             std::less<Data_type>());
+  }
+
+/*! \brief Integer selection algorithm using range.
+
+   \param[in] range Range [first, last) to select from.
+   \param[in] nth Iterator to the position to select the element for.
+
+   \pre Same as @c integer_nth_element(first, nth, last).
+*/
+template <class Range>
+inline void integer_nth_element(Range& range,
+                                typename boost::range_iterator<Range>::type nth)
+{
+  integer_nth_element(boost::begin(range), nth, boost::end(range));
+}
+
+/*! \brief Integer selection algorithm using random access iterators with a right-shift functor.
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] nth Iterator to the position to select the element for.
+   \param[in] last Iterator pointing to one beyond the end of data.
+   \param[in] shift Functor that returns the result of shifting the value_type right a specified number of bits.
+
+   \pre Same as @c integer_nth_element(first, nth, last), with @c shift(x, 0) returning an integral key
+   that @c operator< orders the elements by.
+   \post Same as @c integer_nth_element(first, nth, last).
+*/
+  template <class RandomAccessIter, class Right_shift>
+  inline void integer_nth_element(RandomAccessIter first, RandomAccessIter nth,
+                                  RandomAccessIter last, Right_shift shift)
+  {
+    typedef typename std::iterator_traits<RandomAccessIter>::value_type
+      Data_type;
+    if (nth != last)
+      detail::integer_select(first, nth, last, false, shift(*first, 0), shift,
+                             std::less<Data_type>());
+  }
+
+/*! \brief Integer selection algorithm using random access iterators with both right-shift and user-defined comparison operator.
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] nth Iterator to the position to select the element for.
+   \param[in] last Iterator pointing to one beyond the end of data.
+   \param[in] shift Functor that returns the result of shifting the value_type right a specified number of bits.
+   \param[in] comp A binary functor that returns whether the first element passed to it should go before the second in order.
+
+   \pre Same as @c integer_nth_element(first, nth, last, shift), with @c comp ordering the elements
+   as their keys @c shift(x, 0) are ordered.
+   \post Same as @c integer_nth_element(first, nth, last).
+*/
+  template <class RandomAccessIter, class Right_shift, class Compare>
+  inline void integer_nth_element(RandomAccessIter first, RandomAccessIter nth,
+                                  RandomAccessIter last, Right_shift shift,
+                                  Compare comp)
+  {
+    if (nth != last)
+      detail::integer_select(first, nth, last, false, shift(*first, 0), shift,
+                             comp);
+  }
+
+/*! \brief Integer partial sort algorithm using random access iterators, like @c std::partial_sort.
+  (Falls back to @c std::partial_sort if the data size is too small, < @c detail::min_sort_size).
+
+  \details Selects the element that goes before @c middle as @c integer_nth_element does,
+and sorts the bins before its bin with @c integer_sort as they are moved to the front,
+so only the elements that end up before @c middle, and those sharing their last bin, are sorted.
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] middle Iterator pointing to one beyond the end of the elements to sort.
+   \param[in] last Iterator pointing to one beyond the end of data.
+
+   \pre [@c first, @c middle) and [@c middle, @c last) are valid ranges.
+   \pre @c RandomAccessIter @c value_type is mutable, swappable and an integral type.
+   \post [@c first, @c middle) holds the @c middle - @c first least elements in ascending order;
+   the order of the rest is unspecified.
+
+   \throws std::exception Propagates exceptions if any of the element comparisons, the element swaps,
+   or any operations on iterators throw.
+
+   \warning Throwing an exception may cause data loss.
+*/
+  template <class RandomAccessIter>
+  inline void integer_partial_sort(RandomAccessIter first,
+                                   RandomAccessIter middle,
+                                   RandomAccessIter last)
+  {
+    typedef typename std::iterator_traits<RandomAccessIter>::value_type
+      Data_type;
+    if (middle != first)
+      detail::integer_select(first, middle - 1, last, true, *first >> 0,
+                             detail::lsd_default_shift(),
+                             std::less<Data_type>());
+  }
+
+/*! \brief Integer partial sort algorithm using range.
+
+   \param[in] range Range [first, last) to sort the start of.
+   \param[in] middle Iterator pointing to one beyond the end of the elements to sort.
+
+   \pre Same as @c integer_partial_sort(first, middle, last).
+*/
+template <class Range>
+inline void integer_partial_sort(Range& range,
+                        typename boost::range_iterator<Range>::type middle)
+{
+  integer_partial_sort(boost::begin(range), middle, boost::end(range));
+}
+
+/*! \brief Integer partial sort algorithm using random access iterators with a right-shift functor.
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] middle Iterator pointing to one beyond the end of the elements to sort.
+   \param[in] last Iterator pointing to one beyond the end of data.
+   \param[in] shift Functor that returns the result of shifting the value_type right a specified number of bits.
+
+   \pre Same as @c integer_nth_element(first, nth, last, shift).
+   \post Same as @c integer_partial_sort(first, middle, last).
+*/
+  template <class RandomAccessIter, class Right_shift>
+  inline void integer_partial_sort(RandomAccessIter first,
+                                   RandomAccessIter middle,
+                                   RandomAccessIter last, Right_shift shift)
+  {
+    typedef typename std::iterator_traits<RandomAccessIter>::value_type
+      Data_type;
+    if (middle != first)
+      detail::integer_select(first, middle - 1, last, true, shift(*first, 0),
+                             shift, std::less<Data_type>());
+  }
+
+/*! \brief Integer partial sort algorithm using random access iterators with both right-shift and user-defined comparison operator.
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] middle Iterator pointing to one beyond the end of the elements to sort.
+   \param[in] last Iterator pointing to one beyond the end of data.
+   \param[in] shift Functor that returns the result of shifting the value_type right a specified number of bits.
+   \param[in] comp A binary functor that returns whether the first element passed to it should go before the second in order.
+
+   \pre Same as @c integer_nth_element(first, nth, last, shift, comp).
+   \post Same as @c integer_partial_sort(first, middle, last).
+*/
+  template <class RandomAccessIter, class Right_shift, class Compare>
+  inline void integer_partial_sort(RandomAccessIter first,
+                                   RandomAccessIter middle,
+                                   RandomAccessIter last, Right_shift shift,
+                                   Compare comp)
+  {
+    if (middle != first)
+      detail::integer_select(first, middle - 1, last, true, shift(*first, 0),
+                             shift, comp);
+  }
+
+/*! \brief Integer sort for keys made of several unsigned words, such as 128-bit integers
+  or (timestamp, id) pairs, using random access iterators.
+  (Falls back to @c boost::sort::pdqsort if the data size is too small, < @c detail::min_sort_size).
+
+  \details @c get_word(x, w) returns word @c w of the key of @c x, with word 0 the most significant;
+all words must have the same unsigned integer type, no wider than @c boost::uintmax_t.
+The data is sorted as by @c integer_sort on word 0, then each run of elements with equal
+word 0 is sorted the same way on word 1, and so on, so comparison sorting is only used
+on ranges smaller than @c detail::min_sort_size.
+@c integer_sort(first, last) already sorts @c boost::int128_type and @c boost::uint128_type
+this way where the compiler supports them, and so do the overloads taking @c rshift
+(and @c comp) when @c rshift returns one of these types, on the words of @c rshift(x, 0).
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] last Iterator pointing to one beyond the end of data.
+   \param[in] get_word Functor taking an element and a word number and returning that word of its key.
+   \param[in] word_count Number of words in each key.
+
+   \pre [@c first, @c last) is a valid range.
+   \pre @c word_count > 0.
+   \post The elements in the range [@c first, @c last) are sorted in ascending order of their keys,
+   compared word by word.
+
+   \throws std::exception Propagates exceptions if any of the element comparisons, the element swaps,
+   @c get_word, or the operations on iterators throws.
+
+   \warning Throwing an exception may cause data loss.
+
+   \remark <em> O(N*W*log(K/S + S)) </em> operations worst-case, where:
+   \remark  *  N is @c last - @c first,
+   \remark  *  W is @c word_count,
+   \remark  *  K is the size of each word in bits,
+   \remark  *  S is a constant called max_splits, defaulting to 11.
+*/
+  template <class RandomAccessIter, class Get_word>
+  inline void integer_sort_composite(RandomAccessIter first,
+                                     RandomAccessIter last,
+                                     Get_word get_word, unsigned word_count)
+  {
+    spreadsort_workspace<RandomAccessIter> workspace;
+    if (last - first > 1)
+      detail::integer_sort_composite<default_tuning>(first, last,
+          get_word(*first, 0), get_word, 0, word_count, workspace);
+  }
+
+/*! \brief Integer sort for keys made of several unsigned words, using range.
+
+   \param[in] range Range [first, last) for sorting.
+   \param[in] get_word Functor taking an element and a word number and returning that word of its key.
+   \param[in] word_count Number of words in each key.
+
+   \pre Same as @c integer_sort_composite(first, last, get_word, word_count).
+*/
+template <class Range, class Get_word>
+inline void integer_sort_composite(Range& range, Get_word get_word,
+                                   unsigned word_count)
+{
+  integer_sort_composite(boost::begin(range), boost::end(range), get_word,
+                         word_count);
+}
 }
 }
 }
@@ -0,0 +1,156 @@
+//Templated multithreaded Spreadsort-based implementation of float_sort
+
+//          Copyright Steven J. Ross 2001 - 2014.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// See http://www.boost.org/libs/sort/ for library home page.
+
+#ifndef BOOST_PARALLEL_FLOAT_SORT_HPP
+#define BOOST_PARALLEL_FLOAT_SORT_HPP
+#include <cstdint>
+#include <thread>
+#include <boost/sort/common/util/traits.hpp>
+#include <boost/sort/spreadsort/detail/constants.hpp>
+#include <boost/sort/spreadsort/detail/parallel_float_sort.hpp>
+
+namespace boost {
+namespace sort {
+namespace spreadsort {
+  namespace bscu = boost::sort::common::util;
+
+  /*!
+    \brief Multithreaded @c float_sort with casting to the appropriate size.
+
+    \details @c parallel_float_sort is @c float_sort with its work split across threads.
+The minimum/maximum scan, the bin counting and the in-place placement of the first radix pass
+are all done by the threads together; then the bins, negative and positive,
+are sorted concurrently, largest first, with the serial algorithm,
+and a bin too large for one thread is sorted the same way with all the threads.
+Each thread needs at least @c detail::parallel_min_thread_size elements, so smaller inputs use fewer threads,
+and with a single thread this is exactly @c float_sort.
+Like @c float_sort it is in place and not stable.
+
+    \param[in] first Iterator pointer to first element.
+    \param[in] last Iterator pointing to one beyond the end of data.
+    \param[in] nthread Maximum number of threads to use.
+
+    \pre Same as @c float_sort(first, last).
+    \post The elements in the range [@c first, @c last) are sorted in ascending order.
+
+    \throws std::exception Propagates exceptions if any of the element comparisons, the element swaps (or moves),
+    functors, or any operations on iterators throw, or if a thread can't be started.
+    All threads have finished when the exception reaches the caller.
+  */
+  template <class RandomAccessIter>
+  inline void parallel_float_sort(RandomAccessIter first,
+                                  RandomAccessIter last, uint32_t nthread)
+  {
+    if (last - first < detail::min_sort_size)
+      boost::sort::pdqsort(first, last);
+    else
+      detail::parallel_float_sort(first, last, nthread);
+  }
+
+  /*!
+    \brief Multithreaded @c float_sort with casting to the appropriate size,
+    with one thread per hardware thread.
+
+    \param[in] first Iterator pointer to first element.
+    \param[in] last Iterator pointing to one beyond the end of data.
+  */
+  template <class RandomAccessIter>
+  inline void parallel_float_sort(RandomAccessIter first,
+                                  RandomAccessIter last)
+  {
+    parallel_float_sort(first, last, std::thread::hardware_concurrency());
+  }
+
+  /*!
+    \brief Multithreaded floating-point sort algorithm using random access iterators with just right-shift functor.
+
+    \details The functor is copied into each thread and called concurrently,
+    so it must not modify shared state.
+
+    \param[in] first Iterator pointer to first element.
+    \param[in] last Iterator pointing to one beyond the end of data.
+    \param[in] rshift Functor that returns the result of shifting the value_type right a specified number of bits.
+    \param[in] nthread Maximum number of threads to use.
+  */
+  template <class RandomAccessIter, class Right_shift>
+  inline void parallel_float_sort(RandomAccessIter first,
+                                  RandomAccessIter last, Right_shift rshift,
+                                  uint32_t nthread)
+  {
+    if (last - first < detail::min_sort_size)
+      boost::sort::pdqsort(first, last);
+    else
+      detail::parallel_float_sort(first, last, rshift(*first, 0), rshift,
+                                  nthread);
+  }
+
+  /*!
+    \brief Multithreaded floating-point sort algorithm using random access iterators with just right-shift functor,
+    with one thread per hardware thread.
+
+    \param[in] first Iterator pointer to first element.
+    \param[in] last Iterator pointing to one beyond the end of data.
+    \param[in] rshift Functor that returns the result of shifting the value_type right a specified number of bits.
+  */
+  template <class RandomAccessIter, class Right_shift,
+            bscu::enable_if_not_integral<Right_shift> * = nullptr>
+  inline void parallel_float_sort(RandomAccessIter first,
+                                  RandomAccessIter last, Right_shift rshift)
+  {
+    parallel_float_sort(first, last, rshift,
+                        std::thread::hardware_concurrency());
+  }
+
+  /*!
+    \brief Multithreaded float sort algorithm using random access iterators with both right-shift and user-defined comparison operator.
+
+    \details The functors are copied into each thread and called concurrently,
+    so they must not modify shared state.
+
+    \param[in] first Iterator pointer to first element.
+    \param[in] last Iterator pointing to one beyond the end of data.
+    \param[in] rshift Functor that returns the result of shifting the value_type right a specified number of bits.
+    \param[in] comp A binary functor that returns whether the first element passed to it should go before the second in order.
+    \param[in] nthread Maximum number of threads to use.
+  */
+  template <class RandomAccessIter, class Right_shift, class Compare>
+  inline void parallel_float_sort(RandomAccessIter first,
+                                  RandomAccessIter last, Right_shift rshift,
+                                  Compare comp, uint32_t nthread)
+  {
+    if (last - first < detail::min_sort_size)
+      boost::sort::pdqsort(first, last, comp);
+    else
+      detail::parallel_float_sort(first, last, rshift(*first, 0), rshift,
+                                  comp, nthread);
+  }
+
+  /*!
+    \brief Multithreaded float sort algorithm using random access iterators with both right-shift and user-defined comparison operator,
+    with one thread per hardware thread.
+
+    \param[in] first Iterator pointer to first element.
+    \param[in] last Iterator pointing to one beyond the end of data.
+    \param[in] rshift Functor that returns the result of shifting the value_type right a specified number of bits.
+    \param[in] comp A binary functor that returns whether the first element passed to it should go before the second in order.
+  */
+  template <class RandomAccessIter, class Right_shift, class Compare,
+            bscu::enable_if_not_integral<Compare> * = nullptr>
+  inline void parallel_float_sort(RandomAccessIter first,
+                                  RandomAccessIter last, Right_shift rshift,
+                                  Compare comp)
+  {
+    parallel_float_sort(first, last, rshift, comp,
+                        std::thread::hardware_concurrency());
+  }
+}
+}
+}
+
+#endif
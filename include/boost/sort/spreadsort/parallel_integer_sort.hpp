@@ -0,0 +1,184 @@
+//Templated multithreaded Spreadsort-based implementation of integer_sort
+
+//          Copyright Steven J. Ross 2001 - 2014.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// See http://www.boost.org/libs/sort/ for library home page.
+
+#ifndef BOOST_PARALLEL_INTEGER_SORT_HPP
+#define BOOST_PARALLEL_INTEGER_SORT_HPP
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <thread>
+#include <boost/sort/common/util/traits.hpp>
+#include <boost/sort/spreadsort/detail/constants.hpp>
+#include <boost/sort/spreadsort/detail/parallel_integer_sort.hpp>
+
+namespace boost {
+namespace sort {
+namespace spreadsort {
+  namespace bscu = boost::sort::common::util;
+
+/*! \brief Multithreaded integer sort algorithm using random access iterators.
+  (All variants fall back to @c boost::sort::pdqsort if the data size is too small, < @c detail::min_sort_size).
+
+  \details @c parallel_integer_sort is @c integer_sort with its work split across threads.
+The first radix pass is counted and distributed in place by all the threads together,
+then the resulting bins are sorted concurrently, largest first, with the serial algorithm;
+a bin too large for one thread is sorted the same way with all the threads.
+Each thread needs at least @c detail::parallel_min_thread_size elements, so smaller inputs use fewer threads,
+and with a single thread this is exactly @c integer_sort.
+Like @c integer_sort it is in place and not stable.
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] last Iterator pointing to one beyond the end of data.
+   \param[in] nthread Maximum number of threads to use; defaults to @c std::thread::hardware_concurrency().
+
+   \pre [@c first, @c last) is a valid range.
+   \pre @c RandomAccessIter @c value_type is mutable.
+   \pre @c RandomAccessIter @c value_type is <a href="http://en.cppreference.com/w/cpp/concept/LessThanComparable">LessThanComparable</a>
+   \pre @c RandomAccessIter @c value_type supports the @c operator>>,
+   which returns an integer-type right-shifted a specified number of bits.
+   \post The elements in the range [@c first, @c last) are sorted in ascending order.
+
+   \throws std::exception Propagates exceptions if any of the element comparisons, the element swaps (or moves),
+   the right shift, subtraction of right-shifted elements, functors, or any operations on iterators throw,
+   or if a thread can't be started.  All threads have finished when the exception reaches the caller.
+
+   \warning Throwing an exception may cause data loss.
+   \warning Invalid arguments cause undefined behaviour.
+
+   \remark Worst-case work is the same as @c integer_sort, divided among the threads.
+*/
+  template <class RandomAccessIter>
+  inline void parallel_integer_sort(RandomAccessIter first,
+                                    RandomAccessIter last, uint32_t nthread)
+  {
+    typedef typename std::iterator_traits<RandomAccessIter>::value_type
+      value_type;
+    // Don't sort if it's too small to optimize.
+    if (last - first < detail::min_sort_size)
+      boost::sort::pdqsort(first, last);
+    else
+      detail::parallel_integer_sort(first, last, *first >> 0,
+        detail::default_right_shift(), std::less<value_type>(), nthread);
+  }
+
+/*! \brief Multithreaded integer sort algorithm using random access iterators, with one thread per hardware thread.
+  (All variants fall back to @c boost::sort::pdqsort if the data size is too small, < @c detail::min_sort_size).
+
+  \details Calls @c parallel_integer_sort with @c nthread set to @c std::thread::hardware_concurrency().
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] last Iterator pointing to one beyond the end of data.
+
+   \pre Same as @c integer_sort(first, last).
+   \post The elements in the range [@c first, @c last) are sorted in ascending order.
+*/
+  template <class RandomAccessIter>
+  inline void parallel_integer_sort(RandomAccessIter first,
+                                    RandomAccessIter last)
+  {
+    parallel_integer_sort(first, last, std::thread::hardware_concurrency());
+  }
+
+/*! \brief Multithreaded integer sort algorithm using random access iterators with both right-shift and user-defined comparison operator.
+  (All variants fall back to @c boost::sort::pdqsort if the data size is too small, < @c detail::min_sort_size).
+
+  \details Same as @c parallel_integer_sort(first, last, nthread), using @c shift and @c comp
+  as @c integer_sort(first, last, shift, comp) does.  Both functors are copied into each thread
+  and called concurrently, so they must not modify shared state.
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] last Iterator pointing to one beyond the end of data.
+   \param[in] shift Functor that returns the result of shifting the value_type right a specified number of bits.
+   \param[in] comp A binary functor that returns whether the first element passed to it should go before the second in order.
+   \param[in] nthread Maximum number of threads to use.
+
+   \pre Same as @c integer_sort(first, last, shift, comp).
+   \post The elements in the range [@c first, @c last) are sorted in ascending order.
+*/
+  template <class RandomAccessIter, class Right_shift, class Compare>
+  inline void parallel_integer_sort(RandomAccessIter first,
+                                    RandomAccessIter last, Right_shift shift,
+                                    Compare comp, uint32_t nthread)
+  {
+    if (last - first < detail::min_sort_size)
+      boost::sort::pdqsort(first, last, comp);
+    else
+      detail::parallel_integer_sort(first, last, shift(*first, 0), shift,
+                                    comp, nthread);
+  }
+
+/*! \brief Multithreaded integer sort algorithm using random access iterators with both right-shift and user-defined comparison operator,
+  with one thread per hardware thread.
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] last Iterator pointing to one beyond the end of data.
+   \param[in] shift Functor that returns the result of shifting the value_type right a specified number of bits.
+   \param[in] comp A binary functor that returns whether the first element passed to it should go before the second in order.
+
+   \pre Same as @c integer_sort(first, last, shift, comp).
+   \post The elements in the range [@c first, @c last) are sorted in ascending order.
+*/
+  template <class RandomAccessIter, class Right_shift, class Compare,
+            bscu::enable_if_not_integral<Compare> * = nullptr>
+  inline void parallel_integer_sort(RandomAccessIter first,
+                                    RandomAccessIter last, Right_shift shift,
+                                    Compare comp)
+  {
+    parallel_integer_sort(first, last, shift, comp,
+                          std::thread::hardware_concurrency());
+  }
+
+/*! \brief Multithreaded integer sort algorithm using random access iterators with just right-shift functor.
+  (All variants fall back to @c boost::sort::pdqsort if the data size is too small, < @c detail::min_sort_size).
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] last Iterator pointing to one beyond the end of data.
+   \param[in] shift Functor that returns the result of shifting the value_type right a specified number of bits.
+   \param[in] nthread Maximum number of threads to use.
+
+   \pre Same as @c integer_sort(first, last, shift).
+   \post The elements in the range [@c first, @c last) are sorted in ascending order.
+*/
+  template <class RandomAccessIter, class Right_shift>
+  inline void parallel_integer_sort(RandomAccessIter first,
+                                    RandomAccessIter last, Right_shift shift,
+                                    uint32_t nthread)
+  {
+    typedef typename std::iterator_traits<RandomAccessIter>::value_type
+      value_type;
+    if (last - first < detail::min_sort_size)
+      boost::sort::pdqsort(first, last);
+    else
+      detail::parallel_integer_sort(first, last, shift(*first, 0), shift,
+                                    std::less<value_type>(), nthread);
+  }
+
+/*! \brief Multithreaded integer sort algorithm using random access iterators with just right-shift functor,
+  with one thread per hardware thread.
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] last Iterator pointing to one beyond the end of data.
+   \param[in] shift Functor that returns the result of shifting the value_type right a specified number of bits.
+
+   \pre Same as @c integer_sort(first, last, shift).
+   \post The elements in the range [@c first, @c last) are sorted in ascending order.
+*/
+  template <class RandomAccessIter, class Right_shift,
+            bscu::enable_if_not_integral<Right_shift> * = nullptr>
+  inline void parallel_integer_sort(RandomAccessIter first,
+                                    RandomAccessIter last, Right_shift shift)
+  {
+    parallel_integer_sort(first, last, shift,
+                          std::thread::hardware_concurrency());
+  }
+}
+}
+}
+
+#endif
@@ -0,0 +1,224 @@
+//Templated multithreaded hybrid string_sort
+
+//          Copyright Steven J. Ross 2001 - 2009.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// See http://www.boost.org/libs/sort/ for library home page.
+
+#ifndef BOOST_PARALLEL_STRING_SORT_HPP
+#define BOOST_PARALLEL_STRING_SORT_HPP
+#include <cstdint>
+#include <thread>
+#include <boost/sort/common/util/traits.hpp>
+#include <boost/sort/spreadsort/detail/constants.hpp>
+#include <boost/sort/spreadsort/detail/parallel_string_sort.hpp>
+
+namespace boost {
+namespace sort {
+namespace spreadsort {
+  namespace bscu = boost::sort::common::util;
+
+/*! \brief Multithreaded string sort algorithm using random access iterators, allowing character-type overloads.
+  (All variants fall back to @c boost::sort::pdqsort if the data size is too small, < @c detail::min_sort_size).
+
+  \details @c parallel_string_sort is @c string_sort with its work split across threads.
+The common prefix is found and the strings are distributed on their first differing character
+by all the threads together, in place; then the character bins are sorted concurrently,
+largest first, with the serial algorithm, and a bin too large for one thread is sorted the same way with all the threads.
+Each thread needs at least @c detail::parallel_min_thread_size strings, so smaller inputs use fewer threads,
+and with a single thread this is exactly @c string_sort.
+Like @c string_sort it is in place and not stable.
+
+   \tparam Unsigned_char_type Unsigned character type used for string.
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] last Iterator pointing to one beyond the end of data.
+   \param[in] unused value with the same type as the result of the [] operator, defining the Unsigned_char_type.  The actual value is unused.
+   \param[in] nthread Maximum number of threads to use.
+
+   \pre [@c first, @c last) is a valid range.
+   \pre @c RandomAccessIter @c value_type is mutable.
+   \pre @c RandomAccessIter @c value_type is <a href="http://en.cppreference.com/w/cpp/concept/LessThanComparable">LessThanComparable</a>
+   \pre @c RandomAccessIter @c value_type supports the @c operator[] and @c size() as @c string_sort requires.
+   \post The elements in the range [@c first, @c last) are sorted in ascending order.
+
+   \throws std::exception Propagates exceptions if any of the element comparisons, the element swaps (or moves),
+   functors, or any operations on iterators throw, or if a thread can't be started.
+   All threads have finished when the exception reaches the caller.
+
+   \warning Throwing an exception may cause data loss.
+   \warning Invalid arguments cause undefined behaviour.
+*/
+  template <class RandomAccessIter, class Unsigned_char_type>
+  inline void parallel_string_sort(RandomAccessIter first,
+                                   RandomAccessIter last,
+                                   Unsigned_char_type unused, uint32_t nthread)
+  {
+    //Don't sort if it's too small to optimize
+    if (last - first < detail::min_sort_size)
+      boost::sort::pdqsort(first, last);
+    else
+      detail::parallel_string_sort(first, last, unused, nthread);
+  }
+
+/*! \brief Multithreaded string sort algorithm using random access iterators, wraps using default of @c unsigned char.
+  (All variants fall back to @c boost::sort::pdqsort if the data size is too small, < @c detail::min_sort_size).
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] last Iterator pointing to one beyond the end of data.
+   \param[in] nthread Maximum number of threads to use.
+
+   \pre Same as @c string_sort(first, last).
+   \post The elements in the range [@c first, @c last) are sorted in ascending order.
+*/
+  template <class RandomAccessIter>
+  inline void parallel_string_sort(RandomAccessIter first,
+                                   RandomAccessIter last, uint32_t nthread)
+  {
+    unsigned char unused = '\0';
+    parallel_string_sort(first, last, unused, nthread);
+  }
+
+/*! \brief Multithreaded string sort algorithm using random access iterators, wraps using default of @c unsigned char,
+  with one thread per hardware thread.
+  (All variants fall back to @c boost::sort::pdqsort if the data size is too small, < @c detail::min_sort_size).
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] last Iterator pointing to one beyond the end of data.
+
+   \pre Same as @c string_sort(first, last).
+   \post The elements in the range [@c first, @c last) are sorted in ascending order.
+*/
+  template <class RandomAccessIter>
+  inline void parallel_string_sort(RandomAccessIter first,
+                                   RandomAccessIter last)
+  {
+    parallel_string_sort(first, last, std::thread::hardware_concurrency());
+  }
+
+/*! \brief Multithreaded string sort algorithm using random access iterators, with character and length functors.
+  (All variants fall back to @c boost::sort::pdqsort if the data size is too small, < @c detail::min_sort_size).
+
+  \details Same as @c parallel_string_sort(first, last, nthread), reading characters and lengths
+  as @c string_sort(first, last, get_character, length) does.  The functors are copied into each thread
+  and called concurrently, so they must not modify shared state.
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] last Iterator pointing to one beyond the end of data.
+   \param[in] get_character Bracket functor equivalent to @c operator[], taking a number corresponding to the character offset.
+   \param[in] length Functor to get the length of the string in characters.
+   \param[in] nthread Maximum number of threads to use.
+
+   \pre Same as @c string_sort(first, last, get_character, length).
+   \post The elements in the range [@c first, @c last) are sorted in ascending order.
+*/
+  template <class RandomAccessIter, class Get_char, class Get_length>
+  inline void parallel_string_sort(RandomAccessIter first,
+                                   RandomAccessIter last,
+                                   Get_char get_character, Get_length length,
+                                   uint32_t nthread)
+  {
+    //Don't sort if it's too small to optimize
+    if (last - first < detail::min_sort_size)
+      boost::sort::pdqsort(first, last);
+    else {
+      //skipping past empties, which allows us to get the character type
+      //.empty() is not used so as not to require a user declaration of it
+      while (!length(*first)) {
+        if (++first == last)
+          return;
+      }
+      detail::parallel_string_sort(first, last, get_character, length,
+                                   get_character((*first), 0), nthread);
+    }
+  }
+
+/*! \brief Multithreaded string sort algorithm using random access iterators, with character and length functors,
+  with one thread per hardware thread.
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] last Iterator pointing to one beyond the end of data.
+   \param[in] get_character Bracket functor equivalent to @c operator[], taking a number corresponding to the character offset.
+   \param[in] length Functor to get the length of the string in characters.
+
+   \pre Same as @c string_sort(first, last, get_character, length).
+   \post The elements in the range [@c first, @c last) are sorted in ascending order.
+*/
+  template <class RandomAccessIter, class Get_char, class Get_length,
+            bscu::enable_if_not_integral<Get_length> * = nullptr>
+  inline void parallel_string_sort(RandomAccessIter first,
+                                   RandomAccessIter last,
+                                   Get_char get_character, Get_length length)
+  {
+    parallel_string_sort(first, last, get_character, length,
+                         std::thread::hardware_concurrency());
+  }
+
+/*! \brief Multithreaded string sort algorithm using random access iterators, with character, length and comparison functors.
+  (All variants fall back to @c boost::sort::pdqsort if the data size is too small, < @c detail::min_sort_size).
+
+  \details Same as @c parallel_string_sort(first, last, nthread), using the functors
+  as @c string_sort(first, last, get_character, length, comp) does.  The functors are copied into each thread
+  and called concurrently, so they must not modify shared state.
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] last Iterator pointing to one beyond the end of data.
+   \param[in] get_character Bracket functor equivalent to @c operator[], taking a number corresponding to the character offset.
+   \param[in] length Functor to get the length of the string in characters.
+   \param[in] comp A binary functor that returns whether the first element passed to it should go before the second in order.
+   \param[in] nthread Maximum number of threads to use.
+
+   \pre Same as @c string_sort(first, last, get_character, length, comp).
+   \post The elements in the range [@c first, @c last) are sorted in ascending order.
+*/
+  template <class RandomAccessIter, class Get_char, class Get_length,
+            class Compare>
+  inline void parallel_string_sort(RandomAccessIter first,
+                                   RandomAccessIter last,
+                                   Get_char get_character, Get_length length,
+                                   Compare comp, uint32_t nthread)
+  {
+    //Don't sort if it's too small to optimize
+    if (last - first < detail::min_sort_size)
+      boost::sort::pdqsort(first, last, comp);
+    else {
+      //skipping past empties, which allows us to get the character type
+      //.empty() is not used so as not to require a user declaration of it
+      while (!length(*first)) {
+        if (++first == last)
+          return;
+      }
+      detail::parallel_string_sort(first, last, get_character, length, comp,
+                                   get_character((*first), 0), nthread);
+    }
+  }
+
+/*! \brief Multithreaded string sort algorithm using random access iterators, with character, length and comparison functors,
+  with one thread per hardware thread.
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] last Iterator pointing to one beyond the end of data.
+   \param[in] get_character Bracket functor equivalent to @c operator[], taking a number corresponding to the character offset.
+   \param[in] length Functor to get the length of the string in characters.
+   \param[in] comp A binary functor that returns whether the first element passed to it should go before the second in order.
+
+   \pre Same as @c string_sort(first, last, get_character, length, comp).
+   \post The elements in the range [@c first, @c last) are sorted in ascending order.
+*/
+  template <class RandomAccessIter, class Get_char, class Get_length,
+            class Compare, bscu::enable_if_not_integral<Compare> * = nullptr>
+  inline void parallel_string_sort(RandomAccessIter first,
+                                   RandomAccessIter last,
+                                   Get_char get_character, Get_length length,
+                                   Compare comp)
+  {
+    parallel_string_sort(first, last, get_character, length, comp,
+                         std::thread::hardware_concurrency());
+  }
+}
+}
+}
+
+#endif
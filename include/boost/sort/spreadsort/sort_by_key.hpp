@@ -0,0 +1,290 @@
+//Templated Spreadsort-based key/value sorts for separate key and value arrays
+
+//          Copyright Steven J. Ross 2001 - 2014.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// See http://www.boost.org/libs/sort/ for library home page.
+
+#ifndef BOOST_SORT_BY_KEY_HPP
+#define BOOST_SORT_BY_KEY_HPP
+#include <iterator>
+#include <functional>
+#include <boost/sort/spreadsort/detail/constants.hpp>
+#include <boost/sort/spreadsort/detail/sort_by_key.hpp>
+
+namespace boost {
+namespace sort {
+namespace spreadsort {
+
+/*! \brief Sorts an array of integer keys with a radix sort, and applies the same permutation to an array of values.
+
+  \details This is for columnar data, where keys and their values are in separate arrays
+(or where packing them into one struct would make every swap move the whole struct).
+The keys are copied into (key, index) pairs, which are sorted with @c integer_sort_lsd
+(as they are small, and there is no comparison to call),
+so the values are not touched until the final order is known;
+then the keys are written back and the values are gathered into their final positions through a buffer.
+Indices are 32-bit when there are fewer than 2^32 keys.
+An overload takes a second array of values, to be moved with the first.
+
+   \param[in] keys_first Iterator pointer to first key.
+   \param[in] keys_last Iterator pointing to one beyond the last key.
+   \param[in] values_first Iterator pointer to the value of the first key;
+   there must be one value for each key.
+
+   \pre [@c keys_first, @c keys_last) and [@c values_first, @c values_first + (@c keys_last - @c keys_first)) are valid ranges
+   that do not overlap.
+   \pre The key type is an integral type, or meets the same requirements as for @c integer_sort_lsd(first, last).
+   \pre The value type is copy-constructible and assignable.
+   \post The keys are sorted in ascending order, and the value at each position is the one that was with its key.
+   Values of equal keys keep their relative order.
+
+   \throws std::exception Propagates exceptions if the allocations, the key or value copies,
+   right shifts, or any operations on iterators throw.
+
+   \warning Throwing an exception may cause data loss.
+
+   \remark The same complexity as @c integer_sort_lsd, plus <em> O(N) </em> moves of each value,
+   and <em> O(N) </em> additional memory for the pairs and the buffer.
+*/
+  template <class Key_iter, class Value_iter>
+  inline void integer_sort_by_key(Key_iter keys_first, Key_iter keys_last,
+                                  Value_iter values_first)
+  {
+    if (keys_last - keys_first > 1)
+      detail::integer_sort_by_key(keys_first, keys_last,
+                                  detail::make_mover(values_first),
+                                  *keys_first, detail::lsd_default_shift());
+  }
+
+/*! \brief Sorts an array of integer keys with a radix sort, and applies the same permutation to two arrays of values.
+
+   \param[in] keys_first Iterator pointer to first key.
+   \param[in] keys_last Iterator pointing to one beyond the last key.
+   \param[in] values_first Iterator pointer to the value of the first key in the first array of values.
+   \param[in] values2_first Iterator pointer to the value of the first key in the second array of values.
+
+   \pre Same as @c integer_sort_by_key(keys_first, keys_last, values_first), for both arrays of values.
+   \post The keys are sorted in ascending order, and the values at each position are the ones that were with its key.
+   Values of equal keys keep their relative order.
+*/
+  template <class Key_iter, class Value_iter, class Value2_iter>
+  inline void integer_sort_by_key(Key_iter keys_first, Key_iter keys_last,
+                                  Value_iter values_first,
+                                  Value2_iter values2_first)
+  {
+    if (keys_last - keys_first > 1)
+      detail::integer_sort_by_key(keys_first, keys_last,
+                                  detail::make_mover_pair(
+                                      detail::make_mover(values_first),
+                                      detail::make_mover(values2_first)),
+                                  *keys_first, detail::lsd_default_shift());
+  }
+
+/*! \brief Sorts an array of keys with @c integer_sort using right-shift and comparison functors on the keys,
+  and applies the same permutation to an array of values.
+
+   \param[in] keys_first Iterator pointer to first key.
+   \param[in] keys_last Iterator pointing to one beyond the last key.
+   \param[in] values_first Iterator pointer to the value of the first key.
+   \param[in] shift Functor that returns the result of shifting a key right a specified number of bits.
+   \param[in] comp A binary functor that returns whether the first key passed to it should go before the second in order.
+
+   \details The (key, index) pairs are sorted with @c integer_sort, so this takes the
+same functors and supports any order they define, but values of equal keys are in an unspecified order.
+
+   \pre Same as @c integer_sort_by_key(keys_first, keys_last, values_first), with
+   the key type meeting the requirements of @c integer_sort(first, last, shift, comp).
+   \post The keys are sorted according to @c comp, and the value at each position is the one that was with its key.
+*/
+  template <class Key_iter, class Value_iter, class Right_shift,
+            class Compare>
+  inline void integer_sort_by_key(Key_iter keys_first, Key_iter keys_last,
+                                  Value_iter values_first, Right_shift shift,
+                                  Compare comp)
+  {
+    if (keys_last - keys_first > 1)
+      detail::integer_sort_by_key(keys_first, keys_last,
+                                  detail::make_mover(values_first),
+                                  shift(*keys_first, 0), shift, comp);
+  }
+
+/*! \brief Sorts an array of floating-point keys with @c float_sort, and applies the same permutation to an array of values.
+
+  \details The keys are sorted as (key, index) pairs and the values moved once afterwards,
+as for @c integer_sort_by_key.
+
+   \param[in] keys_first Iterator pointer to first key.
+   \param[in] keys_last Iterator pointing to one beyond the last key.
+   \param[in] values_first Iterator pointer to the value of the first key.
+
+   \pre Same as @c integer_sort_by_key(keys_first, keys_last, values_first), except that the key type must be
+   default-constructible and an IEEE 754 floating-point type with the size of @c boost::int32_t or @c boost::int64_t, as for @c float_sort(first, last).
+   \post The keys are sorted in ascending order, and the value at each position is the one that was with its key.
+   Values of equal keys are in an unspecified order.
+*/
+  template <class Key_iter, class Value_iter>
+  inline void float_sort_by_key(Key_iter keys_first, Key_iter keys_last,
+                                Value_iter values_first)
+  {
+    typedef typename std::iterator_traits<Key_iter>::value_type Key_type;
+    typedef typename detail::float_key_cast<sizeof(Key_type)>::type
+      Cast_type;
+    if (keys_last - keys_first > 1)
+      detail::float_sort_by_key(keys_first, keys_last,
+                                detail::make_mover(values_first),
+                                Cast_type(),
+                                detail::float_key_shift<Key_type, Cast_type>(),
+                                std::less<Key_type>());
+  }
+
+/*! \brief Sorts an array of floating-point keys with @c float_sort, and applies the same permutation to two arrays of values.
+
+   \param[in] keys_first Iterator pointer to first key.
+   \param[in] keys_last Iterator pointing to one beyond the last key.
+   \param[in] values_first Iterator pointer to the value of the first key in the first array of values.
+   \param[in] values2_first Iterator pointer to the value of the first key in the second array of values.
+
+   \pre Same as @c float_sort_by_key(keys_first, keys_last, values_first), for both arrays of values.
+   \post The keys are sorted in ascending order, and the values at each position are the ones that were with its key.
+*/
+  template <class Key_iter, class Value_iter, class Value2_iter>
+  inline void float_sort_by_key(Key_iter keys_first, Key_iter keys_last,
+                                Value_iter values_first,
+                                Value2_iter values2_first)
+  {
+    typedef typename std::iterator_traits<Key_iter>::value_type Key_type;
+    typedef typename detail::float_key_cast<sizeof(Key_type)>::type
+      Cast_type;
+    if (keys_last - keys_first > 1)
+      detail::float_sort_by_key(keys_first, keys_last,
+                                detail::make_mover_pair(
+                                    detail::make_mover(values_first),
+                                    detail::make_mover(values2_first)),
+                                Cast_type(),
+                                detail::float_key_shift<Key_type, Cast_type>(),
+                                std::less<Key_type>());
+  }
+
+/*! \brief Sorts an array of keys with @c float_sort using right-shift and comparison functors on the keys,
+  and applies the same permutation to an array of values.
+
+   \param[in] keys_first Iterator pointer to first key.
+   \param[in] keys_last Iterator pointing to one beyond the last key.
+   \param[in] values_first Iterator pointer to the value of the first key.
+   \param[in] shift Functor that returns the result of casting a key to a signed integer and shifting it right a specified number of bits.
+   \param[in] comp A binary functor that returns whether the first key passed to it should go before the second in order.
+
+   \pre Same as @c integer_sort_by_key(keys_first, keys_last, values_first), with
+   the key type meeting the requirements of @c float_sort(first, last, shift, comp).
+   \post The keys are sorted according to @c comp, and the value at each position is the one that was with its key.
+*/
+  template <class Key_iter, class Value_iter, class Right_shift,
+            class Compare>
+  inline void float_sort_by_key(Key_iter keys_first, Key_iter keys_last,
+                                Value_iter values_first, Right_shift shift,
+                                Compare comp)
+  {
+    if (keys_last - keys_first > 1)
+      detail::float_sort_by_key(keys_first, keys_last,
+                                detail::make_mover(values_first),
+                                shift(*keys_first, 0), shift, comp);
+  }
+
+/*! \brief Sorts an array of string keys with @c string_sort, and applies the same permutation to an array of values.
+
+  \details As strings are already indirect, only an array of indices is sorted, reading the keys through them;
+then the keys and values are gathered into their final positions.
+
+   \param[in] keys_first Iterator pointer to first key.
+   \param[in] keys_last Iterator pointing to one beyond the last key.
+   \param[in] values_first Iterator pointer to the value of the first key.
+
+   \pre [@c keys_first, @c keys_last) and [@c values_first, @c values_first + (@c keys_last - @c keys_first)) are valid ranges
+   that do not overlap.
+   \pre The key type meets the requirements of @c string_sort(first, last), and is copy-constructible and assignable.
+   \pre The value type is copy-constructible and assignable.
+   \post The keys are sorted in ascending order, and the value at each position is the one that was with its key.
+   Values of equal keys are in an unspecified order.
+
+   \throws std::exception Propagates exceptions if the allocations, the key or value copies, the key
+   comparisons, character accesses, or any operations on iterators throw.
+
+   \warning Throwing an exception may cause data loss.
+*/
+  template <class Key_iter, class Value_iter>
+  inline void string_sort_by_key(Key_iter keys_first, Key_iter keys_last,
+                                 Value_iter values_first)
+  {
+    typedef typename std::iterator_traits<Key_iter>::value_type Key_type;
+    if (keys_last - keys_first > 1)
+      detail::string_sort_by_key(keys_first, keys_last,
+                                 detail::make_mover(values_first),
+                                 detail::key_bracket(), detail::key_size(),
+                                 std::less<Key_type>(), (unsigned char)0);
+  }
+
+/*! \brief Sorts an array of string keys with @c string_sort, and applies the same permutation to two arrays of values.
+
+   \param[in] keys_first Iterator pointer to first key.
+   \param[in] keys_last Iterator pointing to one beyond the last key.
+   \param[in] values_first Iterator pointer to the value of the first key in the first array of values.
+   \param[in] values2_first Iterator pointer to the value of the first key in the second array of values.
+
+   \pre Same as @c string_sort_by_key(keys_first, keys_last, values_first), for both arrays of values.
+   \post The keys are sorted in ascending order, and the values at each position are the ones that were with its key.
+*/
+  template <class Key_iter, class Value_iter, class Value2_iter>
+  inline void string_sort_by_key(Key_iter keys_first, Key_iter keys_last,
+                                 Value_iter values_first,
+                                 Value2_iter values2_first)
+  {
+    typedef typename std::iterator_traits<Key_iter>::value_type Key_type;
+    if (keys_last - keys_first > 1)
+      detail::string_sort_by_key(keys_first, keys_last,
+                                 detail::make_mover_pair(
+                                     detail::make_mover(values_first),
+                                     detail::make_mover(values2_first)),
+                                 detail::key_bracket(), detail::key_size(),
+                                 std::less<Key_type>(), (unsigned char)0);
+  }
+
+/*! \brief Sorts an array of keys with @c string_sort using character access and comparison functors on the keys,
+  and applies the same permutation to an array of values.
+
+   \param[in] keys_first Iterator pointer to first key.
+   \param[in] keys_last Iterator pointing to one beyond the last key.
+   \param[in] values_first Iterator pointer to the value of the first key.
+   \param[in] get_character Functor that returns the character at a given offset of a key, as an unsigned type.
+   \param[in] length Functor that returns the length of a key.
+   \param[in] comp A binary functor that returns whether the first key passed to it should go before the second in order.
+
+   \pre Same as @c string_sort_by_key(keys_first, keys_last, values_first), with
+   the key type meeting the requirements of @c string_sort(first, last, get_character, length, comp).
+   \post The keys are sorted according to @c comp, and the value at each position is the one that was with its key.
+*/
+  template <class Key_iter, class Value_iter, class Get_char,
+            class Get_length, class Compare>
+  inline void string_sort_by_key(Key_iter keys_first, Key_iter keys_last,
+                                 Value_iter values_first,
+                                 Get_char get_character, Get_length length,
+                                 Compare comp)
+  {
+    //A key that isn't empty, to get the character type from.
+    //If they are all empty there is nothing to do.
+    Key_iter current = keys_first;
+    while (current != keys_last && !length(*current))
+      ++current;
+    if (current != keys_last)
+      detail::string_sort_by_key(keys_first, keys_last,
+                                 detail::make_mover(values_first),
+                                 get_character, length, comp,
+                                 get_character(*current, 0));
+  }
+}
+}
+}
+
+#endif
@@ -27,6 +27,7 @@ Scott McMurray
 #include <boost/sort/spreadsort/integer_sort.hpp>
 #include <boost/sort/spreadsort/float_sort.hpp>
 #include <boost/sort/spreadsort/string_sort.hpp>
+#include <boost/sort/spreadsort/sort_by_key.hpp>
 #include <boost/range/begin.hpp>
 #include <boost/range/end.hpp>
 
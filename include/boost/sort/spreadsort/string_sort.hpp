@@ -20,7 +20,10 @@ Phil Endecott and Frank Gennari
 #include <limits>
 #include <boost/static_assert.hpp>
 #include <boost/sort/spreadsort/detail/constants.hpp>
+#include <boost/sort/spreadsort/detail/tuning.hpp>
 #include <boost/sort/spreadsort/detail/string_sort.hpp>
+#include <boost/sort/spreadsort/detail/string_sort_cached.hpp>
+#include <boost/sort/spreadsort/detail/string_sort_fixed.hpp>
 #include <boost/range/begin.hpp>
 #include <boost/range/end.hpp>
 
@@ -734,6 +737,368 @@ inline void reverse_string_sort(Range& range, Get_char get_character, Get_length
 {
     reverse_string_sort(boost::begin(range), boost::end(range), get_character, length, comp);
 }
+
+/*! \brief String sort algorithm using random access iterators, wraps using default of @c unsigned char,
+  with a reusable workspace.
+  (Falls back to @c boost::sort::pdqsort if the data size is too small, < @c detail::min_sort_size).
+
+  \details Same as @c string_sort(first, last), but the bin cache and bin sizes are kept in
+@c workspace instead of being allocated for each call, so once the workspace has grown to
+the largest size needed, repeated sorts make no heap allocations.
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] last Iterator pointing to one beyond the end of data.
+   \param[in,out] workspace Storage reused between calls; not used by other threads at the same time.
+
+   \pre Same as @c string_sort(first, last).
+   \post The elements in the range [@c first, @c last) are sorted in ascending order.
+*/
+  template <class RandomAccessIter>
+  inline void string_sort(RandomAccessIter first, RandomAccessIter last,
+                          spreadsort_workspace<RandomAccessIter> &workspace)
+  {
+    unsigned char unused = '\0';
+    if (last - first < detail::min_sort_size)
+      boost::sort::pdqsort(first, last);
+    else
+      detail::string_sort(first, last, unused, &workspace);
+  }
+
+/*! \brief String sort algorithm using random access iterators, with character and length functors,
+  and a reusable workspace.
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] last Iterator pointing to one beyond the end of data.
+   \param[in] get_character Bracket functor equivalent to @c operator[], taking a number corresponding to the character offset.
+   \param[in] length Functor to get the length of the string in characters.
+   \param[in,out] workspace Storage reused between calls; not used by other threads at the same time.
+
+   \pre Same as @c string_sort(first, last, get_character, length).
+   \post The elements in the range [@c first, @c last) are sorted in ascending order.
+*/
+  template <class RandomAccessIter, class Get_char, class Get_length>
+  inline void string_sort(RandomAccessIter first, RandomAccessIter last,
+                          Get_char get_character, Get_length length,
+                          spreadsort_workspace<RandomAccessIter> &workspace)
+  {
+    if (last - first < detail::min_sort_size)
+      boost::sort::pdqsort(first, last);
+    else {
+      while (!length(*first)) {
+        if (++first == last)
+          return;
+      }
+      detail::string_sort(first, last, get_character, length,
+                          get_character((*first), 0), &workspace);
+    }
+  }
+
+/*! \brief String sort algorithm using random access iterators, with character and length functors,
+  a user-defined comparison operator, and a reusable workspace.
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] last Iterator pointing to one beyond the end of data.
+   \param[in] get_character Bracket functor equivalent to @c operator[], taking a number corresponding to the character offset.
+   \param[in] length Functor to get the length of the string in characters.
+   \param[in] comp A binary functor that returns whether the first element passed to it should go before the second in order.
+   \param[in,out] workspace Storage reused between calls; not used by other threads at the same time.
+
+   \pre Same as @c string_sort(first, last, get_character, length, comp).
+   \post The elements in the range [@c first, @c last) are sorted in ascending order.
+*/
+  template <class RandomAccessIter, class Get_char, class Get_length,
+            class Compare>
+  inline void string_sort(RandomAccessIter first, RandomAccessIter last,
+                          Get_char get_character, Get_length length,
+                          Compare comp,
+                          spreadsort_workspace<RandomAccessIter> &workspace)
+  {
+    if (last - first < detail::min_sort_size)
+      boost::sort::pdqsort(first, last, comp);
+    else {
+      while (!length(*first)) {
+        if (++first == last)
+          return;
+      }
+      detail::string_sort(first, last, get_character, length, comp,
+                          get_character((*first), 0), &workspace);
+    }
+  }
+
+/*! \brief String sort algorithm using random access iterators, wraps using default of @c unsigned char,
+  with the size threshold taken from a policy.
+  (Falls back to @c boost::sort::pdqsort if the data size is too small, < @c Tuning::min_sort_size).
+
+  \details Same as @c string_sort(first, last), but falls back to @c boost::sort::pdqsort below
+@c Tuning::min_sort_size elements instead of @c detail::min_sort_size.
+@c string_sort splits on one whole character per pass, so @c min_sort_size is the only
+constant of a @c default_tuning policy it reads; the others are used by @c integer_sort and @c float_sort.
+
+   \tparam Tuning A class derived from @c default_tuning.
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] last Iterator pointing to one beyond the end of data.
+
+   \pre Same as @c string_sort(first, last).
+   \post The elements in the range [@c first, @c last) are sorted in ascending order.
+*/
+  template <class Tuning, class RandomAccessIter>
+  inline typename detail::enable_if_tuning<Tuning>::type
+  string_sort(RandomAccessIter first, RandomAccessIter last)
+  {
+    unsigned char unused = '\0';
+    if (last - first < Tuning::min_sort_size)
+      boost::sort::pdqsort(first, last);
+    else
+      detail::string_sort(first, last, unused);
+  }
+
+/*! \brief String sort algorithm using random access iterators, with character and length functors,
+  and the size threshold taken from a policy.
+
+   \tparam Tuning A class derived from @c default_tuning.
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] last Iterator pointing to one beyond the end of data.
+   \param[in] get_character Bracket functor equivalent to @c operator[], taking a number corresponding to the character offset.
+   \param[in] length Functor to get the length of the string in characters.
+
+   \pre Same as @c string_sort(first, last, get_character, length).
+   \post The elements in the range [@c first, @c last) are sorted in ascending order.
+*/
+  template <class Tuning, class RandomAccessIter, class Get_char,
+            class Get_length>
+  inline typename detail::enable_if_tuning<Tuning>::type
+  string_sort(RandomAccessIter first, RandomAccessIter last,
+              Get_char get_character, Get_length length)
+  {
+    if (last - first < Tuning::min_sort_size)
+      boost::sort::pdqsort(first, last);
+    else {
+      while (!length(*first)) {
+        if (++first == last)
+          return;
+      }
+      detail::string_sort(first, last, get_character, length,
+                          get_character((*first), 0));
+    }
+  }
+
+/*! \brief String sort algorithm using random access iterators, with character and length functors,
+  a user-defined comparison operator, and the size threshold taken from a policy.
+
+   \tparam Tuning A class derived from @c default_tuning.
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] last Iterator pointing to one beyond the end of data.
+   \param[in] get_character Bracket functor equivalent to @c operator[], taking a number corresponding to the character offset.
+   \param[in] length Functor to get the length of the string in characters.
+   \param[in] comp A binary functor that returns whether the first element passed to it should go before the second in order.
+
+   \pre Same as @c string_sort(first, last, get_character, length, comp).
+   \post The elements in the range [@c first, @c last) are sorted in ascending order.
+*/
+  template <class Tuning, class RandomAccessIter, class Get_char,
+            class Get_length, class Compare>
+  inline typename detail::enable_if_tuning<Tuning>::type
+  string_sort(RandomAccessIter first, RandomAccessIter last,
+              Get_char get_character, Get_length length, Compare comp)
+  {
+    if (last - first < Tuning::min_sort_size)
+      boost::sort::pdqsort(first, last, comp);
+    else {
+      while (!length(*first)) {
+        if (++first == last)
+          return;
+      }
+      detail::string_sort(first, last, get_character, length, comp,
+                          get_character((*first), 0));
+    }
+  }
+
+/*! \brief String sort on cached key prefixes, using random access iterators, for strings with @c unsigned @c char characters.
+  (Falls back to @c boost::sort::pdqsort if the data size is too small, < @c detail::min_sort_size).
+
+  \details @c string_sort reads each string's characters through the string itself on every radix pass,
+which for strings stored out of line, like long @c std::string values, is a cache miss per string per pass.
+@c string_sort_cached instead copies the first 8 characters of every string, big-endian,
+into a compact array of (prefix, index) entries and radix sorts those with @c integer_sort.
+Only the strings in a run of equal prefixes are read again, to refill their prefixes with the next 8 characters,
+or to order the ones that end within the prefix by length.
+The strings are then swapped into their sorted positions.\n
+It is faster than @c string_sort when the strings are long and mostly differ within their first few
+characters, as with URLs or file paths; with short strings that @c std::string keeps inline
+there is little to gain, and it needs <em> O(N) </em> memory for the entries.
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] last Iterator pointing to one beyond the end of data.
+
+   \pre [@c first, @c last) is a valid range.
+   \pre @c RandomAccessIter @c value_type is mutable and swappable,
+   with @c operator[] returning a character and @c size() returning the length, as for @c string_sort.
+   \post The elements in the range [@c first, @c last) are sorted in ascending order.
+
+   \throws std::exception Propagates exceptions if the allocation, the character accesses,
+   the element swaps, or any operations on iterators throw.
+
+   \warning Throwing an exception may cause data loss.
+*/
+  template <class RandomAccessIter>
+  inline void string_sort_cached(RandomAccessIter first, RandomAccessIter last)
+  {
+    if (last - first < detail::min_sort_size)
+      boost::sort::pdqsort(first, last);
+    else
+      detail::string_sort_cached(first, last,
+                                 detail::cached_bracket<unsigned char>(),
+                                 detail::cached_size(), (unsigned char)0);
+  }
+
+/*! \brief String sort on cached key prefixes, using range, for strings with @c unsigned @c char characters.
+  (Falls back to @c boost::sort::pdqsort if the data size is too small, < @c detail::min_sort_size).
+
+   \param[in] range Range [first, last) for sorting.
+
+   \pre Same as @c string_sort_cached(first, last).
+   \post The elements in the range [@c first, @c last) are sorted in ascending order.
+*/
+template <class Range>
+inline void string_sort_cached(Range& range)
+{
+  string_sort_cached(boost::begin(range), boost::end(range));
+}
+
+/*! \brief String sort on cached key prefixes, using random access iterators with character access and length functors.
+  (Falls back to @c boost::sort::pdqsort if the data size is too small, < @c detail::min_sort_size).
+
+  \details Same as @c string_sort_cached(first, last), with the characters and lengths given by functors
+as for @c string_sort(first, last, get_character, length).
+A prefix holds 8 bytes' worth of characters, so characters must be smaller than 8 bytes.
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] last Iterator pointing to one beyond the end of data.
+   \param[in] get_character Bracket functor equivalent to @c operator[], taking a number corresponding to the character offset.
+   \param[in] length Functor to get the length of the string in characters.
+
+   \pre [@c first, @c last) is a valid range.
+   \pre @c RandomAccessIter @c value_type is mutable, swappable and
+   <a href="http://en.cppreference.com/w/cpp/concept/LessThanComparable">LessThanComparable</a>,
+   with @c operator< matching the order of the characters.
+   \post The elements in the range [@c first, @c last) are sorted in ascending order.
+
+   \throws std::exception Propagates exceptions if the allocation, the functors,
+   the element swaps, or any operations on iterators throw.
+
+   \warning Throwing an exception may cause data loss.
+*/
+  template <class RandomAccessIter, class Get_char, class Get_length>
+  inline void string_sort_cached(RandomAccessIter first, RandomAccessIter last,
+                                 Get_char get_character, Get_length length)
+  {
+    if (last - first < detail::min_sort_size) {
+      boost::sort::pdqsort(first, last);
+      return;
+    }
+    //A string that isn't empty, to get the character type from
+    RandomAccessIter current = first;
+    while (!length(*current)) {
+      if (++current == last)
+        return;
+    }
+    detail::string_sort_cached(first, last, get_character, length,
+                               get_character(*current, 0));
+  }
+
+/*! \brief String sort on cached key prefixes, using range with character access and length functors.
+  (Falls back to @c boost::sort::pdqsort if the data size is too small, < @c detail::min_sort_size).
+
+   \param[in] range Range [first, last) for sorting.
+   \param[in] get_character Bracket functor equivalent to @c operator[], taking a number corresponding to the character offset.
+   \param[in] length Functor to get the length of the string in characters.
+
+   \pre Same as @c string_sort_cached(first, last, get_character, length).
+   \post The elements in the range [@c first, @c last) are sorted in ascending order.
+*/
+template <class Range, class Get_char, class Get_length>
+inline void string_sort_cached(Range& range, Get_char get_character,
+                               Get_length length)
+{
+  string_sort_cached(boost::begin(range), boost::end(range), get_character,
+                     length);
+}
+
+/*! \brief String sort for keys of exactly @c Width bytes, using random access iterators and a key functor.
+  (Falls back to @c boost::sort::pdqsort if the data size is too small, < @c detail::min_sort_size).
+
+  \details Sorts records by a key of @c Width bytes, such as a @c char[16] code, in @c memcmp order
+(comparing the bytes as @c unsigned @c char).
+As the width is known at compile time, there are no empty strings to bin and no lengths to check,
+and the comparison sort used on small bins compares the remaining bytes 8 at a time with big-endian word loads.\n
+Elements with equal keys may be reordered.
+
+   \tparam Width Number of bytes in each key.
+   \param[in] first Iterator pointer to first element.
+   \param[in] last Iterator pointing to one beyond the end of data.
+   \param[in] get_key Functor returning a pointer to the first key byte of an element,
+   as a pointer to @c char, @c unsigned @c char or @c signed @c char.
+
+   \pre [@c first, @c last) is a valid range.
+   \pre @c RandomAccessIter @c value_type is mutable and swappable.
+   \post The elements in the range [@c first, @c last) are sorted by key in ascending @c memcmp order.
+
+   \throws std::exception Propagates exceptions if the functor, the element swaps,
+   or any operations on iterators throw.
+
+   \warning Throwing an exception may cause data loss.
+*/
+  template <std::size_t Width, class RandomAccessIter, class Get_key>
+  inline void string_sort_fixed(RandomAccessIter first, RandomAccessIter last,
+                                Get_key get_key)
+  {
+    detail::string_sort_fixed<Width>(first, last, get_key);
+  }
+
+/*! \brief String sort for arrays of bytes, using random access iterators.
+  (Falls back to @c boost::sort::pdqsort if the data size is too small, < @c detail::min_sort_size).
+
+  \details Same as @c string_sort_fixed<N>(first, last, get_key), for a @c value_type of
+@c boost::array<Char_type, N>, or, in C++11, @c std::array<Char_type, N>, where @c Char_type is
+a byte-sized character type.
+The order is that of @c memcmp, which for @c char bytes of 0x80 and above differs from the @c operator< of
+@c std::array<char, N> where @c char is signed.
+
+   \param[in] first Iterator pointer to first element.
+   \param[in] last Iterator pointing to one beyond the end of data.
+
+   \pre [@c first, @c last) is a valid range.
+   \post The elements in the range [@c first, @c last) are sorted in ascending @c memcmp order.
+
+   \throws std::exception Propagates exceptions if the element swaps or any operations on iterators throw.
+
+   \warning Throwing an exception may cause data loss.
+*/
+  template <class RandomAccessIter>
+  inline void string_sort_fixed(RandomAccessIter first, RandomAccessIter last)
+  {
+    typedef typename std::iterator_traits<RandomAccessIter>::value_type
+      Data_type;
+    detail::string_sort_fixed<detail::fixed_string_width<Data_type>::value>
+      (first, last, detail::fixed_array_data());
+  }
+
+/*! \brief String sort for arrays of bytes, using range.
+  (Falls back to @c boost::sort::pdqsort if the data size is too small, < @c detail::min_sort_size).
+
+   \param[in] range Range [first, last) for sorting.
+
+   \pre Same as @c string_sort_fixed(first, last).
+   \post The elements in the range [@c first, @c last) are sorted in ascending @c memcmp order.
+*/
+template <class Range>
+inline void string_sort_fixed(Range& range)
+{
+  string_sort_fixed(boost::begin(range), boost::end(range));
+}
 }
 }
 }
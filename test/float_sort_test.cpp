@@ -98,6 +98,11 @@ void float_test()
   for (size_t i = 0; i < input_count; ++i) base_vec.push_back(i);
   for (size_t i = 0; i < input_count; i += 2) base_vec[i] *= -1;
   test_vector(base_vec, rightshift());
+  // Mostly one value, with an odd count
+  base_vec.clear();
+  for (size_t i = 0; i < input_count + 1; ++i)
+    base_vec.push_back(rand() % 10 ? -1.5f : float(rand_32()));
+  test_vector(base_vec, rightshift());
 }
 
 void double_test() {
@@ -133,6 +138,206 @@ void double_test() {
   test_vector(base_vec, rightshift_64());
 }
 
+// A policy with fewer, smaller radix passes than the defaults.
+struct small_tuning : default_tuning {
+  enum { max_splits = 6, max_finishing_splits = 8,
+         float_log_min_split_count = 4, min_sort_size = 10 };
+};
+
+void tuning_test()
+{
+  vector<double> base_vec;
+  for (unsigned u = 0; u < 100000; ++u)
+    base_vec.push_back(double(rand_32()) / (rand() + 1));
+  vector<double> sorted_vec = base_vec;
+  std::sort(sorted_vec.begin(), sorted_vec.end());
+  vector<double> test_vec = base_vec;
+  float_sort<small_tuning>(test_vec.begin(), test_vec.end());
+  BOOST_CHECK(test_vec == sorted_vec);
+  test_vec = base_vec;
+  float_sort<small_tuning>(test_vec.begin(), test_vec.end(), rightshift_64());
+  BOOST_CHECK(test_vec == sorted_vec);
+  test_vec = base_vec;
+  float_sort<small_tuning>(test_vec.begin(), test_vec.end(), rightshift_64(),
+                           less<double>());
+  BOOST_CHECK(test_vec == sorted_vec);
+  //Below the default min_sort_size, so only the policy makes it radix sort
+  vector<float> small_vec;
+  for (unsigned u = 0; u < 50; ++u)
+    small_vec.push_back(float(rand_32()) / (rand() + 1));
+  vector<float> small_sorted = small_vec;
+  std::sort(small_sorted.begin(), small_sorted.end());
+  float_sort<small_tuning>(small_vec.begin(), small_vec.end());
+  BOOST_CHECK(small_vec == small_sorted);
+}
+
+template<class FloatType, class Cast_type>
+void check_total_order(const vector<FloatType> &base_vec, unsigned nan_count,
+                       nan_position nans)
+{
+  vector<FloatType> test_vec = base_vec;
+  float_sort_total_order(test_vec, nans);
+  //NaNs are at the requested end, and the rest is sorted with -0.0 first
+  size_t nan_begin = nans == nans_first ? 0 : test_vec.size() - nan_count;
+  for (size_t u = 0; u < test_vec.size(); ++u) {
+    bool in_nans = u >= nan_begin && u < nan_begin + nan_count;
+    BOOST_CHECK(in_nans == (test_vec[u] != test_vec[u]));
+  }
+  vector<FloatType> numbers(test_vec.begin() + (nan_begin ? 0 : nan_count),
+                            test_vec.begin() + (nan_begin ? nan_begin
+                                                : test_vec.size()));
+  vector<FloatType> sorted_vec = numbers;
+  std::sort(sorted_vec.begin(), sorted_vec.end());
+  BOOST_CHECK(numbers == sorted_vec);
+  for (size_t u = 1; u < numbers.size(); ++u)
+    BOOST_CHECK(!(float_mem_cast<FloatType, Cast_type>(numbers[u - 1]) >= 0 &&
+                  float_mem_cast<FloatType, Cast_type>(numbers[u]) < 0));
+}
+
+struct keyed_float {
+  float key;
+  unsigned index;
+};
+
+struct keyed_float_rightshift {
+  int operator()(const keyed_float &x, const unsigned offset) const {
+    return float_mem_cast<float, int>(x.key) >> offset;
+  }
+};
+
+void stable_test()
+{
+  vector<double> base_vec;
+  for (unsigned u = 0; u < input_count / 10; ++u)
+    base_vec.push_back(double(rand_32()) / (rand() + 1));
+  vector<double> sorted_vec = base_vec;
+  std::sort(sorted_vec.begin(), sorted_vec.end());
+  vector<double> test_vec = base_vec;
+  stable_float_sort(test_vec.begin(), test_vec.end());
+  BOOST_CHECK(test_vec == sorted_vec);
+  test_vec = base_vec;
+  stable_float_sort(test_vec, rightshift_64());
+  BOOST_CHECK(test_vec == sorted_vec);
+  //Few distinct keys of both signs keep the order of their elements
+  vector<keyed_float> keyed_vec(input_count / 10);
+  for (unsigned u = 0; u < keyed_vec.size(); ++u) {
+    keyed_vec[u].key = float(rand() % 200 - 100) / 8;
+    keyed_vec[u].index = u;
+  }
+  stable_float_sort(keyed_vec.begin(), keyed_vec.end(),
+                    keyed_float_rightshift());
+  for (unsigned u = 1; u < keyed_vec.size(); ++u) {
+    BOOST_CHECK(keyed_vec[u - 1].key <= keyed_vec[u].key);
+    if (keyed_vec[u - 1].key == keyed_vec[u].key)
+      BOOST_CHECK(keyed_vec[u - 1].index < keyed_vec[u].index);
+  }
+}
+
+// NaNs, zeros of both signs and infinities, in one pass
+void total_order_test()
+{
+  const unsigned nan_count = 100;
+  vector<float> float_vec;
+  vector<double> double_vec;
+  for (unsigned u = 0; u < 20000; ++u) {
+    float_vec.push_back(float(rand_32()) / (rand() + 1));
+    double_vec.push_back(double(rand_32()) / (rand() + 1));
+  }
+  for (unsigned u = 0; u < nan_count; ++u) {
+    float nan = numeric_limits<float>::quiet_NaN();
+    float_vec[rand() % float_vec.size()] = u % 2 ? -nan : nan;
+    double dnan = numeric_limits<double>::quiet_NaN();
+    double_vec[rand() % double_vec.size()] = u % 2 ? -dnan : dnan;
+  }
+  unsigned float_nans = 0, double_nans = 0;
+  for (size_t u = 0; u < float_vec.size(); ++u) {
+    float_nans += float_vec[u] != float_vec[u];
+    double_nans += double_vec[u] != double_vec[u];
+  }
+  for (unsigned u = 0; u < 100; ++u) {
+    float_vec.push_back(u % 2 ? -0.0f : 0.0f);
+    double_vec.push_back(u % 2 ? -numeric_limits<double>::infinity() : -0.0);
+  }
+  float_vec.push_back(numeric_limits<float>::infinity());
+  check_total_order<float, boost::int32_t>(float_vec, float_nans, nans_last);
+  check_total_order<float, boost::int32_t>(float_vec, float_nans, nans_first);
+  check_total_order<double, boost::int64_t>(double_vec, double_nans,
+                                            nans_last);
+  check_total_order<double, boost::int64_t>(double_vec, double_nans,
+                                            nans_first);
+  //Below min_sort_size, with positive NaNs only
+  vector<float> small_vec(float_vec.begin(), float_vec.begin() + 50);
+  small_vec.push_back(numeric_limits<float>::quiet_NaN());
+  unsigned small_nans = 0;
+  for (size_t u = 0; u < small_vec.size(); ++u)
+    small_nans += small_vec[u] != small_vec[u];
+  check_total_order<float, boost::int32_t>(small_vec, small_nans, nans_first);
+}
+
+// One workspace reused by batches of different sizes
+void workspace_test()
+{
+  spreadsort_workspace<vector<float>::iterator> workspace;
+  for (unsigned batch = 0; batch < 4; ++batch) {
+    vector<float> base_vec;
+    for (unsigned u = 0; u < (batch % 2 ? 2000 : 100000); ++u)
+      base_vec.push_back(float(rand_32()) / (rand() + 1));
+    vector<float> sorted_vec = base_vec;
+    std::sort(sorted_vec.begin(), sorted_vec.end());
+    vector<float> test_vec = base_vec;
+    float_sort(test_vec.begin(), test_vec.end(), workspace);
+    BOOST_CHECK(test_vec == sorted_vec);
+    test_vec = base_vec;
+    float_sort(test_vec.begin(), test_vec.end(), rightshift(), workspace);
+    BOOST_CHECK(test_vec == sorted_vec);
+    test_vec = base_vec;
+    float_sort(test_vec.begin(), test_vec.end(), rightshift(),
+               less<float>(), workspace);
+    BOOST_CHECK(test_vec == sorted_vec);
+  }
+}
+
+// Selection and partial sorting, with zeros of both signs
+void select_test()
+{
+  vector<float> base_vec;
+  for (unsigned u = 0; u < input_count / 10; ++u)
+    base_vec.push_back(u % 10 ? float(rand_32()) / (rand() + 1)
+                              : (u % 20 ? 0.0f : -0.0f));
+  vector<float> sorted_vec = base_vec;
+  std::sort(sorted_vec.begin(), sorted_vec.end());
+  const size_t positions[] = { 0, 5000, 5001, 9999 };
+  for (unsigned p = 0; p < sizeof(positions) / sizeof(positions[0]); ++p) {
+    size_t nth = positions[p];
+    vector<float> test_vec = base_vec;
+    float_nth_element(test_vec.begin(), test_vec.begin() + nth,
+                      test_vec.end());
+    BOOST_CHECK(test_vec[nth] == sorted_vec[nth]);
+    for (size_t u = 0; u < test_vec.size(); ++u)
+      BOOST_CHECK(u < nth ? test_vec[u] <= test_vec[nth]
+                          : u == nth || test_vec[u] >= test_vec[nth]);
+    test_vec = base_vec;
+    float_nth_element(test_vec, test_vec.begin() + nth);
+    BOOST_CHECK(test_vec[nth] == sorted_vec[nth]);
+    test_vec = base_vec;
+    float_partial_sort(test_vec.begin(), test_vec.begin() + nth + 1,
+                       test_vec.end(), rightshift());
+    BOOST_CHECK(std::equal(test_vec.begin(), test_vec.begin() + nth + 1,
+                           sorted_vec.begin()));
+  }
+  vector<double> double_vec;
+  for (unsigned u = 0; u < input_count / 10; ++u)
+    double_vec.push_back(double(rand_32()) / (rand() + 1));
+  vector<double> double_sorted = double_vec;
+  std::sort(double_sorted.begin(), double_sorted.end());
+  float_partial_sort(double_vec, double_vec.begin() + 3000);
+  BOOST_CHECK(std::equal(double_vec.begin(), double_vec.begin() + 3000,
+                         double_sorted.begin()));
+  float_nth_element(double_vec.begin(), double_vec.begin() + 7000,
+                    double_vec.end(), rightshift_64());
+  BOOST_CHECK(double_vec[7000] == double_sorted[7000]);
+}
+
 // Verify that 0 and 1 elements work correctly.
 void corner_test() {
   vector<float> test_vec;
@@ -150,6 +355,11 @@ int test_main( int, char*[] )
   srand(1);
   float_test();
   double_test();
+  tuning_test();
+  stable_test();
+  total_order_test();
+  workspace_test();
+  select_test();
   corner_test();
   return 0;
 }
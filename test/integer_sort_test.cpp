@@ -13,6 +13,7 @@
 #include <boost/test/included/test_exec_monitor.hpp>
 #include <boost/test/test_tools.hpp>
 #include <vector>
+#include <limits>
 
 #include <iostream>
 
@@ -111,6 +112,439 @@ void int_test()
   BOOST_CHECK(long_test_vec == long_sorted_vec);
 }
 
+struct keyed_value {
+  int key;
+  unsigned index;
+};
+
+struct key_rightshift {
+  int operator()(const keyed_value &x, unsigned offset) const {
+    return x.key >> offset;
+  }
+};
+
+template<class T>
+void check_lsd(const vector<T> &base_vec)
+{
+  vector<T> sorted_vec = base_vec;
+  std::sort(sorted_vec.begin(), sorted_vec.end());
+  vector<T> test_vec = base_vec;
+  integer_sort_lsd(test_vec.begin(), test_vec.end());
+  BOOST_CHECK(test_vec == sorted_vec);
+  test_vec = base_vec;
+  integer_sort_lsd(test_vec);
+  BOOST_CHECK(test_vec == sorted_vec);
+}
+
+void lsd_test()
+{
+  vector<int> base_vec;
+  const unsigned count = 100000;
+  srand(1);
+  for (unsigned u = 0; u < count; ++u)
+    base_vec.push_back(rand_32());
+  check_lsd(base_vec);
+  vector<int> sorted_vec = base_vec;
+  std::sort(sorted_vec.begin(), sorted_vec.end());
+  //One functor
+  vector<int> test_vec = base_vec;
+  integer_sort_lsd(test_vec.begin(), test_vec.end(), rightshift());
+  BOOST_CHECK(test_vec == sorted_vec);
+  //Caller-supplied buffer, reused
+  vector<int> buffer(count);
+  for (unsigned i = 0; i < 2; ++i) {
+    test_vec = base_vec;
+    integer_sort_lsd(test_vec.begin(), test_vec.end(), rightshift(),
+                     buffer.begin());
+    BOOST_CHECK(test_vec == sorted_vec);
+  }
+  //Narrow ranges, where most or all of the passes are skipped
+  for (unsigned u = 0; u < count; ++u)
+    base_vec[u] = rand() % 256;
+  check_lsd(base_vec);
+  for (unsigned u = 0; u < count; ++u)
+    base_vec[u] = -1 - rand() % 1000;
+  check_lsd(base_vec);
+  check_lsd(vector<int>(count, -7));
+
+  vector<boost::intmax_t> long_vec;
+  vector<unsigned> unsigned_vec;
+  vector<short> short_vec;
+  vector<signed char> char_vec;
+  for (unsigned u = 0; u < count; ++u) {
+    long_vec.push_back((((boost::intmax_t)rand_32()) <<
+                        ((8 * sizeof(int)) -1)) + rand_32(false));
+    unsigned_vec.push_back(rand_32());
+    short_vec.push_back(static_cast<short>(rand_32()));
+    char_vec.push_back(static_cast<signed char>(rand_32()));
+  }
+  check_lsd(long_vec);
+  check_lsd(unsigned_vec);
+  check_lsd(short_vec);
+  check_lsd(char_vec);
+
+  //Equal keys keep their order
+  vector<keyed_value> keyed_vec(count);
+  for (unsigned u = 0; u < count; ++u) {
+    keyed_vec[u].key = rand_32() % 500;
+    keyed_vec[u].index = u;
+  }
+  integer_sort_lsd(keyed_vec.begin(), keyed_vec.end(), key_rightshift());
+  for (unsigned u = 1; u < count; ++u) {
+    BOOST_CHECK(keyed_vec[u - 1].key <= keyed_vec[u].key);
+    if (keyed_vec[u - 1].key == keyed_vec[u].key)
+      BOOST_CHECK(keyed_vec[u - 1].index < keyed_vec[u].index);
+  }
+}
+
+template<class T>
+void check_stable(const vector<T> &base_vec)
+{
+  vector<T> sorted_vec = base_vec;
+  std::sort(sorted_vec.begin(), sorted_vec.end());
+  vector<T> test_vec = base_vec;
+  stable_integer_sort(test_vec.begin(), test_vec.end());
+  BOOST_CHECK(test_vec == sorted_vec);
+  test_vec = base_vec;
+  stable_integer_sort(test_vec);
+  BOOST_CHECK(test_vec == sorted_vec);
+}
+
+void stable_test()
+{
+  vector<int> base_vec;
+  const unsigned count = 100000;
+  srand(1);
+  for (unsigned u = 0; u < count; ++u)
+    base_vec.push_back(rand_32());
+  check_stable(base_vec);
+  vector<int> sorted_vec = base_vec;
+  std::sort(sorted_vec.begin(), sorted_vec.end());
+  vector<int> test_vec = base_vec;
+  stable_integer_sort(test_vec.begin(), test_vec.end(), rightshift());
+  BOOST_CHECK(test_vec == sorted_vec);
+  for (unsigned u = 0; u < count; ++u)
+    base_vec[u] = -1 - rand() % 1000;
+  check_stable(base_vec);
+  check_stable(vector<int>(count, -7));
+  base_vec.resize(100);
+  check_stable(base_vec);
+
+  vector<boost::intmax_t> long_vec;
+  vector<unsigned> unsigned_vec;
+  vector<short> short_vec;
+  for (unsigned u = 0; u < count; ++u) {
+    long_vec.push_back((((boost::intmax_t)rand_32()) <<
+                        ((8 * sizeof(int)) -1)) + rand_32(false));
+    unsigned_vec.push_back(rand_32());
+    short_vec.push_back(static_cast<short>(rand_32()));
+  }
+  check_stable(long_vec);
+  check_stable(unsigned_vec);
+  check_stable(short_vec);
+
+  //Equal keys keep their order, both in large bins and insertion sorted ones
+  for (unsigned range = 16; range <= 1 << 20; range <<= 4) {
+    vector<keyed_value> keyed_vec(count);
+    for (unsigned u = 0; u < count; ++u) {
+      keyed_vec[u].key = rand_32() % range - range / 2;
+      keyed_vec[u].index = u;
+    }
+    stable_integer_sort(keyed_vec, key_rightshift());
+    for (unsigned u = 1; u < count; ++u) {
+      BOOST_CHECK(keyed_vec[u - 1].key <= keyed_vec[u].key);
+      if (keyed_vec[u - 1].key == keyed_vec[u].key)
+        BOOST_CHECK(keyed_vec[u - 1].index < keyed_vec[u].index);
+    }
+  }
+}
+
+// A policy with fewer, smaller radix passes than the defaults.
+struct small_tuning : default_tuning {
+  enum { max_splits = 6, max_finishing_splits = 8,
+         int_log_min_split_count = 4, min_sort_size = 10 };
+};
+
+void tuning_test()
+{
+  vector<int> base_vec;
+  srand(1);
+  for (unsigned u = 0; u < 100000; ++u)
+    base_vec.push_back(rand_32());
+  vector<int> sorted_vec = base_vec;
+  std::sort(sorted_vec.begin(), sorted_vec.end());
+  vector<int> test_vec = base_vec;
+  integer_sort<small_tuning>(test_vec.begin(), test_vec.end());
+  BOOST_CHECK(test_vec == sorted_vec);
+  test_vec = base_vec;
+  integer_sort<small_tuning>(test_vec.begin(), test_vec.end(), rightshift());
+  BOOST_CHECK(test_vec == sorted_vec);
+  test_vec = base_vec;
+  integer_sort<small_tuning>(test_vec.begin(), test_vec.end(),
+                             negrightshift(), std::greater<int>());
+  std::reverse(test_vec.begin(), test_vec.end());
+  BOOST_CHECK(test_vec == sorted_vec);
+  //Below the default min_sort_size, so only the policy makes it radix sort
+  base_vec.resize(50);
+  sorted_vec = base_vec;
+  std::sort(sorted_vec.begin(), sorted_vec.end());
+  test_vec = base_vec;
+  integer_sort<small_tuning>(test_vec.begin(), test_vec.end());
+  BOOST_CHECK(test_vec == sorted_vec);
+  //The default policy is the same as no policy
+  vector<boost::intmax_t> long_vec;
+  for (unsigned u = 0; u < 10000; ++u)
+    long_vec.push_back((static_cast<boost::intmax_t>(rand_32()) << 31) +
+                       rand_32(false));
+  vector<boost::intmax_t> long_sorted = long_vec;
+  std::sort(long_sorted.begin(), long_sorted.end());
+  integer_sort<default_tuning>(long_vec.begin(), long_vec.end(),
+                               rightshift_max());
+  BOOST_CHECK(long_vec == long_sorted);
+}
+
+// Mostly one value, with an odd count; bin sizes are counted in two halves
+void skew_test()
+{
+  vector<int> base_vec;
+  srand(1);
+  for (unsigned u = 0; u < 100001; ++u)
+    base_vec.push_back(rand() % 10 ? 12345 : rand_32());
+  vector<int> sorted_vec = base_vec;
+  std::sort(sorted_vec.begin(), sorted_vec.end());
+  vector<int> test_vec = base_vec;
+  integer_sort(test_vec.begin(), test_vec.end());
+  BOOST_CHECK(test_vec == sorted_vec);
+  test_vec = base_vec;
+  integer_sort(test_vec.begin(), test_vec.end(), rightshift());
+  BOOST_CHECK(test_vec == sorted_vec);
+}
+
+struct timestamped_id {
+  boost::uint64_t timestamp;
+  boost::uint64_t id;
+  bool operator<(const timestamped_id &y) const {
+    return timestamp < y.timestamp || (timestamp == y.timestamp && id < y.id);
+  }
+  bool operator==(const timestamped_id &y) const {
+    return timestamp == y.timestamp && id == y.id;
+  }
+};
+
+struct timestamped_id_words {
+  boost::uint64_t operator()(const timestamped_id &x, unsigned word) const {
+    return word ? x.id : x.timestamp;
+  }
+};
+
+#ifdef BOOST_HAS_INT128
+//A record sorted on its 128-bit key by a user right shift
+struct int128_record {
+  boost::int128_type key;
+  int payload;
+  bool operator<(const int128_record &y) const { return key < y.key; }
+};
+
+struct int128_record_rightshift {
+  boost::int128_type operator()(const int128_record &x, unsigned offset) const {
+    return x.key >> offset;
+  }
+};
+#endif
+
+void composite_test()
+{
+  //Few timestamps, so runs with an equal first word need the second word
+  vector<timestamped_id> base_vec;
+  srand(1);
+  for (unsigned u = 0; u < 100000; ++u) {
+    timestamped_id x;
+    x.timestamp = rand() % 100;
+    x.id = (static_cast<boost::uint64_t>(rand_32(false)) << 32) | rand_32(false);
+    base_vec.push_back(x);
+  }
+  vector<timestamped_id> sorted_vec = base_vec;
+  std::sort(sorted_vec.begin(), sorted_vec.end());
+  vector<timestamped_id> test_vec = base_vec;
+  integer_sort_composite(test_vec.begin(), test_vec.end(),
+                         timestamped_id_words(), 2);
+  BOOST_CHECK(test_vec == sorted_vec);
+  test_vec = base_vec;
+  integer_sort_composite(test_vec, timestamped_id_words(), 1);
+  for (unsigned u = 1; u < test_vec.size(); ++u)
+    BOOST_CHECK(test_vec[u - 1].timestamp <= test_vec[u].timestamp);
+#ifdef BOOST_HAS_INT128
+  vector<boost::int128_type> int128_vec;
+  for (unsigned u = 0; u < 100000; ++u)
+    int128_vec.push_back((static_cast<boost::int128_type>(rand_32()) << 64) +
+        (static_cast<boost::int128_type>(rand_32(false)) << 32) + rand_32());
+  vector<boost::int128_type> int128_sorted = int128_vec;
+  std::sort(int128_sorted.begin(), int128_sorted.end());
+  integer_sort(int128_vec.begin(), int128_vec.end());
+  BOOST_CHECK(int128_vec == int128_sorted);
+  vector<boost::uint128_type> uint128_vec;
+  for (unsigned u = 0; u < 100000; ++u)
+    uint128_vec.push_back((static_cast<boost::uint128_type>(rand_32()) << 96) +
+                          rand_32(false));
+  vector<boost::uint128_type> uint128_sorted = uint128_vec;
+  std::sort(uint128_sorted.begin(), uint128_sorted.end());
+  integer_sort(uint128_vec.begin(), uint128_vec.end());
+  BOOST_CHECK(uint128_vec == uint128_sorted);
+  //The shift and comparison versions take the same path, with their keys
+  vector<int128_record> record_vec;
+  for (unsigned u = 0; u < 100000; ++u) {
+    int128_record x = { int128_vec[(u * 7919) % int128_vec.size()],
+                        static_cast<int>(u) };
+    record_vec.push_back(x);
+  }
+  vector<int128_record> record_test = record_vec;
+  integer_sort(record_test.begin(), record_test.end(),
+               int128_record_rightshift());
+  for (unsigned u = 0; u < record_test.size(); ++u)
+    BOOST_CHECK(record_test[u].key == int128_sorted[u]);
+  record_test = record_vec;
+  integer_sort(record_test.begin(), record_test.end(),
+               int128_record_rightshift(), std::less<int128_record>());
+  for (unsigned u = 0; u < record_test.size(); ++u)
+    BOOST_CHECK(record_test[u].key == int128_sorted[u]);
+#endif
+}
+
+// One workspace reused by batches of different sizes
+void workspace_test()
+{
+  spreadsort_workspace<vector<int>::iterator> workspace;
+  srand(1);
+  for (unsigned batch = 0; batch < 4; ++batch) {
+    vector<int> base_vec;
+    for (unsigned u = 0; u < (batch % 2 ? 2000 : 100000); ++u)
+      base_vec.push_back(rand_32());
+    vector<int> sorted_vec = base_vec;
+    std::sort(sorted_vec.begin(), sorted_vec.end());
+    vector<int> test_vec = base_vec;
+    integer_sort(test_vec.begin(), test_vec.end(), workspace);
+    BOOST_CHECK(test_vec == sorted_vec);
+    test_vec = base_vec;
+    integer_sort(test_vec.begin(), test_vec.end(), rightshift(), workspace);
+    BOOST_CHECK(test_vec == sorted_vec);
+    test_vec = base_vec;
+    integer_sort(test_vec.begin(), test_vec.end(), negrightshift(),
+                 greater<int>(), workspace);
+    std::reverse(test_vec.begin(), test_vec.end());
+    BOOST_CHECK(test_vec == sorted_vec);
+  }
+  // Values in [0, 1000) are sorted by counting, whose counts the workspace
+  // keeps: after the first sort they aren't reallocated
+  const size_t *counts = 0;
+  for (unsigned batch = 0; batch < 3; ++batch) {
+    vector<int> test_vec;
+    for (unsigned u = 0; u < 10000; ++u)
+      test_vec.push_back(rand() % 1000);
+    vector<int> sorted_vec = test_vec;
+    std::sort(sorted_vec.begin(), sorted_vec.end());
+    integer_sort(test_vec.begin(), test_vec.end(), workspace);
+    BOOST_CHECK(test_vec == sorted_vec);
+    BOOST_CHECK(!workspace.counts().empty());
+    if (batch)
+      BOOST_CHECK(&workspace.counts()[0] == counts);
+    counts = &workspace.counts()[0];
+  }
+}
+
+template <class T>
+void check_nth(const vector<T> &test_vec, const vector<T> &sorted_vec,
+               size_t nth)
+{
+  BOOST_CHECK(test_vec[nth] == sorted_vec[nth]);
+  for (size_t u = 0; u < nth; ++u)
+    BOOST_CHECK(!(test_vec[nth] < test_vec[u]));
+  for (size_t u = nth + 1; u < test_vec.size(); ++u)
+    BOOST_CHECK(!(test_vec[u] < test_vec[nth]));
+}
+
+// Selection and partial sorting at the ends, in the middle, and in data
+// where most elements share the target bin
+void select_test()
+{
+  vector<int> base_vec;
+  srand(1);
+  for (unsigned u = 0; u < 100000; ++u)
+    base_vec.push_back(u % 3 ? rand_32() : 1000 + rand() % 100);
+  vector<int> sorted_vec = base_vec;
+  std::sort(sorted_vec.begin(), sorted_vec.end());
+  const size_t positions[] = { 0, 1, 999, 50000, 66000, 99999 };
+  for (unsigned p = 0; p < sizeof(positions) / sizeof(positions[0]); ++p) {
+    size_t nth = positions[p];
+    vector<int> test_vec = base_vec;
+    integer_nth_element(test_vec.begin(), test_vec.begin() + nth,
+                        test_vec.end());
+    check_nth(test_vec, sorted_vec, nth);
+    test_vec = base_vec;
+    integer_nth_element(test_vec.begin(), test_vec.begin() + nth,
+                        test_vec.end(), rightshift());
+    check_nth(test_vec, sorted_vec, nth);
+    test_vec = base_vec;
+    integer_partial_sort(test_vec.begin(), test_vec.begin() + nth + 1,
+                         test_vec.end(), rightshift());
+    BOOST_CHECK(std::equal(test_vec.begin(), test_vec.begin() + nth + 1,
+                           sorted_vec.begin()));
+    test_vec = base_vec;
+    integer_partial_sort(test_vec.begin(), test_vec.begin() + nth + 1,
+                         test_vec.end(), negrightshift(), greater<int>());
+    BOOST_CHECK(std::equal(test_vec.begin(), test_vec.begin() + nth + 1,
+                           sorted_vec.rbegin()));
+  }
+  vector<int> test_vec = base_vec;
+  integer_nth_element(test_vec, test_vec.begin() + 500);
+  check_nth(test_vec, sorted_vec, 500);
+  test_vec = base_vec;
+  integer_partial_sort(test_vec, test_vec.end());
+  BOOST_CHECK(test_vec == sorted_vec);
+  test_vec = base_vec;
+  integer_nth_element(test_vec.begin(), test_vec.end(), test_vec.end());
+  BOOST_CHECK(test_vec == base_vec);
+  //Too few to radix sort
+  test_vec.assign(base_vec.begin(), base_vec.begin() + 100);
+  sorted_vec = test_vec;
+  std::sort(sorted_vec.begin(), sorted_vec.end());
+  integer_partial_sort(test_vec.begin(), test_vec.begin() + 10,
+                       test_vec.end());
+  BOOST_CHECK(std::equal(test_vec.begin(), test_vec.begin() + 10,
+                         sorted_vec.begin()));
+}
+
+template <class T>
+void check_counting(const vector<T> &base_vec)
+{
+  vector<T> sorted_vec = base_vec;
+  std::sort(sorted_vec.begin(), sorted_vec.end());
+  vector<T> test_vec = base_vec;
+  integer_sort(test_vec.begin(), test_vec.end());
+  BOOST_CHECK(test_vec == sorted_vec);
+}
+
+// Ranges small enough to be sorted by counting, at the ends of their types
+void counting_test()
+{
+  srand(1);
+  vector<int> int_vec;
+  for (unsigned u = 0; u < 100000; ++u)
+    int_vec.push_back((std::numeric_limits<int>::min)() + rand() % 300);
+  check_counting(int_vec);
+  for (unsigned u = 0; u < int_vec.size(); ++u)
+    int_vec[u] = rand() % 60000 - 30000;
+  check_counting(int_vec);
+  vector<signed char> char_vec;
+  for (unsigned u = 0; u < 5000; ++u)
+    char_vec.push_back(static_cast<signed char>(rand()));
+  check_counting(char_vec);
+  vector<boost::uint64_t> uint64_vec;
+  for (unsigned u = 0; u < 5000; ++u)
+    uint64_vec.push_back((std::numeric_limits<boost::uint64_t>::max)() -
+                         rand() % 4999);
+  check_counting(uint64_vec);
+}
+
 // Verify that 0 and 1 elements work correctly.
 void corner_test() {
   vector<int> test_vec;
@@ -126,6 +560,14 @@ void corner_test() {
 int test_main( int, char*[] )
 {
   int_test();
+  lsd_test();
+  stable_test();
+  tuning_test();
+  skew_test();
+  composite_test();
+  workspace_test();
+  select_test();
+  counting_test();
   corner_test();    
   return 0;
 }
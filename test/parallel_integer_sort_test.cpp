@@ -0,0 +1,175 @@
+//  Boost Sort library parallel_integer_sort_test.cpp file  ------------------//
+
+//  Copyright Steven Ross 2009-2014. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+//  See http://www.boost.org/libs/sort for library home page.
+
+#include <boost/cstdint.hpp>
+#include <boost/sort/spreadsort/parallel_integer_sort.hpp>
+// Include unit test framework
+#include <boost/test/included/test_exec_monitor.hpp>
+#include <boost/test/test_tools.hpp>
+#include <algorithm>
+#include <functional>
+#include <vector>
+#include <limits>
+
+
+using namespace std;
+using namespace boost::sort::spreadsort;
+
+struct rightshift {
+  int operator()(int x, unsigned offset) { return x >> offset; }
+};
+
+struct rightshift_max {
+  boost::intmax_t operator()(const boost::intmax_t &x, unsigned offset) {
+    return x >> offset;
+  }
+};
+
+struct negrightshift {
+  int operator()(const int &x, const unsigned offset) { return -(x >> offset); }
+};
+
+boost::int32_t
+rand_32(bool sign = true) {
+   boost::int32_t result = rand() | (rand()<< 16);
+   if (rand() % 2)
+     result |= 1 << 15;
+   //Adding the sign bit
+   if (sign && (rand() % 2))
+     result *= -1;
+   return result;
+}
+
+// Sorts base_vec with every thread count and checks the result.
+void check_all_threads(const vector<int> &base_vec)
+{
+  vector<int> sorted_vec = base_vec;
+  std::sort(sorted_vec.begin(), sorted_vec.end());
+  const unsigned thread_counts[] = { 1, 2, 3, 4, 8 };
+  for (unsigned i = 0; i < sizeof(thread_counts) / sizeof(unsigned); ++i) {
+    vector<int> test_vec = base_vec;
+    parallel_integer_sort(test_vec.begin(), test_vec.end(), thread_counts[i]);
+    BOOST_CHECK(test_vec == sorted_vec);
+  }
+}
+
+void int_test()
+{
+  // Prepare inputs
+  vector<int> base_vec;
+  unsigned count = 200000;
+  srand(1);
+  //Generating semirandom numbers
+  for (unsigned u = 0; u < count; ++u)
+    base_vec.push_back(rand_32());
+  vector<int> sorted_vec = base_vec;
+  vector<int> test_vec = base_vec;
+  std::sort(sorted_vec.begin(), sorted_vec.end());
+  //Testing basic call
+  parallel_integer_sort(test_vec.begin(), test_vec.end());
+  BOOST_CHECK(test_vec == sorted_vec);
+  check_all_threads(base_vec);
+  //One functor
+  test_vec = base_vec;
+  parallel_integer_sort(test_vec.begin(), test_vec.end(), rightshift());
+  BOOST_CHECK(test_vec == sorted_vec);
+  test_vec = base_vec;
+  parallel_integer_sort(test_vec.begin(), test_vec.end(), rightshift(), 3);
+  BOOST_CHECK(test_vec == sorted_vec);
+  //Both functors
+  test_vec = base_vec;
+  parallel_integer_sort(test_vec.begin(), test_vec.end(), rightshift(),
+                        less<int>());
+  BOOST_CHECK(test_vec == sorted_vec);
+  test_vec = base_vec;
+  parallel_integer_sort(test_vec.begin(), test_vec.end(), rightshift(),
+                        less<int>(), 4);
+  BOOST_CHECK(test_vec == sorted_vec);
+  //reverse order
+  std::sort(sorted_vec.begin(), sorted_vec.end(), greater<int>());
+  test_vec = base_vec;
+  parallel_integer_sort(test_vec.begin(), test_vec.end(), negrightshift(),
+                        greater<int>(), 4);
+  BOOST_CHECK(test_vec == sorted_vec);
+
+  //Making sure we're correctly sorting boost::intmax_ts
+  vector<boost::intmax_t> long_base_vec;
+  for (unsigned u = 0; u < base_vec.size(); ++u)
+    long_base_vec.push_back((((boost::intmax_t)rand_32()) <<
+                             ((8 * sizeof(int)) -1)) + rand_32(false));
+  vector<boost::intmax_t> long_sorted_vec = long_base_vec;
+  vector<boost::intmax_t> long_test_vec = long_base_vec;
+  parallel_integer_sort(long_test_vec.begin(), long_test_vec.end(), 4);
+  std::sort(long_sorted_vec.begin(), long_sorted_vec.end());
+  BOOST_CHECK(long_test_vec == long_sorted_vec);
+  long_test_vec = long_base_vec;
+  parallel_integer_sort(long_test_vec.begin(), long_test_vec.end(),
+                        rightshift_max(), less<boost::intmax_t>(), 3);
+  BOOST_CHECK(long_test_vec == long_sorted_vec);
+}
+
+// Distributions that stress the parallel distribution and bin scheduling.
+void distribution_test()
+{
+  const unsigned count = 300000;
+  srand(2);
+  vector<int> base_vec;
+  //Already sorted, reverse sorted, and sorted but for one element
+  for (unsigned u = 0; u < count; ++u)
+    base_vec.push_back(int(u) - int(count / 2));
+  check_all_threads(base_vec);
+  std::reverse(base_vec.begin(), base_vec.end());
+  check_all_threads(base_vec);
+  std::reverse(base_vec.begin(), base_vec.end());
+  std::swap(base_vec[count / 3], base_vec[count - 1]);
+  check_all_threads(base_vec);
+  //All equal
+  base_vec.assign(count, 42);
+  check_all_threads(base_vec);
+  //Few distinct values, so the first pass finishes the sort
+  for (unsigned u = 0; u < count; ++u)
+    base_vec[u] = rand() % 16;
+  check_all_threads(base_vec);
+  //Few distinct values of both signs, and at the top of the range, so
+  //they are counted rather than binned
+  for (unsigned u = 0; u < count; ++u)
+    base_vec[u] = rand() % 600 - 300;
+  check_all_threads(base_vec);
+  for (unsigned u = 0; u < count; ++u)
+    base_vec[u] = (std::numeric_limits<int>::max)() - rand() % 5000;
+  check_all_threads(base_vec);
+  //Heavily skewed, so one bin holds most of the data
+  for (unsigned u = 0; u < count; ++u)
+    base_vec[u] = (rand() % 10) ? (rand() % 1000) : rand_32();
+  check_all_threads(base_vec);
+  //Just large enough to use more than one thread
+  base_vec.resize(2 * boost::sort::spreadsort::detail::parallel_min_thread_size
+                  + 1);
+  check_all_threads(base_vec);
+}
+
+// Verify that 0 and 1 elements work correctly.
+void corner_test() {
+  vector<int> test_vec;
+  parallel_integer_sort(test_vec.begin(), test_vec.end());
+  const int test_value = 42;
+  test_vec.push_back(test_value);
+  parallel_integer_sort(test_vec.begin(), test_vec.end(), 4);
+  BOOST_CHECK(test_vec.size() == 1);
+  BOOST_CHECK(test_vec[0] == test_value);
+}
+
+// test main
+int test_main( int, char*[] )
+{
+  int_test();
+  distribution_test();
+  corner_test();
+  return 0;
+}
@@ -0,0 +1,169 @@
+//  Boost Sort library parallel_string_sample_sort_test.cpp file  ------------//
+
+//  Copyright Steven Ross 2009. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+//  See http://www.boost.org/libs/sort for library home page.
+
+#include <boost/sort/spreadsort/parallel_string_sample_sort.hpp>
+// Include unit test framework
+#include <boost/test/included/test_exec_monitor.hpp>
+#include <boost/test/test_tools.hpp>
+#include <algorithm>
+#include <vector>
+#include <string>
+
+
+using namespace std;
+using namespace boost::sort::spreadsort;
+
+struct bracket {
+  unsigned char operator()(const string &x, size_t offset) const {
+    return x[offset];
+  }
+};
+
+struct get_size {
+  size_t operator()(const string &x) const{ return x.size(); }
+};
+
+struct wbracket {
+  wchar_t operator()(const wstring &x, size_t offset) const {
+    return x[offset];
+  }
+};
+
+struct wget_size {
+  size_t operator()(const wstring &x) const{ return x.size(); }
+};
+
+static const unsigned input_count = 100000;
+
+// Sorts base_vec with every thread count and checks the result.
+void check_all_threads(const vector<string> &base_vec)
+{
+  vector<string> sorted_vec = base_vec;
+  std::sort(sorted_vec.begin(), sorted_vec.end());
+  const unsigned thread_counts[] = { 1, 2, 3, 4, 8 };
+  for (unsigned i = 0; i < sizeof(thread_counts) / sizeof(unsigned); ++i) {
+    vector<string> test_vec = base_vec;
+    parallel_string_sample_sort(test_vec.begin(), test_vec.end(),
+                                thread_counts[i]);
+    BOOST_CHECK(test_vec == sorted_vec);
+    test_vec = base_vec;
+    parallel_string_sample_sort(test_vec.begin(), test_vec.end(), bracket(),
+                                get_size(), thread_counts[i]);
+    BOOST_CHECK(test_vec == sorted_vec);
+  }
+}
+
+void string_test()
+{
+  vector<string> base_vec;
+  const unsigned max_length = 32;
+  srand(1);
+  for (unsigned u = 0; u < input_count; ++u) {
+    unsigned length = rand() % max_length;
+    string result;
+    for (unsigned v = 0; v < length; ++v)
+      result.push_back(rand() % 256);
+    base_vec.push_back(result);
+  }
+  vector<string> sorted_vec = base_vec;
+  std::sort(sorted_vec.begin(), sorted_vec.end());
+  vector<string> test_vec = base_vec;
+  parallel_string_sample_sort(test_vec.begin(), test_vec.end());
+  BOOST_CHECK(test_vec == sorted_vec);
+  test_vec = base_vec;
+  parallel_string_sample_sort(test_vec.begin(), test_vec.end(), bracket(),
+                              get_size());
+  BOOST_CHECK(test_vec == sorted_vec);
+  test_vec = base_vec;
+  parallel_string_sample_sort(test_vec.begin(), test_vec.end(),
+                              (unsigned char)0, 3);
+  BOOST_CHECK(test_vec == sorted_vec);
+  check_all_threads(base_vec);
+}
+
+// Long shared prefixes, where the splitters share most of their characters,
+// and many duplicates, which fill the buckets of strings equal to a splitter.
+void prefix_test()
+{
+  vector<string> base_vec;
+  srand(2);
+  const char *hosts[] = { "http://www.example.com/catalog/items/",
+                          "https://static.example.org/assets/images/",
+                          "http://www.example.com/catalog/index/" };
+  for (unsigned u = 0; u < input_count; ++u) {
+    string result = hosts[rand() % 3];
+    unsigned length = rand() % 12;
+    for (unsigned v = 0; v < length; ++v)
+      result.push_back('a' + rand() % 3);
+    base_vec.push_back(result);
+  }
+  check_all_threads(base_vec);
+  //Few distinct strings, so most are equal to a splitter
+  for (unsigned u = 0; u < input_count; ++u)
+    base_vec[u] = hosts[rand() % 3] + string(rand() % 4, 'z');
+  check_all_threads(base_vec);
+  //Mixed empties and strings that are prefixes of each other
+  for (unsigned u = 0; u < input_count; ++u) {
+    if (!(rand() % 20))
+      base_vec[u].clear();
+    else
+      base_vec[u] = string(hosts[0]).substr(0, rand() % 38);
+  }
+  check_all_threads(base_vec);
+  //All identical
+  base_vec.assign(input_count, hosts[1]);
+  check_all_threads(base_vec);
+}
+
+// Characters too wide for string_sort use block_indirect_sort instead.
+void wstring_test()
+{
+  vector<wstring> base_vec;
+  srand(3);
+  for (unsigned u = 0; u < input_count; ++u) {
+    wstring result(rand() % 8, L'a');
+    for (unsigned v = 0; v < result.size(); ++v)
+      result[v] = wchar_t(rand() % 0x20000);
+    base_vec.push_back(result);
+  }
+  vector<wstring> sorted_vec = base_vec;
+  std::sort(sorted_vec.begin(), sorted_vec.end());
+  vector<wstring> test_vec = base_vec;
+  parallel_string_sample_sort(test_vec.begin(), test_vec.end(), wbracket(),
+                              wget_size(), 4);
+  BOOST_CHECK(test_vec == sorted_vec);
+}
+
+// Verify that 0, 1, and input_count empty strings all sort correctly.
+void corner_test() {
+  vector<string> test_vec;
+  parallel_string_sample_sort(test_vec.begin(), test_vec.end());
+  test_vec.resize(1);
+  parallel_string_sample_sort(test_vec.begin(), test_vec.end(), 4);
+  BOOST_CHECK(test_vec[0].empty());
+  test_vec.resize(input_count);
+  parallel_string_sample_sort(test_vec.begin(), test_vec.end(), 4);
+  BOOST_CHECK(test_vec.size() == input_count);
+  for (unsigned i = 0; i < test_vec.size(); ++i) {
+    BOOST_CHECK(test_vec[i].empty());
+  }
+  parallel_string_sample_sort(test_vec.begin(), test_vec.end(), bracket(),
+                              get_size(), 4);
+  BOOST_CHECK(test_vec.size() == input_count);
+}
+
+// test main
+int test_main( int, char*[] )
+{
+  string_test();
+  prefix_test();
+  wstring_test();
+  corner_test();
+  return 0;
+}
@@ -0,0 +1,150 @@
+//  Boost Sort library parallel_string_sort_test.cpp file  -------------------//
+
+//  Copyright Steven Ross 2009. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+//  See http://www.boost.org/libs/sort for library home page.
+
+#include <boost/sort/spreadsort/parallel_string_sort.hpp>
+// Include unit test framework
+#include <boost/test/included/test_exec_monitor.hpp>
+#include <boost/test/test_tools.hpp>
+#include <algorithm>
+#include <functional>
+#include <vector>
+#include <string>
+
+
+using namespace std;
+using namespace boost::sort::spreadsort;
+
+struct bracket {
+  unsigned char operator()(const string &x, size_t offset) const {
+    return x[offset];
+  }
+};
+
+struct get_size {
+  size_t operator()(const string &x) const{ return x.size(); }
+};
+
+static const unsigned input_count = 100000;
+
+// Sorts base_vec with every thread count and checks the result.
+void check_all_threads(const vector<string> &base_vec)
+{
+  vector<string> sorted_vec = base_vec;
+  std::sort(sorted_vec.begin(), sorted_vec.end());
+  const unsigned thread_counts[] = { 1, 2, 3, 4, 8 };
+  for (unsigned i = 0; i < sizeof(thread_counts) / sizeof(unsigned); ++i) {
+    vector<string> test_vec = base_vec;
+    parallel_string_sort(test_vec.begin(), test_vec.end(), thread_counts[i]);
+    BOOST_CHECK(test_vec == sorted_vec);
+  }
+}
+
+void string_test()
+{
+  // Prepare inputs
+  vector<string> base_vec;
+  const unsigned max_length = 32;
+  srand(1);
+  //Generating semirandom numbers
+  for (unsigned u = 0; u < input_count; ++u) {
+    unsigned length = rand() % max_length;
+    string result;
+    for (unsigned v = 0; v < length; ++v) {
+      result.push_back(rand() % 256);
+    }
+    base_vec.push_back(result);
+  }
+  vector<string> sorted_vec = base_vec;
+  vector<string> test_vec = base_vec;
+  std::sort(sorted_vec.begin(), sorted_vec.end());
+  //Testing basic call
+  parallel_string_sort(test_vec.begin(), test_vec.end());
+  BOOST_CHECK(test_vec == sorted_vec);
+  check_all_threads(base_vec);
+  //Explicit character type
+  test_vec = base_vec;
+  parallel_string_sort(test_vec.begin(), test_vec.end(), (unsigned char)0, 3);
+  BOOST_CHECK(test_vec == sorted_vec);
+  //Character functors
+  test_vec = base_vec;
+  parallel_string_sort(test_vec.begin(), test_vec.end(), bracket(),
+                       get_size());
+  BOOST_CHECK(test_vec == sorted_vec);
+  test_vec = base_vec;
+  parallel_string_sort(test_vec.begin(), test_vec.end(), bracket(),
+                       get_size(), 4);
+  BOOST_CHECK(test_vec == sorted_vec);
+  //All functors
+  test_vec = base_vec;
+  parallel_string_sort(test_vec.begin(), test_vec.end(), bracket(),
+                       get_size(), less<string>());
+  BOOST_CHECK(test_vec == sorted_vec);
+  test_vec = base_vec;
+  parallel_string_sort(test_vec.begin(), test_vec.end(), bracket(),
+                       get_size(), less<string>(), 4);
+  BOOST_CHECK(test_vec == sorted_vec);
+}
+
+// Inputs where the parallel common prefix search and bin splitting matter.
+void prefix_test()
+{
+  vector<string> base_vec;
+  srand(2);
+  //A long common prefix, with the first difference at a varying position
+  const string prefix(100, 'x');
+  for (unsigned u = 0; u < input_count; ++u) {
+    string result = prefix;
+    unsigned length = rand() % 8;
+    for (unsigned v = 0; v < length; ++v)
+      result.push_back('a' + rand() % 4);
+    base_vec.push_back(result);
+  }
+  check_all_threads(base_vec);
+  //The prefix differs only in one late chunk
+  base_vec[input_count - 10][50] = 'w';
+  check_all_threads(base_vec);
+  //Mixed empties, shared prefixes, and one dominant first character
+  for (unsigned u = 0; u < input_count; ++u) {
+    if (!(rand() % 20))
+      base_vec[u].clear();
+    else if (rand() % 4)
+      base_vec[u] = "http://" + base_vec[u].substr(95);
+  }
+  check_all_threads(base_vec);
+  //All identical
+  base_vec.assign(input_count, prefix);
+  check_all_threads(base_vec);
+}
+
+// Verify that 0, 1, and input_count empty strings all sort correctly.
+void corner_test() {
+  vector<string> test_vec;
+  parallel_string_sort(test_vec.begin(), test_vec.end());
+  test_vec.resize(1);
+  parallel_string_sort(test_vec.begin(), test_vec.end(), 4);
+  BOOST_CHECK(test_vec[0].empty());
+  test_vec.resize(input_count);
+  parallel_string_sort(test_vec.begin(), test_vec.end(), 4);
+  BOOST_CHECK(test_vec.size() == input_count);
+  for (unsigned i = 0; i < test_vec.size(); ++i) {
+    BOOST_CHECK(test_vec[i].empty());
+  }
+  parallel_string_sort(test_vec.begin(), test_vec.end(), bracket(),
+                       get_size(), 4);
+  BOOST_CHECK(test_vec.size() == input_count);
+}
+
+// test main
+int test_main( int, char*[] )
+{
+  string_test();
+  prefix_test();
+  corner_test();
+  return 0;
+}
@@ -0,0 +1,258 @@
+//  Boost Sort library sort_by_key_test.cpp file  ----------------------------//
+
+//  Copyright Steven Ross 2009-2014. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+//  See http://www.boost.org/libs/sort for library home page.
+
+#include <boost/cstdint.hpp>
+#include <boost/sort/spreadsort/sort_by_key.hpp>
+// Include unit test framework
+#include <boost/test/included/test_exec_monitor.hpp>
+#include <boost/test/test_tools.hpp>
+#include <algorithm>
+#include <functional>
+#include <vector>
+#include <string>
+
+
+using namespace std;
+using namespace boost::sort::spreadsort;
+
+struct negrightshift {
+  int operator()(const int &x, const unsigned offset) { return -(x >> offset); }
+};
+
+struct rightshift_float {
+  int operator()(const float &x, const unsigned offset) const {
+    return float_mem_cast<float, int>(x) >> offset;
+  }
+};
+
+struct bracket {
+  unsigned char operator()(const string &x, size_t offset) const {
+    return x[offset];
+  }
+};
+
+struct get_size {
+  size_t operator()(const string &x) const{ return x.size(); }
+};
+
+boost::int32_t
+rand_32(bool sign = true) {
+   boost::int32_t result = rand() | (rand()<< 16);
+   if (rand() % 2)
+     result |= 1 << 15;
+   //Adding the sign bit
+   if (sign && (rand() % 2))
+     result *= -1;
+   return result;
+}
+
+static const unsigned input_count = 100000;
+
+// The values are the original positions of the keys, so each must point
+// back to an original key equal to the one now beside it.
+template<class Key>
+void check_by_key(const vector<Key> &base_keys, const vector<Key> &keys,
+                  const vector<unsigned> &values, const vector<Key> &sorted)
+{
+  BOOST_CHECK(keys == sorted);
+  BOOST_CHECK(values.size() == keys.size());
+  vector<bool> seen(keys.size(), false);
+  for (unsigned u = 0; u < values.size(); ++u) {
+    BOOST_CHECK(values[u] < base_keys.size() && !seen[values[u]]);
+    seen[values[u]] = true;
+    BOOST_CHECK(base_keys[values[u]] == keys[u]);
+  }
+}
+
+vector<unsigned> positions(size_t count)
+{
+  vector<unsigned> values(count);
+  for (unsigned u = 0; u < count; ++u)
+    values[u] = u;
+  return values;
+}
+
+void integer_test()
+{
+  vector<int> base_keys;
+  for (unsigned u = 0; u < input_count; ++u)
+    base_keys.push_back(rand_32());
+  vector<int> sorted = base_keys;
+  std::sort(sorted.begin(), sorted.end());
+  vector<int> keys = base_keys;
+  vector<unsigned> values = positions(input_count);
+  integer_sort_by_key(keys.begin(), keys.end(), values.begin());
+  check_by_key(base_keys, keys, values, sorted);
+  //Reverse order with both functors
+  std::sort(sorted.begin(), sorted.end(), greater<int>());
+  keys = base_keys;
+  values = positions(input_count);
+  integer_sort_by_key(keys.begin(), keys.end(), values.begin(),
+                      negrightshift(), greater<int>());
+  check_by_key(base_keys, keys, values, sorted);
+  //Many duplicates, whose values keep their order, and a small input
+  for (unsigned u = 0; u < input_count; ++u)
+    base_keys[u] = rand() % 100 - 50;
+  sorted = base_keys;
+  std::sort(sorted.begin(), sorted.end());
+  keys = base_keys;
+  values = positions(input_count);
+  integer_sort_by_key(keys.begin(), keys.end(), values.begin());
+  check_by_key(base_keys, keys, values, sorted);
+  for (unsigned u = 1; u < input_count; ++u) {
+    if (keys[u - 1] == keys[u])
+      BOOST_CHECK(values[u - 1] < values[u]);
+  }
+  base_keys.resize(10);
+  sorted = base_keys;
+  std::sort(sorted.begin(), sorted.end());
+  keys = base_keys;
+  values = positions(10);
+  integer_sort_by_key(keys.begin(), keys.end(), values.begin());
+  check_by_key(base_keys, keys, values, sorted);
+
+  vector<boost::int64_t> long_base_keys;
+  for (unsigned u = 0; u < input_count; ++u)
+    long_base_keys.push_back((((boost::int64_t)rand_32()) <<
+                              ((8 * sizeof(int)) -1)) + rand_32(false));
+  vector<boost::int64_t> long_sorted = long_base_keys;
+  std::sort(long_sorted.begin(), long_sorted.end());
+  vector<boost::int64_t> long_keys = long_base_keys;
+  values = positions(input_count);
+  integer_sort_by_key(long_keys.begin(), long_keys.end(), values.begin());
+  check_by_key(long_base_keys, long_keys, values, long_sorted);
+}
+
+void float_test()
+{
+  vector<float> base_keys;
+  for (unsigned u = 0; u < input_count; ++u) {
+    float val = float(rand_32());
+    //As std::sort gives arbitrary results for NaNs and 0.0 vs. -0.0, treat all
+    //those as just 0.0 for testing
+    if (!(val < 0.0) && !(0.0 < val))
+      base_keys.push_back(0.0);
+    else
+      base_keys.push_back(val);
+  }
+  vector<float> sorted = base_keys;
+  std::sort(sorted.begin(), sorted.end());
+  vector<float> keys = base_keys;
+  vector<unsigned> values = positions(input_count);
+  float_sort_by_key(keys.begin(), keys.end(), values.begin());
+  check_by_key(base_keys, keys, values, sorted);
+  keys = base_keys;
+  values = positions(input_count);
+  float_sort_by_key(keys.begin(), keys.end(), values.begin(),
+                    rightshift_float(), less<float>());
+  check_by_key(base_keys, keys, values, sorted);
+
+  vector<double> double_base_keys;
+  for (unsigned u = 0; u < input_count; ++u)
+    double_base_keys.push_back(double(rand_32()) * rand_32() + 0.5);
+  vector<double> double_sorted = double_base_keys;
+  std::sort(double_sorted.begin(), double_sorted.end());
+  vector<double> double_keys = double_base_keys;
+  values = positions(input_count);
+  float_sort_by_key(double_keys.begin(), double_keys.end(), values.begin());
+  check_by_key(double_base_keys, double_keys, values, double_sorted);
+}
+
+void string_test()
+{
+  vector<string> base_keys;
+  const unsigned max_length = 32;
+  for (unsigned u = 0; u < input_count; ++u) {
+    unsigned length = rand() % max_length;
+    string result;
+    for (unsigned v = 0; v < length; ++v)
+      result.push_back(rand() % 256);
+    base_keys.push_back(result);
+  }
+  vector<string> sorted = base_keys;
+  std::sort(sorted.begin(), sorted.end());
+  vector<string> keys = base_keys;
+  vector<unsigned> values = positions(input_count);
+  string_sort_by_key(keys.begin(), keys.end(), values.begin());
+  check_by_key(base_keys, keys, values, sorted);
+  keys = base_keys;
+  values = positions(input_count);
+  string_sort_by_key(keys.begin(), keys.end(), values.begin(), bracket(),
+                     get_size(), less<string>());
+  check_by_key(base_keys, keys, values, sorted);
+  //All empty
+  keys.assign(input_count, string());
+  values = positions(input_count);
+  string_sort_by_key(keys.begin(), keys.end(), values.begin(), bracket(),
+                     get_size(), less<string>());
+  BOOST_CHECK(values == positions(input_count));
+}
+
+// Two value arrays sorted together.
+void two_values_test()
+{
+  vector<int> base_keys;
+  for (unsigned u = 0; u < input_count; ++u)
+    base_keys.push_back(rand_32());
+  vector<int> sorted = base_keys;
+  std::sort(sorted.begin(), sorted.end());
+  vector<int> keys = base_keys;
+  vector<unsigned> values = positions(input_count);
+  vector<double> doubled(input_count);
+  for (unsigned u = 0; u < input_count; ++u)
+    doubled[u] = 2.0 * keys[u];
+  integer_sort_by_key(keys.begin(), keys.end(), values.begin(),
+                      doubled.begin());
+  check_by_key(base_keys, keys, values, sorted);
+  for (unsigned u = 0; u < input_count; ++u)
+    BOOST_CHECK(doubled[u] == 2.0 * keys[u]);
+
+  vector<string> string_keys;
+  for (unsigned u = 0; u < input_count; ++u)
+    string_keys.push_back(string(rand() % 8, char('a' + rand() % 26)));
+  vector<string> base_string_keys = string_keys;
+  vector<string> string_sorted = string_keys;
+  std::sort(string_sorted.begin(), string_sorted.end());
+  vector<size_t> lengths(input_count);
+  for (unsigned u = 0; u < input_count; ++u)
+    lengths[u] = string_keys[u].size();
+  values = positions(input_count);
+  string_sort_by_key(string_keys.begin(), string_keys.end(), values.begin(),
+                     lengths.begin());
+  check_by_key(base_string_keys, string_keys, values, string_sorted);
+  for (unsigned u = 0; u < input_count; ++u)
+    BOOST_CHECK(lengths[u] == string_keys[u].size());
+}
+
+// Verify that 0 and 1 elements work correctly.
+void corner_test() {
+  vector<int> keys;
+  vector<unsigned> values;
+  integer_sort_by_key(keys.begin(), keys.end(), values.begin());
+  integer_sort_by_key(keys.begin(), keys.end(), values.begin(),
+                      negrightshift(), greater<int>());
+  keys.push_back(42);
+  values.push_back(7);
+  integer_sort_by_key(keys.begin(), keys.end(), values.begin());
+  BOOST_CHECK(keys[0] == 42 && values[0] == 7);
+  vector<string> string_keys;
+  string_sort_by_key(string_keys.begin(), string_keys.end(), values.begin());
+}
+
+// test main
+int test_main( int, char*[] )
+{
+  srand(1);
+  integer_test();
+  float_test();
+  string_test();
+  two_values_test();
+  corner_test();
+  return 0;
+}
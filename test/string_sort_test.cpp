@@ -13,8 +13,10 @@
 // Include unit test framework
 #include <boost/test/included/test_exec_monitor.hpp>
 #include <boost/test/test_tools.hpp>
+#include <boost/array.hpp>
 #include <vector>
 #include <string>
+#include <cstring>
 
 
 using namespace std;
@@ -136,6 +138,206 @@ void string_test()
   BOOST_CHECK(test_vec == sorted_vec);  
 }
 
+// string_sort_cached, on inputs where the prefix refills and the strings
+// ending within a prefix matter.
+void cached_test()
+{
+  vector<string> base_vec;
+  srand(3);
+  //Random bytes, including 0, so padding has to be told from real zeros
+  for (unsigned u = 0; u < input_count; ++u) {
+    string result;
+    unsigned length = rand() % 20;
+    for (unsigned v = 0; v < length; ++v)
+      result.push_back(rand() % 4);
+    base_vec.push_back(result);
+  }
+  //Long shared prefixes, like URLs
+  const string prefixes[] = { "http://www.example.com/",
+                              "https://www.example.com/path/to/",
+                              "http://www.example.com/path/" };
+  for (unsigned u = 0; u < input_count; ++u) {
+    string result = prefixes[rand() % 3];
+    unsigned length = rand() % 12;
+    for (unsigned v = 0; v < length; ++v)
+      result.push_back('a' + rand() % 3);
+    base_vec.push_back(result);
+  }
+  vector<string> sorted_vec = base_vec;
+  std::sort(sorted_vec.begin(), sorted_vec.end());
+  vector<string> test_vec = base_vec;
+  string_sort_cached(test_vec.begin(), test_vec.end());
+  BOOST_CHECK(test_vec == sorted_vec);
+  test_vec = base_vec;
+  string_sort_cached(test_vec);
+  BOOST_CHECK(test_vec == sorted_vec);
+  test_vec = base_vec;
+  string_sort_cached(test_vec.begin(), test_vec.end(), bracket(), get_size());
+  BOOST_CHECK(test_vec == sorted_vec);
+
+  //Wide characters, 2 to a prefix
+  vector<wstring> wbase_vec;
+  for (unsigned u = 0; u < input_count; ++u) {
+    wstring result;
+    unsigned length = rand() % 10;
+    for (unsigned v = 0; v < length; ++v)
+      result.push_back(rand() % 3 ? L'a' : wchar_t(0x10000 + rand() % 3));
+    wbase_vec.push_back(result);
+  }
+  vector<wstring> wsorted_vec = wbase_vec;
+  std::sort(wsorted_vec.begin(), wsorted_vec.end());
+  string_sort_cached(wbase_vec.begin(), wbase_vec.end(), wbracket(),
+                     wget_size());
+  BOOST_CHECK(wbase_vec == wsorted_vec);
+
+  //All identical, and all empty
+  test_vec.assign(input_count, prefixes[1]);
+  string_sort_cached(test_vec.begin(), test_vec.end());
+  BOOST_CHECK(test_vec == vector<string>(input_count, prefixes[1]));
+  test_vec.assign(input_count, string());
+  string_sort_cached(test_vec.begin(), test_vec.end(), bracket(), get_size());
+  BOOST_CHECK(test_vec == vector<string>(input_count, string()));
+
+  //Shared prefixes far longer than the stack could take one frame per
+  //prefix for: two identical strings, and two that differ at the end
+  const string long_string(2000000, 'x');
+  test_vec.clear();
+  for (unsigned u = 0; u < 1998; ++u)
+    test_vec.push_back(string(rand() % 4, 'x' - 1 + rand() % 3));
+  test_vec.push_back(long_string);
+  test_vec.push_back(long_string + 'b');
+  test_vec.push_back(long_string);
+  test_vec.push_back(long_string + 'a');
+  sorted_vec = test_vec;
+  std::sort(sorted_vec.begin(), sorted_vec.end());
+  string_sort_cached(test_vec.begin(), test_vec.end());
+  BOOST_CHECK(test_vec == sorted_vec);
+}
+
+struct small_tuning : default_tuning {
+  enum { min_sort_size = 10 };
+};
+
+void tuning_test()
+{
+  vector<string> base_vec;
+  srand(1);
+  for (unsigned u = 0; u < 50; ++u) {
+    string value;
+    for (int len = rand() % 12; len > 0; --len)
+      value.push_back('a' + rand() % 4);
+    base_vec.push_back(value);
+  }
+  vector<string> sorted_vec = base_vec;
+  std::sort(sorted_vec.begin(), sorted_vec.end());
+  vector<string> test_vec = base_vec;
+  string_sort<small_tuning>(test_vec.begin(), test_vec.end());
+  BOOST_CHECK(test_vec == sorted_vec);
+  test_vec = base_vec;
+  string_sort<small_tuning>(test_vec.begin(), test_vec.end(), bracket(),
+                            get_size());
+  BOOST_CHECK(test_vec == sorted_vec);
+  test_vec = base_vec;
+  string_sort<small_tuning>(test_vec.begin(), test_vec.end(), bracket(),
+                            get_size(), less<string>());
+  BOOST_CHECK(test_vec == sorted_vec);
+}
+
+// One workspace reused by batches of different sizes
+void workspace_test()
+{
+  spreadsort_workspace<vector<string>::iterator> workspace;
+  srand(1);
+  for (unsigned batch = 0; batch < 4; ++batch) {
+    vector<string> base_vec;
+    for (unsigned u = 0; u < (batch % 2 ? 2000 : 20000); ++u) {
+      string value;
+      for (int len = rand() % 12; len > 0; --len)
+        value.push_back('a' + rand() % 26);
+      base_vec.push_back(value);
+    }
+    vector<string> sorted_vec = base_vec;
+    std::sort(sorted_vec.begin(), sorted_vec.end());
+    vector<string> test_vec = base_vec;
+    string_sort(test_vec.begin(), test_vec.end(), workspace);
+    BOOST_CHECK(test_vec == sorted_vec);
+    test_vec = base_vec;
+    string_sort(test_vec.begin(), test_vec.end(), bracket(), get_size(),
+                workspace);
+    BOOST_CHECK(test_vec == sorted_vec);
+    test_vec = base_vec;
+    string_sort(test_vec.begin(), test_vec.end(), bracket(), get_size(),
+                less<string>(), workspace);
+    BOOST_CHECK(test_vec == sorted_vec);
+  }
+  workspace.clear();
+}
+
+struct fixed_record {
+  char code[5];
+  unsigned index;
+};
+
+struct get_code {
+  const char *operator()(const fixed_record &x) const { return x.code; }
+};
+
+struct code_less {
+  bool operator()(const fixed_record &x, const fixed_record &y) const {
+    return memcmp(x.code, y.code, sizeof(x.code)) < 0;
+  }
+};
+
+template <class Array>
+bool memcmp_less(const Array &x, const Array &y) {
+  return memcmp(x.data(), y.data(), x.size()) < 0;
+}
+
+// string_sort_fixed on 16-byte arrays and on records with a char[5] key,
+// with bytes of 0x80 and above and long shared prefixes.
+void fixed_test()
+{
+  typedef boost::array<char, 16> code16;
+  vector<code16> base_vec;
+  srand(5);
+  for (unsigned u = 0; u < input_count; ++u) {
+    code16 value;
+    for (unsigned v = 0; v < value.size(); ++v)
+      value[v] = char(v < 9 && u % 2 ? 0x90 + v : rand() % 4 * 0x50);
+    base_vec.push_back(value);
+  }
+  vector<code16> sorted_vec = base_vec;
+  std::sort(sorted_vec.begin(), sorted_vec.end(), memcmp_less<code16>);
+  vector<code16> test_vec = base_vec;
+  string_sort_fixed(test_vec.begin(), test_vec.end());
+  BOOST_CHECK(test_vec == sorted_vec);
+  test_vec = base_vec;
+  string_sort_fixed(test_vec);
+  BOOST_CHECK(test_vec == sorted_vec);
+  //Too few to radix sort
+  test_vec.assign(base_vec.begin(), base_vec.begin() + 100);
+  sorted_vec = test_vec;
+  std::sort(sorted_vec.begin(), sorted_vec.end(), memcmp_less<code16>);
+  string_sort_fixed(test_vec);
+  BOOST_CHECK(test_vec == sorted_vec);
+  //All identical
+  test_vec.assign(input_count, base_vec[0]);
+  string_sort_fixed(test_vec);
+  BOOST_CHECK(test_vec == vector<code16>(input_count, base_vec[0]));
+
+  vector<fixed_record> records(input_count);
+  for (unsigned u = 0; u < input_count; ++u) {
+    for (unsigned v = 0; v < 5; ++v)
+      records[u].code[v] = char(rand() % (v < 2 ? 3 : 256));
+    records[u].index = u;
+  }
+  vector<fixed_record> sorted_records = records;
+  std::sort(sorted_records.begin(), sorted_records.end(), code_less());
+  string_sort_fixed<5>(records.begin(), records.end(), get_code());
+  for (unsigned u = 0; u < input_count; ++u)
+    BOOST_CHECK(!memcmp(records[u].code, sorted_records[u].code, 5));
+}
+
 // Verify that 0, 1, and input_count empty strings all sort correctly.
 void corner_test() {
   vector<string> test_vec;
@@ -157,6 +359,10 @@ int test_main( int, char*[] )
   update_offset_test();
   offset_comparison_test();
   string_test();
+  cached_test();
+  tuning_test();
+  workspace_test();
+  fixed_test();
   corner_test();
   return 0;
 }
@@ -0,0 +1,81 @@
+//----------------------------------------------------------------------------
+/// @file test_block_indirect_geometry.cpp
+/// @brief Test program of the geometries of block_indirect_sort selected
+///        from the L2 cache, with BOOST_SORT_BLOCK_INDIRECT_CACHE_AWARE
+///
+/// @author Copyright (c) 2016 Francisco Jose Tapia (fjtapia@gmail.com )\n
+///         Distributed under the Boost Software License, Version 1.0.\n
+///         ( See accompanying file LICENSE_1_0.txt or copy at
+///           http://www.boost.org/LICENSE_1_0.txt  )
+/// @version 0.1
+///
+/// @remarks The option is defined only here, so test_block_indirect_sort
+///          checks the default geometry
+//-----------------------------------------------------------------------------
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#define BOOST_SORT_BLOCK_INDIRECT_CACHE_AWARE
+#include <boost/test/included/test_exec_monitor.hpp>
+#include <boost/test/test_tools.hpp>
+#include <boost/sort/sort.hpp>
+
+namespace bsp = boost::sort;
+using boost::sort::block_indirect_sort;
+
+// ------------------- vector with 64 bits random numbers --------------------
+std::vector< uint64_t > Vrandom;
+const uint64_t NELEM = 2000000;
+
+// Every geometry selected from the L2 cache sorts
+void test1 (void)
+{
+    std::vector< uint64_t > V1, V2 = Vrandom;
+    std::sort (V2.begin ( ), V2.end ( ));
+    std::vector< std::string > S1, S2;
+    for (uint32_t i = 0; i < 50000; ++i)
+        S2.push_back (std::to_string (Vrandom[i]));
+    std::vector< std::string > S3 = S2;
+    std::sort (S3.begin ( ), S3.end ( ));
+
+    for (int log_scale = -1; log_scale <= 2; ++log_scale)
+    {
+        bsp::set_block_indirect_geometry (log_scale);
+        BOOST_CHECK (bsp::block_indirect_geometry ( ) == log_scale);
+        V1 = Vrandom;
+        block_indirect_sort (V1.begin ( ), V1.end ( ), 8);
+        BOOST_CHECK (V1 == V2);
+        S1 = S2;
+        block_indirect_sort (S1.begin ( ), S1.end ( ), 8);
+        BOOST_CHECK (S1 == S3);
+    };
+    bsp::reset_block_indirect_geometry ( );
+};
+
+// The values out of range are clamped, and the reset returns to the
+// geometry of the host
+void test2 (void)
+{
+    bsp::set_block_indirect_geometry (-5);
+    BOOST_CHECK (bsp::block_indirect_geometry ( ) == -1);
+    bsp::set_block_indirect_geometry (9);
+    BOOST_CHECK (bsp::block_indirect_geometry ( ) == 2);
+
+    bsp::reset_block_indirect_geometry ( );
+    int log_scale = bsp::block_indirect_geometry ( );
+    BOOST_CHECK (log_scale >= -1 && log_scale <= 2);
+};
+
+int test_main (int, char *[])
+{
+    std::mt19937 my_rand (0);
+    Vrandom.reserve (NELEM);
+    for (uint32_t i = 0; i < NELEM; ++i) Vrandom.push_back (my_rand ( ));
+
+    test1 ( );
+    test2 ( );
+
+    return 0;
+};
@@ -12,6 +12,7 @@
 //-----------------------------------------------------------------------------
 #include <algorithm>
 #include <random>
+#include <stdexcept>
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
@@ -92,6 +93,28 @@ void test1 (void)
     for (unsigned i = 1; i < NElem; i++) 
     {   BOOST_CHECK (V1[ i - 1 ] == V1[ i ]);
     };
+
+    //----- sorted and reverse sorted elements, with one pair out of order ---
+    for (uint32_t nthread : {4u, 8u})
+    {
+        for (uint32_t pos : {NElem / 2, NElem - 1})
+        {
+            V1.clear ( );
+            for (uint32_t i = 0; i < NElem; ++i) V1.push_back (i);
+            std::swap (V1[ pos - 1 ], V1[ pos ]);
+            block_indirect_sort (V1.begin ( ), V1.end ( ), nthread);
+            for (unsigned i = 1; i < NElem; i++)
+            {   BOOST_CHECK (V1[ i - 1 ] <= V1[ i ]);
+            };
+
+            std::reverse (V1.begin ( ), V1.end ( ));
+            std::swap (V1[ pos - 1 ], V1[ pos ]);
+            block_indirect_sort (V1.begin ( ), V1.end ( ), nthread);
+            for (unsigned i = 1; i < NElem; i++)
+            {   BOOST_CHECK (V1[ i - 1 ] <= V1[ i ]);
+            };
+        };
+    };
 };
 
 void test2 (void)
@@ -174,6 +197,46 @@ void test3 (void)
     test_int_array<int_array<8> >(1u << 17);
 }
 
+// The parallel algorithms run on an installed thread_pool, which also runs
+// batches bigger than the pool and propagates exceptions
+void test4 (void)
+{
+    std::vector< uint64_t > V1, V2 = Vrandom;
+    std::sort (V2.begin ( ), V2.end ( ));
+
+    bsp::thread_pool pool (3, 64);
+    BOOST_CHECK (bsp::install_thread_pool (&pool) == nullptr);
+    for (uint32_t nthread : {2u, 4u, 8u})
+    {
+        V1 = Vrandom;
+        block_indirect_sort (V1.begin ( ), V1.end ( ), nthread);
+        BOOST_CHECK (V1 == V2);
+        V1 = Vrandom;
+        bsp::sample_sort (V1.begin ( ), V1.end ( ), nthread);
+        BOOST_CHECK (V1 == V2);
+        V1 = Vrandom;
+        bsp::parallel_stable_sort (V1.begin ( ), V1.end ( ), nthread);
+        BOOST_CHECK (V1 == V2);
+    };
+    BOOST_CHECK (bsp::install_thread_pool (nullptr) == &pool);
+
+    std::vector< uint32_t > ran (16, 0);
+    pool.execute (16, [&ran](uint32_t i) { ++ran[i]; });
+    BOOST_CHECK (std::count (ran.begin ( ), ran.end ( ), 1u) == 16);
+
+    bool caught = false;
+    try
+    {
+        pool.execute (8, [](uint32_t i)
+        {   if (i == 5) throw std::runtime_error ("task");
+        });
+    } catch (std::runtime_error &)
+    {
+        caught = true;
+    };
+    BOOST_CHECK (caught);
+};
+
 int test_main (int, char *[])
 {   
     std::mt19937 my_rand (0);
@@ -183,6 +246,7 @@ int test_main (int, char *[])
     test1  ( );
     test2  ( );
     test3  ( );
+    test4  ( );
 
     return 0;
 };
@@ -0,0 +1,116 @@
+//----------------------------------------------------------------------------
+/// @file test_deque_ws.cpp
+/// @brief Test program of the deque_ws work stealing deque
+///
+/// @author Copyright (c) 2016 Francisco Jose Tapia (fjtapia@gmail.com )\n
+///         Distributed under the Boost Software License, Version 1.0.\n
+///         ( See accompanying file LICENSE_1_0.txt or copy at
+///           http://www.boost.org/LICENSE_1_0.txt  )
+/// @version 0.1
+///
+/// @remarks
+//-----------------------------------------------------------------------------
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <boost/sort/common/deque_ws.hpp>
+#include <boost/test/included/test_exec_monitor.hpp>
+#include <boost/test/test_tools.hpp>
+
+using boost::sort::common::deque_ws;
+
+void test1 (void)
+{
+    // ---------------------- one thread, as a stack ------------------------
+    // The initial capacity of 2 makes the buffer grow several times
+    const int NElem = 1000;
+    std::vector< int > V (NElem);
+    deque_ws< int > D (2);
+
+    BOOST_CHECK (D.empty ( ));
+    BOOST_CHECK (D.pop ( ) == nullptr);
+    BOOST_CHECK (D.steal ( ) == nullptr);
+
+    for (int i = 0; i < NElem; ++i) D.push (&V[ i ]);
+    BOOST_CHECK (not D.empty ( ));
+
+    // The thieves take the oldest, the owner the newest
+    BOOST_CHECK (D.steal ( ) == &V[ 0 ]);
+    BOOST_CHECK (D.steal ( ) == &V[ 1 ]);
+    for (int i = NElem - 1; i > 1; --i) BOOST_CHECK (D.pop ( ) == &V[ i ]);
+
+    BOOST_CHECK (D.empty ( ));
+    BOOST_CHECK (D.pop ( ) == nullptr);
+    BOOST_CHECK (D.steal ( ) == nullptr);
+
+    // Reused after being emptied
+    D.push (&V[ 5 ]);
+    BOOST_CHECK (D.steal ( ) == &V[ 5 ]);
+    D.push (&V[ 6 ]);
+    BOOST_CHECK (D.pop ( ) == &V[ 6 ]);
+    BOOST_CHECK (D.empty ( ));
+};
+
+void test2 (void)
+{
+    // ------------------- the owner against several thieves -----------------
+    // Each element must be taken exactly once, by the owner or by a thief
+    const int NElem = 200000;
+    const int NThief = 3;
+    std::vector< int > V (NElem);
+    std::vector< std::atomic< int > > taken (NElem);
+    for (int i = 0; i < NElem; ++i) taken[ i ] = 0;
+
+    deque_ws< int > D (4);
+    std::atomic< bool > done (false);
+
+    auto take = [&](int *ptr) { taken[ ptr - &V[ 0 ] ]++; };
+
+    std::vector< std::thread > thieves;
+    for (int k = 0; k < NThief; ++k)
+    {
+        thieves.emplace_back ([&]( ) {
+            while (not done)
+            {
+                int *ptr = D.steal ( );
+                if (ptr != nullptr) take (ptr);
+                else std::this_thread::yield ( );
+            };
+        });
+    };
+
+    // The owner pushes in bursts and pops part of each, leaving the rest to
+    // the thieves, so pop and steal race on the last element
+    int next = 0;
+    while (next < NElem)
+    {
+        int burst = 1 + (next % 7);
+        for (int i = 0; i < burst and next < NElem; ++i) D.push (&V[ next++ ]);
+        for (int i = 0; i < burst / 2; ++i)
+        {
+            int *ptr = D.pop ( );
+            if (ptr != nullptr) take (ptr);
+        };
+    };
+    for (int *ptr = D.pop ( ); ptr != nullptr; ptr = D.pop ( )) take (ptr);
+
+    done = true;
+    for (auto &t : thieves) t.join ( );
+
+    BOOST_CHECK (D.empty ( ));
+    int lost = 0, duplicated = 0;
+    for (int i = 0; i < NElem; ++i)
+    {
+        if (taken[ i ] == 0) ++lost;
+        if (taken[ i ] > 1) ++duplicated;
+    };
+    BOOST_CHECK (lost == 0);
+    BOOST_CHECK (duplicated == 0);
+};
+
+int test_main (int, char *[])
+{
+    test1 ( );
+    test2 ( );
+    return 0;
+};
@@ -0,0 +1,133 @@
+//----------------------------------------------------------------------------
+/// @file test_inplace_sample_sort.cpp
+/// @brief test program of the inplace_sample_sort algorithm
+///
+/// @author Copyright (c) 2017 Francisco José Tapia (fjtapia@gmail.com )\n
+///         Distributed under the Boost Software License, Version 1.0.\n
+///         ( See accompanying file LICENSE_1_0.txt or copy at
+///           http://www.boost.org/LICENSE_1_0.txt  )
+/// @version 0.1
+///
+/// @remarks
+//-----------------------------------------------------------------------------
+#include <algorithm>
+#include <deque>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <boost/sort/inplace_sample_sort/inplace_sample_sort.hpp>
+#include <boost/test/included/test_exec_monitor.hpp>
+#include <boost/test/test_tools.hpp>
+
+using namespace boost::sort;
+
+void test1 ( );
+void test2 ( );
+void test3 ( );
+
+void test1 (void)
+{
+    typedef std::less< uint64_t > compare_t;
+    std::mt19937_64 my_rand (0);
+
+    // The sizes aren't multiple of the block size, and with few different
+    // values the buckets of the equal elements are used
+    for (uint32_t nelem : {5000u, 100003u, 1000003u})
+    {
+        for (uint64_t nkey : {2ull, 1000ull, 0ull})
+        {
+            for (uint32_t nthread : {1u, 3u, 8u})
+            {
+                std::vector< uint64_t > V1, V2;
+                V1.reserve (nelem);
+                for (uint32_t i = 0; i < nelem; ++i)
+                    V1.push_back ((nkey != 0) ? my_rand ( ) % nkey
+                                              : my_rand ( ));
+                V2 = V1;
+                inplace_sample_sort (V1.begin ( ), V1.end ( ), compare_t ( ),
+                                     nthread);
+                std::sort (V2.begin ( ), V2.end ( ));
+                BOOST_CHECK (V1 == V2);
+            };
+        };
+    };
+};
+
+void test2 (void)
+{
+    typedef std::less< uint64_t > compare_t;
+
+    const uint32_t NElem = 500000;
+    std::vector< uint64_t > V1;
+    compare_t comp;
+
+    // --------------------------- sorted elements ----------------------------
+    for (uint32_t i = 0; i < NElem; ++i) V1.push_back (i);
+    inplace_sample_sort (V1.begin ( ), V1.end ( ), comp, 4);
+    for (unsigned i = 1; i < NElem; i++) {
+        BOOST_CHECK (V1[ i - 1 ] <= V1[ i ]);
+    };
+
+    //-------------------------- reverse sorted elements ----------------------
+    V1.clear ( );
+    for (uint32_t i = 0; i < NElem; ++i) V1.push_back (NElem - i);
+    inplace_sample_sort (V1.begin ( ), V1.end ( ), comp, 4);
+    for (unsigned i = 1; i < NElem; i++) {
+        BOOST_CHECK (V1[ i - 1 ] <= V1[ i ]);
+    };
+
+    //---------------------------- equal elements ----------------------------
+    V1.clear ( );
+    for (uint32_t i = 0; i < NElem; ++i) V1.push_back (1000);
+    inplace_sample_sort (V1.begin ( ), V1.end ( ), comp, 4);
+    for (unsigned i = 1; i < NElem; i++) {
+        BOOST_CHECK (V1[ i - 1 ] == V1[ i ]);
+    };
+
+    //------------------------- few elements ---------------------------------
+    std::mt19937_64 my_rand (0);
+    for (uint32_t nelem : {0u, 1u, 2u, 1000u, 4096u, 4097u})
+    {
+        std::vector< uint64_t > V2;
+        V1.clear ( );
+        for (uint32_t i = 0; i < nelem; ++i) V1.push_back (my_rand ( ));
+        V2 = V1;
+        inplace_sample_sort (V1.begin ( ), V1.end ( ), 8);
+        std::sort (V2.begin ( ), V2.end ( ));
+        BOOST_CHECK (V1 == V2);
+    };
+};
+
+void test3 (void)
+{
+    const uint32_t NELEM = 300000;
+    std::mt19937 my_rand (0);
+
+    //---------------------------- strings ------------------------------------
+    std::vector<std::string> VS1, VS2;
+    for (uint32_t i = 0; i < NELEM; ++i)
+        VS1.push_back (std::to_string (my_rand ( ) % 50000));
+    VS2 = VS1;
+    inplace_sample_sort (VS1.begin ( ), VS1.end ( ), 6);
+    std::sort (VS2.begin ( ), VS2.end ( ));
+    BOOST_CHECK (VS1 == VS2);
+
+    //---------------------------- deque --------------------------------------
+    std::deque<uint32_t> D1, D2;
+    for (uint32_t i = 0; i < NELEM * 2 + 17; ++i)
+        D1.push_back (my_rand ( ));
+    D2 = D1;
+    inplace_sample_sort (D1.begin ( ), D1.end ( ), std::greater<uint32_t> ( ),
+                         3);
+    std::sort (D2.begin ( ), D2.end ( ), std::greater<uint32_t> ( ));
+    BOOST_CHECK (D1 == D2);
+}
+
+int test_main (int, char *[])
+{
+    test1 ( );
+    test2 ( );
+    test3 ( );
+    return 0;
+};
@@ -0,0 +1,189 @@
+//----------------------------------------------------------------------------
+/// @file test_parallel_flat_stable_sort.cpp
+/// @brief test program of the parallel_flat_stable_sort algorithm
+///
+/// @author Copyright (c) 2017 Francisco José Tapia (fjtapia@gmail.com )\n
+///         Distributed under the Boost Software License, Version 1.0.\n
+///         ( See accompanying file LICENSE_1_0.txt or copy at
+///           http://www.boost.org/LICENSE_1_0.txt  )
+/// @version 0.1
+///
+/// @remarks
+//-----------------------------------------------------------------------------
+#include <algorithm>
+#include <deque>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <boost/sort/flat_stable_sort/parallel_flat_stable_sort.hpp>
+#include <boost/test/included/test_exec_monitor.hpp>
+#include <boost/test/test_tools.hpp>
+
+using namespace boost::sort;
+
+void test1 ( );
+void test2 ( );
+void test3 ( );
+void test4 ( );
+
+//---------------- stability test -----------------------------------
+struct xk
+{
+    unsigned tail : 4;
+    unsigned num : 28;
+    xk ( uint32_t n =0 , uint32_t t =0): tail (t), num(n){};
+    bool operator< (xk A) const { return (num < A.num); };
+};
+
+void test1 ( )
+{
+    typedef std::less< xk > compare_t;
+    std::mt19937_64 my_rand (0);
+
+    // The sizes aren't multiple of the block size, to have a tail
+    for (uint32_t nelem : {300001u, 1000003u})
+    {
+        for (uint32_t nkey : {16u, 1000u, 1u << 28})
+        {
+            for (uint32_t nthread : {2u, 3u, 8u})
+            {
+                std::vector< xk > V1, V2;
+                V1.reserve (nelem);
+                for (uint32_t k = 0; k < nelem; ++k)
+                    V1.emplace_back (uint32_t (my_rand ( ) % nkey), k & 15);
+                V2 = V1;
+                parallel_flat_stable_sort (V1.begin ( ), V1.end ( ),
+                                           compare_t ( ), nthread);
+                std::stable_sort (V2.begin ( ), V2.end ( ));
+                BOOST_CHECK (V1.size ( ) == V2.size ( ));
+                for (uint32_t i = 0; i < V1.size ( ); ++i) {
+                    BOOST_CHECK (V1[ i ].num == V2[ i ].num &&
+                                 V1[ i ].tail == V2[ i ].tail);
+                };
+            };
+        };
+    };
+};
+
+void test2 (void)
+{
+    typedef std::less< uint64_t > compare_t;
+
+    const uint32_t NElem = 500000;
+    std::vector< uint64_t > V1,V2;
+    std::mt19937_64 my_rand (0);
+    compare_t comp;
+
+    // ------------------------ random elements -------------------------------
+    for (uint32_t i = 0; i < NElem; ++i) V1.push_back (my_rand ( ) % NElem);
+    V2 = V1;
+    parallel_flat_stable_sort (V1.begin ( ), V1.end ( ), comp, 4);
+    std::stable_sort (V2.begin ( ), V2.end ( ), comp);
+    for (unsigned i = 0; i < NElem; i++) {
+        BOOST_CHECK (V2[ i ] == V1[ i ]);
+    };
+
+    // --------------------------- sorted elements ----------------------------
+    V1.clear ( );
+    for (uint32_t i = 0; i < NElem; ++i) V1.push_back (i);
+    parallel_flat_stable_sort (V1.begin ( ), V1.end ( ), comp, 4);
+    for (unsigned i = 1; i < NElem; i++) {
+        BOOST_CHECK (V1[ i - 1 ] <= V1[ i ]);
+    };
+
+    //-------------------------- reverse sorted elements ----------------------
+    V1.clear ( );
+    for (uint32_t i = 0; i < NElem; ++i) V1.push_back (NElem - i);
+    parallel_flat_stable_sort (V1.begin ( ), V1.end ( ), comp, 4);
+    for (unsigned i = 1; i < NElem; i++) {
+        BOOST_CHECK (V1[ i - 1 ] <= V1[ i ]);
+    };
+
+    //---------------------------- equal elements ----------------------------
+    V1.clear ( );
+    for (uint32_t i = 0; i < NElem; ++i) V1.push_back (1000);
+    parallel_flat_stable_sort (V1.begin ( ), V1.end ( ), comp, 4);
+    for (unsigned i = 1; i < NElem; i++) {
+        BOOST_CHECK (V1[ i - 1 ] == V1[ i ]);
+    };
+
+    //----------------- the first half greater than the second ---------------
+    // the merges of the runs move blocks without merging them
+    V1.clear ( );
+    for (uint32_t i = 0; i < NElem; ++i)
+        V1.push_back ((i < NElem / 2) ? i + NElem : i);
+    V2 = V1;
+    parallel_flat_stable_sort (V1.begin ( ), V1.end ( ), comp, 5);
+    std::stable_sort (V2.begin ( ), V2.end ( ), comp);
+    BOOST_CHECK (V1 == V2);
+
+    //------------- few elements, sorted with only one thread ----------------
+    for (uint32_t nelem : {0u, 1u, 2u, 1000u, 20000u})
+    {
+        V1.clear ( );
+        for (uint32_t i = 0; i < nelem; ++i) V1.push_back (my_rand ( ));
+        V2 = V1;
+        parallel_flat_stable_sort (V1.begin ( ), V1.end ( ), 8);
+        std::stable_sort (V2.begin ( ), V2.end ( ));
+        BOOST_CHECK (V1 == V2);
+    };
+};
+
+void test3 (void)
+{
+    typedef typename std::vector<xk>::iterator  iter_t;
+    typedef std::less<xk>                       compare_t;
+    std::mt19937 my_rand (0);
+    std::vector<xk> V ;
+    const uint32_t NELEM = 100000;
+    V.reserve(NELEM * 10);
+
+
+    for (uint32_t k =0 ; k < 10 ; ++k)
+    {   for ( uint32_t i =0 ; i < NELEM ; ++i)
+        {   V.emplace_back(i , k);
+        };
+        iter_t first = V.begin() + (k * NELEM);
+        iter_t last = first + NELEM ;
+        std::shuffle( first, last, my_rand);
+    };
+    parallel_flat_stable_sort( V.begin() , V.end(), compare_t(), 6);
+    for ( uint32_t i =0 ; i < ( NELEM * 10); ++i)
+    {   BOOST_CHECK ( V[i].num == (i / 10) && V[i].tail == (i %10) );
+    };
+}
+
+void test4 (void)
+{
+    const uint32_t NELEM = 200000;
+    std::mt19937 my_rand (0);
+
+    //---------------------------- strings ------------------------------------
+    std::vector<std::string> VS1, VS2;
+    for (uint32_t i = 0; i < NELEM; ++i)
+        VS1.push_back (std::to_string (my_rand ( ) % 50000));
+    VS2 = VS1;
+    parallel_flat_stable_sort (VS1.begin ( ), VS1.end ( ), 6);
+    std::stable_sort (VS2.begin ( ), VS2.end ( ));
+    BOOST_CHECK (VS1 == VS2);
+
+    //---------------------------- deque --------------------------------------
+    std::deque<uint32_t> D1, D2;
+    for (uint32_t i = 0; i < NELEM * 2 + 17; ++i)
+        D1.push_back (my_rand ( ) % 1000);
+    D2 = D1;
+    parallel_flat_stable_sort (D1.begin ( ), D1.end ( ),
+                               std::greater<uint32_t> ( ), 3);
+    std::stable_sort (D2.begin ( ), D2.end ( ), std::greater<uint32_t> ( ));
+    BOOST_CHECK (D1 == D2);
+}
+
+int test_main (int, char *[])
+{
+    test1 ( );
+    test2 ( );
+    test3 ( );
+    test4 ( );
+    return 0;
+};
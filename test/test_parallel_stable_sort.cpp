@@ -15,6 +15,7 @@
 #include <cstdlib>
 #include <ctime>
 #include <vector>
+#include <string>
 #include <random>
 #include <algorithm>
 #include <boost/sort/parallel_stable_sort/parallel_stable_sort.hpp>
@@ -98,6 +99,30 @@ void test2(void)
     for (unsigned i = 1; i < NElem; i++)
     {   BOOST_CHECK(V1[i - 1] == V1[i]);
     };
+
+    // ---------- sorted elements, with one pair out of order ----------------
+    for (uint32_t pos : {NElem / 2, NElem - 1})
+    {
+        V1.clear();
+        for (uint32_t i = 0; i < NElem; ++i)  V1.push_back(i);
+        std::swap(V1[pos - 1], V1[pos]);
+        bss::parallel_stable_sort(V1.begin(), V1.end(), 8);
+        for (unsigned i = 1; i < NElem; i++)
+        {   BOOST_CHECK(V1[i - 1] <= V1[i]);
+        };
+    };
+
+    // ------- reverse sorted elements, with equal elements -------------------
+    // They are not reversed, as the equal elements would lose their order
+    std::vector<xk> V2, V3;
+    for (uint32_t i = 0; i < NElem; ++i)
+        V2.push_back(xk((NElem - i) >> 1, i & 15));
+    V3 = V2;
+    bss::parallel_stable_sort(V2.begin(), V2.end(), 8);
+    std::stable_sort(V3.begin(), V3.end());
+    for (unsigned i = 0; i < NElem; i++)
+    {   BOOST_CHECK(V2[i].num == V3[i].num && V2[i].tail == V3[i].tail);
+    };
 };
 void test3(void)
 {
@@ -174,6 +199,48 @@ void test5 (void)
     };
 }
 
+// The final merge of the two halves is split between the threads. The
+// equal elements keep their order, also when a half is before the other
+void test6 (void)
+{
+    const uint32_t NELEM = 400000;
+    std::mt19937 my_rand (0);
+    std::vector<xk> V1, V2;
+    for (uint32_t nkey : {1000u, NELEM * 4})
+    {
+        for (uint32_t nthread : {2u, 5u, 8u})
+        {
+            V1.clear();
+            for (uint32_t i = 0; i < NELEM; ++i)
+                V1.emplace_back(my_rand() % nkey, i & 15);
+            V2 = V1;
+            bss::parallel_stable_sort(V1.begin(), V1.end(), nthread);
+            std::stable_sort(V2.begin(), V2.end());
+            for (uint32_t i = 0; i < NELEM; ++i)
+            {   BOOST_CHECK(V1[i].num == V2[i].num && V1[i].tail == V2[i].tail);
+            };
+        };
+    };
+    V1.clear();
+    for (uint32_t i = 0; i < NELEM; ++i)
+        V1.emplace_back((i < NELEM / 2) ? i + NELEM : i, i & 15);
+    V2 = V1;
+    bss::parallel_stable_sort(V1.begin(), V1.end(), 8);
+    std::stable_sort(V2.begin(), V2.end());
+    for (uint32_t i = 0; i < NELEM; ++i)
+    {   BOOST_CHECK(V1[i].num == V2[i].num && V1[i].tail == V2[i].tail);
+    };
+
+    // the moves of the merge of a thread can't be seen by the others
+    std::vector<std::string> VS1, VS2;
+    for (uint32_t i = 0; i < NELEM; ++i)
+        VS1.push_back(std::to_string(my_rand() % 50000));
+    VS2 = VS1;
+    bss::parallel_stable_sort(VS1.begin(), VS1.end(), 6);
+    std::stable_sort(VS2.begin(), VS2.end());
+    BOOST_CHECK(VS1 == VS2);
+}
+
 
 int test_main(int, char *[])
 {
@@ -182,6 +249,7 @@ int test_main(int, char *[])
     test3();
     test4();
     test5();
+    test6();
     return 0;
 };
 
@@ -0,0 +1,177 @@
+//----------------------------------------------------------------------------
+/// @file test_scheduler.cpp
+/// @brief Test program of the work stealing scheduler
+///
+/// @author Copyright (c) 2016 Francisco Jose Tapia (fjtapia@gmail.com )\n
+///         Distributed under the Boost Software License, Version 1.0.\n
+///         ( See accompanying file LICENSE_1_0.txt or copy at
+///           http://www.boost.org/LICENSE_1_0.txt  )
+/// @version 0.1
+///
+/// @remarks
+//-----------------------------------------------------------------------------
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <boost/sort/common/scheduler.hpp>
+#include <boost/sort/common/thread_pool.hpp>
+#include <boost/test/included/test_exec_monitor.hpp>
+#include <boost/test/test_tools.hpp>
+
+namespace bsc = boost::sort::common;
+
+typedef bsc::scheduler< > scheduler_t;
+typedef scheduler_t::atomic_t atomic_t;
+
+const uint32_t NThread = 4;
+
+// Runs the work inserted in the slot 0 with NThread threads, until counter
+// is zero
+void run_all (scheduler_t &sch, atomic_t &counter)
+{
+    bsc::run_threads (NThread, [&](uint32_t i) { sch.exec (i, counter); });
+};
+
+// Splits [first, last) in halves with nested emplace and exec, as the
+// parallel sorts do, and adds the leaves to sum
+void split (scheduler_t &sch, uint64_t first, uint64_t last,
+            std::atomic< uint64_t > &sum)
+{
+    if (last - first <= 16)
+    {
+        uint64_t partial = 0;
+        for (uint64_t i = first; i < last; ++i) partial += i;
+        sum += partial;
+        return;
+    };
+    uint64_t mid = (first + last) / 2;
+    atomic_t son_counter (1);
+    sch.emplace ([&sch, &son_counter, &sum, mid, last]( ) {
+        split (sch, mid, last, sum);
+        --son_counter;
+    });
+    split (sch, first, mid, sum);
+    sch.exec (son_counter);
+};
+
+void test1 (void)
+{
+    // ------------------- nested emplace and exec ---------------------------
+    const uint64_t NElem = 1000000;
+    scheduler_t sch (NThread);
+    std::atomic< uint64_t > sum (0);
+    atomic_t counter (1);
+    sch.emplace ([&]( ) {
+        split (sch, 0, NElem, sum);
+        --counter;
+    });
+    run_all (sch, counter);
+    BOOST_CHECK (sum == NElem * (NElem - 1) / 2);
+};
+
+void test2 (void)
+{
+    // -------------------------- stealing -----------------------------------
+    // The parent work waits, without running works, until its son has run,
+    // so the son can only be stolen by another slot
+    scheduler_t sch (NThread);
+    std::atomic< bool > son_done (false);
+    std::thread::id parent_id, son_id;
+    atomic_t counter (1);
+    sch.emplace ([&]( ) {
+        parent_id = std::this_thread::get_id ( );
+        sch.emplace ([&]( ) {
+            son_id = std::this_thread::get_id ( );
+            son_done = true;
+        });
+        while (not son_done) std::this_thread::yield ( );
+        --counter;
+    });
+    run_all (sch, counter);
+    BOOST_CHECK (son_done);
+    BOOST_CHECK (son_id != parent_id);
+};
+
+void test3 (void)
+{
+    // ------------------------ parking and waking ---------------------------
+    // While the first work sleeps, the other threads exhaust their backoff
+    // and park. The son inserted later must wake one of them, as in test2
+    scheduler_t sch (NThread);
+    std::atomic< int > nson (0);
+    atomic_t counter (1);
+    sch.emplace ([&]( ) {
+        std::this_thread::sleep_for (std::chrono::milliseconds (100));
+        for (int i = 0; i < 3; ++i)
+            sch.emplace ([&]( ) { ++nson; });
+        while (nson != 3) std::this_thread::yield ( );
+        std::this_thread::sleep_for (std::chrono::milliseconds (50));
+        --counter;
+    });
+    // all the threads return, the parked ones woken by the end of the work
+    run_all (sch, counter);
+    BOOST_CHECK (nson == 3);
+};
+
+void test4 (void)
+{
+    // ---------------------------- exceptions -------------------------------
+    // A leaf throws while the other works are running, waiting in nested
+    // execs, or still in the deques. All the threads must return, and the
+    // exception must reach the caller
+    for (uint32_t bad : {0u, 37u, 500u})
+    {
+        scheduler_t sch (NThread);
+        std::atomic< uint64_t > nleaf (0);
+        atomic_t counter (1);
+        std::function< void (uint32_t, uint32_t) > tree;
+        tree = [&](uint32_t first, uint32_t last) {
+            if (last - first == 1)
+            {
+                if (first == bad) throw std::runtime_error ("bad leaf");
+                ++nleaf;
+                return;
+            };
+            // both halves are works, so that no work unwinds while its
+            // sons can still be running
+            uint32_t mid = (first + last) / 2;
+            atomic_t son_counter (2);
+            sch.emplace ([&tree, &son_counter, first, mid]( ) {
+                tree (first, mid);
+                --son_counter;
+            });
+            sch.emplace ([&tree, &son_counter, mid, last]( ) {
+                tree (mid, last);
+                --son_counter;
+            });
+            sch.exec (son_counter);
+        };
+        sch.emplace ([&]( ) {
+            tree (0, 1000);
+            --counter;
+        });
+        bool thrown = false;
+        try
+        {
+            run_all (sch, counter);
+        } catch (std::runtime_error &)
+        {
+            thrown = true;
+        };
+        BOOST_CHECK (thrown);
+        BOOST_CHECK (nleaf <= 999);
+        BOOST_CHECK (counter == 1);
+    };
+};
+
+int test_main (int, char *[])
+{
+    test1 ( );
+    test2 ( );
+    test3 ( );
+    test4 ( );
+    return 0;
+};
@@ -0,0 +1,123 @@
+//----------------------------------------------------------------------------
+/// @file test_small_task.cpp
+/// @brief Test program of the small_task class
+///
+/// @author Copyright (c) 2016 Francisco Jose Tapia (fjtapia@gmail.com )\n
+///         Distributed under the Boost Software License, Version 1.0.\n
+///         ( See accompanying file LICENSE_1_0.txt or copy at
+///           http://www.boost.org/LICENSE_1_0.txt  )
+/// @version 0.1
+///
+/// @remarks
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <memory>
+#include <boost/sort/common/small_task.hpp>
+#include <boost/test/included/test_exec_monitor.hpp>
+#include <boost/test/test_tools.hpp>
+
+using boost::sort::common::small_task;
+
+// Counts the calls, copies, moves and destructions of a function of Size
+// bytes
+int ncall, ncopy, nmove, ndestroy;
+
+void reset (void) { ncall = ncopy = nmove = ndestroy = 0; };
+
+template<uint32_t Size>
+struct counted
+{
+    char data[ Size ];
+    bool alive;
+
+    counted (void) : alive (true) { data[ 0 ] = 1; };
+    counted (const counted &other) : alive (true)
+    {
+        data[ 0 ] = other.data[ 0 ];
+        ++ncopy;
+    };
+    counted (counted &&other) : alive (true)
+    {
+        data[ 0 ] = other.data[ 0 ];
+        ++nmove;
+    };
+    ~counted (void)
+    {
+        // only the copies stored in the tasks are counted
+        if (alive and data[ 0 ] == 2) ++ndestroy;
+        alive = false;
+    };
+    void operator() (void) { ++ncall; };
+};
+
+template<uint32_t Size>
+void check_stored (void)
+{
+    // --------------------------- from a rvalue -----------------------------
+    reset ( );
+    {
+        counted< Size > func;
+        func.data[ 0 ] = 2;
+        small_task<> task (std::move (func));
+        BOOST_CHECK (nmove == 1 and ncopy == 0);
+        task ( );
+        task ( );
+        BOOST_CHECK (ncall == 2);
+        func.alive = false;
+        BOOST_CHECK (ndestroy == 0);
+    };
+    BOOST_CHECK (ndestroy == 1);
+
+    // --------------------------- from a lvalue -----------------------------
+    reset ( );
+    {
+        counted< Size > func;
+        func.data[ 0 ] = 2;
+        small_task<> task (func);
+        BOOST_CHECK (ncopy == 1 and nmove == 0);
+        task ( );
+        BOOST_CHECK (ncall == 1);
+        func.alive = false;
+    };
+    BOOST_CHECK (ndestroy == 1);
+};
+
+// A function which can only be moved
+struct move_only
+{
+    int *pvalue;
+    std::unique_ptr< int > pdelta;
+
+    move_only (int *p, int delta) : pvalue (p), pdelta (new int (delta)) { };
+    void operator() (void) { *pvalue += *pdelta; };
+};
+
+void test1 (void)
+{
+    // stored inside the buffer of 64 bytes
+    check_stored< 16 > ( );
+    // stored apart, in the heap
+    check_stored< 200 > ( );
+};
+
+void test2 (void)
+{
+    // ---------------- lambdas, with the captures of the sorts ---------------
+    int value = 0;
+    int *pvalue = &value;
+    small_task<> task1 ([pvalue]( ) { *pvalue += 1; });
+    task1 ( );
+    BOOST_CHECK (value == 1);
+
+    // a move only function, in a task too small to hold it inside
+    small_task< 8 > task2 (move_only (&value, 5));
+    task2 ( );
+    BOOST_CHECK (value == 6);
+};
+
+int test_main (int, char *[])
+{
+    test1 ( );
+    test2 ( );
+    return 0;
+};